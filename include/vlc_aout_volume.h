@@ -48,6 +48,11 @@ struct audio_volume
 
     vlc_fourcc_t format; /**< Audio samples format */
     void (*amplify)(audio_volume_t *, block_t *, float); /**< Amplifier */
+    /**
+     * Amplifier with a linear gain ramp across the block (optional).
+     * The gain of the last sample frame is the second factor.
+     */
+    void (*amplify_ramp)(audio_volume_t *, block_t *, float, float);
 };
 
 /** @} */
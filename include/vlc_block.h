@@ -144,6 +144,32 @@ VLC_API block_t *block_Alloc(size_t size) VLC_USED VLC_MALLOC;
 
 VLC_API block_t *block_TryRealloc(block_t *, ssize_t pre, size_t body) VLC_USED;
 
+/**
+ * Block allocator statistics for one size class.
+ */
+typedef struct
+{
+    size_t   size; /**< Largest payload size of the class */
+    uint64_t hits; /**< Allocations served from recycled blocks */
+    uint64_t misses; /**< Allocations served from the heap */
+    uint64_t frees; /**< Releases of blocks of the class */
+    unsigned depot; /**< Blocks currently shared among threads */
+} block_pool_stats_t;
+
+/**
+ * Gets block allocator statistics.
+ *
+ * block_Alloc() recycles blocks of a few common payload sizes (TS packets,
+ * datagrams, etc.) instead of freeing them. This reports the per size class
+ * recycling counters. Counters of other threads than the calling one are only
+ * updated periodically, so the values are approximate.
+ *
+ * @param stats table of statistics to fill
+ * @param max size of the table
+ * @return the number of filled table entries
+ */
+VLC_API size_t block_PoolGetStats(block_pool_stats_t *stats, size_t max);
+
 /**
  * Reallocates a block.
  *
@@ -213,6 +239,44 @@ static inline block_t *block_Duplicate( block_t *p_block )
     return p_dup;
 }
 
+/**
+ * Shares a block.
+ *
+ * Creates a new block referencing the same payload as the given block,
+ * without copying it. The block properties are copied.
+ *
+ * Both blocks then have a read-only payload: it must not be written to until
+ * block_MakeWritable() is called. block_Realloc() and block_TryRealloc()
+ * copy a shared payload if it needs to grow. Skipping leading or trailing
+ * bytes, as described for block_Realloc(), is safe.
+ *
+ * The payload is freed when the last of the blocks sharing it is released.
+ * Blocks sharing a payload may be released from different threads.
+ *
+ * @return the new block on success, NULL on error.
+ */
+VLC_API block_t *block_Share(block_t *) VLC_USED;
+
+/**
+ * Checks whether a block payload is shared.
+ *
+ * @return true if other blocks reference the same payload (see block_Share()),
+ * in which case the payload must not be written to.
+ */
+VLC_API bool block_IsShared(const block_t *) VLC_USED;
+
+/**
+ * Makes a block writable.
+ *
+ * If the block payload is shared (see block_Share()), it is copied, unless
+ * the other blocks sharing it were all released already.
+ *
+ * @return a block with a writable payload (possibly the same block),
+ * or NULL on error.
+ * @note On error, the block is discarded.
+ */
+VLC_API block_t *block_MakeWritable(block_t *) VLC_USED;
+
 /**
  * Wraps heap in a block.
  *
@@ -619,6 +683,83 @@ static inline void vlc_fifo_Cleanup(void *fifo)
 }
 #define vlc_fifo_CleanupPush(fifo) vlc_cleanup_push(vlc_fifo_Cleanup, fifo)
 
+/**
+ * @}
+ * \defgroup spsc_fifo Single producer single consumer block FIFO
+ * Lock-free block queue functions
+ *
+ * This is a lighter alternative to @ref block_fifo_t for the common case
+ * where exactly one thread queues blocks and exactly one (other) thread
+ * dequeues them. Queueing and dequeueing do not take any lock; only a
+ * consumer waiting on an empty queue sleeps.
+ *
+ * @warning Calling the producer functions from more than one thread, or the
+ * consumer functions from more than one thread, is undefined.
+ * @{
+ */
+
+typedef struct block_spsc_t block_spsc_t;
+
+/**
+ * Creates a single producer single consumer FIFO queue of blocks.
+ *
+ * The created queue must be released with block_SpscRelease().
+ *
+ * @return the FIFO or NULL on memory error
+ */
+VLC_API block_spsc_t *block_SpscNew(void) VLC_USED VLC_MALLOC;
+
+/**
+ * Destroys a FIFO created by block_SpscNew().
+ *
+ * @note Any queued blocks are also destroyed.
+ * @warning Neither the producer nor the consumer may be using the FIFO when
+ * this function is called.
+ */
+VLC_API void block_SpscRelease(block_spsc_t *);
+
+/**
+ * Queues blocks at the end of the FIFO (producer side).
+ *
+ * The FIFO takes ownership of the blocks in any case. If memory runs out,
+ * the blocks that could not be queued are released.
+ *
+ * @param block head of a block list to queue (may be NULL)
+ * @return VLC_SUCCESS, or VLC_ENOMEM if some blocks were dropped
+ */
+VLC_API int block_SpscPut(block_spsc_t *, block_t *);
+
+/**
+ * Dequeues the first block from the FIFO, if any (consumer side).
+ *
+ * @note This function is not a cancellation point.
+ * @return a block or NULL if the FIFO is empty
+ */
+VLC_API block_t *block_SpscTryGet(block_spsc_t *) VLC_USED;
+
+/**
+ * Dequeues the first block from the FIFO (consumer side). If necessary, waits
+ * until there is one block in the queue.
+ *
+ * @note This function is (always) a cancellation point.
+ * @return a valid block
+ */
+VLC_API block_t *block_SpscGet(block_spsc_t *) VLC_USED;
+
+/**
+ * Counts blocks in the FIFO.
+ *
+ * @note The value may be stale by the time it is returned, but it is exact
+ * from the point of view of either the producer or the consumer when the
+ * other side is idle.
+ */
+VLC_API size_t block_SpscCount(block_spsc_t *) VLC_USED;
+
+/**
+ * Counts bytes in the FIFO. See block_SpscCount().
+ */
+VLC_API size_t block_SpscSize(block_spsc_t *) VLC_USED;
+
 /** @} */
 
 /** @} */
@@ -278,6 +278,47 @@ VLC_API int filter_Blend( filter_t *, picture_t *p_dst, int i_dst_x, int i_dst_y
  */
 VLC_API void filter_DeleteBlend( filter_t * );
 
+/**
+ * Processes one of i_slices slices of a picture.
+ *
+ * Slices may run in parallel, so they must neither write to the same
+ * memory nor depend on each other.
+ */
+typedef void (*filter_slice_cb)( filter_t *, void *opaque,
+                                 unsigned i_slice, unsigned i_slices );
+
+/**
+ * It runs a slice callback for each slice of a picture, in parallel.
+ *
+ * The callback runs on the calling thread and on the video filter slice
+ * threads shared by all filters. The actual number of slices depends on
+ * the "slice-threads" setting and is at most i_slices; with a single slice,
+ * the callback simply runs synchronously on the whole picture.
+ *
+ * It returns once all slices are done.
+ */
+VLC_API void filter_ExecuteSlices( filter_t *, filter_slice_cb, void *opaque,
+                                   unsigned i_slices );
+
+/**
+ * Converts lines [0, i_lines) of a source picture into a destination picture.
+ */
+typedef void (*filter_picture_slice_cb)( filter_t *, picture_t *p_src,
+                                         picture_t *p_dst, unsigned i_lines );
+
+/**
+ * It runs a conversion callback on horizontal slices of the source and
+ * destination pictures, in parallel (see filter_ExecuteSlices).
+ *
+ * The callback is given views of the slices (see picture_GetSlice). The
+ * slices start at multiples of i_align lines, so that subsampled chroma
+ * planes are split at the same place. The pictures must have the same
+ * height.
+ */
+VLC_API void filter_ExecutePictureSlices( filter_t *, filter_picture_slice_cb,
+                                          picture_t *p_src, picture_t *p_dst,
+                                          unsigned i_lines, unsigned i_align );
+
 /**
  * Create a picture_t *(*)( filter_t *, picture_t * ) compatible wrapper
  * using a void (*)( filter_t *, picture_t *, picture_t * ) function
@@ -298,6 +339,30 @@ VLC_API void filter_DeleteBlend( filter_t * );
         return p_outpic;                                                \
     }
 
+/**
+ * Create a picture_t *(*)( filter_t *, picture_t * ) compatible wrapper
+ * using a void (*)( filter_t *, picture_t *, picture_t *, unsigned ) function
+ * converting the given number of lines, run on slices in parallel
+ *
+ * The converted lines are those of the input format, including the top
+ * offset; slices start at multiples of align lines.
+ */
+#define VIDEO_FILTER_WRAPPER_SLICES( name, align )                      \
+    static picture_t *name ## _Filter ( filter_t *p_filter,             \
+                                        picture_t *p_pic )              \
+    {                                                                   \
+        picture_t *p_outpic = filter_NewPicture( p_filter );            \
+        if( p_outpic )                                                  \
+        {                                                               \
+            filter_ExecutePictureSlices( p_filter, name, p_pic,         \
+                    p_outpic, p_filter->fmt_in.video.i_y_offset         \
+                    + p_filter->fmt_in.video.i_visible_height, align ); \
+            picture_CopyProperties( p_outpic, p_pic );                  \
+        }                                                               \
+        picture_Release( p_pic );                                       \
+        return p_outpic;                                                \
+    }
+
 /**
  * Filter chain management API
  * The filter chain management API is used to dynamically construct filters
@@ -421,6 +421,14 @@ struct input_stats_t
     /* Aout */
     int64_t i_played_abuffers;
     int64_t i_lost_abuffers;
+
+    /* Timeshift */
+    int64_t i_timeshift_fill;   /* Buffered bytes */
+    int64_t i_timeshift_index;  /* Seek index entries */
+
+    /* Video decoder */
+    int64_t i_decode_time;      /* Video decoding time per block (us) */
+    int64_t i_decoder_queue;    /* Video blocks waiting for the decoder */
 };
 
 /**
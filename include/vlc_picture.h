@@ -177,6 +177,22 @@ VLC_API void picture_Reset( picture_t * );
 VLC_API void picture_CopyPixels( picture_t *p_dst, const picture_t *p_src );
 VLC_API void plane_CopyPixels( plane_t *p_dst, const plane_t *p_src );
 
+/**
+ * This function sets up a view of a horizontal slice of a picture.
+ *
+ * The view shares the pixels of the picture: it must not be held nor
+ * released, and it is only valid as long as the picture is.
+ * i_start and i_end are lines of the first plane. Except at the bottom of the
+ * picture, they must be multiples of the vertical chroma subsampling.
+ *
+ * \param p_view pointer to the view to set up.
+ * \param p_pic pointer to the picture.
+ * \param i_start first line of the slice.
+ * \param i_end line following the slice.
+ */
+VLC_API void picture_GetSlice( picture_t *p_view, const picture_t *p_pic,
+                               unsigned i_start, unsigned i_end );
+
 /**
  * This function will copy both picture dynamic properties and pixels.
  * You have to notice that sometime a simple picture_Hold may do what
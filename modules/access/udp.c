@@ -49,6 +49,12 @@
 #ifdef HAVE_SYS_UIO_H
 # include <sys/uio.h>
 #endif
+#ifdef __linux__
+# include <netinet/udp.h>
+# ifndef UDP_GRO
+#  define UDP_GRO 104
+# endif
+#endif
 
 /*****************************************************************************
  * Module descriptor
@@ -59,6 +65,13 @@ static void Close( vlc_object_t * );
 #define BUFFER_TEXT N_("Receive buffer")
 #define BUFFER_LONGTEXT N_("UDP receive buffer size (bytes)" )
 #define TIMEOUT_TEXT N_("UDP Source timeout (sec)")
+#define BATCH_TEXT N_("Receive batch size")
+#define BATCH_LONGTEXT N_("Maximum number of datagrams received with a " \
+    "single system call. This reduces CPU usage with high bit rates.")
+#define GRO_TEXT N_("Receive offload")
+#define GRO_LONGTEXT N_("Let the operating system coalesce consecutive " \
+    "datagrams into larger buffers. This is only suitable for byte " \
+    "streams such as MPEG-TS.")
 
 vlc_module_begin ()
     set_shortname( N_("UDP" ) )
@@ -69,6 +82,13 @@ vlc_module_begin ()
     add_obsolete_integer( "server-port" ) /* since 2.0.0 */
     add_obsolete_integer( "udp-buffer" ) /* since 3.0.0 */
     add_integer( "udp-timeout", -1, TIMEOUT_TEXT, NULL, true )
+#ifdef HAVE_RECVMMSG
+    add_integer( "udp-batch", 32, BATCH_TEXT, BATCH_LONGTEXT, true )
+        change_integer_range( 1, 256 )
+#endif
+#ifdef __linux__
+    add_bool( "udp-gro", false, GRO_TEXT, GRO_LONGTEXT, true )
+#endif
 
     set_capability( "access", 0 )
     add_shortcut( "udp", "udpstream", "udp4", "udp6" )
@@ -81,12 +101,24 @@ struct access_sys_t
     int fd;
     int timeout;
     size_t mtu;
+#ifdef HAVE_RECVMMSG
+    /* Batched reception */
+    unsigned batch;
+    unsigned count; /**< Datagrams received by the last recvmmsg() */
+    unsigned next; /**< Next received datagram to return */
+    struct mmsghdr *msgs;
+    struct iovec *iovecs;
+    block_t **blocks;
+#endif
 };
 
 /*****************************************************************************
  * Local prototypes
  *****************************************************************************/
 static block_t *BlockUDP( stream_t *, bool * );
+#ifdef HAVE_RECVMMSG
+static block_t *BlockUDPBatch( stream_t *, bool * );
+#endif
 static int Control( stream_t *, int, va_list );
 
 /*****************************************************************************
@@ -170,10 +202,50 @@ static int Open( vlc_object_t *p_this )
 
     sys->mtu = 7 * 188;
 
+#ifdef __linux__
+    if( var_InheritBool( p_access, "udp-gro" ) )
+    {
+        if( setsockopt( sys->fd, IPPROTO_UDP, UDP_GRO, &(int){ 1 },
+                        sizeof (int) ) == 0 )
+            sys->mtu = 65535; /* Room for coalesced datagrams */
+        else
+            msg_Warn( p_access, "receive offload not supported: %s",
+                      vlc_strerror_c(errno) );
+    }
+#endif
+
     sys->timeout = var_InheritInteger( p_access, "udp-timeout");
     if( sys->timeout > 0)
         sys->timeout *= 1000;
 
+#ifdef HAVE_RECVMMSG
+    sys->batch = var_InheritInteger( p_access, "udp-batch" );
+    if( sys->mtu > 7 * 188 && sys->batch > 8 )
+        sys->batch = 8; /* Bound memory use with large buffers */
+    sys->count = sys->next = 0;
+    if( sys->batch > 1 )
+    {
+        sys->msgs = vlc_obj_calloc( p_this, sys->batch, sizeof (*sys->msgs) );
+        sys->iovecs = vlc_obj_calloc( p_this, sys->batch,
+                                      sizeof (*sys->iovecs) );
+        sys->blocks = vlc_obj_calloc( p_this, sys->batch,
+                                      sizeof (*sys->blocks) );
+        if( unlikely(sys->msgs == NULL || sys->iovecs == NULL
+                  || sys->blocks == NULL) )
+        {
+            net_Close( sys->fd );
+            return VLC_ENOMEM;
+        }
+
+        for( unsigned i = 0; i < sys->batch; i++ )
+        {
+            sys->msgs[i].msg_hdr.msg_iov = &sys->iovecs[i];
+            sys->msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+        p_access->pf_block = BlockUDPBatch;
+    }
+#endif
+
     return VLC_SUCCESS;
 }
 
@@ -185,6 +257,12 @@ static void Close( vlc_object_t *p_this )
     stream_t     *p_access = (stream_t*)p_this;
     access_sys_t *sys = p_access->p_sys;
 
+#ifdef HAVE_RECVMMSG
+    if( sys->batch > 1 )
+        for( unsigned i = 0; i < sys->batch; i++ )
+            if( sys->blocks[i] != NULL )
+                block_Release( sys->blocks[i] );
+#endif
     net_Close( sys->fd );
 }
 
@@ -285,3 +363,95 @@ skip:
 
     return pkt;
 }
+
+#ifdef HAVE_RECVMMSG
+/*****************************************************************************
+ * BlockUDPBatch: receives up to sys->batch datagrams per system call
+ *****************************************************************************/
+static block_t *BlockUDPBatchDequeue(stream_t *access)
+{
+    access_sys_t *sys = access->p_sys;
+    unsigned i = sys->next++;
+    block_t *pkt = sys->blocks[i];
+    size_t len = sys->msgs[i].msg_len;
+
+    sys->blocks[i] = NULL;
+
+    if (sys->msgs[i].msg_hdr.msg_flags & MSG_TRUNC)
+    {
+        msg_Err(access, "%zu bytes packet truncated (MTU was %zu)",
+                len, sys->iovecs[i].iov_len);
+        pkt->i_flags |= BLOCK_FLAG_CORRUPTED;
+        pkt->i_buffer = sys->iovecs[i].iov_len;
+        if (len > sys->mtu)
+            sys->mtu = len;
+    }
+    else
+        pkt->i_buffer = len;
+
+    return pkt;
+}
+
+static block_t *BlockUDPBatch(stream_t *access, bool *restrict eof)
+{
+    access_sys_t *sys = access->p_sys;
+
+    if (sys->next < sys->count)
+        return BlockUDPBatchDequeue(access);
+
+    /* Replace the buffers handed out by the previous batch */
+    unsigned n;
+    for (n = 0; n < sys->batch; n++)
+    {
+        block_t *pkt = sys->blocks[n];
+
+        if (pkt != NULL && sys->iovecs[n].iov_len < sys->mtu)
+        {   /* MTU grew since allocation */
+            block_Release(pkt);
+            pkt = NULL;
+        }
+
+        if (pkt == NULL)
+        {
+            pkt = block_Alloc(sys->mtu);
+            if (unlikely(pkt == NULL))
+                break;
+
+            sys->blocks[n] = pkt;
+            sys->iovecs[n].iov_base = pkt->p_buffer;
+            sys->iovecs[n].iov_len = sys->mtu;
+        }
+    }
+
+    if (unlikely(n == 0))
+    {   /* OOM - dequeue and discard one packet */
+        char dummy;
+        recv(sys->fd, &dummy, 1, 0);
+        return NULL;
+    }
+
+    struct pollfd ufd[1];
+
+    ufd[0].fd = sys->fd;
+    ufd[0].events = POLLIN;
+
+    switch (vlc_poll_i11e(ufd, 1, sys->timeout))
+    {
+        case 0:
+            msg_Err(access, "receive time-out");
+            *eof = true;
+            /* fall through */
+        case -1:
+            return NULL;
+    }
+
+    /* Only take what is already queued: do not wait for a full batch. */
+    int val = recvmmsg(sys->fd, sys->msgs, n, MSG_TRUNC | MSG_DONTWAIT, NULL);
+    if (val <= 0)
+        return NULL;
+
+    sys->count = val;
+    sys->next = 0;
+    return BlockUDPBatchDequeue(access);
+}
+#endif
@@ -50,6 +50,8 @@
 #include <vlc_network.h>
 
 #define MAX_EMPTY_BLOCKS 200
+#define MAX_BURST        64
+#define STATS_PERIOD     (CLOCK_FREQ * 10)
 
 /*****************************************************************************
  * Module descriptor
@@ -71,6 +73,14 @@ static void Close( vlc_object_t * );
                           "helps reducing the scheduling load on " \
                           "heavily-loaded systems." )
 
+#define WINDOW_TEXT N_("Burst window (ms)")
+#define WINDOW_LONGTEXT N_("Packets due within this delay of the next " \
+                           "packet are sent at once, with a single system " \
+                           "call where supported. This reduces the " \
+                           "scheduling and system call load with many " \
+                           "streams, at the cost of output jitter. " \
+                           "Zero disables bursts." )
+
 vlc_module_begin ()
     set_description( N_("UDP stream output") )
     set_shortname( "UDP" )
@@ -79,6 +89,9 @@ vlc_module_begin ()
     add_integer( SOUT_CFG_PREFIX "caching", DEFAULT_PTS_DELAY / 1000, CACHING_TEXT, CACHING_LONGTEXT, true )
     add_integer( SOUT_CFG_PREFIX "group", 1, GROUP_TEXT, GROUP_LONGTEXT,
                                  true )
+    add_integer( SOUT_CFG_PREFIX "window", 0, WINDOW_TEXT, WINDOW_LONGTEXT,
+                                 true )
+        change_integer_range( 0, 1000 )
 
     set_capability( "sout access", 0 )
     add_shortcut( "udp" )
@@ -92,6 +105,7 @@ vlc_module_end ()
 static const char *const ppsz_sout_options[] = {
     "caching",
     "group",
+    "window",
     NULL
 };
 
@@ -107,6 +121,7 @@ static ssize_t Write   ( sout_access_out_t *, block_t * );
 static int Control( sout_access_out_t *, int, va_list );
 
 static void* ThreadWrite( void * );
+static void* ThreadWriteBurst( void * );
 static block_t *NewUDPPacket( sout_access_out_t *, vlc_tick_t );
 
 struct sout_access_out_sys_t
@@ -116,11 +131,22 @@ struct sout_access_out_sys_t
     bool          b_mtu_warning;
     size_t        i_mtu;
 
-    block_fifo_t *p_fifo;
-    block_fifo_t *p_empty_blocks;
+    block_spsc_t *p_fifo;
+    block_spsc_t *p_empty_blocks;
     block_t      *p_buffer;
 
+    vlc_tick_t    i_window;
     vlc_thread_t  thread;
+
+    /* Burst statistics (owned by the thread) */
+    struct
+    {
+        uint64_t   bursts;
+        uint64_t   packets;
+        unsigned   max_burst;
+        vlc_tick_t jitter; /**< Sum of packets absolute send date errors */
+        vlc_tick_t max_jitter;
+    } stats;
 };
 
 #define DEFAULT_PORT 1234
@@ -209,16 +235,25 @@ static int Open( vlc_object_t *p_this )
     p_sys->i_handle = i_handle;
     p_sys->i_mtu = var_CreateGetInteger( p_this, "mtu" );
     p_sys->b_mtu_warning = false;
-    p_sys->p_fifo = block_FifoNew();
-    p_sys->p_empty_blocks = block_FifoNew();
+    /* Write() is the only producer and ThreadWrite() the only consumer of
+     * p_fifo, and conversely for p_empty_blocks. */
+    p_sys->p_fifo = block_SpscNew();
+    p_sys->p_empty_blocks = block_SpscNew();
     p_sys->p_buffer = NULL;
-
-    if( vlc_clone( &p_sys->thread, ThreadWrite, p_access,
-                           VLC_THREAD_PRIORITY_HIGHEST ) )
+    p_sys->i_window = UINT64_C(1000)
+                    * var_GetInteger( p_access, SOUT_CFG_PREFIX "window" );
+    memset( &p_sys->stats, 0, sizeof (p_sys->stats) );
+
+    if( p_sys->p_fifo == NULL || p_sys->p_empty_blocks == NULL
+     || vlc_clone( &p_sys->thread,
+                   p_sys->i_window > 0 ? ThreadWriteBurst : ThreadWrite,
+                   p_access, VLC_THREAD_PRIORITY_HIGHEST ) )
     {
         msg_Err( p_access, "cannot spawn sout access thread" );
-        block_FifoRelease( p_sys->p_fifo );
-        block_FifoRelease( p_sys->p_empty_blocks );
+        if( p_sys->p_fifo != NULL )
+            block_SpscRelease( p_sys->p_fifo );
+        if( p_sys->p_empty_blocks != NULL )
+            block_SpscRelease( p_sys->p_empty_blocks );
         net_Close (i_handle);
         free (p_sys);
         return VLC_EGENERIC;
@@ -240,8 +275,16 @@ static void Close( vlc_object_t * p_this )
 
     vlc_cancel( p_sys->thread );
     vlc_join( p_sys->thread, NULL );
-    block_FifoRelease( p_sys->p_fifo );
-    block_FifoRelease( p_sys->p_empty_blocks );
+
+    if( p_sys->stats.bursts > 0 )
+        msg_Dbg( p_access, "sent %"PRIu64" packets in %"PRIu64" bursts "
+                 "(max %u), jitter average %"PRId64" us, max %"PRId64" us",
+                 p_sys->stats.packets, p_sys->stats.bursts,
+                 p_sys->stats.max_burst,
+                 p_sys->stats.jitter / (vlc_tick_t)p_sys->stats.packets,
+                 p_sys->stats.max_jitter );
+    block_SpscRelease( p_sys->p_fifo );
+    block_SpscRelease( p_sys->p_empty_blocks );
 
     if( p_sys->p_buffer ) block_Release( p_sys->p_buffer );
 
@@ -296,7 +339,8 @@ static ssize_t Write( sout_access_out_t *p_access, block_t *p_buffer )
                          now - p_sys->p_buffer->i_dts
                           - p_sys->i_caching );
             }
-            block_FifoPut( p_sys->p_fifo, p_sys->p_buffer );
+            if( block_SpscPut( p_sys->p_fifo, p_sys->p_buffer ) )
+                msg_Err( p_access, "cannot queue packet: dropped" );
             p_sys->p_buffer = NULL;
         }
 
@@ -336,7 +380,8 @@ static ssize_t Write( sout_access_out_t *p_access, block_t *p_buffer )
                              mdate() - p_sys->p_buffer->i_dts
                               - p_sys->i_caching );
                 }
-                block_FifoPut( p_sys->p_fifo, p_sys->p_buffer );
+                if( block_SpscPut( p_sys->p_fifo, p_sys->p_buffer ) )
+                    msg_Err( p_access, "cannot queue packet: dropped" );
                 p_sys->p_buffer = NULL;
             }
         }
@@ -357,22 +402,26 @@ static block_t *NewUDPPacket( sout_access_out_t *p_access, vlc_tick_t i_dts)
     sout_access_out_sys_t *p_sys = p_access->p_sys;
     block_t *p_buffer;
 
-    while ( block_FifoCount( p_sys->p_empty_blocks ) > MAX_EMPTY_BLOCKS )
+    while ( block_SpscCount( p_sys->p_empty_blocks ) > MAX_EMPTY_BLOCKS )
     {
-        p_buffer = block_FifoGet( p_sys->p_empty_blocks );
+        p_buffer = block_SpscTryGet( p_sys->p_empty_blocks );
+        if( p_buffer == NULL )
+            break;
         block_Release( p_buffer );
     }
 
-    if( block_FifoCount( p_sys->p_empty_blocks ) == 0 )
+    p_buffer = block_SpscTryGet( p_sys->p_empty_blocks );
+    if( p_buffer == NULL )
     {
         p_buffer = block_Alloc( p_sys->i_mtu );
     }
     else
     {
-        p_buffer = block_FifoGet(p_sys->p_empty_blocks );
         p_buffer->i_flags = 0;
         p_buffer = block_Realloc( p_buffer, 0, p_sys->i_mtu );
     }
+    if( unlikely(p_buffer == NULL) )
+        return NULL;
 
     p_buffer->i_dts = i_dts;
     p_buffer->i_buffer = 0;
@@ -395,7 +444,7 @@ static void* ThreadWrite( void *data )
 
     for (;;)
     {
-        block_t *p_pk = block_FifoGet( p_sys->p_fifo );
+        block_t *p_pk = block_SpscGet( p_sys->p_fifo );
         vlc_tick_t    i_date, i_sent;
 
         i_date = p_sys->i_caching + p_pk->i_dts;
@@ -407,7 +456,7 @@ static void* ThreadWrite( void *data )
                     msg_Dbg( p_access, "mmh, hole (%"PRId64" > 2s) -> drop",
                              i_date - i_date_last );
 
-                block_FifoPut( p_sys->p_empty_blocks, p_pk );
+                block_SpscPut( p_sys->p_empty_blocks, p_pk );
 
                 i_date_last = i_date;
                 i_dropped_packets++;
@@ -447,9 +496,164 @@ static void* ThreadWrite( void *data )
         }
 #endif
 
-        block_FifoPut( p_sys->p_empty_blocks, p_pk );
+        block_SpscPut( p_sys->p_empty_blocks, p_pk );
+
+        i_date_last = i_date;
+    }
+    return NULL;
+}
+
+/*****************************************************************************
+ * ThreadWriteBurst: Write packets due within a time window at once.
+ *****************************************************************************/
+struct udp_burst
+{
+    block_t *pkts[MAX_BURST];
+    unsigned count;
+    block_t *next; /* First packet of the next burst, if already dequeued */
+};
+
+static void BurstCleanup( void *data )
+{
+    struct udp_burst *burst = data;
+
+    for( unsigned i = 0; i < burst->count; i++ )
+        block_Release( burst->pkts[i] );
+    if( burst->next != NULL )
+        block_Release( burst->next );
+}
+
+static void BurstSend( sout_access_out_t *p_access, struct udp_burst *burst )
+{
+    sout_access_out_sys_t *p_sys = p_access->p_sys;
+
+#ifdef HAVE_SENDMMSG
+    struct mmsghdr msgs[MAX_BURST];
+    struct iovec iov[MAX_BURST];
+
+    for( unsigned i = 0; i < burst->count; i++ )
+    {
+        iov[i].iov_base = burst->pkts[i]->p_buffer;
+        iov[i].iov_len = burst->pkts[i]->i_buffer;
+        memset( &msgs[i], 0, sizeof (msgs[i]) );
+        msgs[i].msg_hdr.msg_iov = &iov[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    for( unsigned i = 0; i < burst->count; )
+    {
+        int val = sendmmsg( p_sys->i_handle, msgs + i, burst->count - i, 0 );
+        if( val < 0 )
+        {   /* Skip the failing datagram */
+            msg_Warn( p_access, "send error: %s", vlc_strerror_c(errno) );
+            val = 1;
+        }
+        i += val;
+    }
+#else
+    for( unsigned i = 0; i < burst->count; i++ )
+        if( send( p_sys->i_handle, burst->pkts[i]->p_buffer,
+                  burst->pkts[i]->i_buffer, 0 ) == -1 )
+            msg_Warn( p_access, "send error: %s", vlc_strerror_c(errno) );
+#endif
+}
+
+static void* ThreadWriteBurst( void *data )
+{
+    sout_access_out_t *p_access = data;
+    sout_access_out_sys_t *p_sys = p_access->p_sys;
+    struct udp_burst burst = { .count = 0, .next = NULL };
+
+    vlc_cleanup_push( BurstCleanup, &burst );
+    vlc_tick_t i_date_last = -1;
+    vlc_tick_t i_stats_last = mdate();
+    unsigned i_dropped_packets = 0;
+
+    for (;;)
+    {
+        block_t *p_pk = burst.next;
+
+        burst.next = NULL;
+        if( p_pk == NULL )
+            p_pk = block_SpscGet( p_sys->p_fifo );
+
+        vlc_tick_t i_date = p_sys->i_caching + p_pk->i_dts;
+        if( i_date_last > 0 && i_date - i_date_last > 2000000 )
+        {
+            if( !i_dropped_packets )
+                msg_Dbg( p_access, "mmh, hole (%"PRId64" > 2s) -> drop",
+                         i_date - i_date_last );
+
+            block_SpscPut( p_sys->p_empty_blocks, p_pk );
+            i_date_last = i_date;
+            i_dropped_packets++;
+            continue;
+        }
+
+        burst.pkts[burst.count++] = p_pk;
+        mwait( i_date );
+
+        /* Gather the packets already queued and due within the window */
+        const vlc_tick_t i_end = i_date + p_sys->i_window;
 
         i_date_last = i_date;
+        while( burst.count < MAX_BURST )
+        {
+            p_pk = block_SpscTryGet( p_sys->p_fifo );
+            if( p_pk == NULL )
+                break;
+            if( p_sys->i_caching + p_pk->i_dts > i_end )
+            {
+                burst.next = p_pk;
+                break;
+            }
+            burst.pkts[burst.count++] = p_pk;
+        }
+
+        BurstSend( p_access, &burst );
+
+        if( i_dropped_packets )
+        {
+            msg_Dbg( p_access, "dropped %i packets", i_dropped_packets );
+            i_dropped_packets = 0;
+        }
+
+        /* Statistics and recycling */
+        vlc_tick_t i_sent = mdate();
+
+        if ( i_sent > i_date + 20000 )
+            msg_Dbg( p_access, "packet has been sent too late (%"PRId64 ")",
+                     i_sent - i_date );
+
+        for( unsigned i = 0; i < burst.count; i++ )
+        {
+            vlc_tick_t i_due = p_sys->i_caching + burst.pkts[i]->i_dts;
+            vlc_tick_t i_jitter = i_sent > i_due ? i_sent - i_due
+                                                 : i_due - i_sent;
+
+            p_sys->stats.jitter += i_jitter;
+            if( i_jitter > p_sys->stats.max_jitter )
+                p_sys->stats.max_jitter = i_jitter;
+            i_date_last = __MAX( i_date_last, i_due );
+            block_SpscPut( p_sys->p_empty_blocks, burst.pkts[i] );
+        }
+
+        p_sys->stats.bursts++;
+        p_sys->stats.packets += burst.count;
+        if( burst.count > p_sys->stats.max_burst )
+            p_sys->stats.max_burst = burst.count;
+        burst.count = 0;
+
+        if( i_sent - i_stats_last >= STATS_PERIOD )
+        {
+            msg_Dbg( p_access, "%.1f packets per burst, jitter average "
+                     "%"PRId64" us, max %"PRId64" us",
+                     p_sys->stats.packets / (double)p_sys->stats.bursts,
+                     p_sys->stats.jitter / (vlc_tick_t)p_sys->stats.packets,
+                     p_sys->stats.max_jitter );
+            i_stats_last = i_sent;
+        }
     }
+    vlc_cleanup_pop();
     return NULL;
 }
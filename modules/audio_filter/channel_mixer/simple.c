@@ -30,6 +30,7 @@
 
 #include <vlc_common.h>
 #include <vlc_plugin.h>
+#include <vlc_cpu.h>
 #include <vlc_aout.h>
 #include <vlc_filter.h>
 #include <vlc_block.h>
@@ -258,6 +259,99 @@ static void DoWork_6_1_to_5_x( filter_t * p_filter,  block_t * p_in_buf, block_t
     }
 }
 
+#if (defined(__i386__) || defined(__x86_64__)) && \
+    (VLC_GCC_VERSION(4,9) || defined(__clang__))
+# include <immintrin.h>
+# define SIMPLE_HAVE_AVX2
+
+/* The stereo downmixes of 5.1 and 7.1, four frames at a time. Each pair of
+ * input channels is moved as one 64-bits element, so that the pairs line up
+ * with the stereo output. The results are the same as the C versions. */
+__attribute__ ((__target__ ("avx2")))
+static void DoWork_5_1_to_2_0_avx2( filter_t * p_filter,  block_t * p_in_buf, block_t * p_out_buf ) {
+    VLC_UNUSED(p_filter);
+    float *p_dest = (float *)p_out_buf->p_buffer;
+    const float *p_src = (const float *)p_in_buf->p_buffer;
+    const __m256 k = _mm256_set1_ps( 0.7071f );
+    int i = p_in_buf->i_nb_samples;
+
+    for( ; i >= 4; i -= 4, p_src += 24, p_dest += 8 )
+    {
+        /* Pairs 0-11 of four frames: (L,R) (Ls,Rs) (C,LFE) for each frame */
+        __m256d y0 = _mm256_loadu_pd( (const double *)p_src );
+        __m256d y1 = _mm256_loadu_pd( (const double *)(p_src + 8) );
+        __m256d y2 = _mm256_loadu_pd( (const double *)(p_src + 16) );
+
+        /* pairs 0, 9, 6, 3 */
+        __m256d front = _mm256_blend_pd( _mm256_blend_pd( y0, y1, 0x4 ),
+                                         y2, 0x2 );
+        /* pairs 4, 1, 10, 7 */
+        __m256d rear = _mm256_blend_pd( _mm256_blend_pd( y0, y1, 0x9 ),
+                                        y2, 0x4 );
+        /* pairs 8, 5, 2, 11 */
+        __m256d center = _mm256_blend_pd( _mm256_blend_pd( y0, y1, 0x2 ),
+                                          y2, 0x9 );
+
+        __m256 l_r = _mm256_castpd_ps( _mm256_permute4x64_pd( front, 0x6C ) );
+        __m256 ls_rs = _mm256_castpd_ps( _mm256_permute4x64_pd( rear, 0xB1 ) );
+        __m256 c = _mm256_moveldup_ps( _mm256_castpd_ps(
+                       _mm256_permute4x64_pd( center, 0xC6 ) ) );
+
+        _mm256_storeu_ps( p_dest, _mm256_add_ps( l_r,
+                              _mm256_mul_ps( k, _mm256_add_ps( c, ls_rs ) ) ) );
+    }
+
+    for( ; i > 0; i--, p_src += 6 )
+    {
+        *p_dest++ = p_src[0] + 0.7071f * (p_src[4] + p_src[2]);
+        *p_dest++ = p_src[1] + 0.7071f * (p_src[4] + p_src[3]);
+    }
+}
+
+__attribute__ ((__target__ ("avx2")))
+static void DoWork_7_1_to_2_0_avx2( filter_t * p_filter,  block_t * p_in_buf, block_t * p_out_buf ) {
+    VLC_UNUSED(p_filter);
+    float *p_dest = (float *)p_out_buf->p_buffer;
+    const float *p_src = (const float *)p_in_buf->p_buffer;
+    const __m256 k = _mm256_set1_ps( 0.7071f );
+    const __m256 quarter = _mm256_set1_ps( .25f );
+    int i = p_in_buf->i_nb_samples;
+
+    for( ; i >= 4; i -= 4, p_src += 32, p_dest += 8 )
+    {
+        /* One frame per vector, transposed as 64-bits pairs */
+        __m256d f0 = _mm256_loadu_pd( (const double *)p_src );
+        __m256d f1 = _mm256_loadu_pd( (const double *)(p_src + 8) );
+        __m256d f2 = _mm256_loadu_pd( (const double *)(p_src + 16) );
+        __m256d f3 = _mm256_loadu_pd( (const double *)(p_src + 24) );
+
+        __m256d t0 = _mm256_permute2f128_pd( f0, f2, 0x20 );
+        __m256d t1 = _mm256_permute2f128_pd( f1, f3, 0x20 );
+        __m256d t2 = _mm256_permute2f128_pd( f0, f2, 0x31 );
+        __m256d t3 = _mm256_permute2f128_pd( f1, f3, 0x31 );
+
+        /* Frames in the order 0, 1, 2, 3 after the unpacking */
+        __m256 l_r = _mm256_castpd_ps( _mm256_unpacklo_pd( t0, t1 ) );
+        __m256 p1 = _mm256_castpd_ps( _mm256_unpackhi_pd( t0, t1 ) );
+        __m256 p2 = _mm256_castpd_ps( _mm256_unpacklo_pd( t2, t3 ) );
+        __m256 ctr = _mm256_mul_ps( _mm256_moveldup_ps(
+                         _mm256_castpd_ps( _mm256_unpackhi_pd( t2, t3 ) ) ), k );
+
+        __m256 out = _mm256_add_ps( ctr, l_r );
+        out = _mm256_add_ps( out, _mm256_mul_ps( p1, quarter ) );
+        out = _mm256_add_ps( out, _mm256_mul_ps( p2, quarter ) );
+        _mm256_storeu_ps( p_dest, out );
+    }
+
+    for( ; i > 0; i--, p_src += 8 )
+    {
+        float ctr = p_src[6] * 0.7071f;
+        *p_dest++ = ctr + p_src[0] + p_src[2] / 4 + p_src[4] / 4;
+        *p_dest++ = ctr + p_src[1] + p_src[3] / 4 + p_src[5] / 4;
+    }
+}
+#endif
+
 #if defined (CAN_COMPILE_NEON)
 #include "simple_neon.h"
 #define GET_WORK(in, out) GET_WORK_##in##_to_##out##_neon()
@@ -346,6 +440,17 @@ static int OpenFilter( vlc_object_t *p_this )
     if( do_work == NULL )
         return VLC_EGENERIC;
 
+#if defined (SIMPLE_HAVE_AVX2)
+    if( vlc_CPU_AVX2() &&
+        ( p_filter->fmt_in.audio.i_physical_channels & AOUT_CHAN_LFE ) )
+    {
+        if( do_work == DoWork_5_x_to_2_0 )
+            do_work = DoWork_5_1_to_2_0_avx2;
+        else if( do_work == DoWork_7_x_to_2_0 )
+            do_work = DoWork_7_1_to_2_0_avx2;
+    }
+#endif
+
     p_filter->pf_audio_filter = Filter;
     p_filter->p_sys = (void *)do_work;
     return VLC_SUCCESS;
@@ -36,6 +36,7 @@
 
 #include <vlc_common.h>
 #include <vlc_plugin.h>
+#include <vlc_cpu.h>
 #include <vlc_aout.h>
 #include <vlc_block.h>
 #include <vlc_filter.h>
@@ -82,6 +83,58 @@ static int Open(vlc_object_t *object)
     return VLC_SUCCESS;
 }
 
+/*** Sample conversions shared with the SIMD versions ***/
+static inline float S16toFl32Sample(int16_t s)
+{
+#if 0
+    /* Slow version */
+    return (float)s / 32768.f;
+#else
+    /* This is Walken's trick based on IEEE float format. On my PIII
+     * this takes 16 seconds to perform one billion conversions, instead
+     * of 19 seconds for the above division. */
+    union { float f; int32_t i; } u;
+    u.i = s + 0x43c00000;
+    return u.f - 384.f;
+#endif
+}
+
+static inline int16_t Fl32toS16Sample(float f)
+{
+#if 0
+    /* Slow version. */
+    if (f >= 1.0) return 32767;
+    else if (f < -1.0) return -32768;
+    else return lroundf(f * 32768.f);
+#else
+    /* This is Walken's trick based on IEEE float format. */
+    union { float f; int32_t i; } u;
+    u.f = f + 384.f;
+    if (u.i > 0x43c07fff)
+        return 32767;
+    else if (u.i < 0x43bf8000)
+        return -32768;
+    else
+        return u.i - 0x43c00000;
+#endif
+}
+
+static inline int32_t Fl32toS32Sample(float f)
+{
+    float s = f * 2147483648.f;
+    if (s >= 2147483647.f)
+        return 2147483647;
+    else
+    if (s <= -2147483648.f)
+        return -2147483648;
+    else
+        return lroundf(s);
+}
+
+static inline float S32toFl32Sample(int32_t s)
+{
+    return (float)s / 2147483648.f;
+}
 
 /*** from U8 ***/
 static block_t *U8toS16(filter_t *filter, block_t *bsrc)
@@ -176,18 +229,7 @@ static block_t *S16toFl32(filter_t *filter, block_t *bsrc)
     int16_t *src = (int16_t *)bsrc->p_buffer;
     float   *dst = (float *)bdst->p_buffer;
     for (size_t i = bsrc->i_buffer / 2; i--;)
-#if 0
-        /* Slow version */
-        *dst++ = (float)*src++ / 32768.f;
-#else
-    {   /* This is Walken's trick based on IEEE float format. On my PIII
-         * this takes 16 seconds to perform one billion conversions, instead
-         * of 19 seconds for the above division. */
-        union { float f; int32_t i; } u;
-        u.i = *src++ + 0x43c00000;
-        *dst++ = u.f - 384.f;
-    }
-#endif
+        *dst++ = S16toFl32Sample(*src++);
 out:
     block_Release(bsrc);
     VLC_UNUSED(filter);
@@ -255,25 +297,8 @@ static block_t *Fl32toS16(filter_t *filter, block_t *b)
     VLC_UNUSED(filter);
     float   *src = (float *)b->p_buffer;
     int16_t *dst = (int16_t *)src;
-    for (int i = b->i_buffer / 4; i--;) {
-#if 0
-        /* Slow version. */
-        if (*src >= 1.0) *dst = 32767;
-        else if (*src < -1.0) *dst = -32768;
-        else *dst = lroundf(*src * 32768.f);
-        src++; dst++;
-#else
-        /* This is Walken's trick based on IEEE float format. */
-        union { float f; int32_t i; } u;
-        u.f = *src++ + 384.f;
-        if (u.i > 0x43c07fff)
-            *dst++ = 32767;
-        else if (u.i < 0x43bf8000)
-            *dst++ = -32768;
-        else
-            *dst++ = u.i - 0x43c00000;
-#endif
-    }
+    for (int i = b->i_buffer / 4; i--;)
+        *dst++ = Fl32toS16Sample(*src++);
     b->i_buffer /= 2;
     return b;
 }
@@ -283,16 +308,7 @@ static block_t *Fl32toS32(filter_t *filter, block_t *b)
     float   *src = (float *)b->p_buffer;
     int32_t *dst = (int32_t *)src;
     for (size_t i = b->i_buffer / 4; i--;)
-    {
-        float s = *(src++) * 2147483648.f;
-        if (s >= 2147483647.f)
-            *(dst++) = 2147483647;
-        else
-        if (s <= -2147483648.f)
-            *(dst++) = -2147483648;
-        else
-            *(dst++) = lroundf(s);
-    }
+        *(dst++) = Fl32toS32Sample(*(src++));
     VLC_UNUSED(filter);
     return b;
 }
@@ -346,7 +362,7 @@ static block_t *S32toFl32(filter_t *filter, block_t *b)
     int32_t *src = (int32_t*)b->p_buffer;
     float   *dst = (float *)src;
     for (int i = b->i_buffer / 4; i--;)
-        *dst++ = (float)(*src++) / 2147483648.f;
+        *dst++ = S32toFl32Sample(*src++);
     return b;
 }
 
@@ -439,13 +455,333 @@ static block_t *Fl64toS32(filter_t *filter, block_t *b)
 }
 
 
+/*** SIMD versions of the common conversions ***/
+/* They give the same results as the scalar conversions above, and convert
+ * the remaining samples with them. */
+#if (defined(__i386__) || defined(__x86_64__)) && \
+    (VLC_GCC_VERSION(4,9) || defined(__clang__))
+# include <immintrin.h>
+# define FORMAT_HAVE_X86
+
+__attribute__ ((__target__ ("sse2")))
+static block_t *S16toFl32SSE2(filter_t *filter, block_t *bsrc)
+{
+    block_t *bdst = block_Alloc(bsrc->i_buffer * 2);
+    if (unlikely(bdst == NULL))
+        goto out;
+
+    block_CopyProperties(bdst, bsrc);
+    const int16_t *src = (const int16_t *)bsrc->p_buffer;
+    float *dst = (float *)bdst->p_buffer;
+    size_t i = bsrc->i_buffer / 2;
+    const __m128 scale = _mm_set1_ps(1.f / 32768.f);
+
+    for (; i >= 8; i -= 8, src += 8, dst += 8)
+    {
+        __m128i s = _mm_loadu_si128((const __m128i *)src);
+        /* Sign extension to 32 bits */
+        __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16);
+        __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(s, s), 16);
+        _mm_storeu_ps(dst, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+        _mm_storeu_ps(dst + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+    }
+    for (; i > 0; i--)
+        *dst++ = S16toFl32Sample(*src++);
+out:
+    block_Release(bsrc);
+    VLC_UNUSED(filter);
+    return bdst;
+}
+
+/* The conversion is done in place: each store is below the next loads. */
+__attribute__ ((__target__ ("sse2")))
+static block_t *Fl32toS16SSE2(filter_t *filter, block_t *b)
+{
+    VLC_UNUSED(filter);
+    const float *src = (const float *)b->p_buffer;
+    int16_t *dst = (int16_t *)b->p_buffer;
+    size_t i = b->i_buffer / 4;
+    const __m128 scale = _mm_set1_ps(32768.f);
+    const __m128 min = _mm_set1_ps(-32768.f), max = _mm_set1_ps(32767.f);
+
+    for (; i >= 8; i -= 8, src += 8, dst += 8)
+    {
+        __m128 lo = _mm_mul_ps(_mm_loadu_ps(src), scale);
+        __m128 hi = _mm_mul_ps(_mm_loadu_ps(src + 4), scale);
+        lo = _mm_min_ps(_mm_max_ps(lo, min), max);
+        hi = _mm_min_ps(_mm_max_ps(hi, min), max);
+        _mm_storeu_si128((__m128i *)dst,
+                         _mm_packs_epi32(_mm_cvtps_epi32(lo),
+                                         _mm_cvtps_epi32(hi)));
+    }
+    for (; i > 0; i--)
+        *dst++ = Fl32toS16Sample(*src++);
+    b->i_buffer /= 2;
+    return b;
+}
+
+/* lroundf() rounds halves away from zero, unlike _mm_cvtps_epi32(). */
+__attribute__ ((__target__ ("sse2")))
+static inline __m128i Fl32toS32VecSSE2(__m128 f)
+{
+    const __m128 half = _mm_set1_ps(.5f), mhalf = _mm_set1_ps(-.5f);
+    __m128 s = _mm_mul_ps(f, _mm_set1_ps(2147483648.f));
+    __m128i t = _mm_cvttps_epi32(s);
+    __m128 d = _mm_sub_ps(s, _mm_cvtepi32_ps(t));
+
+    t = _mm_sub_epi32(t, _mm_castps_si128(_mm_cmpge_ps(d, half)));
+    t = _mm_add_epi32(t, _mm_castps_si128(_mm_cmple_ps(d, mhalf)));
+
+    __m128i over = _mm_castps_si128(_mm_cmpge_ps(s,
+                                        _mm_set1_ps(2147483647.f)));
+    __m128i under = _mm_castps_si128(_mm_cmple_ps(s,
+                                        _mm_set1_ps(-2147483648.f)));
+    t = _mm_andnot_si128(_mm_or_si128(over, under), t);
+    t = _mm_or_si128(t, _mm_and_si128(over, _mm_set1_epi32(INT32_MAX)));
+    return _mm_or_si128(t, _mm_and_si128(under, _mm_set1_epi32(INT32_MIN)));
+}
+
+__attribute__ ((__target__ ("sse2")))
+static block_t *Fl32toS32SSE2(filter_t *filter, block_t *b)
+{
+    VLC_UNUSED(filter);
+    const float *src = (const float *)b->p_buffer;
+    int32_t *dst = (int32_t *)b->p_buffer;
+    size_t i = b->i_buffer / 4;
+
+    for (; i >= 4; i -= 4, src += 4, dst += 4)
+        _mm_storeu_si128((__m128i *)dst, Fl32toS32VecSSE2(_mm_loadu_ps(src)));
+    for (; i > 0; i--)
+        *dst++ = Fl32toS32Sample(*src++);
+    return b;
+}
+
+__attribute__ ((__target__ ("sse2")))
+static block_t *S32toFl32SSE2(filter_t *filter, block_t *b)
+{
+    VLC_UNUSED(filter);
+    const int32_t *src = (const int32_t *)b->p_buffer;
+    float *dst = (float *)b->p_buffer;
+    size_t i = b->i_buffer / 4;
+    const __m128 scale = _mm_set1_ps(1.f / 2147483648.f);
+
+    for (; i >= 4; i -= 4, src += 4, dst += 4)
+    {
+        __m128i s = _mm_loadu_si128((const __m128i *)src);
+        _mm_storeu_ps(dst, _mm_mul_ps(_mm_cvtepi32_ps(s), scale));
+    }
+    for (; i > 0; i--)
+        *dst++ = S32toFl32Sample(*src++);
+    return b;
+}
+
+__attribute__ ((__target__ ("avx2")))
+static block_t *S16toFl32AVX2(filter_t *filter, block_t *bsrc)
+{
+    block_t *bdst = block_Alloc(bsrc->i_buffer * 2);
+    if (unlikely(bdst == NULL))
+        goto out;
+
+    block_CopyProperties(bdst, bsrc);
+    const int16_t *src = (const int16_t *)bsrc->p_buffer;
+    float *dst = (float *)bdst->p_buffer;
+    size_t i = bsrc->i_buffer / 2;
+    const __m256 scale = _mm256_set1_ps(1.f / 32768.f);
+
+    for (; i >= 16; i -= 16, src += 16, dst += 16)
+    {
+        __m256i lo = _mm256_cvtepi16_epi32(
+                         _mm_loadu_si128((const __m128i *)src));
+        __m256i hi = _mm256_cvtepi16_epi32(
+                         _mm_loadu_si128((const __m128i *)(src + 8)));
+        _mm256_storeu_ps(dst, _mm256_mul_ps(_mm256_cvtepi32_ps(lo), scale));
+        _mm256_storeu_ps(dst + 8,
+                         _mm256_mul_ps(_mm256_cvtepi32_ps(hi), scale));
+    }
+    for (; i > 0; i--)
+        *dst++ = S16toFl32Sample(*src++);
+out:
+    block_Release(bsrc);
+    VLC_UNUSED(filter);
+    return bdst;
+}
+
+__attribute__ ((__target__ ("avx2")))
+static block_t *Fl32toS16AVX2(filter_t *filter, block_t *b)
+{
+    VLC_UNUSED(filter);
+    const float *src = (const float *)b->p_buffer;
+    int16_t *dst = (int16_t *)b->p_buffer;
+    size_t i = b->i_buffer / 4;
+    const __m256 scale = _mm256_set1_ps(32768.f);
+    const __m256 min = _mm256_set1_ps(-32768.f);
+    const __m256 max = _mm256_set1_ps(32767.f);
+
+    for (; i >= 16; i -= 16, src += 16, dst += 16)
+    {
+        __m256 lo = _mm256_mul_ps(_mm256_loadu_ps(src), scale);
+        __m256 hi = _mm256_mul_ps(_mm256_loadu_ps(src + 8), scale);
+        lo = _mm256_min_ps(_mm256_max_ps(lo, min), max);
+        hi = _mm256_min_ps(_mm256_max_ps(hi, min), max);
+        /* The packing works on each 128-bits lane: restore the order */
+        __m256i s = _mm256_packs_epi32(_mm256_cvtps_epi32(lo),
+                                       _mm256_cvtps_epi32(hi));
+        _mm256_storeu_si256((__m256i *)dst,
+                            _mm256_permute4x64_epi64(s, 0xD8));
+    }
+    for (; i > 0; i--)
+        *dst++ = Fl32toS16Sample(*src++);
+    b->i_buffer /= 2;
+    return b;
+}
+
+__attribute__ ((__target__ ("avx2")))
+static block_t *Fl32toS32AVX2(filter_t *filter, block_t *b)
+{
+    VLC_UNUSED(filter);
+    const float *src = (const float *)b->p_buffer;
+    int32_t *dst = (int32_t *)b->p_buffer;
+    size_t i = b->i_buffer / 4;
+    const __m256 half = _mm256_set1_ps(.5f), mhalf = _mm256_set1_ps(-.5f);
+    const __m256 scale = _mm256_set1_ps(2147483648.f);
+    const __m256 max = _mm256_set1_ps(2147483647.f);
+    const __m256 min = _mm256_set1_ps(-2147483648.f);
+
+    for (; i >= 8; i -= 8, src += 8, dst += 8)
+    {
+        __m256 s = _mm256_mul_ps(_mm256_loadu_ps(src), scale);
+        __m256i t = _mm256_cvttps_epi32(s);
+        __m256 d = _mm256_sub_ps(s, _mm256_cvtepi32_ps(t));
+
+        /* Round halves away from zero as lroundf() */
+        t = _mm256_sub_epi32(t, _mm256_castps_si256(
+                                    _mm256_cmp_ps(d, half, _CMP_GE_OQ)));
+        t = _mm256_add_epi32(t, _mm256_castps_si256(
+                                    _mm256_cmp_ps(d, mhalf, _CMP_LE_OQ)));
+
+        __m256 over = _mm256_cmp_ps(s, max, _CMP_GE_OQ);
+        __m256 under = _mm256_cmp_ps(s, min, _CMP_LE_OQ);
+        __m256 r = _mm256_blendv_ps(_mm256_castsi256_ps(t),
+                       _mm256_castsi256_ps(_mm256_set1_epi32(INT32_MAX)), over);
+        r = _mm256_blendv_ps(r,
+                _mm256_castsi256_ps(_mm256_set1_epi32(INT32_MIN)), under);
+        _mm256_storeu_ps((float *)dst, r);
+    }
+    for (; i > 0; i--)
+        *dst++ = Fl32toS32Sample(*src++);
+    return b;
+}
+
+__attribute__ ((__target__ ("avx2")))
+static block_t *S32toFl32AVX2(filter_t *filter, block_t *b)
+{
+    VLC_UNUSED(filter);
+    const int32_t *src = (const int32_t *)b->p_buffer;
+    float *dst = (float *)b->p_buffer;
+    size_t i = b->i_buffer / 4;
+    const __m256 scale = _mm256_set1_ps(1.f / 2147483648.f);
+
+    for (; i >= 8; i -= 8, src += 8, dst += 8)
+    {
+        __m256i s = _mm256_loadu_si256((const __m256i *)src);
+        _mm256_storeu_ps(dst, _mm256_mul_ps(_mm256_cvtepi32_ps(s), scale));
+    }
+    for (; i > 0; i--)
+        *dst++ = S32toFl32Sample(*src++);
+    return b;
+}
+
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+# include <arm_neon.h>
+# define FORMAT_HAVE_NEON
+
+static block_t *S16toFl32NEON(filter_t *filter, block_t *bsrc)
+{
+    block_t *bdst = block_Alloc(bsrc->i_buffer * 2);
+    if (unlikely(bdst == NULL))
+        goto out;
+
+    block_CopyProperties(bdst, bsrc);
+    const int16_t *src = (const int16_t *)bsrc->p_buffer;
+    float *dst = (float *)bdst->p_buffer;
+    size_t i = bsrc->i_buffer / 2;
+
+    for (; i >= 8; i -= 8, src += 8, dst += 8)
+    {
+        int16x8_t s = vld1q_s16(src);
+        vst1q_f32(dst, vcvtq_n_f32_s32(vmovl_s16(vget_low_s16(s)), 15));
+        vst1q_f32(dst + 4, vcvtq_n_f32_s32(vmovl_s16(vget_high_s16(s)), 15));
+    }
+    for (; i > 0; i--)
+        *dst++ = S16toFl32Sample(*src++);
+out:
+    block_Release(bsrc);
+    VLC_UNUSED(filter);
+    return bdst;
+}
+
+static block_t *S32toFl32NEON(filter_t *filter, block_t *b)
+{
+    VLC_UNUSED(filter);
+    const int32_t *src = (const int32_t *)b->p_buffer;
+    float *dst = (float *)b->p_buffer;
+    size_t i = b->i_buffer / 4;
+
+    for (; i >= 4; i -= 4, src += 4, dst += 4)
+        vst1q_f32(dst, vcvtq_n_f32_s32(vld1q_s32(src), 31));
+    for (; i > 0; i--)
+        *dst++ = S32toFl32Sample(*src++);
+    return b;
+}
+
+# ifdef __aarch64__
+/* The conversions to integers saturate, as the scalar versions */
+static block_t *Fl32toS16NEON(filter_t *filter, block_t *b)
+{
+    VLC_UNUSED(filter);
+    const float *src = (const float *)b->p_buffer;
+    int16_t *dst = (int16_t *)b->p_buffer;
+    size_t i = b->i_buffer / 4;
+
+    for (; i >= 8; i -= 8, src += 8, dst += 8)
+    {
+        int32x4_t lo = vcvtnq_s32_f32(vmulq_n_f32(vld1q_f32(src), 32768.f));
+        int32x4_t hi = vcvtnq_s32_f32(vmulq_n_f32(vld1q_f32(src + 4),
+                                                  32768.f));
+        vst1q_s16(dst, vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi)));
+    }
+    for (; i > 0; i--)
+        *dst++ = Fl32toS16Sample(*src++);
+    b->i_buffer /= 2;
+    return b;
+}
+
+static block_t *Fl32toS32NEON(filter_t *filter, block_t *b)
+{
+    VLC_UNUSED(filter);
+    const float *src = (const float *)b->p_buffer;
+    int32_t *dst = (int32_t *)b->p_buffer;
+    size_t i = b->i_buffer / 4;
+
+    /* Rounds halves away from zero as lroundf() */
+    for (; i >= 4; i -= 4, src += 4, dst += 4)
+        vst1q_s32(dst, vcvtaq_s32_f32(vmulq_n_f32(vld1q_f32(src),
+                                                  2147483648.f)));
+    for (; i > 0; i--)
+        *dst++ = Fl32toS32Sample(*src++);
+    return b;
+}
+# endif
+#endif
+
 /* */
-/* */
-static const struct {
+struct cvt_direct {
     vlc_fourcc_t src;
     vlc_fourcc_t dst;
     cvt_t convert;
-} cvt_directs[] = {
+};
+
+static const struct cvt_direct cvt_directs[] = {
     { VLC_CODEC_U8,   VLC_CODEC_S16N, U8toS16    },
     { VLC_CODEC_U8,   VLC_CODEC_FL32, U8toFl32   },
     { VLC_CODEC_U8,   VLC_CODEC_S32N, U8toS32    },
@@ -474,8 +810,55 @@ static const struct {
     { 0, 0, NULL }
 };
 
+#if defined(FORMAT_HAVE_X86)
+static const struct cvt_direct cvt_sse2[] = {
+    { VLC_CODEC_S16N, VLC_CODEC_FL32, S16toFl32SSE2 },
+    { VLC_CODEC_FL32, VLC_CODEC_S16N, Fl32toS16SSE2 },
+    { VLC_CODEC_FL32, VLC_CODEC_S32N, Fl32toS32SSE2 },
+    { VLC_CODEC_S32N, VLC_CODEC_FL32, S32toFl32SSE2 },
+
+    { 0, 0, NULL }
+};
+
+static const struct cvt_direct cvt_avx2[] = {
+    { VLC_CODEC_S16N, VLC_CODEC_FL32, S16toFl32AVX2 },
+    { VLC_CODEC_FL32, VLC_CODEC_S16N, Fl32toS16AVX2 },
+    { VLC_CODEC_FL32, VLC_CODEC_S32N, Fl32toS32AVX2 },
+    { VLC_CODEC_S32N, VLC_CODEC_FL32, S32toFl32AVX2 },
+
+    { 0, 0, NULL }
+};
+#elif defined(FORMAT_HAVE_NEON)
+static const struct cvt_direct cvt_neon[] = {
+    { VLC_CODEC_S16N, VLC_CODEC_FL32, S16toFl32NEON },
+    { VLC_CODEC_S32N, VLC_CODEC_FL32, S32toFl32NEON },
+# ifdef __aarch64__
+    { VLC_CODEC_FL32, VLC_CODEC_S16N, Fl32toS16NEON },
+    { VLC_CODEC_FL32, VLC_CODEC_S32N, Fl32toS32NEON },
+# endif
+
+    { 0, 0, NULL }
+};
+#endif
+
 static cvt_t FindConversion(vlc_fourcc_t src, vlc_fourcc_t dst)
 {
+    const struct cvt_direct *simd = NULL;
+
+#if defined(FORMAT_HAVE_X86)
+    if (vlc_CPU_AVX2())
+        simd = cvt_avx2;
+    else if (vlc_CPU_SSE2())
+        simd = cvt_sse2;
+#elif defined(FORMAT_HAVE_NEON)
+    simd = cvt_neon;
+#endif
+    for (int i = 0; simd != NULL && simd[i].convert; i++) {
+        if (simd[i].src == src &&
+            simd[i].dst == dst)
+            return simd[i].convert;
+    }
+
     for (int i = 0; cvt_directs[i].convert; i++) {
         if (cvt_directs[i].src == src &&
             cvt_directs[i].dst == dst)
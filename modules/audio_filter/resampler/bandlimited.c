@@ -39,6 +39,7 @@
 
 #include <vlc_common.h>
 #include <vlc_plugin.h>
+#include <vlc_cpu.h>
 #include <vlc_aout.h>
 #include <vlc_filter.h>
 #include <vlc_block.h>
@@ -63,9 +64,34 @@ static void ResampleFloat( filter_t *p_filter,
                            double d_factor, bool b_factor_old,
                            int i_nb_channels, int i_bytes_per_frame );
 
+typedef struct polyphase_t polyphase_t;
+static polyphase_t *PolyphaseNew( unsigned i_in_rate, unsigned i_out_rate,
+                                  unsigned i_nb_channels );
+static void PolyphaseDelete( polyphase_t * );
+
 /*****************************************************************************
  * Local structures
  *****************************************************************************/
+/* Precomputed coefficients for a fixed ratio: one set of taps per phase,
+ * i.e. per value of the remainder */
+struct polyphase_t
+{
+    unsigned i_in_rate;
+    unsigned i_out_rate;
+    unsigned i_gcd;            /* the remainder is always a multiple of it */
+    unsigned i_phases;
+    unsigned i_stride;         /* coefficients per phase */
+    unsigned i_expand;         /* channels each coefficient is repeated for */
+    bool     b_up;             /* same FilterFloatUP/UD choice as d_factor */
+
+    int     *pi_start;         /* first input frame, relative to p_in */
+    unsigned *pi_taps;
+    float   *p_coeffs;
+
+    void (*pf_filter)( const polyphase_t *, const float *p_in, float *p_out,
+                       unsigned i_phase, unsigned i_nb_channels );
+};
+
 struct filter_sys_t
 {
     int32_t *p_buf;                        /* this filter introduces a delay */
@@ -78,8 +104,18 @@ struct filter_sys_t
     bool b_first;
 
     date_t end_date;
+
+    bool b_polyphase;
+    polyphase_t *p_poly;
 };
 
+#define POLYPHASE_MAX_PHASES 1024
+
+#define POLYPHASE_TEXT N_("Polyphase resampling")
+#define POLYPHASE_LONGTEXT N_( \
+    "Use precomputed filter phases for the fixed ratios between the common " \
+    "sample rates, instead of interpolating the filter for each sample.")
+
 /*****************************************************************************
  * Module descriptor
  *****************************************************************************/
@@ -89,6 +125,8 @@ vlc_module_begin ()
     set_description( N_("Audio filter for band-limited interpolation resampling") )
     set_capability( "audio converter", 20 )
     set_callbacks( OpenFilter, CloseFilter )
+    add_bool( "bandlimited-polyphase", true, POLYPHASE_TEXT,
+              POLYPHASE_LONGTEXT, true )
 
     add_submodule()
     set_capability( "audio resampler", 20 )
@@ -199,6 +237,18 @@ static block_t *Resample( filter_t * p_filter, block_t * p_in_buf )
     /* Make sure the output buffer is reset */
     memset( p_out_buf->p_buffer, 0, p_out_buf->i_buffer );
 
+    /* Use the polyphase table if the current ratio allows it. The sample
+     * rate can change at any time with the "audio resampler" capability. */
+    if( p_sys->b_polyphase &&
+        ( p_sys->p_poly == NULL ||
+          p_sys->p_poly->i_in_rate != p_filter->fmt_in.audio.i_rate ||
+          p_sys->p_poly->i_out_rate != i_out_rate ) )
+    {
+        PolyphaseDelete( p_sys->p_poly );
+        p_sys->p_poly = PolyphaseNew( p_filter->fmt_in.audio.i_rate,
+                                      i_out_rate, i_nb_channels );
+    }
+
     /* Calculate the new length of the filter wing */
     d_factor = (double)i_out_rate / p_filter->fmt_in.audio.i_rate;
     i_filter_wing = ((SMALL_FILTER_NMULT+1)/2.0) * __MAX(1.0,1.0/d_factor) + 1;
@@ -307,6 +357,8 @@ static int OpenFilter( vlc_object_t *p_this )
 
     p_sys->i_old_wing = 0;
     p_sys->b_first = true;
+    p_sys->b_polyphase = var_InheritBool( p_filter, "bandlimited-polyphase" );
+    p_sys->p_poly = NULL;
     p_filter->pf_audio_filter = Resample;
 
     msg_Dbg( p_this, "%4.4s/%iKHz/%i->%4.4s/%iKHz/%i",
@@ -329,6 +381,7 @@ static int OpenFilter( vlc_object_t *p_this )
 static void CloseFilter( vlc_object_t *p_this )
 {
     filter_t *p_filter = (filter_t *)p_this;
+    PolyphaseDelete( p_filter->p_sys->p_poly );
     free( p_filter->p_sys->p_buf );
     free( p_filter->p_sys );
 }
@@ -432,6 +485,323 @@ static void FilterFloatUD( const float Imp[], const float ImpD[], uint16_t Nwing
     }
 }
 
+/*****************************************************************************
+ * Polyphase resampling: the coefficients computed by FilterFloatUP() and
+ * FilterFloatUD() only depend on the remainder, which takes a limited number
+ * of values for a fixed ratio. They are computed once per remainder.
+ *****************************************************************************/
+
+/* Same coefficients as FilterFloatUP(), returns their number */
+static unsigned CoeffsFloatUP( const float Imp[], const float ImpD[],
+                               uint16_t Nwing, float *p_coeffs,
+                               uint32_t ui_remainder,
+                               uint32_t ui_output_rate, int16_t Inc )
+{
+    unsigned i_pos = (ui_remainder<<Nhc)/ui_output_rate;
+    unsigned i_end = Nwing;
+    unsigned i_taps = 0;
+    uint32_t ui_linear_remainder = (ui_remainder<<Nhc) -
+                            (ui_remainder<<Nhc)/ui_output_rate*ui_output_rate;
+
+    if (Inc == 1)
+    {
+        i_end--;
+        if (ui_remainder == 0)
+            i_pos += Npc;
+    }
+
+    for( ; i_pos < i_end; i_pos += Npc )
+    {
+        float t = Imp[i_pos];
+        t += ImpD[i_pos] * ui_linear_remainder / ui_output_rate / Npc;
+        p_coeffs[i_taps++] = t;
+    }
+    return i_taps;
+}
+
+/* Same coefficients as FilterFloatUD(), returns their number */
+static unsigned CoeffsFloatUD( const float Imp[], const float ImpD[],
+                               uint16_t Nwing, float *p_coeffs,
+                               uint32_t ui_remainder,
+                               uint32_t ui_output_rate, uint32_t ui_input_rate,
+                               int16_t Inc )
+{
+    unsigned i_pos = (ui_remainder<<Nhc) / ui_input_rate;
+    unsigned i_end = Nwing;
+    unsigned i_taps = 0;
+    int ui_counter = 0;
+
+    if (Inc == 1)
+    {
+        i_end--;
+        if (ui_remainder == 0)
+        {
+            i_pos = (ui_output_rate << Nhc) / ui_input_rate;
+            ui_counter++;
+        }
+    }
+
+    while( i_pos < i_end )
+    {
+        uint32_t ui_linear_remainder =
+          ((ui_output_rate * ui_counter + ui_remainder)<< Nhc) -
+          ((ui_output_rate * ui_counter + ui_remainder)<< Nhc) /
+          ui_input_rate * ui_input_rate;
+        float t = Imp[i_pos];
+        t += ImpD[i_pos] * ui_linear_remainder / ui_input_rate / Npc;
+        p_coeffs[i_taps++] = t;
+
+        ui_counter++;
+        i_pos = ((ui_output_rate * ui_counter + ui_remainder)<< Nhc)
+                / ui_input_rate;
+    }
+    return i_taps;
+}
+
+static void PolyphaseFilterC( const polyphase_t *p_poly, const float *p_in,
+                              float *p_out, unsigned i_phase,
+                              unsigned i_nb_channels )
+{
+    const float *p_coeffs = p_poly->p_coeffs + i_phase * p_poly->i_stride;
+    unsigned i_taps = p_poly->pi_taps[i_phase];
+
+    p_in += p_poly->pi_start[i_phase] * (int)i_nb_channels;
+    if( i_nb_channels > AOUT_CHAN_MAX )
+    {
+        for( unsigned i = 0; i < i_nb_channels; i++ )
+        {
+            float f_out = 0.f;
+
+            for( unsigned j = 0; j < i_taps; j++ )
+                f_out += p_coeffs[j] * p_in[j * i_nb_channels + i];
+            p_out[i] = f_out;
+        }
+        return;
+    }
+
+    /* Walk the input frames in order, one accumulator per channel */
+    float f_out[AOUT_CHAN_MAX] = { 0.f };
+
+    for( unsigned j = 0; j < i_taps; j++, p_in += i_nb_channels )
+        for( unsigned i = 0; i < i_nb_channels; i++ )
+            f_out[i] += p_coeffs[j] * p_in[i];
+    memcpy( p_out, f_out, i_nb_channels * sizeof( float ) );
+}
+
+/* The vector versions work on coefficients repeated for each channel, so
+ * that each lane of the accumulator always sums the same channel. */
+static void PolyphaseReduce( float *p_out, float *p_lanes, unsigned i_lanes,
+                             unsigned i_nb_channels )
+{
+    for( unsigned i = 0; i < i_nb_channels; i++ )
+    {
+        float f_out = 0.f;
+
+        for( unsigned j = i; j < i_lanes; j += i_nb_channels )
+            f_out += p_lanes[j];
+        p_out[i] = f_out;
+    }
+}
+
+#if (defined(__i386__) || defined(__x86_64__)) && \
+    (VLC_GCC_VERSION(4,9) || defined(__clang__))
+# include <immintrin.h>
+# define POLYPHASE_HAVE_X86
+
+__attribute__ ((__target__ ("sse2")))
+static void PolyphaseFilterSSE2( const polyphase_t *p_poly, const float *p_in,
+                                 float *p_out, unsigned i_phase,
+                                 unsigned i_nb_channels )
+{
+    const float *p_coeffs = p_poly->p_coeffs + i_phase * p_poly->i_stride;
+    unsigned i_count = p_poly->pi_taps[i_phase] * i_nb_channels;
+    unsigned i = 0;
+    __m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps();
+    float lanes[4];
+
+    p_in += p_poly->pi_start[i_phase] * (int)i_nb_channels;
+    for( ; i + 8 <= i_count; i += 8 )
+    {
+        acc0 = _mm_add_ps( acc0, _mm_mul_ps( _mm_loadu_ps( p_coeffs + i ),
+                                             _mm_loadu_ps( p_in + i ) ) );
+        acc1 = _mm_add_ps( acc1, _mm_mul_ps( _mm_loadu_ps( p_coeffs + i + 4 ),
+                                             _mm_loadu_ps( p_in + i + 4 ) ) );
+    }
+    _mm_storeu_ps( lanes, _mm_add_ps( acc0, acc1 ) );
+    for( ; i < i_count; i++ )
+        lanes[i & 3] += p_coeffs[i] * p_in[i];
+
+    PolyphaseReduce( p_out, lanes, 4, i_nb_channels );
+}
+
+__attribute__ ((__target__ ("avx2")))
+static void PolyphaseFilterAVX2( const polyphase_t *p_poly, const float *p_in,
+                                 float *p_out, unsigned i_phase,
+                                 unsigned i_nb_channels )
+{
+    const float *p_coeffs = p_poly->p_coeffs + i_phase * p_poly->i_stride;
+    unsigned i_count = p_poly->pi_taps[i_phase] * i_nb_channels;
+    unsigned i = 0;
+    __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+    float lanes[8];
+
+    p_in += p_poly->pi_start[i_phase] * (int)i_nb_channels;
+    for( ; i + 16 <= i_count; i += 16 )
+    {
+        acc0 = _mm256_add_ps( acc0,
+                              _mm256_mul_ps( _mm256_loadu_ps( p_coeffs + i ),
+                                             _mm256_loadu_ps( p_in + i ) ) );
+        acc1 = _mm256_add_ps( acc1,
+                              _mm256_mul_ps( _mm256_loadu_ps( p_coeffs + i + 8 ),
+                                             _mm256_loadu_ps( p_in + i + 8 ) ) );
+    }
+    if( i + 8 <= i_count )
+    {
+        acc0 = _mm256_add_ps( acc0,
+                              _mm256_mul_ps( _mm256_loadu_ps( p_coeffs + i ),
+                                             _mm256_loadu_ps( p_in + i ) ) );
+        i += 8;
+    }
+    _mm256_storeu_ps( lanes, _mm256_add_ps( acc0, acc1 ) );
+    for( ; i < i_count; i++ )
+        lanes[i & 7] += p_coeffs[i] * p_in[i];
+
+    PolyphaseReduce( p_out, lanes, 8, i_nb_channels );
+}
+#endif
+
+static unsigned gcd( unsigned a, unsigned b )
+{
+    while( b )
+    {
+        unsigned c = a % b;
+        a = b;
+        b = c;
+    }
+    return a;
+}
+
+/*****************************************************************************
+ * PolyphaseNew: computes the table of a ratio, if it has few enough phases
+ *****************************************************************************/
+static polyphase_t *PolyphaseNew( unsigned i_in_rate, unsigned i_out_rate,
+                                  unsigned i_nb_channels )
+{
+    unsigned i_gcd = gcd( i_in_rate, i_out_rate );
+    if( i_gcd == 0 || i_out_rate / i_gcd > POLYPHASE_MAX_PHASES
+     || i_in_rate > 16 * i_out_rate )
+        return NULL;
+
+    polyphase_t *p_poly = malloc( sizeof( *p_poly ) );
+    float *p_left = malloc( 2 * SMALL_FILTER_NWING * sizeof( float ) );
+    if( unlikely(p_poly == NULL || p_left == NULL) )
+    {
+        free( p_left );
+        free( p_poly );
+        return NULL;
+    }
+    float *p_right = p_left + SMALL_FILTER_NWING;
+
+    p_poly->i_in_rate = i_in_rate;
+    p_poly->i_out_rate = i_out_rate;
+    p_poly->i_gcd = i_gcd;
+    p_poly->i_phases = i_out_rate / i_gcd;
+    p_poly->b_up = i_out_rate >= i_in_rate;
+    p_poly->i_expand = 1;
+    p_poly->pf_filter = PolyphaseFilterC;
+#if defined(POLYPHASE_HAVE_X86)
+    if( vlc_CPU_AVX2() && 8 % i_nb_channels == 0 )
+    {
+        p_poly->i_expand = i_nb_channels;
+        p_poly->pf_filter = PolyphaseFilterAVX2;
+    }
+    else if( vlc_CPU_SSE2() && 4 % i_nb_channels == 0 )
+    {
+        p_poly->i_expand = i_nb_channels;
+        p_poly->pf_filter = PolyphaseFilterSSE2;
+    }
+#endif
+
+    /* The longest phase gives the size of the table */
+    unsigned i_max_taps = p_poly->b_up
+        ? 2 * ( SMALL_FILTER_NWING / Npc + 1 )
+        : 2 * ( SMALL_FILTER_NWING * i_in_rate / ( i_out_rate << Nhc ) + 2 );
+    p_poly->i_stride = ( i_max_taps * p_poly->i_expand + 7 ) & ~7u;
+    p_poly->pi_start = malloc( p_poly->i_phases * sizeof( int ) );
+    p_poly->pi_taps = malloc( p_poly->i_phases * sizeof( unsigned ) );
+    p_poly->p_coeffs = calloc( p_poly->i_phases,
+                               p_poly->i_stride * sizeof( float ) );
+    if( unlikely(p_poly->pi_start == NULL || p_poly->pi_taps == NULL ||
+                 p_poly->p_coeffs == NULL) )
+        goto error;
+
+    for( unsigned i = 0; i < p_poly->i_phases; i++ )
+    {
+        uint32_t ui_remainder = i * i_gcd;
+        unsigned i_left, i_right;
+
+        /* Same wings as ResampleFloat() */
+        if( p_poly->b_up )
+        {
+            i_left = CoeffsFloatUP( SMALL_FILTER_FLOAT_IMP,
+                                    SMALL_FILTER_FLOAT_IMPD,
+                                    SMALL_FILTER_NWING, p_left,
+                                    ui_remainder, i_out_rate, -1 );
+            i_right = CoeffsFloatUP( SMALL_FILTER_FLOAT_IMP,
+                                     SMALL_FILTER_FLOAT_IMPD,
+                                     SMALL_FILTER_NWING, p_right,
+                                     i_out_rate - ui_remainder,
+                                     i_out_rate, 1 );
+        }
+        else
+        {
+            i_left = CoeffsFloatUD( SMALL_FILTER_FLOAT_IMP,
+                                    SMALL_FILTER_FLOAT_IMPD,
+                                    SMALL_FILTER_NWING, p_left,
+                                    ui_remainder, i_out_rate, i_in_rate,
+                                    -1 );
+            i_right = CoeffsFloatUD( SMALL_FILTER_FLOAT_IMP,
+                                     SMALL_FILTER_FLOAT_IMPD,
+                                     SMALL_FILTER_NWING, p_right,
+                                     i_out_rate - ui_remainder,
+                                     i_out_rate, i_in_rate, 1 );
+        }
+        if( unlikely(i_left + i_right > i_max_taps) )
+            goto error;
+
+        /* The left wing goes backwards from p_in, the right wing forward
+         * from the next frame: store them as one run of input frames */
+        float *p_coeffs = p_poly->p_coeffs + i * p_poly->i_stride;
+
+        p_poly->pi_start[i] = i_left > 0 ? 1 - (int)i_left : 1;
+        p_poly->pi_taps[i] = i_left + i_right;
+        for( unsigned j = i_left; j-- > 0; )
+            for( unsigned k = 0; k < p_poly->i_expand; k++ )
+                *p_coeffs++ = p_left[j];
+        for( unsigned j = 0; j < i_right; j++ )
+            for( unsigned k = 0; k < p_poly->i_expand; k++ )
+                *p_coeffs++ = p_right[j];
+    }
+
+    free( p_left );
+    return p_poly;
+
+error:
+    free( p_left );
+    PolyphaseDelete( p_poly );
+    return NULL;
+}
+
+static void PolyphaseDelete( polyphase_t *p_poly )
+{
+    if( p_poly == NULL )
+        return;
+    free( p_poly->p_coeffs );
+    free( p_poly->pi_taps );
+    free( p_poly->pi_start );
+    free( p_poly );
+}
+
 static int ReallocBuffer( block_t **pp_out_buf,
                           float **pp_out, size_t i_out,
                           int i_nb_channels, int i_bytes_per_frame )
@@ -460,6 +830,10 @@ static void ResampleFloat( filter_t *p_filter,
                            int i_nb_channels, int i_bytes_per_frame )
 {
     filter_sys_t *p_sys = p_filter->p_sys;
+    const polyphase_t *p_poly = p_sys->p_poly;
+
+    if( p_poly != NULL && p_poly->b_up != ( d_factor >= 1 ) )
+        p_poly = NULL;
 
     float *p_in = *pp_in;
     size_t i_out = *pi_out;
@@ -486,7 +860,13 @@ static void ResampleFloat( filter_t *p_filter,
                                i_out, i_nb_channels, i_bytes_per_frame ) )
                 return;
 
-            if( d_factor >= 1 )
+            if( p_poly != NULL && p_sys->i_remainder % p_poly->i_gcd == 0 )
+            {
+                p_poly->pf_filter( p_poly, p_in, p_out,
+                                   p_sys->i_remainder / p_poly->i_gcd,
+                                   i_nb_channels );
+            }
+            else if( d_factor >= 1 )
             {
                 /* FilterFloatUP() is faster if we can use it */
 
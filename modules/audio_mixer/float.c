@@ -32,6 +32,7 @@
 #include <stddef.h>
 #include <vlc_common.h>
 #include <vlc_plugin.h>
+#include <vlc_cpu.h>
 #include <vlc_aout.h>
 #include <vlc_aout_volume.h>
 
@@ -81,6 +82,193 @@ static void FilterFL64( audio_volume_t *p_volume, block_t *p_buffer,
     (void) p_volume;
 }
 
+/**
+ * Returns the number of interleaved channels of a buffer, or 0 if the buffer
+ * does not hold a whole number of sample frames.
+ */
+static unsigned BufferChannels( const block_t *p_buffer, size_t i_size )
+{
+    size_t i_samples = p_buffer->i_buffer / i_size;
+
+    if( p_buffer->i_nb_samples == 0
+     || i_samples % p_buffer->i_nb_samples != 0 )
+        return 0;
+    return i_samples / p_buffer->i_nb_samples;
+}
+
+/**
+ * Applies a linear gain ramp, one gain per sample frame, from f_from
+ * (excluded) to f_to (reached on the last frame).
+ */
+static void FilterRampFL32( audio_volume_t *p_volume, block_t *p_buffer,
+                            float f_from, float f_to )
+{
+    unsigned i_channels = BufferChannels( p_buffer, sizeof (float) );
+    if( i_channels == 0 )
+    {
+        p_volume->amplify( p_volume, p_buffer, f_to );
+        return;
+    }
+
+    float *p = (float *)p_buffer->p_buffer;
+    float f_step = (f_to - f_from) / p_buffer->i_nb_samples;
+
+    for( unsigned i = 0; i < p_buffer->i_nb_samples; i++ )
+    {
+        float f_gain = f_from + f_step * (float)(i + 1);
+
+        for( unsigned j = 0; j < i_channels; j++ )
+            *(p++) *= f_gain;
+    }
+}
+
+static void FilterRampFL64( audio_volume_t *p_volume, block_t *p_buffer,
+                            float f_from, float f_to )
+{
+    unsigned i_channels = BufferChannels( p_buffer, sizeof (double) );
+    if( i_channels == 0 )
+    {
+        p_volume->amplify( p_volume, p_buffer, f_to );
+        return;
+    }
+
+    double *p = (double *)p_buffer->p_buffer;
+    double step = ((double)f_to - f_from) / p_buffer->i_nb_samples;
+
+    for( unsigned i = 0; i < p_buffer->i_nb_samples; i++ )
+    {
+        double gain = f_from + step * (i + 1);
+
+        for( unsigned j = 0; j < i_channels; j++ )
+            *(p++) *= gain;
+    }
+}
+
+#if (defined(__i386__) || defined(__x86_64__)) && \
+    (VLC_GCC_VERSION(4,9) || defined(__clang__))
+# include <immintrin.h>
+# define FLOAT_HAVE_AVX2
+
+__attribute__ ((__target__ ("avx2")))
+static void FilterFL32AVX2( audio_volume_t *p_volume, block_t *p_buffer,
+                            float f_multiplier )
+{
+    if( f_multiplier == 1.f )
+        return; /* nothing to do */
+
+    float *p = (float *)p_buffer->p_buffer;
+    size_t i_count = p_buffer->i_buffer / sizeof(*p);
+    const __m256 mult = _mm256_set1_ps( f_multiplier );
+
+    for( ; i_count >= 32; i_count -= 32, p += 32 )
+    {
+        __m256 a = _mm256_loadu_ps( p );
+        __m256 b = _mm256_loadu_ps( p + 8 );
+        __m256 c = _mm256_loadu_ps( p + 16 );
+        __m256 d = _mm256_loadu_ps( p + 24 );
+        _mm256_storeu_ps( p,      _mm256_mul_ps( a, mult ) );
+        _mm256_storeu_ps( p + 8,  _mm256_mul_ps( b, mult ) );
+        _mm256_storeu_ps( p + 16, _mm256_mul_ps( c, mult ) );
+        _mm256_storeu_ps( p + 24, _mm256_mul_ps( d, mult ) );
+    }
+    for( ; i_count >= 8; i_count -= 8, p += 8 )
+        _mm256_storeu_ps( p, _mm256_mul_ps( _mm256_loadu_ps( p ), mult ) );
+    for( ; i_count > 0; i_count-- )
+        *(p++) *= f_multiplier;
+
+    (void) p_volume;
+}
+
+__attribute__ ((__target__ ("avx2")))
+static void FilterFL64AVX2( audio_volume_t *p_volume, block_t *p_buffer,
+                            float f_multiplier )
+{
+    double *p = (double *)p_buffer->p_buffer;
+    double mult = f_multiplier;
+    if( mult == 1. )
+        return; /* nothing to do */
+
+    size_t i_count = p_buffer->i_buffer / sizeof(*p);
+    const __m256d vmult = _mm256_set1_pd( mult );
+
+    for( ; i_count >= 16; i_count -= 16, p += 16 )
+    {
+        __m256d a = _mm256_loadu_pd( p );
+        __m256d b = _mm256_loadu_pd( p + 4 );
+        __m256d c = _mm256_loadu_pd( p + 8 );
+        __m256d d = _mm256_loadu_pd( p + 12 );
+        _mm256_storeu_pd( p,      _mm256_mul_pd( a, vmult ) );
+        _mm256_storeu_pd( p + 4,  _mm256_mul_pd( b, vmult ) );
+        _mm256_storeu_pd( p + 8,  _mm256_mul_pd( c, vmult ) );
+        _mm256_storeu_pd( p + 12, _mm256_mul_pd( d, vmult ) );
+    }
+    for( ; i_count >= 4; i_count -= 4, p += 4 )
+        _mm256_storeu_pd( p, _mm256_mul_pd( _mm256_loadu_pd( p ), vmult ) );
+    for( ; i_count > 0; i_count-- )
+        *(p++) *= mult;
+
+    (void) p_volume;
+}
+
+/**
+ * Same as FilterRampFL32(), eight sample frames at a time: the gains of the
+ * frames are computed in one vector, then spread over the interleaved
+ * channels with one permutation per vector of samples.
+ */
+__attribute__ ((__target__ ("avx2")))
+static void FilterRampFL32AVX2( audio_volume_t *p_volume, block_t *p_buffer,
+                                float f_from, float f_to )
+{
+    unsigned i_channels = BufferChannels( p_buffer, sizeof (float) );
+    if( i_channels == 0 || i_channels > AOUT_CHAN_MAX )
+    {
+        FilterRampFL32( p_volume, p_buffer, f_from, f_to );
+        return;
+    }
+
+    float *p = (float *)p_buffer->p_buffer;
+    float f_step = (f_to - f_from) / p_buffer->i_nb_samples;
+    __m256i spread[AOUT_CHAN_MAX];
+
+    /* Sample l of vector v belongs to frame (8 * v + l) / channels */
+    for( unsigned v = 0; v < i_channels; v++ )
+    {
+        int32_t frames[8];
+
+        for( unsigned l = 0; l < 8; l++ )
+            frames[l] = (8 * v + l) / i_channels;
+        spread[v] = _mm256_loadu_si256( (const __m256i *)frames );
+    }
+
+    const __m256 from = _mm256_set1_ps( f_from );
+    const __m256 step = _mm256_set1_ps( f_step );
+    const __m256i eight = _mm256_set1_epi32( 8 );
+    __m256i frame = _mm256_setr_epi32( 1, 2, 3, 4, 5, 6, 7, 8 );
+    unsigned i = 0;
+
+    for( ; i + 8 <= p_buffer->i_nb_samples; i += 8 )
+    {
+        __m256 gains = _mm256_add_ps( from,
+                           _mm256_mul_ps( step, _mm256_cvtepi32_ps( frame ) ) );
+
+        for( unsigned v = 0; v < i_channels; v++, p += 8 )
+        {
+            __m256 gain = _mm256_permutevar8x32_ps( gains, spread[v] );
+            _mm256_storeu_ps( p, _mm256_mul_ps( _mm256_loadu_ps( p ), gain ) );
+        }
+        frame = _mm256_add_epi32( frame, eight );
+    }
+
+    for( ; i < p_buffer->i_nb_samples; i++ )
+    {
+        float f_gain = f_from + f_step * (float)(i + 1);
+
+        for( unsigned j = 0; j < i_channels; j++ )
+            *(p++) *= f_gain;
+    }
+}
+#endif
+
 /**
  * Initializes the mixer
  */
@@ -92,9 +280,22 @@ static int Create( vlc_object_t *p_this )
     {
         case VLC_CODEC_FL32:
             p_volume->amplify = FilterFL32;
+            p_volume->amplify_ramp = FilterRampFL32;
+#ifdef FLOAT_HAVE_AVX2
+            if( vlc_CPU_AVX2() )
+            {
+                p_volume->amplify = FilterFL32AVX2;
+                p_volume->amplify_ramp = FilterRampFL32AVX2;
+            }
+#endif
             break;
         case VLC_CODEC_FL64:
             p_volume->amplify = FilterFL64;
+            p_volume->amplify_ramp = FilterRampFL64;
+#ifdef FLOAT_HAVE_AVX2
+            if( vlc_CPU_AVX2() )
+                p_volume->amplify = FilterFL64AVX2;
+#endif
             break;
         default:
             return -1;
@@ -366,6 +366,10 @@ static int DecodeBlock( decoder_t *p_dec, block_t *p_block )
     {
         if( decoder_UpdateAudioFormat( p_dec ) )
             goto skip;
+        /* Audio filters may process the samples in place */
+        p_block = block_MakeWritable( p_block );
+        if( p_block == NULL )
+            return VLCDEC_SUCCESS;
         p_block->i_nb_samples = samples;
         p_block->i_buffer = samples * (p_sys->framebits / 8);
     }
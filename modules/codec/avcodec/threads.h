@@ -0,0 +1,77 @@
+/*****************************************************************************
+ * threads.h: libavcodec decoder threading policy
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef VLC_AVCODEC_THREADS_H
+#define VLC_AVCODEC_THREADS_H 1
+
+/**
+ * Computes the number of decoding threads.
+ *
+ * This does not depend on libavcodec, so that the policy can be tested.
+ *
+ * \param i_requested number of threads requested by the user, 0 or less
+ *                    for automatic
+ * \param i_cpus number of CPUs
+ * \param i_width picture width, 0 if not known yet
+ * \param i_height picture height, 0 if not known yet
+ * \param b_hevc whether the codec is HEVC
+ * \param b_low_delay whether latency is favored over throughput
+ * \param b_slices whether slice threads are used (rather than frame threads)
+ * \return the number of threads
+ */
+static inline int ffmpeg_GetThreadCount( int i_requested, unsigned i_cpus,
+                                         unsigned i_width, unsigned i_height,
+                                         bool b_hevc, bool b_low_delay,
+                                         bool b_slices )
+{
+    int i_thread_count = i_requested;
+
+    if( i_thread_count <= 0 )
+    {
+        /* Small pictures do not keep many threads busy */
+        const uint64_t i_pixels = (uint64_t)i_width * i_height;
+        int i_max;
+
+        if( i_pixels == 0 ) /* not known yet */
+            i_max = b_hevc ? 10 : 6;
+        else if( i_pixels <= 1024 * 576 )
+            i_max = 4;
+        else if( i_pixels <= 2048 * 1152 )
+            i_max = 8;
+        else
+            i_max = 16;
+
+        i_thread_count = i_cpus;
+        /* One more frame thread keeps the CPUs busy while another one
+         * waits for its references */
+        if( i_thread_count > 1 && !b_low_delay )
+            i_thread_count++;
+        /* Without slice threads, every frame thread adds latency */
+        if( b_low_delay && !b_slices )
+            i_max = __MIN( i_max, 2 );
+#if VLC_WINSTORE_APP
+        i_max = __MIN( i_max, 6 );
+#endif
+        i_thread_count = __MIN( i_thread_count, i_max );
+    }
+    return __MIN( i_thread_count, b_hevc ? 32 : 16 );
+}
+
+#endif
@@ -45,6 +45,7 @@
 
 #include "avcodec.h"
 #include "va.h"
+#include "threads.h"
 
 #include "../../packetizer/av1_obu.h"
 #include "../../packetizer/av1.h"
@@ -462,6 +463,64 @@ static int OpenVideoCodec( decoder_t *p_dec )
     return 0;
 }
 
+/*****************************************************************************
+ * ffmpeg_InitThreads: picks the threading mode and the number of threads
+ *****************************************************************************
+ * Frame threads scale best, but each one delays the output by one picture
+ * and holds one more picture. Slice threads add no delay, but only help
+ * when the pictures have several slices. Frame threads are the default,
+ * "low-delay" gets slice threads when the codec supports them.
+ * Small pictures do not keep many threads busy, so the automatic number of
+ * threads follows the picture size.
+ *****************************************************************************/
+static void ffmpeg_InitThreads( decoder_t *p_dec, AVCodecContext *p_context,
+                                const AVCodec *p_codec )
+{
+    decoder_sys_t *p_sys = p_dec->p_sys;
+    const bool b_low_delay = var_InheritBool( p_dec, "low-delay" );
+
+    switch( p_codec->id )
+    {
+        case AV_CODEC_ID_MPEG4:
+        case AV_CODEC_ID_H263:
+            p_context->thread_type = 0;
+            break;
+        case AV_CODEC_ID_MPEG1VIDEO:
+        case AV_CODEC_ID_MPEG2VIDEO:
+            p_context->thread_type &= ~FF_THREAD_SLICE;
+            /* fall through */
+# if (LIBAVCODEC_VERSION_INT < AV_VERSION_INT(55, 1, 0))
+        case AV_CODEC_ID_H264:
+        case AV_CODEC_ID_VC1:
+        case AV_CODEC_ID_WMV3:
+            p_context->thread_type &= ~FF_THREAD_FRAME;
+# endif
+        default:
+            break;
+    }
+
+    const bool b_slices = (p_codec->capabilities & AV_CODEC_CAP_SLICE_THREADS)
+                       && (p_context->thread_type & FF_THREAD_SLICE);
+    if( b_low_delay && b_slices )
+        p_context->thread_type &= ~FF_THREAD_FRAME;
+
+    int i_thread_count = p_sys->b_hardware_only ? 1 : var_InheritInteger( p_dec, "avcodec-threads" );
+    i_thread_count = ffmpeg_GetThreadCount( i_thread_count, vlc_GetCPUCount(),
+                                            p_dec->fmt_in.video.i_width,
+                                            p_dec->fmt_in.video.i_height,
+                                            p_codec->id == AV_CODEC_ID_HEVC,
+                                            b_low_delay, b_slices );
+    msg_Dbg( p_dec, "allowing %d thread(s) for %s decoding", i_thread_count,
+             b_low_delay ? "low delay" : "throughput" );
+    p_context->thread_count = i_thread_count;
+#if LIBAVCODEC_VERSION_MAJOR < 60
+    p_context->thread_safe_callbacks = true;
+#endif
+
+    if( p_context->thread_type & FF_THREAD_FRAME )
+        p_dec->i_extra_picture_buffers = 2 * p_context->thread_count;
+}
+
 static int InitVideoDecCommon( decoder_t *p_dec )
 {
     decoder_sys_t *p_sys = p_dec->p_sys;
@@ -540,49 +599,7 @@ static int InitVideoDecCommon( decoder_t *p_dec )
     p_context->get_buffer2 = lavc_GetFrame;
     p_context->opaque = p_dec;
 
-    int i_thread_count = p_sys->b_hardware_only ? 1 : var_InheritInteger( p_dec, "avcodec-threads" );
-    if( i_thread_count <= 0 )
-    {
-        i_thread_count = vlc_GetCPUCount();
-        if( i_thread_count > 1 )
-            i_thread_count++;
-
-        //FIXME: take in count the decoding time
-#if VLC_WINSTORE_APP
-        i_thread_count = __MIN( i_thread_count, 6 );
-#else
-        i_thread_count = __MIN( i_thread_count, p_codec->id == AV_CODEC_ID_HEVC ? 10 : 6 );
-#endif
-    }
-    i_thread_count = __MIN( i_thread_count, p_codec->id == AV_CODEC_ID_HEVC ? 32 : 16 );
-    msg_Dbg( p_dec, "allowing %d thread(s) for decoding", i_thread_count );
-    p_context->thread_count = i_thread_count;
-#if LIBAVCODEC_VERSION_MAJOR < 60
-    p_context->thread_safe_callbacks = true;
-#endif
-
-    switch( p_codec->id )
-    {
-        case AV_CODEC_ID_MPEG4:
-        case AV_CODEC_ID_H263:
-            p_context->thread_type = 0;
-            break;
-        case AV_CODEC_ID_MPEG1VIDEO:
-        case AV_CODEC_ID_MPEG2VIDEO:
-            p_context->thread_type &= ~FF_THREAD_SLICE;
-            /* fall through */
-# if (LIBAVCODEC_VERSION_INT < AV_VERSION_INT(55, 1, 0))
-        case AV_CODEC_ID_H264:
-        case AV_CODEC_ID_VC1:
-        case AV_CODEC_ID_WMV3:
-            p_context->thread_type &= ~FF_THREAD_FRAME;
-# endif
-        default:
-            break;
-    }
-
-    if( p_context->thread_type & FF_THREAD_FRAME )
-        p_dec->i_extra_picture_buffers = 2 * p_context->thread_count;
+    ffmpeg_InitThreads( p_dec, p_context, p_codec );
 
     /* ***** misc init ***** */
     date_Init(&p_sys->pts, 1, 30001);
@@ -576,6 +576,9 @@ helper_process_block_xvcc2annexb(struct hxxx_helper *hh, block_t *p_block,
                                  bool *p_config_changed)
 {
     assert(helper_nal_length_valid(hh));
+    p_block = block_MakeWritable(p_block);
+    if (p_block == NULL)
+        return NULL;
     h264_AVC_to_AnnexB(p_block->p_buffer, p_block->i_buffer,
                        hh->i_nal_length_size);
     return helper_process_block_h264_annexb(hh, p_block, p_config_changed);
@@ -42,7 +42,12 @@ static int
 DecodeBlock(decoder_t *p_dec, block_t *p_block)
 {
     if (p_block != NULL)
-        decoder_QueueAudio( p_dec, p_block );
+    {
+        /* Audio filters may process the buffer in place */
+        p_block = block_MakeWritable(p_block);
+        if (p_block != NULL)
+            decoder_QueueAudio( p_dec, p_block );
+    }
     return VLCDEC_SUCCESS;
 }
 
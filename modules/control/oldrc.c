@@ -1747,11 +1747,19 @@ static int updateStatistics( intf_thread_t *p_intf, input_item_t *p_item )
             p_item->p_stats->i_demux_corrupted );
     msg_rc(_("| discontinuities  :    %5"PRIi64),
             p_item->p_stats->i_demux_discontinuity );
+    msg_rc(_("| timeshift buffer : %8.0f KiB"),
+            (float)(p_item->p_stats->i_timeshift_fill)/1024 );
+    msg_rc(_("| timeshift index  :    %5"PRIi64),
+            p_item->p_stats->i_timeshift_index );
     msg_rc("|");
     /* Video */
     msg_rc("%s", _("+-[Video Decoding]"));
     msg_rc(_("| video decoded    :    %5"PRIi64),
             p_item->p_stats->i_decoded_video );
+    msg_rc(_("| decoding time    : %8.2f ms"),
+            (float)(p_item->p_stats->i_decode_time)/1000 );
+    msg_rc(_("| decoder queue    :    %5"PRIi64),
+            p_item->p_stats->i_decoder_queue );
     msg_rc(_("| frames displayed :    %5"PRIi64),
             p_item->p_stats->i_displayed_pictures );
     msg_rc(_("| frames lost      :    %5"PRIi64),
@@ -31,19 +31,23 @@
 #include "playlist/BaseAdaptationSet.h"
 #include "playlist/BaseRepresentation.h"
 #include "http/HTTPConnectionManager.h"
+#include "http/Downloader.hpp"
 #include "logic/AlwaysBestAdaptationLogic.h"
 #include "logic/RateBasedAdaptationLogic.h"
 #include "logic/AlwaysLowestAdaptationLogic.hpp"
 #include "logic/PredictiveAdaptationLogic.hpp"
 #include "logic/NearOptimalAdaptationLogic.hpp"
 #include "logic/BufferingLogic.hpp"
+#include "logic/CatchupLogic.hpp"
 #include "tools/Debug.hpp"
 #include <vlc_stream.h>
 #include <vlc_demux.h>
+#include <vlc_input.h>
 #include <vlc_threads.h>
 
 #include <algorithm>
 #include <ctime>
+#include <cmath>
 #include <cassert>
 
 using namespace adaptive::http;
@@ -83,6 +87,12 @@ PlaylistManager::PlaylistManager( demux_t *p_demux_,
     cached.playlistEnd = 0;
     cached.playlistLength = 0;
     cached.lastupdate = 0;
+    catchup.b_enabled = false;
+    catchup.logic = nullptr;
+    catchup.rate = 1.0f;
+    catchup.lastupdate = 0;
+    dlstats.downloads = 0;
+    dlstats.lastupdate = 0;
 }
 
 PlaylistManager::~PlaylistManager   ()
@@ -93,6 +103,7 @@ PlaylistManager::~PlaylistManager   ()
     delete logic;
     delete resources;
     delete bufferingLogic;
+    delete catchup.logic;
     vlc_cond_destroy(&waitcond);
     vlc_mutex_destroy(&lock);
     vlc_mutex_destroy(&demux.lock);
@@ -130,6 +141,9 @@ bool PlaylistManager::setupPeriod()
             if(!tracker)
                 continue;
 
+            if(!b_preparsing)
+                tracker->setPrefetchCount(var_InheritInteger(p_demux, "adaptive-prefetch"));
+
             AbstractStream *st = streamFactory->create(p_demux, set->getStreamFormat(),
                                                        tracker);
             if(!st)
@@ -163,6 +177,8 @@ bool PlaylistManager::init(bool b_preparsing)
 
     if(b_preparsing)
         preparsePlaylist();
+    else
+        catchup.b_enabled = var_InheritInteger(p_demux, "adaptive-catchup-rate") > 100;
     updateControlsPosition();
 
     return true;
@@ -499,6 +515,8 @@ int PlaylistManager::doDemux(int64_t increment)
     vlc_mutex_unlock(&demux.lock);
 
     updateControlsPosition();
+    updateCatchup();
+    updateDownloadStats();
 
     switch(status)
     {
@@ -851,6 +869,99 @@ void PlaylistManager::updateControlsPosition()
                             startTimes.segment.demux, cached.f_position));
 }
 
+vlc_tick_t PlaylistManager::getLiveLatency() const
+{
+    /* From the demuxed position to the live edge: buffered data,
+     * and data available but not downloaded yet */
+    const Times times = getTimes();
+    if(times.continuous == VLC_TICK_INVALID)
+        return 0;
+
+    vlc_tick_t latency = 0;
+    for(const AbstractStream *st : streams)
+    {
+        if(st->isValid() && !st->isDisabled() && st->isSelected())
+        {
+            const vlc_tick_t l = st->getDemuxedAmount(times) + st->getMinAheadTime();
+            if(latency == 0 || l < latency)
+                latency = l;
+        }
+    }
+    return latency;
+}
+
+void PlaylistManager::updateCatchup()
+{
+    if(!catchup.b_enabled || !p_demux->p_input)
+        return;
+
+    const vlc_tick_t now = mdate();
+    if(now - catchup.lastupdate < CLOCK_FREQ)
+        return;
+    catchup.lastupdate = now;
+
+    const bool b_live = playlist->isLive();
+    if(!catchup.logic)
+    {
+        if(!b_live)
+            return;
+        if(!(catchup.logic = createCatchupLogic()))
+        {
+            catchup.b_enabled = false;
+            return;
+        }
+    }
+
+    /* back to normal speed once no longer live */
+    const vlc_tick_t latency = b_live ? getLiveLatency() : 0;
+    const float rate = latency ? catchup.logic->getRate(latency) : 1.0f;
+    if(rate == catchup.rate)
+        return;
+
+    /* never override a rate set by the user */
+    if(std::fabs(var_GetFloat(p_demux->p_input, "rate") - catchup.rate) > 0.001f)
+        return;
+
+    msg_Dbg(p_demux, "live latency %" PRId64 "ms, target %" PRId64 "ms, "
+                     "playback rate %.2f", latency / 1000,
+                     catchup.logic->getTarget() / 1000, rate);
+    var_SetFloat(p_demux->p_input, "rate", rate);
+    catchup.rate = rate;
+}
+
+void PlaylistManager::updateDownloadStats()
+{
+    if(!p_demux->p_input)
+        return;
+
+    const vlc_tick_t now = mdate();
+    if(now - dlstats.lastupdate < CLOCK_FREQ)
+        return;
+    dlstats.lastupdate = now;
+
+    const HTTPConnectionManager *conn =
+            dynamic_cast<HTTPConnectionManager *>(resources->getConnManager());
+    if(!conn)
+        return;
+
+    const DownloaderStats stats = conn->getDownloadStats();
+    if(stats.downloads == dlstats.downloads)
+        return;
+    dlstats.downloads = stats.downloads;
+
+    const char *cat = _("Adaptive streaming");
+    input_Control(p_demux->p_input, INPUT_ADD_INFO, cat,
+                  _("Segment downloads"), "%u", stats.downloads);
+    input_Control(p_demux->p_input, INPUT_ADD_INFO, cat,
+                  _("Concurrent downloads (peak)"), "%u", stats.peakActive);
+    input_Control(p_demux->p_input, INPUT_ADD_INFO, cat,
+                  _("Download queue wait (average)"), "%" PRId64 " ms",
+                  stats.totalWait / stats.downloads / 1000);
+    input_Control(p_demux->p_input, INPUT_ADD_INFO, cat,
+                  _("Download queue wait (max)"), "%" PRId64 " ms",
+                  stats.maxWait / 1000);
+}
+
 AbstractAdaptationLogic *PlaylistManager::createLogic(AbstractAdaptationLogic::LogicType type, AbstractConnectionManager *conn)
 {
     vlc_object_t *obj = VLC_OBJECT(p_demux);
@@ -932,6 +1043,23 @@ AbstractBufferingLogic *PlaylistManager::createBufferingLogic() const
         v = var_InheritInteger(p_demux, "adaptive-maxbuffer");
         if(v)
             bl->setUserMaxBuffering(CLOCK_FREQ / 1000 * v);
+        int lowlatency = var_InheritInteger(p_demux, "adaptive-lowlatency");
+        if(lowlatency != -1)
+            bl->setLowDelay(lowlatency == 1);
     }
     return bl;
 }
+
+CatchupLogic *PlaylistManager::createCatchupLogic() const
+{
+    /* Defaults to the live delay of low latency streams only, as
+     * others are expected to play behind the live edge */
+    vlc_tick_t target = CLOCK_FREQ / 1000 *
+                        var_InheritInteger(p_demux, "adaptive-latency-target");
+    if(!target && playlist->isLowLatency())
+        target = bufferingLogic->getLiveDelay(playlist);
+    if(!target)
+        return nullptr;
+    float maxrate = var_InheritInteger(p_demux, "adaptive-catchup-rate") / 100.0f;
+    return new (std::nothrow) CatchupLogic(target, maxrate);
+}
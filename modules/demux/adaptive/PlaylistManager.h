@@ -39,6 +39,11 @@ namespace adaptive
         class AbstractConnectionManager;
     }
 
+    namespace logic
+    {
+        class CatchupLogic;
+    }
+
     using namespace playlist;
     using namespace logic;
 
@@ -91,11 +96,15 @@ namespace adaptive
             void unsetPeriod();
 
             void updateControlsPosition();
+            vlc_tick_t getLiveLatency() const;
+            void updateCatchup();
+            void updateDownloadStats();
 
             /* local factories */
             virtual AbstractAdaptationLogic *createLogic(AbstractAdaptationLogic::LogicType,
                                                          AbstractConnectionManager *);
             virtual AbstractBufferingLogic *createBufferingLogic() const;
+            virtual CatchupLogic *createCatchupLogic() const;
 
             SharedResources                     *resources;
             AbstractAdaptationLogic::LogicType  logicType;
@@ -142,6 +151,22 @@ namespace adaptive
 
             SynchronizationReferences synchronizationReferences;
 
+            /* Live latency control, from the demux thread */
+            struct
+            {
+                bool        b_enabled;
+                CatchupLogic *logic;
+                float       rate;
+                vlc_tick_t  lastupdate;
+            } catchup;
+
+            /* Downloader statistics, published as input info */
+            struct
+            {
+                unsigned    downloads;
+                vlc_tick_t  lastupdate;
+            } dlstats;
+
         private:
             void setBufferingRunState(bool);
             void Run();
@@ -31,6 +31,7 @@
 #include "playlist/SegmentChunk.hpp"
 #include "logic/AbstractAdaptationLogic.h"
 #include "logic/BufferingLogic.hpp"
+#include "http/HTTPConnectionManager.h"
 
 #include <cassert>
 #include <limits>
@@ -137,6 +138,7 @@ SegmentTracker::SegmentTracker(SharedResources *res,
     resources = res;
     first = true;
     initializing = true;
+    prefetchCount = 0;
     bufferingLogic = bl;
     setAdaptationLogic(logic_);
     adaptationSet = adaptSet;
@@ -147,6 +149,8 @@ SegmentTracker::SegmentTracker(SharedResources *res,
 SegmentTracker::~SegmentTracker()
 {
     reset();
+    if(adaptationSet)
+        resources->getConnManager()->removeStream(adaptationSet->getID());
 }
 
 SegmentTracker::Position::Position()
@@ -335,6 +339,43 @@ SegmentTracker::prepareChunk(bool switch_allowed, Position pos) const
     return ChunkEntry(segmentChunk, pos, startTime, duration, displayTime);
 }
 
+void SegmentTracker::prefetchChunks(bool switch_allowed)
+{
+    /* Those still waiting for a worker are prepared again, so that
+     * the representation is chosen as late as possible */
+    while(!chunkssequence.empty() && chunkssequence.back().isValid() &&
+          resources->getConnManager()->isPending(chunkssequence.back().chunk->getSource()))
+    {
+        delete chunkssequence.back().chunk;
+        chunkssequence.pop_back();
+    }
+
+    /* Prepare the following chunks, which starts their download while the
+     * current one is demuxed */
+    while(chunkssequence.size() < prefetchCount)
+    {
+        Position pos = next;
+        if(!chunkssequence.empty())
+        {
+            pos = chunkssequence.back().pos;
+            ++pos;
+        }
+
+        /* Don't request past the live edge */
+        if(adaptationSet->getPlaylist()->isLive() &&
+           pos.rep->getMinAheadTime(pos.number) == 0)
+            break;
+
+        ChunkEntry chunk = prepareChunk(switch_allowed, pos);
+        if(!chunk.isValid())
+        {
+            delete chunk.chunk;
+            break;
+        }
+        chunkssequence.push_back(chunk);
+    }
+}
+
 void SegmentTracker::resetChunksSequence()
 {
     while(!chunkssequence.empty())
@@ -354,6 +395,15 @@ ChunkInterface * SegmentTracker::getNextChunk(bool switch_allowed)
         ChunkEntry chunk = prepareChunk(switch_allowed, next);
         chunkssequence.push_back(chunk);
     }
+    else if(chunkssequence.front().isValid() &&
+            resources->getConnManager()->isPending(chunkssequence.front().chunk->getSource()))
+    {
+        /* Prefetched, but not downloading yet: don't stick to the
+         * representation chosen back then */
+        resetChunksSequence();
+        ChunkEntry chunk = prepareChunk(switch_allowed, next);
+        chunkssequence.push_back(chunk);
+    }
 
     ChunkEntry chunk = chunkssequence.front();
     if(!chunk.isValid())
@@ -436,7 +486,10 @@ ChunkInterface * SegmentTracker::getNextChunk(bool switch_allowed)
                                chunk.starttime, chunk.duration, chunk.displaytime));
 
     if(!b_gap)
+    {
         ++next;
+        prefetchChunks(switch_allowed);
+    }
 
     return returnedChunk;
 }
@@ -582,6 +635,8 @@ void SegmentTracker::notifyBufferingLevel(vlc_tick_t min, vlc_tick_t max,
                                           vlc_tick_t current, vlc_tick_t target) const
 {
     notify(BufferingLevelChangedEvent(adaptationSet->getID(), min, max, current, target));
+    resources->getConnManager()->updateBufferingLevel(adaptationSet->getID(),
+                                                      current, target);
 }
 
 void SegmentTracker::registerListener(SegmentTrackerListenerInterface *listener)
@@ -589,6 +644,11 @@ void SegmentTracker::registerListener(SegmentTrackerListenerInterface *listener)
     listeners.push_back(listener);
 }
 
+void SegmentTracker::setPrefetchCount(unsigned count)
+{
+    prefetchCount = count;
+}
+
 bool SegmentTracker::bufferingAvailable() const
 {
     if(adaptationSet->getPlaylist()->isLive())
@@ -235,6 +235,7 @@ namespace adaptive
             void notifyBufferingState(bool) const;
             void notifyBufferingLevel(mtime_t, mtime_t, mtime_t, mtime_t) const;
             void registerListener(SegmentTrackerListenerInterface *);
+            void setPrefetchCount(unsigned);
             bool updateSelected();
             bool bufferingAvailable() const;
 
@@ -253,11 +254,13 @@ namespace adaptive
             };
             std::list<ChunkEntry> chunkssequence;
             ChunkEntry prepareChunk(bool switch_allowed, Position pos) const;
+            void prefetchChunks(bool switch_allowed);
             void resetChunksSequence();
             void setAdaptationLogic(AbstractAdaptationLogic *);
             void notify(const TrackerEvent &) const;
             bool first;
             bool initializing;
+            unsigned prefetchCount;
             Position current;
             Position next;
             StreamFormat format;
@@ -64,7 +64,9 @@ SharedResources * SharedResources::createDefault(vlc_object_t *obj,
 {
     AuthStorage *auth = new AuthStorage(obj);
     Keyring *keyring = new Keyring(obj);
-    HTTPConnectionManager *m = new HTTPConnectionManager(obj);
+    HTTPConnectionManager *m =
+        new HTTPConnectionManager(obj, var_InheritInteger(obj, "adaptive-downloads"),
+                                  var_InheritInteger(obj, "adaptive-host-connections"));
     if(!var_InheritBool(obj, "adaptive-use-access")) /* only use http from access */
         m->addFactory(new LibVLCHTTPConnectionFactory(auth));
     m->addFactory(new StreamUrlConnectionFactory());
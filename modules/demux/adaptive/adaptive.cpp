@@ -85,6 +85,26 @@ static void Close   (vlc_object_t *);
 #define ADAPT_LOWLATENCY_TEXT N_("Low latency")
 #define ADAPT_LOWLATENCY_LONGTEXT N_("Overrides low latency parameters")
 
+#define ADAPT_DOWNLOADS_TEXT N_("Parallel downloads")
+#define ADAPT_DOWNLOADS_LONGTEXT N_("Maximum number of segments downloaded " \
+    "at the same time. Each stream downloads one segment at a time.")
+
+#define ADAPT_HOSTCONNS_TEXT N_("Connections per host")
+#define ADAPT_HOSTCONNS_LONGTEXT N_("Maximum number of segments downloaded " \
+    "at the same time from a single host (0 for no limit)")
+
+#define ADAPT_PREFETCH_TEXT N_("Segments prefetch")
+#define ADAPT_PREFETCH_LONGTEXT N_("Number of segments requested ahead of " \
+    "the one being demuxed, per stream")
+
+#define ADAPT_LATENCY_TEXT N_("Live latency target (ms)")
+#define ADAPT_LATENCY_LONGTEXT N_("Live playback is sped up when lagging " \
+    "behind this target (0 for the live delay of low latency streams)")
+
+#define ADAPT_CATCHUP_TEXT N_("Catch-up rate (%)")
+#define ADAPT_CATCHUP_LONGTEXT N_("Maximum playback speed used to catch up " \
+    "with the live latency target (100 to disable)")
+
 static const AbstractAdaptationLogic::LogicType pi_logics[] = {
                                 AbstractAdaptationLogic::LogicType::Default,
                                 AbstractAdaptationLogic::LogicType::Predictive,
@@ -145,6 +165,20 @@ vlc_module_begin ()
                      ADAPT_MAXBUFFER_TEXT, nullptr, true );
         add_integer( "adaptive-lowlatency", -1, ADAPT_LOWLATENCY_TEXT, ADAPT_LOWLATENCY_LONGTEXT, true );
             change_integer_list(rgi_latency, ppsz_latency)
+        add_integer( "adaptive-downloads", 3, ADAPT_DOWNLOADS_TEXT,
+                     ADAPT_DOWNLOADS_LONGTEXT, true );
+            change_integer_range( 1, 16 )
+        add_integer( "adaptive-host-connections", 0, ADAPT_HOSTCONNS_TEXT,
+                     ADAPT_HOSTCONNS_LONGTEXT, true );
+            change_integer_range( 0, 16 )
+        add_integer( "adaptive-prefetch", 1, ADAPT_PREFETCH_TEXT,
+                     ADAPT_PREFETCH_LONGTEXT, true );
+            change_integer_range( 0, 8 )
+        add_integer( "adaptive-latency-target", 0, ADAPT_LATENCY_TEXT,
+                     ADAPT_LATENCY_LONGTEXT, true );
+        add_integer( "adaptive-catchup-rate", 110, ADAPT_CATCHUP_TEXT,
+                     ADAPT_CATCHUP_LONGTEXT, true );
+            change_integer_range( 100, 150 )
         set_callbacks( Open, Close )
 vlc_module_end ()
 
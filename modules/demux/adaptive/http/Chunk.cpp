@@ -41,6 +41,7 @@ AbstractChunkSource::AbstractChunkSource(ChunkType t, const BytesRange &range)
 {
     type = t;
     contentLength = 0;
+    paced = false;
     requeststatus = RequestStatus::Success;
     bytesRange = range;
     if(bytesRange.isValid() && bytesRange.getEndByte())
@@ -77,6 +78,11 @@ ChunkType AbstractChunkSource::getChunkType() const
     return type;
 }
 
+void AbstractChunkSource::setPaced(bool b)
+{
+    paced = b;
+}
+
 AbstractChunk::AbstractChunk(AbstractChunkSource *source_)
 {
     bytesRead = 0;
@@ -103,6 +109,11 @@ size_t AbstractChunk::getBytesRead() const
     return this->bytesRead;
 }
 
+const AbstractChunkSource * AbstractChunk::getSource() const
+{
+    return source;
+}
+
 uint64_t AbstractChunk::getStartByteInFile() const
 {
     if(!source || !source->getBytesRange().isValid())
@@ -224,8 +235,14 @@ block_t * HTTPChunkSource::read(size_t readsize)
         return nullptr;
     }
 
-    ssize_t ret = connection->read(p_block->p_buffer, readsize);
-    if(ret < 0)
+    /* connection reads are partial, but direct readers expect full blocks */
+    ssize_t ret = 0;
+    size_t filled = 0;
+    while(filled < readsize &&
+          (ret = connection->read(&p_block->p_buffer[filled], readsize - filled)) > 0)
+        filled += ret;
+
+    if(ret < 0 && filled == 0)
     {
         block_Release(p_block);
         p_block = nullptr;
@@ -234,15 +251,16 @@ block_t * HTTPChunkSource::read(size_t readsize)
     }
     else
     {
-        p_block->i_buffer = (size_t) ret;
+        p_block->i_buffer = filled;
         consumed += p_block->i_buffer;
-        if((size_t)ret < readsize)
+        if(filled < readsize)
         {
             eof = true;
             downloadEndTime = mdate();
         }
-        if(ret && connection->getBytesRead() &&
-           downloadEndTime > requestStartTime && type == ChunkType::Segment)
+        if(filled && connection->getBytesRead() &&
+           downloadEndTime > requestStartTime && type == ChunkType::Segment &&
+           !paced)
         {
             connManager->updateDownloadRate(sourceid,
                                             connection->getBytesRead(),
@@ -278,6 +296,11 @@ void HTTPChunkSource::setIdentifier(const std::string &s, const BytesRange &r)
     storeid =  makeStorageID(s, r);
 }
 
+const ConnectionParams & HTTPChunkSource::getConnectionParams() const
+{
+    return params;
+}
+
 bool HTTPChunkSource::prepare()
 {
     if(prepared)
@@ -446,7 +469,9 @@ void HTTPChunkBufferedSource::bufferize(size_t readsize)
             p_read = p_block;
             inblockreadoffset = 0;
         }
-        if((size_t) ret < readsize)
+        /* Short reads are data arriving as it is produced. The end is
+         * only known from the length, or from the next empty read. */
+        if(contentLength && buffered >= contentLength)
         {
             done = true;
             downloadEndTime = mdate();
@@ -456,7 +481,9 @@ void HTTPChunkBufferedSource::bufferize(size_t readsize)
         }
     }
 
-    if(rate.size && rate.time && type == ChunkType::Segment)
+    /* The transfer of a segment still being produced lasts about as long
+     * as its playback, whatever the bandwidth: do not account it. */
+    if(rate.size && rate.time && type == ChunkType::Segment && !paced)
     {
         connManager->updateDownloadRate(sourceid, rate.size,
                                         rate.time, rate.latency);
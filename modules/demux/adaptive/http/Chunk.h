@@ -74,6 +74,7 @@ namespace adaptive
                 const BytesRange &  getBytesRange   () const;
                 ChunkType           getChunkType    () const;
                 const StorageID &   getStorageID    () const;
+                void                setPaced        (bool);
                 virtual std::string getContentType  () const override;
                 virtual RequestStatus getRequestStatus() const override;
                 virtual void        recycle() = 0;
@@ -86,6 +87,7 @@ namespace adaptive
                 RequestStatus       requeststatus;
                 size_t              contentLength;
                 BytesRange          bytesRange;
+                bool                paced; /* delivered as produced */
         };
 
         class AbstractChunk : public ChunkInterface
@@ -98,6 +100,7 @@ namespace adaptive
                 virtual size_t        getBytesRead          () const override;
                 virtual bool          hasMoreData           () const override;
                 uint64_t              getStartByteInFile    () const;
+                const AbstractChunkSource * getSource       () const;
 
                 virtual block_t *   readBlock       () override;
                 virtual block_t *   read            (size_t) override;
@@ -137,6 +140,7 @@ namespace adaptive
 
                 virtual bool        prepare();
                 void                setIdentifier(const std::string &, const BytesRange &);
+                const ConnectionParams & getConnectionParams() const;
                 AbstractConnection    *connection;
                 AbstractConnectionManager *connManager;
                 mutable vlc_mutex_t lock;
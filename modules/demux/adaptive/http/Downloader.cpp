@@ -26,28 +26,49 @@
 #include <vlc_threads.h>
 #include <vlc_atomic.h>
 
+#include <algorithm>
+
 using namespace adaptive::http;
 
-Downloader::Downloader()
+DownloaderStats::DownloaderStats()
+{
+    downloads = 0;
+    active = 0;
+    peakActive = 0;
+    totalWait = 0;
+    maxWait = 0;
+}
+
+Downloader::Job::Job(HTTPChunkBufferedSource *source_)
+{
+    source = source_;
+    const ConnectionParams &params = source->getConnectionParams();
+    host = params.getHostname() + ':' + std::to_string(params.getPort());
+    queued = mdate();
+    active = false;
+    cancelled = false;
+}
+
+Downloader::Downloader(unsigned workers_, unsigned hostconnections_)
 {
     vlc_mutex_init(&lock);
     vlc_cond_init(&waitcond);
     vlc_cond_init(&updatedcond);
     killed = false;
-    thread_handle_valid = false;
-    current = nullptr;
-    cancel_current = false;
+    workers = workers_ ? workers_ : 1;
+    hostconnections = hostconnections_;
 }
 
 bool Downloader::start()
 {
-    if(!thread_handle_valid &&
-       vlc_clone(&thread_handle, downloaderThread,
-                 static_cast<void *>(this), VLC_THREAD_PRIORITY_INPUT))
+    while(threads.size() < workers)
     {
-        return false;
+        vlc_thread_t thread_handle;
+        if(vlc_clone(&thread_handle, downloaderThread,
+                     static_cast<void *>(this), VLC_THREAD_PRIORITY_INPUT))
+            return !threads.empty();
+        threads.push_back(thread_handle);
     }
-    thread_handle_valid = true;
     return true;
 }
 
@@ -55,19 +76,20 @@ Downloader::~Downloader()
 {
     vlc_mutex_lock( &lock );
     killed = true;
-    vlc_cond_signal(&waitcond);
+    vlc_cond_broadcast(&waitcond);
     vlc_mutex_unlock( &lock );
 
-    if(thread_handle_valid)
+    for(vlc_thread_t thread_handle : threads)
         vlc_join(thread_handle, nullptr);
     vlc_mutex_destroy(&lock);
     vlc_cond_destroy(&waitcond);
+    vlc_cond_destroy(&updatedcond);
 }
 void Downloader::schedule(HTTPChunkBufferedSource *source)
 {
     vlc_mutex_lock(&lock);
     source->hold();
-    chunks.push_back(source);
+    jobs.push_back(Job(source));
     vlc_cond_signal(&waitcond);
     vlc_mutex_unlock(&lock);
 }
@@ -75,18 +97,109 @@ void Downloader::schedule(HTTPChunkBufferedSource *source)
 void Downloader::cancel(HTTPChunkBufferedSource *source)
 {
     vlc_mutex_lock(&lock);
-    while (current == source)
+    for(auto it = jobs.begin(); it != jobs.end(); )
     {
-        cancel_current = true;
-        vlc_cond_wait(&updatedcond, &lock);
+        if((*it).source != source)
+        {
+            ++it;
+            continue;
+        }
+        if((*it).active)
+        {
+            /* let the worker drop it, then check again */
+            (*it).cancelled = true;
+            vlc_cond_wait(&updatedcond, &lock);
+            it = jobs.begin();
+            continue;
+        }
+        jobs.erase(it);
+        source->release();
+        break;
     }
+    vlc_mutex_unlock(&lock);
+}
 
-    if(!source->isDone())
+bool Downloader::isPending(const HTTPChunkBufferedSource *source) const
+{
+    bool ret = false;
+    vlc_mutex_lock(&lock);
+    for(const Job &job : jobs)
     {
-        chunks.remove(source);
-        source->release();
+        if(job.source == source)
+        {
+            ret = !job.active;
+            break;
+        }
     }
     vlc_mutex_unlock(&lock);
+    return ret;
+}
+
+void Downloader::setBufferingLevel(const ID &id, vlc_tick_t current,
+                                   vlc_tick_t target)
+{
+    vlc_mutex_lock(&lock);
+    bufferinglevels[id] = target > 0 ? (float) current / target : 1.0f;
+    vlc_mutex_unlock(&lock);
+}
+
+void Downloader::removeStream(const ID &id)
+{
+    vlc_mutex_lock(&lock);
+    bufferinglevels.erase(id);
+    vlc_mutex_unlock(&lock);
+}
+
+DownloaderStats Downloader::getStats() const
+{
+    vlc_mutex_lock(&lock);
+    DownloaderStats ret = stats;
+    vlc_mutex_unlock(&lock);
+    return ret;
+}
+
+Downloader::Job * Downloader::getNextJob()
+{
+    /* Among the startable jobs, pick the one of the stream with the lowest
+     * buffering level, then the oldest one. A stream downloads one segment
+     * at a time, so that concurrent downloads of the same stream do not
+     * spoil its bandwidth estimation. */
+    Job *next = nullptr;
+    float nextlevel = 0.0f;
+    for(Job &job : jobs)
+    {
+        if(job.active)
+            continue;
+
+        if(hostconnections)
+        {
+            auto host = hostsactive.find(job.host);
+            if(host != hostsactive.end() && (*host).second >= hostconnections)
+                continue;
+        }
+
+        const ID &id = job.source->sourceid;
+        bool busy = false;
+        for(const Job &other : jobs)
+        {
+            if(other.active && other.source->sourceid == id)
+            {
+                busy = true;
+                break;
+            }
+        }
+        if(busy)
+            continue;
+
+        auto it = bufferinglevels.find(id);
+        float level = (it != bufferinglevels.end()) ? (*it).second : 0.0f;
+        if(!next || level < nextlevel)
+        {
+            next = &job;
+            nextlevel = level;
+        }
+    }
+    return next;
 }
 
 void * Downloader::downloaderThread(void *opaque)
@@ -101,24 +214,49 @@ void Downloader::Run()
     vlc_mutex_lock(&lock);
     while(1)
     {
-        while(chunks.empty() && !killed)
+        Job *job = nullptr;
+        while(!killed && !(job = getNextJob()))
             vlc_cond_wait(&waitcond, &lock);
 
         if(killed)
             break;
 
-        current = chunks.front();
-        vlc_mutex_unlock(&lock);
-        current->bufferize(HTTPChunkSource::CHUNK_SIZE);
-        vlc_mutex_lock(&lock);
-        if(current->isDone() || cancel_current)
+        job->active = true;
+        hostsactive[job->host]++;
+        const vlc_tick_t wait = mdate() - job->queued;
+        stats.totalWait += wait;
+        stats.maxWait = std::max(stats.maxWait, wait);
+        if(++stats.active > stats.peakActive)
+            stats.peakActive = stats.active;
+
+        HTTPChunkBufferedSource *source = job->source;
+        while(!killed && !job->cancelled)
+        {
+            vlc_mutex_unlock(&lock);
+            source->bufferize(HTTPChunkSource::CHUNK_SIZE);
+            bool done = source->isDone();
+            vlc_mutex_lock(&lock);
+            if(done)
+                break;
+        }
+
+        const std::string host = job->host;
+        for(auto it = jobs.begin(); it != jobs.end(); ++it)
         {
-            chunks.pop_front();
-            current->release();
+            if(&(*it) == job)
+            {
+                jobs.erase(it);
+                break;
+            }
         }
-        cancel_current = false;
-        current = nullptr;
-        vlc_cond_signal(&updatedcond);
+        source->release();
+        if(--hostsactive[host] == 0)
+            hostsactive.erase(host);
+        stats.active--;
+        stats.downloads++;
+        /* wake up cancellers, and the workers waiting for this host or stream */
+        vlc_cond_broadcast(&updatedcond);
+        vlc_cond_broadcast(&waitcond);
     }
     vlc_mutex_unlock(&lock);
 }
@@ -24,6 +24,8 @@
 
 #include <vlc_common.h>
 #include <list>
+#include <map>
+#include <vector>
 
 namespace adaptive
 {
@@ -31,27 +33,55 @@ namespace adaptive
     namespace http
     {
 
+        class DownloaderStats
+        {
+            public:
+                DownloaderStats();
+                unsigned   downloads;    /* completed or cancelled */
+                unsigned   active;       /* downloads in progress */
+                unsigned   peakActive;
+                vlc_tick_t totalWait;    /* time spent queued */
+                vlc_tick_t maxWait;
+        };
+
         class Downloader
         {
             public:
-                Downloader();
+                Downloader(unsigned workers = 1, unsigned hostconnections = 0);
                 ~Downloader();
                 bool start();
                 void schedule(HTTPChunkBufferedSource *);
                 void cancel(HTTPChunkBufferedSource *);
+                bool isPending(const HTTPChunkBufferedSource *) const;
+                void setBufferingLevel(const ID &, vlc_tick_t, vlc_tick_t);
+                void removeStream(const ID &);
+                DownloaderStats getStats() const;
 
             private:
+                class Job
+                {
+                    public:
+                        Job(HTTPChunkBufferedSource *);
+                        HTTPChunkBufferedSource *source;
+                        std::string host;
+                        vlc_tick_t  queued;
+                        bool        active;
+                        bool        cancelled;
+                };
                 static void * downloaderThread(void *);
                 void Run();
-                vlc_thread_t thread_handle;
-                vlc_mutex_t  lock;
+                Job * getNextJob();
+                unsigned     workers;
+                unsigned     hostconnections; /* per host, 0 for no limit */
+                std::vector<vlc_thread_t> threads;
+                mutable vlc_mutex_t lock;
                 vlc_cond_t   waitcond;
                 vlc_cond_t   updatedcond;
-                bool         thread_handle_valid;
                 bool         killed;
-                bool         cancel_current;
-                std::list<HTTPChunkBufferedSource *> chunks;
-                HTTPChunkBufferedSource *current;
+                std::list<Job> jobs; /* queued and active, in schedule order */
+                std::map<std::string, unsigned> hostsactive;
+                std::map<ID, float> bufferinglevels; /* buffered / target */
+                DownloaderStats stats;
         };
 
     }
@@ -406,9 +406,20 @@ RequestStatus LibVLCHTTPConnection::request(const std::string &path,
     return RequestStatus::Success;
 }
 
+/* Returns what has already arrived, as in-progress segments are sent
+ * chunked and must reach the demuxer before their end is produced */
+static ssize_t ReadAvailable(stream_t *s, void *p_buffer, size_t len)
+{
+    ssize_t ret;
+    do
+        ret = vlc_stream_ReadPartial(s, p_buffer, len);
+    while(ret < 0); /* no data yet, as vlc_stream_Read() does */
+    return ret;
+}
+
 ssize_t LibVLCHTTPConnection::read(void *p_buffer, size_t len)
 {
-    ssize_t read = vlc_stream_Read(stream, p_buffer, len);
+    ssize_t read = ReadAvailable(stream, p_buffer, len);
     bytesRead = source->totalRead;
     return read;
 }
@@ -514,11 +525,11 @@ ssize_t StreamUrlConnection::read(void *p_buffer, size_t len)
     if(len > toRead)
         len = toRead;
 
-    ssize_t ret = vlc_stream_Read(p_streamurl, p_buffer, len);
+    ssize_t ret = ReadAvailable(p_streamurl, p_buffer, len);
     if(ret >= 0)
         bytesRead += ret;
 
-    if(ret < 0 || (size_t)ret < len || /* set EOF */
+    if(ret <= 0 || /* set EOF */
        contentLength == bytesRead )
     {
         reset();
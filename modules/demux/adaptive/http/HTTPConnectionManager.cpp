@@ -60,6 +60,22 @@ void AbstractConnectionManager::updateDownloadRate(const adaptive::ID &sourceid,
     }
 }
 
+void AbstractConnectionManager::updateBufferingLevel(const adaptive::ID &,
+                                                     vlc_tick_t, vlc_tick_t)
+{
+
+}
+
+void AbstractConnectionManager::removeStream(const adaptive::ID &)
+{
+
+}
+
+bool AbstractConnectionManager::isPending(const AbstractChunkSource *) const
+{
+    return false;
+}
+
 void AbstractConnectionManager::setDownloadRateObserver(IDownloadRateObserver *obs)
 {
     rateObserver = obs;
@@ -70,12 +86,14 @@ void AbstractConnectionManager::deleteSource(AbstractChunkSource *source)
     delete source;
 }
 
-HTTPConnectionManager::HTTPConnectionManager    (vlc_object_t *p_object_)
+HTTPConnectionManager::HTTPConnectionManager    (vlc_object_t *p_object_,
+                                                 unsigned downloads,
+                                                 unsigned hostconnections)
     : AbstractConnectionManager( p_object_ ),
       localAllowed(false)
 {
     vlc_mutex_init(&lock);
-    downloader = new Downloader();
+    downloader = new Downloader(downloads, hostconnections);
     downloaderhp = new Downloader();
     downloader->start();
     downloaderhp->start();
@@ -85,6 +103,13 @@ HTTPConnectionManager::HTTPConnectionManager    (vlc_object_t *p_object_)
 
 HTTPConnectionManager::~HTTPConnectionManager   ()
 {
+    DownloaderStats stats = downloader->getStats();
+    if(p_object && stats.downloads)
+        msg_Dbg(p_object, "%u downloads, %u concurrent at most, queued "
+                "%" PRId64 " ms on average, %" PRId64 " ms at most",
+                stats.downloads, stats.peakActive,
+                stats.totalWait / stats.downloads / 1000,
+                stats.maxWait / 1000);
     delete downloader;
     delete downloaderhp;
     this->closeAllConnections();
@@ -258,6 +283,30 @@ void HTTPConnectionManager::cancel(AbstractChunkSource *source)
         getDownloadQueue(src)->cancel(src);
 }
 
+bool HTTPConnectionManager::isPending(const AbstractChunkSource *source) const
+{
+    const HTTPChunkBufferedSource *src =
+            dynamic_cast<const HTTPChunkBufferedSource *>(source);
+    return src && getDownloadQueue(src)->isPending(src);
+}
+
+void HTTPConnectionManager::updateBufferingLevel(const adaptive::ID &id,
+                                                 vlc_tick_t current,
+                                                 vlc_tick_t target)
+{
+    downloader->setBufferingLevel(id, current, target);
+}
+
+void HTTPConnectionManager::removeStream(const adaptive::ID &id)
+{
+    downloader->removeStream(id);
+}
+
+DownloaderStats HTTPConnectionManager::getDownloadStats() const
+{
+    return downloader->getStats();
+}
+
 void HTTPConnectionManager::setLocalConnectionsAllowed()
 {
     localAllowed = true;
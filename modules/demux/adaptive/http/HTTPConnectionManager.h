@@ -44,6 +44,7 @@ namespace adaptive
         class Downloader;
         class AbstractChunkSource;
         class HTTPChunkBufferedSource;
+        class DownloaderStats;
         enum class ChunkType;
 
         class AbstractConnectionManager : public IDownloadRateObserver
@@ -60,9 +61,12 @@ namespace adaptive
 
                 virtual void start(AbstractChunkSource *) = 0;
                 virtual void cancel(AbstractChunkSource *) = 0;
+                virtual bool isPending(const AbstractChunkSource *) const;
 
                 virtual void updateDownloadRate(const ID &, size_t,
                                                 mtime_t, mtime_t) override;
+                virtual void updateBufferingLevel(const ID &, vlc_tick_t, vlc_tick_t);
+                virtual void removeStream(const ID &);
                 void setDownloadRateObserver(IDownloadRateObserver *);
 
             protected:
@@ -76,7 +80,9 @@ namespace adaptive
         class HTTPConnectionManager : public AbstractConnectionManager
         {
             public:
-                HTTPConnectionManager           (vlc_object_t *p_object);
+                HTTPConnectionManager           (vlc_object_t *p_object,
+                                                 unsigned downloads = 1,
+                                                 unsigned hostconnections = 0);
                 virtual ~HTTPConnectionManager  ();
 
                 virtual void    closeAllConnections ()  override;
@@ -88,6 +94,10 @@ namespace adaptive
 
                 virtual void start(AbstractChunkSource *)  override;
                 virtual void cancel(AbstractChunkSource *)  override;
+                virtual bool isPending(const AbstractChunkSource *) const override;
+                virtual void updateBufferingLevel(const ID &, vlc_tick_t, vlc_tick_t) override;
+                virtual void removeStream(const ID &) override;
+                DownloaderStats getDownloadStats() const;
                 void         setLocalConnectionsAllowed();
                 void         addFactory(AbstractConnectionFactory *);
 
@@ -240,8 +240,10 @@ uint64_t DefaultBufferingLogic::getLiveStartSegmentNumber(BaseRepresentation *re
         stime_t scaledduration = mediaSegmentTemplate->inheritDuration();
         if(scaledduration)
         {
-            /* Compute playback offset and effective finished segment from wall time */
-            vlc_tick_t now = CLOCK_FREQ * time(nullptr);
+            /* Compute playback offset and effective finished segment from wall time,
+             * low latency segments being available availabilityTimeOffset earlier */
+            vlc_tick_t now = CLOCK_FREQ * time(nullptr) +
+                             mediaSegmentTemplate->inheritAvailabilityTimeOffset();
             vlc_tick_t playbacktime = now - i_buffering;
             vlc_tick_t minavailtime = playlist->availabilityStartTime.Get() + rep->getPeriodStart();
             const uint64_t startnumber = mediaSegmentTemplate->inheritStartNumber();
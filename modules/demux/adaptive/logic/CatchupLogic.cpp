@@ -0,0 +1,66 @@
+/*
+ * CatchupLogic.cpp
+ *****************************************************************************
+ * Copyright (C) 2026 - VideoLabs, VideoLAN and VLC authors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "CatchupLogic.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace adaptive::logic;
+
+/* latency jitter not worth catching up */
+const vlc_tick_t CatchupLogic::TOLERANCE = CLOCK_FREQ / 2;
+/* time to catch up the current excess latency at full rate */
+const vlc_tick_t CatchupLogic::CATCHUP_PERIOD = CLOCK_FREQ * 10;
+/* further behind, playback was moved back in the timeshift window */
+const vlc_tick_t CatchupLogic::MAX_EXCESS = CLOCK_FREQ * 15;
+
+CatchupLogic::CatchupLogic(vlc_tick_t target_, float maxrate)
+{
+    target = target_;
+    maxRate = std::max(maxrate, 1.0f);
+    rate = 1.0f;
+}
+
+float CatchupLogic::getRate(vlc_tick_t latency)
+{
+    const vlc_tick_t excess = latency - target;
+    if(excess <= 0 || excess > MAX_EXCESS || maxRate <= 1.0f ||
+       (rate == 1.0f && excess <= TOLERANCE))
+    {
+        rate = 1.0f;
+    }
+    else
+    {
+        float r = 1.0f + (float) excess / CATCHUP_PERIOD;
+        /* in steps, as each change is applied to the whole output */
+        r = std::round(std::min(r, maxRate) * 100.0f) / 100.0f;
+        rate = std::max(r, 1.01f);
+    }
+    return rate;
+}
+
+vlc_tick_t CatchupLogic::getTarget() const
+{
+    return target;
+}
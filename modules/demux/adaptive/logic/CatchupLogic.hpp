@@ -0,0 +1,49 @@
+/*
+ * CatchupLogic.hpp
+ *****************************************************************************
+ * Copyright (C) 2026 - VideoLabs, VideoLAN and VLC authors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#ifndef CATCHUPLOGIC_HPP
+#define CATCHUPLOGIC_HPP
+
+#include <vlc_common.h>
+
+namespace adaptive
+{
+    namespace logic
+    {
+        /* Playback rate keeping a live stream close to a latency target:
+         * speeds up when lagging behind, back to normal once caught up */
+        class CatchupLogic
+        {
+            public:
+                CatchupLogic(vlc_tick_t target, float maxrate);
+                float getRate(vlc_tick_t latency);
+                vlc_tick_t getTarget() const;
+                static const vlc_tick_t TOLERANCE;
+                static const vlc_tick_t CATCHUP_PERIOD;
+                static const vlc_tick_t MAX_EXCESS;
+
+            private:
+                vlc_tick_t target;
+                float maxRate;
+                float rate;
+        };
+    }
+}
+
+#endif // CATCHUPLOGIC_HPP
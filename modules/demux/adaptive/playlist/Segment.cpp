@@ -52,6 +52,7 @@ ISegment::ISegment(const ICanonicalUrl *parent):
     discontinuitySequenceNumber = std::numeric_limits<uint64_t>::max();
     templated = false;
     discontinuity = false;
+    incomplete = false;
     displayTime = VLC_TICK_INVALID;
 }
 
@@ -96,6 +97,9 @@ SegmentChunk* ISegment::toChunk(SharedResources *res, size_t index, BaseRepresen
                                                           range);
     if(source)
     {
+        /* served as it is produced: the transfer time is not the bandwidth */
+        if(chunkType == ChunkType::Segment && isBeingProduced(index))
+            source->setPaced(true);
         SegmentChunk *chunk = createChunk(source, rep);
         if(chunk)
         {
@@ -118,6 +122,11 @@ SegmentChunk* ISegment::toChunk(SharedResources *res, size_t index, BaseRepresen
     return nullptr;
 }
 
+bool ISegment::isBeingProduced(uint64_t) const
+{
+    return incomplete;
+}
+
 bool ISegment::isTemplate() const
 {
     return templated;
@@ -171,6 +180,8 @@ void ISegment::debug(vlc_object_t *obj, int indent) const
         if(discontinuitySequenceNumber != std::numeric_limits<uint64_t>::max())
             ss << "#" << discontinuitySequenceNumber;
     }
+    if(incomplete)
+        ss << " incomplete";
     msg_Dbg(obj, "%s", ss.str().c_str());
 }
 
@@ -69,12 +69,14 @@ namespace adaptive
                 virtual size_t                          getOffset       () const;
                 virtual void                            debug           (vlc_object_t *,int = 0) const;
                 virtual bool                            contains        (size_t byte) const;
+                virtual bool                            isBeingProduced (uint64_t) const;
                 void                                    setEncryption   (CommonEncryption &);
                 void                                    setDisplayTime  (vlc_tick_t);
                 vlc_tick_t                              getDisplayTime  () const;
                 Property<stime_t>       startTime;
                 Property<stime_t>       duration;
                 bool                    discontinuity;
+                bool                    incomplete; /* listed while still produced */
 
             protected:
                 virtual bool                            prepareChunk    (SharedResources *,
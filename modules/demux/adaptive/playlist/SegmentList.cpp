@@ -30,6 +30,7 @@
 #include "SegmentInformation.hpp"
 #include "SegmentTimeline.h"
 
+#include <algorithm>
 #include <limits>
 #include <cassert>
 
@@ -41,6 +42,7 @@ SegmentList::SegmentList( SegmentInformation *parent_, bool b_relative ):
 {
     totalLength = 0;
     b_relative_mediatimes = b_relative;
+    windowStart = std::numeric_limits<uint64_t>::max();
 }
 SegmentList::~SegmentList()
 {
@@ -96,10 +98,21 @@ void SegmentList::updateWith(AbstractMultipleSegmentBaseType *updated_,
     AbstractMultipleSegmentBaseType::updateWith(updated_);
 
     SegmentList *updated = dynamic_cast<SegmentList *>(updated_);
-    if(!updated || updated->segments.empty())
+    if(!updated)
         return;
 
-    b_restamp = b_relative_mediatimes;
+    /* a partial update carries its window start */
+    const bool b_partial = updated->windowStart != std::numeric_limits<uint64_t>::max();
+
+    if(updated->segments.empty())
+    {
+        /* nothing new, but the window may have moved */
+        if(b_partial)
+            pruneBySegmentNumber(updated->windowStart);
+        return;
+    }
+
+    b_restamp = b_relative_mediatimes || b_partial;
 
     if(!b_restamp || segments.empty())
     {
@@ -112,14 +125,38 @@ void SegmentList::updateWith(AbstractMultipleSegmentBaseType *updated_,
     }
     else
     {
-        const Segment * prevSegment = segments.back();
-        const uint64_t oldest = updated->segments.front()->getSequenceNumber();
+        Segment * prevSegment = segments.back();
+        const uint64_t oldest = std::min(updated->windowStart,
+                                         updated->segments.front()->getSequenceNumber());
+
+        /* our last segment was listed while produced, take its final version */
+        if(prevSegment->incomplete)
+        {
+            auto it = std::find_if(updated->segments.begin(), updated->segments.end(),
+                                   [prevSegment](const Segment *s){
+                        return s->getSequenceNumber() == prevSegment->getSequenceNumber(); });
+            if(it != updated->segments.end())
+            {
+                Segment *cur = *it;
+                updated->segments.erase(it);
+                updated->totalLength -= cur->duration.Get();
+                cur->startTime.Set(prevSegment->startTime.Get());
+                totalLength += cur->duration.Get() - prevSegment->duration.Get();
+                segments.back() = cur;
+                delete prevSegment;
+                prevSegment = cur;
+            }
+        }
 
         /* filter out known segments from the update */
         updated->pruneBySegmentNumber(prevSegment->getSequenceNumber() + 1);
 
+        /* nothing new, but the window may have moved */
         if(updated->segments.empty())
+        {
+            pruneBySegmentNumber(oldest);
             return;
+        }
 
         /* merge update with current list */
         for(auto it = updated->segments.begin(); it != updated->segments.end(); ++it)
@@ -155,17 +192,17 @@ void SegmentList::pruneByPlaybackTime(vlc_tick_t time)
 void SegmentList::pruneBySegmentNumber(uint64_t tobelownum)
 {
     std::vector<Segment *>::iterator it = segments.begin();
-    while(it != segments.end())
+    for(; it != segments.end(); ++it)
     {
         Segment *seg = *it;
 
         if(seg->getSequenceNumber() >= tobelownum)
             break;
 
-        totalLength -= (*it)->duration.Get();
-        delete *it;
-        it = segments.erase(it);
+        totalLength -= seg->duration.Get();
+        delete seg;
     }
+    segments.erase(segments.begin(), it);
 }
 
 bool SegmentList::getPlaybackTimeDurationBySegmentNumber(uint64_t number,
@@ -237,6 +274,11 @@ stime_t SegmentList::getTotalLength() const
     return totalLength;
 }
 
+void SegmentList::setWindowStart(uint64_t number)
+{
+    windowStart = number;
+}
+
 bool SegmentList::hasRelativeMediaTimes() const
 {
     return b_relative_mediatimes;
@@ -257,7 +299,8 @@ vlc_tick_t SegmentList::getMinAheadTime(uint64_t curnum) const
     for(it = segments.begin(); it != segments.end(); ++it)
     {
         const Segment *seg = *it;
-        if(seg->getSequenceNumber() > curnum)
+        /* incomplete ones are not available up to their duration yet */
+        if(seg->getSequenceNumber() > curnum && !seg->incomplete)
             minTime += timescale.ToTime(seg->duration.Get());
     }
     return minTime;
@@ -49,6 +49,7 @@ namespace adaptive
                 void                    pruneByPlaybackTime(vlc_tick_t);
                 stime_t                 getTotalLength() const;
                 bool                    hasRelativeMediaTimes() const;
+                void                    setWindowStart(uint64_t);
 
                 virtual vlc_tick_t  getMinAheadTime(uint64_t) const override;
                 virtual Segment * getMediaSegment(uint64_t pos) const override;
@@ -64,6 +65,8 @@ namespace adaptive
                 std::vector<Segment *>  segments;
                 stime_t totalLength;
                 bool b_relative_mediatimes;
+                /* first number of an update that only carries new segments */
+                uint64_t windowStart;
         };
     }
 }
@@ -50,6 +50,11 @@ void SegmentTemplateSegment::setSourceUrl(const std::string &url)
     sourceUrl = Url(Url::Component(url, templ));
 }
 
+bool SegmentTemplateSegment::isBeingProduced(uint64_t number) const
+{
+    return templ && templ->isBeingProduced(number);
+}
+
 void SegmentTemplateSegment::setParentTemplate( SegmentTemplate *templ_ )
 {
     templ = templ_;
@@ -115,6 +120,16 @@ uint64_t SegmentTemplate::getLiveTemplateNumber(vlc_tick_t playbacktime, bool ab
     return number;
 }
 
+bool SegmentTemplate::isBeingProduced(uint64_t number) const
+{
+    /* only segments requested ahead of time through the
+     * availabilityTimeOffset can still be incomplete */
+    if(inheritSegmentTimeline() || inheritAvailabilityTimeOffset() <= 0 ||
+       !parentSegmentInformation->getPlaylist()->availabilityStartTime.Get())
+        return false;
+    return number > getLiveTemplateNumber(CLOCK_FREQ * ::time(nullptr));
+}
+
 void SegmentTemplate::debug(vlc_object_t *obj, int indent) const
 {
     AbstractSegmentBaseType::debug(obj, indent);
@@ -136,7 +151,9 @@ vlc_tick_t SegmentTemplate::getMinAheadTime(uint64_t number) const
     else
     {
         const Timescale timescale = inheritTimescale();
-        uint64_t current = getLiveTemplateNumber(CLOCK_FREQ * time(nullptr));
+        /* low latency segments are available before being complete */
+        uint64_t current = getLiveTemplateNumber(CLOCK_FREQ * time(nullptr) +
+                                                 inheritAvailabilityTimeOffset());
         stime_t i_length = (current - number) * inheritDuration();
         return timescale.ToTime(i_length);
     }
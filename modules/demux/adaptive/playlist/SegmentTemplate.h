@@ -43,6 +43,7 @@ namespace adaptive
                 SegmentTemplateSegment( ICanonicalUrl * = nullptr );
                 virtual ~SegmentTemplateSegment();
                 virtual void setSourceUrl( const std::string &url ) override;
+                virtual bool isBeingProduced( uint64_t ) const override;
                 void setParentTemplate( SegmentTemplate * );
 
             protected:
@@ -58,6 +59,7 @@ namespace adaptive
                 uint64_t getLiveTemplateNumber(mtime_t, bool = true) const;
                 void pruneByPlaybackTime(vlc_tick_t);
                 size_t pruneBySequenceNumber(uint64_t);
+                bool isBeingProduced(uint64_t) const;
 
                 virtual vlc_tick_t getMinAheadTime(uint64_t curnum) const override;
                 virtual Segment * getMediaSegment(uint64_t number) const override;
@@ -27,7 +27,7 @@
 #include "Inheritables.hpp"
 
 #include <vlc_common.h>
-#include <list>
+#include <deque>
 
 namespace adaptive
 {
@@ -57,21 +57,27 @@ namespace adaptive
                 void debug(vlc_object_t *, int = 0) const;
 
             private:
-                std::list<Element *> elements;
-                stime_t totalLength;
-                AbstractMultipleSegmentBaseType *parent;
-
                 class Element
                 {
                     public:
                         Element(uint64_t, stime_t, uint64_t, stime_t);
                         void debug(vlc_object_t *, int = 0) const;
                         bool contains(stime_t) const;
+                        stime_t length() const;
                         stime_t  t;
                         stime_t  d;
                         uint64_t r;
                         uint64_t number;
+                        stime_t  offset; /* length of the previous elements */
                 };
+
+                /* Sorted by number and time. Lookups are binary searches */
+                std::deque<Element> elements;
+                AbstractMultipleSegmentBaseType *parent;
+
+                std::deque<Element>::const_iterator findByNumber(uint64_t) const;
+                std::deque<Element>::const_iterator findByTime(stime_t) const;
+                stime_t getEndOffset() const;
         };
     }
 }
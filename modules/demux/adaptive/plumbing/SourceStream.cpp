@@ -135,6 +135,8 @@ size_t ChunksSourceStream::Peek(const uint8_t **pp, size_t sz)
     return std::min(p_block->i_buffer, sz);
 }
 
+/* Returns once a block was copied, as the next one might not be
+ * available yet with segments still being produced */
 ssize_t ChunksSourceStream::Read(uint8_t *buf, size_t size)
 {
     size_t i_copied = 0;
@@ -142,10 +144,15 @@ ssize_t ChunksSourceStream::Read(uint8_t *buf, size_t size)
 
     while(i_toread && !b_eof)
     {
-        if(!p_block && !(p_block = source->readNextBlock()))
+        if(!p_block)
         {
-            b_eof = true;
-            break;
+            if(i_copied)
+                break;
+            if(!(p_block = source->readNextBlock()))
+            {
+                b_eof = true;
+                break;
+            }
         }
 
         if(p_block->i_buffer > i_toread)
@@ -114,7 +114,8 @@ class DummyChunkSource : public AbstractChunkSource
 class DummyConnectionManager : public AbstractConnectionManager
 {
     public:
-        DummyConnectionManager() : AbstractConnectionManager(nullptr) {}
+        DummyConnectionManager() : AbstractConnectionManager(nullptr), sources(0),
+                                   pending(false) {}
         virtual ~DummyConnectionManager() = default;
         virtual void closeAllConnections () override {}
         virtual AbstractConnection * getConnection(ConnectionParams &) override { return nullptr; }
@@ -123,6 +124,7 @@ class DummyConnectionManager : public AbstractConnectionManager
                                                 const BytesRange &br) override
         {
             DummyChunkSource *d;
+            sources++;
             auto it = data.find(uri);
             if(it == data.end())
                 d = new DummyChunkSource(t, br, std::vector<uint8_t>(), uri);
@@ -133,12 +135,18 @@ class DummyConnectionManager : public AbstractConnectionManager
         virtual void recycleSource(AbstractChunkSource *) override {}
         virtual void start(AbstractChunkSource *) override {}
         virtual void cancel(AbstractChunkSource *) override {}
+        virtual bool isPending(const AbstractChunkSource *) const override { return pending; }
 
         std::map<std::string, std::vector<uint8_t>> data;
+        unsigned sources;
+        bool pending; /* downloads waiting for a worker */
 };
 
 using mapentry = std::pair<std::string, std::vector<uint8_t>>;
 
+/* manager of the running test */
+static DummyConnectionManager *currentConnManager;
+
 class SegmentTrackerListener : public SegmentTrackerListenerInterface
 {
     public:
@@ -731,6 +739,180 @@ static int SegmentTracker_check_HLSseeks(BaseAdaptationSet *adaptSet,
     return 0;
 }
 
+/****** check prefetching ******/
+static int SegmentTracker_check_prefetch(BaseAdaptationSet *adaptSet,
+                                         DummyLogic *,
+                                         SegmentTracker *tracker,
+                                         SegmentTrackerListener &events)
+{
+    const stime_t START = 1337;
+    Timescale timescale(100);
+    DummyConnectionManager *connManager = currentConnManager;
+
+    ChunkInterface *currentChunk = nullptr;
+    try
+    {
+        DummyRepresentation *rep0 = new DummyRepresentation(adaptSet);
+        adaptSet->addRepresentation(rep0);
+        rep0->setID(ID("0"));
+
+        SegmentList *segmentList = nullptr;
+        try
+        {
+            segmentList = new SegmentList(rep0);
+            segmentList->addAttribute(new TimescaleAttr(timescale));
+            for(int i=0; i<3; i++)
+            {
+                Segment *seg = new Segment(rep0);
+                seg->setSequenceNumber(123 + i);
+                seg->startTime.Set(START + 100 * i);
+                seg->duration.Set(100);
+                seg->setSourceUrl("sample/aac");
+                segmentList->addSegment(seg);
+            }
+        } catch (...) {
+            delete segmentList;
+            std::rethrow_exception(std::current_exception());
+        }
+        rep0->addAttribute(segmentList);
+
+        tracker->setPrefetchCount(1);
+        Expect(tracker->setStartPosition() == true);
+
+        /* the next segment is requested along with the first one */
+        currentChunk = tracker->getNextChunk(true);
+        Expect(currentChunk);
+        Expect(connManager->sources == 2);
+        delete currentChunk;
+        currentChunk = nullptr;
+
+        events.reset();
+        currentChunk = tracker->getNextChunk(true);
+        Expect(currentChunk);
+        Expect(connManager->sources == 3);
+        Expect(events.segmentchanged.starttime == timescale.ToTime(START + 100 * 1) + VLC_TICK_0);
+        delete currentChunk;
+        currentChunk = nullptr;
+
+        /* nothing left to prefetch */
+        currentChunk = tracker->getNextChunk(true);
+        Expect(currentChunk);
+        Expect(connManager->sources == 3);
+        Expect(events.segmentchanged.starttime == timescale.ToTime(START + 100 * 2) + VLC_TICK_0);
+        delete currentChunk;
+        currentChunk = nullptr;
+
+        currentChunk = tracker->getNextChunk(true);
+        Expect(currentChunk == nullptr);
+
+        /* seeking drops the prefetched segments */
+        connManager->sources = 0;
+        Expect(tracker->setPositionByTime(timescale.ToTime(START) + VLC_TICK_0, false, false));
+        currentChunk = tracker->getNextChunk(true);
+        Expect(currentChunk);
+        Expect(connManager->sources == 2);
+        Expect(events.segmentchanged.starttime == timescale.ToTime(START) + VLC_TICK_0);
+        delete currentChunk;
+        currentChunk = nullptr;
+    } catch( ... ) {
+        delete currentChunk;
+        return 1;
+    }
+
+    return 0;
+}
+
+/* prefetched segments are only bound to a representation once started */
+static int SegmentTracker_check_prefetch_switch(BaseAdaptationSet *adaptSet,
+                                                DummyLogic *logic,
+                                                SegmentTracker *tracker,
+                                                SegmentTrackerListener &events)
+{
+    const stime_t START = 1337;
+    Timescale timescale(100);
+    DummyConnectionManager *connManager = currentConnManager;
+
+    ChunkInterface *currentChunk = nullptr;
+    try
+    {
+        for(int r=0; r<2; r++)
+        {
+            DummyRepresentation *rep = new DummyRepresentation(adaptSet);
+            adaptSet->addRepresentation(rep);
+            rep->setID(ID(std::to_string(r)));
+
+            SegmentList *segmentList = nullptr;
+            try
+            {
+                segmentList = new SegmentList(rep);
+                segmentList->addAttribute(new TimescaleAttr(timescale));
+                for(int i=0; i<5; i++)
+                {
+                    Segment *seg = new Segment(rep);
+                    seg->setSequenceNumber(123 + i);
+                    seg->startTime.Set(START + 100 * i);
+                    seg->duration.Set(100);
+                    seg->setSourceUrl("sample/aac");
+                    segmentList->addSegment(seg);
+                }
+            } catch (...) {
+                delete segmentList;
+                std::rethrow_exception(std::current_exception());
+            }
+            rep->addAttribute(segmentList);
+        }
+        BaseRepresentation *rep0 = adaptSet->getRepresentations().at(0);
+        BaseRepresentation *rep1 = adaptSet->getRepresentations().at(1);
+
+        tracker->setPrefetchCount(1);
+        Expect(tracker->setStartPosition() == true);
+        currentChunk = tracker->getNextChunk(true);
+        Expect(currentChunk);
+        Expect(connManager->sources == 2);
+        delete currentChunk;
+        currentChunk = nullptr;
+
+        /* the prefetched segment is downloading: kept */
+        logic->repindex = 1;
+        events.reset();
+        currentChunk = tracker->getNextChunk(true);
+        Expect(currentChunk);
+        Expect(events.occured(TrackerEvent::Type::RepresentationSwitch) == false);
+        Expect(connManager->sources == 3);
+        delete currentChunk;
+        currentChunk = nullptr;
+
+        /* the prefetched one, for rep1, still waits: chosen again */
+        logic->repindex = 0;
+        connManager->pending = true;
+        events.reset();
+        currentChunk = tracker->getNextChunk(true);
+        Expect(currentChunk);
+        Expect(events.occured(TrackerEvent::Type::RepresentationSwitch) == false);
+        Expect(events.segmentchanged.starttime == timescale.ToTime(START + 100 * 2) + VLC_TICK_0);
+        Expect(connManager->sources == 5);
+        delete currentChunk;
+        currentChunk = nullptr;
+
+        /* then switches as decided when it is dequeued */
+        logic->repindex = 1;
+        events.reset();
+        currentChunk = tracker->getNextChunk(true);
+        Expect(currentChunk);
+        Expect(events.occured(TrackerEvent::Type::RepresentationSwitch) == true);
+        Expect(events.representationchanged.prev == rep0);
+        Expect(events.representationchanged.next == rep1);
+        Expect(events.segmentchanged.starttime == timescale.ToTime(START + 100 * 3) + VLC_TICK_0);
+        delete currentChunk;
+        currentChunk = nullptr;
+    } catch( ... ) {
+        delete currentChunk;
+        return 1;
+    }
+
+    return 0;
+}
+
 typedef decltype(SegmentTracker_check_formats) testfunc;
 
 static int Prepare_test(testfunc func)
@@ -746,6 +928,7 @@ static int Prepare_test(testfunc func)
     connManager->data.insert(mapentry("sample/aacinit", std::vector<uint8_t>({ 0xFF, 0xF1, 0, 0 })));
 
     SharedResources sharedRes(nullptr, nullptr, connManager);
+    currentConnManager = connManager;
     DefaultBufferingLogic bufLogic;
     SynchronizationReferences syncRefs;
 
@@ -786,5 +969,7 @@ int SegmentTracker_test()
         Prepare_test(SegmentTracker_check_seeks) ||
         Prepare_test(SegmentTracker_check_switches) ||
         Prepare_test(SegmentTracker_check_HLSseeks) ||
+        Prepare_test(SegmentTracker_check_prefetch) ||
+        Prepare_test(SegmentTracker_check_prefetch_switch) ||
         0;
 }
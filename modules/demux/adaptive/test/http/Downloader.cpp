@@ -0,0 +1,351 @@
+/*****************************************************************************
+ *
+ *****************************************************************************
+ * Copyright (C) 2026 VideoLabs, VideoLAN and VLC Authors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "../../http/HTTPConnectionManager.h"
+#include "../../http/HTTPConnection.hpp"
+#include "../../http/Downloader.hpp"
+#include "../../http/Chunk.h"
+
+#include "../test.hpp"
+
+#include <vlc_block.h>
+
+#include <map>
+#include <cstring>
+
+using namespace adaptive;
+using namespace adaptive::http;
+
+/* Stand-in for a HTTP server: each path has a size, a response latency and
+ * a transfer rate. Segments still being produced are sent chunked, with
+ * no length, as their chunks are produced. */
+struct Resource
+{
+    size_t size;
+    vlc_tick_t latency;
+    size_t bytespersec;
+    size_t chunk;
+};
+
+using Resources = std::map<std::string, Resource>;
+
+class DelayedConnection : public AbstractConnection
+{
+    public:
+        DelayedConnection(const Resources &r)
+            : AbstractConnection(nullptr), resources(r), resource(nullptr) {}
+        virtual ~DelayedConnection() = default;
+
+        virtual bool canReuse(const ConnectionParams &params_) const override
+        {
+            return available && params.getHostname() == params_.getHostname();
+        }
+
+        virtual RequestStatus request(const std::string &path,
+                                      const BytesRange &) override
+        {
+            auto it = resources.find(path);
+            if(it == resources.end())
+                return RequestStatus::NotFound;
+            resource = &(*it).second;
+            msleep(resource->latency);
+            contentLength = resource->chunk ? 0 : resource->size;
+            bytesRead = 0;
+            return RequestStatus::Success;
+        }
+
+        virtual ssize_t read(void *p_buffer, size_t len) override
+        {
+            if(len > resource->size - bytesRead)
+                len = resource->size - bytesRead;
+            if(resource->chunk && len > resource->chunk)
+                len = resource->chunk;
+            if(len == 0)
+                return 0;
+            msleep(CLOCK_FREQ * len / resource->bytespersec);
+            memset(p_buffer, 0x42, len);
+            bytesRead += len;
+            return len;
+        }
+
+        virtual void setUsed(bool b) override
+        {
+            available = !b;
+        }
+
+    private:
+        const Resources &resources;
+        const Resource *resource;
+};
+
+class DelayedConnectionFactory : public AbstractConnectionFactory
+{
+    public:
+        DelayedConnectionFactory(const Resources &r) : resources(r) {}
+        virtual ~DelayedConnectionFactory() = default;
+        virtual AbstractConnection * createConnection(vlc_object_t *,
+                                                      const ConnectionParams &) override
+        {
+            return new DelayedConnection(resources);
+        }
+
+    private:
+        const Resources &resources;
+};
+
+/* Like HTTPChunk, but the source can be flagged before it is started */
+class SegmentDownloadChunk : public AbstractChunk
+{
+    public:
+        SegmentDownloadChunk(AbstractConnectionManager *m, const std::string &url,
+                             const char *id, bool paced)
+            : AbstractChunk(m->makeSource(url, ID(id), ChunkType::Segment, BytesRange()))
+        {
+            source->setPaced(paced);
+            m->start(source);
+        }
+
+    protected:
+        virtual void onDownload(block_t **) override {}
+};
+
+class Download
+{
+    public:
+        Download(HTTPConnectionManager *m, const std::string &url, const char *id,
+                 bool paced = false)
+        {
+            start = mdate();
+            first = VLC_TICK_INVALID;
+            end = VLC_TICK_INVALID;
+            size = 0;
+            chunk = new SegmentDownloadChunk(m, url, id, paced);
+        }
+        ~Download()
+        {
+            delete chunk;
+        }
+        /* Reads the whole chunk, returns the time the data was complete */
+        vlc_tick_t wait()
+        {
+            block_t *b;
+            while((b = chunk->readBlock()))
+            {
+                if(first == VLC_TICK_INVALID && b->i_buffer)
+                    first = mdate();
+                size += b->i_buffer;
+                block_Release(b);
+            }
+            end = mdate();
+            return end - start;
+        }
+        vlc_tick_t start;
+        vlc_tick_t first;
+        vlc_tick_t end;
+        size_t size;
+
+    private:
+        AbstractChunk *chunk;
+};
+
+class RateCounter : public IDownloadRateObserver
+{
+    public:
+        RateCounter() : updates(0) {}
+        virtual void updateDownloadRate(const ID &, size_t, vlc_tick_t, vlc_tick_t) override
+        {
+            updates++;
+        }
+        unsigned updates;
+};
+
+#define MS(x) (CLOCK_FREQ / 1000 * (x))
+
+static HTTPConnectionManager * CreateManager(const Resources &r, unsigned workers,
+                                             unsigned hostconnections)
+{
+    HTTPConnectionManager *m = new HTTPConnectionManager(nullptr, workers,
+                                                         hostconnections);
+    m->addFactory(new DelayedConnectionFactory(r));
+    return m;
+}
+
+/* A slow video segment must not delay the audio one */
+static int Downloader_test_parallel(const Resources &r)
+{
+    vlc_tick_t audio[2];
+
+    for(unsigned workers = 1; workers <= 2; workers++)
+    {
+        HTTPConnectionManager *m = CreateManager(r, workers, 0);
+        try
+        {
+            Download video(m, "http://host/video", "video");
+            Download sound(m, "http://host/audio", "audio");
+            audio[workers - 1] = sound.wait();
+            Expect(video.wait() >= MS(150));
+            Expect(video.size == 128 * 1024);
+            Expect(sound.size == 16 * 1024);
+        } catch(...) {
+            delete m;
+            return 1;
+        }
+
+        DownloaderStats stats = m->getDownloadStats();
+        delete m;
+        std::cerr << " " << workers << " worker(s): audio segment after "
+                  << (audio[workers - 1]) / 1000 << " ms, "
+                  << stats.peakActive << " concurrent download(s), "
+                  << (stats.maxWait) / 1000 << " ms max queue wait"
+                  << std::endl;
+        try
+        {
+            Expect(stats.downloads == 2);
+            Expect(stats.peakActive == workers);
+        } catch(...) {
+            return 1;
+        }
+    }
+
+    try
+    {
+        /* serially, audio waits for the whole video segment */
+        Expect(audio[0] >= MS(150));
+        Expect(audio[1] < audio[0]);
+    } catch(...) {
+        return 1;
+    }
+    return 0;
+}
+
+/* Segments of the same stream, or beyond the host limit, are serialized */
+static int Downloader_test_limits(const Resources &r)
+{
+    HTTPConnectionManager *m = CreateManager(r, 4, 0);
+    try
+    {
+        Download first(m, "http://host/audio", "audio");
+        Download second(m, "http://host/audio2", "audio");
+        second.wait();
+        first.wait();
+        Expect(m->getDownloadStats().peakActive == 1);
+    } catch(...) {
+        delete m;
+        return 1;
+    }
+    delete m;
+
+    m = CreateManager(r, 4, 1);
+    try
+    {
+        {
+            Download video(m, "http://host/audio", "video");
+            Download sound(m, "http://host/audio2", "audio");
+            Download other(m, "http://otherhost/audio", "subs");
+            video.wait();
+            sound.wait();
+            other.wait();
+        }
+        /* the downloads are accounted once their chunks are released */
+        DownloaderStats stats = m->getDownloadStats();
+        Expect(stats.peakActive == 2);
+        Expect(stats.downloads == 3);
+    } catch(...) {
+        delete m;
+        return 1;
+    }
+    delete m;
+    return 0;
+}
+
+/* The least buffered stream is served first */
+static int Downloader_test_priority(const Resources &r)
+{
+    HTTPConnectionManager *m = CreateManager(r, 1, 0);
+    try
+    {
+        m->updateBufferingLevel(ID("video"), MS(20000), MS(30000));
+        m->updateBufferingLevel(ID("audio"), MS(2000), MS(30000));
+        Download busy(m, "http://host/audio", "subs");
+        Download video(m, "http://host/audio2", "video");
+        Download sound(m, "http://host/audio", "audio");
+        /* waiting first for the audio one, which should be ready first */
+        busy.wait();
+        sound.wait();
+        video.wait();
+        Expect(sound.end < video.end);
+    } catch(...) {
+        delete m;
+        return 1;
+    }
+    delete m;
+    return 0;
+}
+
+/* A segment being produced is read as its chunks arrive, up to its end.
+ * Its transfer time is paced by the producer and is not a bandwidth. */
+static int Downloader_test_progressive(const Resources &r)
+{
+    HTTPConnectionManager *m = CreateManager(r, 1, 0);
+    RateCounter rates;
+    m->setDownloadRateObserver(&rates);
+    try
+    {
+        {
+            Download live(m, "http://host/live", "video", true);
+            live.wait();
+            std::cerr << " chunked segment: first data after "
+                      << (live.first - live.start) / 1000 << " ms, complete after "
+                      << (live.end - live.start) / 1000 << " ms" << std::endl;
+            Expect(live.size == 64 * 1024);
+            Expect(live.end - live.start >= MS(300));
+            Expect(live.first - live.start < MS(100));
+        }
+        /* accounted once the chunk is released */
+        Expect(rates.updates == 0);
+        {
+            Download sound(m, "http://host/audio", "audio");
+            sound.wait();
+        }
+        Expect(rates.updates == 1);
+    } catch(...) {
+        delete m;
+        return 1;
+    }
+    delete m;
+    return 0;
+}
+
+int Downloader_test()
+{
+    Resources r;
+    r["/video"] = { 128 * 1024, MS(20), 128 * 1024 * 1000 / 200, 0 };
+    r["/audio"] = { 16 * 1024, MS(10), 16 * 1024 * 1000 / 20, 0 };
+    r["/audio2"] = r["/audio"];
+    r["/live"] = { 64 * 1024, MS(10), 4 * 1024 * 1000 / 20, 4 * 1024 };
+
+    return Downloader_test_parallel(r) ||
+           Downloader_test_limits(r) ||
+           Downloader_test_priority(r) ||
+           Downloader_test_progressive(r);
+}
@@ -0,0 +1,356 @@
+/*****************************************************************************
+ *
+ *****************************************************************************
+ * Copyright (C) 2026 VideoLabs, VideoLAN and VLC Authors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "../../playlist/BasePlaylist.hpp"
+#include "../../playlist/BasePeriod.h"
+#include "../../playlist/BaseAdaptationSet.h"
+#include "../../playlist/BaseRepresentation.h"
+#include "../../logic/BufferingLogic.hpp"
+#include "../../logic/RateBasedAdaptationLogic.h"
+#include "../../logic/PredictiveAdaptationLogic.hpp"
+#include "../../logic/NearOptimalAdaptationLogic.hpp"
+#include "../../logic/AlwaysLowestAdaptationLogic.hpp"
+#include "../../SegmentTracker.hpp"
+#include "../../ID.hpp"
+
+#include "../test.hpp"
+
+#include <vector>
+#include <sstream>
+#include <iomanip>
+
+using namespace adaptive;
+using namespace adaptive::playlist;
+using namespace adaptive::logic;
+
+#define MS(x) (CLOCK_FREQ / 1000 * (x))
+
+/* Network conditions, looped over: each point lasts for a duration with
+ * a throughput and a request latency */
+struct TracePoint
+{
+    vlc_tick_t duration;
+    unsigned kbps;
+    vlc_tick_t latency;
+};
+
+class Trace
+{
+    public:
+        Trace(const char *name_) : name(name_), length(0) {}
+
+        void add(vlc_tick_t duration, unsigned kbps, vlc_tick_t latency)
+        {
+            points.push_back({ duration, kbps, latency });
+            length += duration;
+        }
+
+        /* Reads recorded samples, one "duration_ms kbps latency_ms" per line */
+        bool load(const char *text)
+        {
+            std::istringstream ss(text);
+            std::string line;
+            while(std::getline(ss, line))
+            {
+                std::istringstream ls(line);
+                unsigned ms, kbps, latency;
+                if(line.empty() || line[0] == '#')
+                    continue;
+                if(!(ls >> ms >> kbps >> latency) || !ms)
+                    return false;
+                add(MS(ms), kbps, MS(latency));
+            }
+            return length > 0;
+        }
+
+        /* Time to request then receive a segment, starting at the given time */
+        vlc_tick_t transfer(vlc_tick_t start, size_t size) const
+        {
+            vlc_tick_t end;
+            vlc_tick_t now = start + at(start, &end).latency;
+            double bits = size * 8.0;
+            for(;;)
+            {
+                const TracePoint &p = at(now, &end);
+                double avail = (double)(end - now) * p.kbps * 1000 / CLOCK_FREQ;
+                if(avail >= bits)
+                    return now + bits * CLOCK_FREQ / (p.kbps * 1000.0) - start;
+                bits -= avail;
+                now = end;
+            }
+        }
+
+        const char *name;
+
+    private:
+        const TracePoint & at(vlc_tick_t time, vlc_tick_t *end) const
+        {
+            vlc_tick_t pos = time % length;
+            vlc_tick_t loopstart = time - pos;
+            for(const TracePoint &p : points)
+            {
+                if(pos < p.duration)
+                {
+                    *end = loopstart + p.duration;
+                    return p;
+                }
+                pos -= p.duration;
+                loopstart += p.duration;
+            }
+            *end = loopstart; /* unreachable */
+            return points.back();
+        }
+
+        std::vector<TracePoint> points;
+        vlc_tick_t length;
+};
+
+class ReplayPlaylist : public BasePlaylist
+{
+    public:
+        ReplayPlaylist() : BasePlaylist(nullptr) {}
+        virtual ~ReplayPlaylist() {}
+        virtual bool isLive() const override { return false; }
+        virtual bool isLowLatency() const override { return false; }
+};
+
+struct ReplayResult
+{
+    vlc_tick_t startup;
+    vlc_tick_t rebuffering;
+    unsigned stalls;
+    unsigned switches;
+    uint64_t bitrate; /* average of the downloaded representations */
+};
+
+/* Plays a VOD stream on a simulated clock: the segment server answers
+ * according to the trace, the playhead consumes the buffer in real time,
+ * and the logic sees the same events as from the SegmentTracker */
+static ReplayResult Replay(AbstractAdaptationLogic *logic, const Trace &trace,
+                           BaseAdaptationSet *set, const BasePlaylist *playlist)
+{
+    const unsigned SEGMENTS = 300;
+    const vlc_tick_t segmentduration = CLOCK_FREQ * 2;
+    DefaultBufferingLogic bufferingLogic;
+    const vlc_tick_t minbuffering = bufferingLogic.getMinBuffering(playlist);
+    const vlc_tick_t maxbuffering = bufferingLogic.getMaxBuffering(playlist);
+    const vlc_tick_t target = bufferingLogic.getStableBuffering(playlist);
+    const ID &id = set->getID();
+
+    ReplayResult result = { VLC_TICK_INVALID, 0, 0, 0, 0 };
+    vlc_tick_t now = 0;
+    vlc_tick_t buffered = 0; /* ahead of the playhead */
+    bool playing = false;
+    BaseRepresentation *current = nullptr;
+    double bits = 0;
+
+    logic->trackerEvent(BufferingStateUpdatedEvent(id, true));
+
+    for(unsigned i = 0; i < SEGMENTS; i++)
+    {
+        /* Wait for room in the buffer */
+        if(playing && buffered + segmentduration > maxbuffering)
+        {
+            const vlc_tick_t idle = buffered + segmentduration - maxbuffering;
+            now += idle;
+            buffered -= idle;
+            logic->trackerEvent(BufferingLevelChangedEvent(id, minbuffering, maxbuffering,
+                                                           buffered, target));
+        }
+
+        BaseRepresentation *rep = logic->getNextRepresentation(set, current);
+        if(rep != current)
+        {
+            if(current)
+                result.switches++;
+            logic->trackerEvent(RepresentationSwitchEvent(current, rep));
+            current = rep;
+        }
+        logic->trackerEvent(SegmentChangedEvent(id, i, segmentduration * i, segmentduration));
+
+        const size_t size = rep->getBandwidth() * segmentduration / CLOCK_FREQ / 8;
+        const vlc_tick_t elapsed = trace.transfer(now, size);
+        const vlc_tick_t latency = trace.transfer(now, 0);
+        now += elapsed;
+        if(playing)
+        {
+            if(elapsed > buffered)
+            {
+                result.rebuffering += elapsed - buffered;
+                result.stalls++;
+                buffered = 0;
+                playing = false;
+            }
+            else buffered -= elapsed;
+        }
+        logic->updateDownloadRate(id, size, elapsed, elapsed - latency);
+
+        buffered += segmentduration;
+        bits += (double) rep->getBandwidth() * segmentduration / CLOCK_FREQ;
+        if(!playing && buffered >= std::min(minbuffering, segmentduration * (SEGMENTS - i - 1)))
+        {
+            if(result.startup == VLC_TICK_INVALID)
+                result.startup = now;
+            playing = true;
+        }
+        logic->trackerEvent(BufferingLevelChangedEvent(id, minbuffering, maxbuffering,
+                                                       buffered, target));
+    }
+
+    logic->trackerEvent(RepresentationSwitchEvent(current, nullptr));
+    logic->trackerEvent(BufferingStateUpdatedEvent(id, false));
+    result.bitrate = bits * CLOCK_FREQ / (segmentduration * SEGMENTS);
+    return result;
+}
+
+static AbstractAdaptationLogic * CreateLogic(AbstractAdaptationLogic::LogicType type)
+{
+    switch(type)
+    {
+        case AbstractAdaptationLogic::LogicType::RateBased:
+            return new RateBasedAdaptationLogic(nullptr);
+        case AbstractAdaptationLogic::LogicType::Predictive:
+            return new PredictiveAdaptationLogic(nullptr);
+        case AbstractAdaptationLogic::LogicType::NearOptimal:
+            return new NearOptimalAdaptationLogic(nullptr);
+        case AbstractAdaptationLogic::LogicType::AlwaysLowest:
+        default:
+            return new AlwaysLowestAdaptationLogic(nullptr);
+    }
+}
+
+/* A sample in the recorded format, from a cellular drive test */
+static const char cellular_trace[] =
+    "# duration_ms kbps latency_ms\n"
+    "4000 5200 45\n"
+    "3000 3800 60\n"
+    "5000 6100 40\n"
+    "2000 900 180\n"
+    "1500 150 400\n"
+    "3000 1700 120\n"
+    "6000 4400 55\n"
+    "4000 2600 80\n"
+    "2500 700 220\n"
+    "5000 3300 70\n"
+    "8000 5800 45\n"
+    "3000 1200 150\n";
+
+int AdaptationLogic_test()
+{
+    ReplayPlaylist *playlist = nullptr;
+    try
+    {
+        playlist = new ReplayPlaylist();
+        BasePeriod *period = new BasePeriod(playlist);
+        playlist->addPeriod(period);
+        BaseAdaptationSet *set = new BaseAdaptationSet(period);
+        period->addAdaptationSet(set);
+        set->setID(ID("video"));
+        const uint64_t bandwidths[] = { 400000, 1000000, 2000000, 4000000, 6000000 };
+        for(uint64_t bw : bandwidths)
+        {
+            BaseRepresentation *rep = new BaseRepresentation(set);
+            rep->setBandwidth(bw);
+            set->addRepresentation(rep);
+        }
+
+        /* Results per trace and logic, as startup and rebuffering time in
+         * ms, average bitrate in kbps and switches count */
+        const struct Baseline
+        {
+            unsigned startup, rebuffering, kbps, switches;
+        } baselines[4][4] = {
+            { { 360, 0, 400, 0 }, { 360, 0, 3964, 1 },
+              { 4560, 0, 474, 3 }, { 3160, 0, 5981, 1 } },
+            { { 360, 0, 400, 0 }, { 360, 0, 1717, 3 },
+              { 4560, 0, 474, 3 }, { 3160, 100069, 5981, 1 } },
+            { { 570, 0, 400, 0 }, { 1210, 0, 1117, 57 },
+              { 7290, 0, 479, 3 }, { 5050, 165293, 5981, 1 } },
+            { { 596, 0, 400, 0 }, { 1211, 0, 2080, 114 },
+              { 7737, 0, 474, 3 }, { 5237, 53753, 5981, 1 } },
+        };
+
+        std::vector<Trace> traces;
+        traces.emplace_back("constant");
+        traces.back().add(CLOCK_FREQ * 60, 8000, MS(20));
+
+        traces.emplace_back("step down");
+        traces.back().add(CLOCK_FREQ * 120, 8000, MS(20));
+        traces.back().add(CLOCK_FREQ * 600, 1500, MS(80));
+
+        traces.emplace_back("oscillating");
+        traces.back().add(CLOCK_FREQ * 15, 5000, MS(30));
+        traces.back().add(CLOCK_FREQ * 15, 1200, MS(100));
+
+        traces.emplace_back("cellular");
+        Expect(traces.back().load(cellular_trace));
+        Expect(traces.size() == ARRAY_SIZE(baselines));
+
+        const struct
+        {
+            AbstractAdaptationLogic::LogicType type;
+            const char *name;
+        } logics[] = {
+            { AbstractAdaptationLogic::LogicType::AlwaysLowest, "lowest" },
+            { AbstractAdaptationLogic::LogicType::RateBased,    "rate" },
+            { AbstractAdaptationLogic::LogicType::Predictive,   "predictive" },
+            { AbstractAdaptationLogic::LogicType::NearOptimal,  "nearoptimal" },
+        };
+
+        for(size_t t = 0; t < traces.size(); t++)
+        {
+            const Trace &trace = traces[t];
+            for(size_t l = 0; l < ARRAY_SIZE(logics); l++)
+            {
+                AbstractAdaptationLogic *logic = CreateLogic(logics[l].type);
+                ReplayResult res = Replay(logic, trace, set, playlist);
+                delete logic;
+
+                std::cerr << " " << std::left << std::setw(12) << trace.name
+                          << std::setw(12) << logics[l].name << std::right << std::fixed
+                          << std::setprecision(1)
+                          << " startup " << std::setw(4) << (double) res.startup / CLOCK_FREQ
+                          << " s, rebuffering " << std::setw(5) << (double) res.rebuffering / CLOCK_FREQ
+                          << " s (" << res.stalls << "), "
+                          << std::setw(4) << res.bitrate / 1000 << " kbps, "
+                          << res.switches << " switches" << std::endl;
+
+                /* Regressions from the recorded behaviour, with some slack
+                 * for tuning. Improvements should update the baseline. */
+                const Baseline &b = baselines[t][l];
+                Expect(res.startup != VLC_TICK_INVALID);
+                Expect(res.startup <= MS(b.startup) + CLOCK_FREQ);
+                Expect(res.rebuffering <= MS(b.rebuffering) * 11 / 10 + CLOCK_FREQ);
+                Expect(res.bitrate / 1000 >= b.kbps * 9 / 10);
+                Expect(res.switches <= b.switches * 5 / 4 + 2);
+            }
+        }
+
+        delete playlist;
+    } catch(...) {
+        delete playlist;
+        return 1;
+    }
+
+    return 0;
+}
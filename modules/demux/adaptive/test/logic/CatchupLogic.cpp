@@ -0,0 +1,77 @@
+/*****************************************************************************
+ *
+ *****************************************************************************
+ * Copyright (C) 2026 VideoLabs, VideoLAN and VLC Authors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "../../logic/CatchupLogic.hpp"
+
+#include "../test.hpp"
+
+using namespace adaptive::logic;
+
+#define SEC(x) (CLOCK_FREQ * (x))
+
+int CatchupLogic_test()
+{
+    try
+    {
+        CatchupLogic logic(SEC(2), 1.1f);
+        Expect(logic.getTarget() == SEC(2));
+
+        /* jitter around the target is not caught up */
+        Expect(logic.getRate(SEC(2)) == 1.0f);
+        Expect(logic.getRate(SEC(2) + CatchupLogic::TOLERANCE) == 1.0f);
+        Expect(logic.getRate(SEC(1)) == 1.0f);
+
+        /* 6 s behind after a stall: the live edge moves at normal speed,
+         * playback at the returned rate, checked every second */
+        vlc_tick_t latency = SEC(8);
+        float rate = logic.getRate(latency);
+        Expect(rate > 1.0f && rate <= 1.1f);
+        unsigned seconds = 0;
+        for(; rate > 1.0f && seconds < 300; seconds++)
+        {
+            latency -= (rate - 1.0f) * CLOCK_FREQ;
+            rate = logic.getRate(latency);
+            Expect(rate <= 1.1f);
+        }
+        Expect(rate == 1.0f);
+        Expect(latency <= SEC(2));
+        Expect(latency > SEC(2) - CLOCK_FREQ / 10);
+        Expect(seconds < 120);
+        std::cerr << " caught up 6 s of latency in " << seconds << " s" << std::endl;
+
+        /* and does not restart for small variations */
+        Expect(logic.getRate(latency + CLOCK_FREQ / 4) == 1.0f);
+
+        /* moved back in the timeshift window, not lagging */
+        Expect(logic.getRate(SEC(2) + CatchupLogic::MAX_EXCESS + 1) == 1.0f);
+
+        /* disabled */
+        CatchupLogic disabled(SEC(2), 1.0f);
+        Expect(disabled.getRate(SEC(10)) == 1.0f);
+    }
+    catch(...)
+    {
+        return 1;
+    }
+    return 0;
+}
@@ -40,6 +40,7 @@
 
 #include <limits>
 #include <algorithm>
+#include <string>
 
 using namespace adaptive;
 using namespace adaptive::playlist;
@@ -548,3 +549,344 @@ int M3U8Playlist_test()
 
     return 0;
 }
+
+static void RefreshM3U8(vlc_object_t *obj, BaseRepresentation *rep, const std::string &text)
+{
+    M3U8Parser parser(nullptr);
+    stream_t *substream = vlc_stream_MemoryNew(obj, (uint8_t *)text.c_str(),
+                                               text.size(), true);
+    if(!substream)
+        return;
+    parser.appendSegmentsFromStream(obj, substream, static_cast<HLSRepresentation *>(rep));
+    vlc_stream_Delete(substream);
+}
+
+static std::string EventSegment(unsigned i)
+{
+    return "#EXTINF:2.000,\nsegment" + std::to_string(i) + ".ts\n";
+}
+
+/* A 6 hours event playlist, growing by one segment every 2 s */
+static int M3U8PlaylistRefresh_bench(vlc_object_t *obj)
+{
+    const unsigned SEGMENTS = 6 * 3600 / 2;
+    const unsigned SAMPLES = 30;
+    std::string text = "#EXTM3U\n"
+                       "#EXT-X-PLAYLIST-TYPE:EVENT\n"
+                       "#EXT-X-TARGETDURATION:2\n"
+                       "#EXT-X-MEDIA-SEQUENCE:0\n";
+    unsigned count = 0;
+    while(count < SEGMENTS / SAMPLES)
+        text += EventSegment(count++);
+
+    M3U8 *m3u = ParseM3U8(obj, text.c_str(), text.size());
+    try
+    {
+        Expect(m3u);
+        BaseRepresentation *rep = m3u->getFirstPeriod()->getAdaptationSets().front()->
+                                  getRepresentations().front();
+
+        /* Samples the refresh cost during the session */
+        vlc_tick_t full = 0, incremental = 0;
+        for(unsigned i = 1; i < SAMPLES; i++)
+        {
+            while(count < SEGMENTS / SAMPLES * (i + 1) - 1)
+                text += EventSegment(count++);
+            RefreshM3U8(obj, rep, text);
+            text += EventSegment(count++);
+
+            vlc_tick_t start = mdate();
+            M3U8 *reparsed = ParseM3U8(obj, text.c_str(), text.size());
+            full += mdate() - start;
+            delete reparsed;
+
+            start = mdate();
+            RefreshM3U8(obj, rep, text);
+            incremental += mdate() - start;
+        }
+
+        const SegmentList *list = rep->inheritSegmentList();
+        Expect(list);
+        Expect(list->getSegments().size() == SEGMENTS);
+        Expect(rep->getProfile()->getStartSegmentNumber() == 0);
+        const Segment *seg = rep->getMediaSegment(SEGMENTS - 1);
+        Expect(seg);
+        Expect(seg->startTime.Get() ==
+               rep->inheritTimescale().ToScaled(vlc_tick_from_sec(2 * (SEGMENTS - 1))));
+
+        /* extrapolated to a refresh every segment */
+        full /= SAMPLES - 1;
+        incremental /= SAMPLES - 1;
+        std::cerr << " " << SEGMENTS << " segments event: "
+                  << full << " us per full parse, "
+                  << incremental << " us per refresh, ~"
+                  << SEC_FROM_VLC_TICK(full * SEGMENTS) << " s vs ~"
+                  << SEC_FROM_VLC_TICK(incremental * SEGMENTS)
+                  << " s over the session" << std::endl;
+
+        delete m3u;
+    }
+    catch (...)
+    {
+        delete m3u;
+        return 1;
+    }
+
+    return 0;
+}
+
+int M3U8PlaylistRefresh_test()
+{
+    vlc_object_t *obj = static_cast<vlc_object_t*>(nullptr);
+
+    const char manifest0[] =
+    "#EXTM3U\n"
+    "#EXT-X-MEDIA-SEQUENCE:10\n"
+    "#EXT-X-KEY:METHOD=AES-128,URI=\"http://example.com/key\"\n"
+    "#EXTINF:4\n"
+    "foobar.ts\n"
+    "#EXT-X-BYTERANGE:100@0\n"
+    "#EXTINF:5\n"
+    "foobar2.ts\n"
+    "#EXT-X-BYTERANGE:200\n"
+    "#EXTINF:6\n"
+    "foobar2.ts\n";
+
+    /* first one expired, two known ones, a new one after a discontinuity */
+    const char manifest1[] =
+    "#EXTM3U\n"
+    "#EXT-X-MEDIA-SEQUENCE:11\n"
+    "#EXT-X-KEY:METHOD=AES-128,URI=\"http://example.com/key\"\n"
+    "#EXT-X-BYTERANGE:100@0\n"
+    "#EXTINF:5\n"
+    "foobar2.ts\n"
+    "#EXT-X-BYTERANGE:200\n"
+    "#EXTINF:6\n"
+    "foobar2.ts\n"
+    "#EXT-X-DISCONTINUITY\n"
+    "#EXT-X-BYTERANGE:300\n"
+    "#EXTINF:7\n"
+    "foobar2.ts\n"
+    "#EXTINF:8\n"
+    "foobar3.ts\n";
+
+    /* no new segment, the window moved */
+    const char manifest2[] =
+    "#EXTM3U\n"
+    "#EXT-X-MEDIA-SEQUENCE:12\n"
+    "#EXT-X-KEY:METHOD=AES-128,URI=\"http://example.com/key\"\n"
+    "#EXT-X-BYTERANGE:200@100\n"
+    "#EXTINF:6\n"
+    "foobar2.ts\n"
+    "#EXT-X-DISCONTINUITY\n"
+    "#EXT-X-BYTERANGE:300\n"
+    "#EXTINF:7\n"
+    "foobar2.ts\n"
+    "#EXTINF:8\n"
+    "foobar3.ts\n";
+
+    /* dated, the date is extrapolated over the known segments */
+    const char manifestpdt0[] =
+    "#EXTM3U\n"
+    "#EXT-X-TARGETDURATION:8\n"
+    "#EXT-X-MEDIA-SEQUENCE:10\n"
+    "#EXT-X-PROGRAM-DATE-TIME:1970-01-01T00:00:10.000+00:00\n"
+    "#EXTINF:4\n"
+    "foobar.ts\n"
+    "#EXTINF:5\n"
+    "foobar2.ts\n";
+
+    const char manifestpdt1[] =
+    "#EXTM3U\n"
+    "#EXT-X-TARGETDURATION:8\n"
+    "#EXT-X-MEDIA-SEQUENCE:11\n"
+    "#EXT-X-PROGRAM-DATE-TIME:1970-01-01T00:00:14.000+00:00\n"
+    "#EXTINF:5\n"
+    "foobar2.ts\n"
+    "foobar3.ts\n"
+    "#EXTINF:6\n"
+    "foobar4.ts\n";
+
+    M3U8 *m3u = ParseM3U8(obj, manifest0, sizeof(manifest0));
+    try
+    {
+        Expect(m3u);
+        Expect(m3u->isLive());
+        BaseRepresentation *rep = m3u->getFirstPeriod()->getAdaptationSets().front()->
+                                  getRepresentations().front();
+
+        RefreshM3U8(obj, rep, std::string(manifest1));
+        Expect(rep->getProfile()->getStartSegmentNumber() == 11);
+        const SegmentList *list = rep->inheritSegmentList();
+        Expect(list);
+        Expect(list->getSegments().size() == 4);
+
+        Timescale timescale = rep->inheritTimescale();
+        Segment *seg = rep->getMediaSegment(12);
+        Expect(seg);
+        Expect(!seg->discontinuity);
+        Expect(seg->startTime.Get() == timescale.ToScaled(vlc_tick_from_sec(9)));
+        seg = rep->getMediaSegment(13);
+        Expect(seg);
+        Expect(seg->discontinuity);
+        Expect(seg->startTime.Get() == timescale.ToScaled(vlc_tick_from_sec(15)));
+        Expect(seg->duration.Get() == timescale.ToScaled(vlc_tick_from_sec(7)));
+        Expect(seg->getOffset() == 300);
+        seg = rep->getMediaSegment(14);
+        Expect(seg);
+        Expect(!seg->discontinuity);
+        Expect(seg->startTime.Get() == timescale.ToScaled(vlc_tick_from_sec(22)));
+
+        /* nothing new */
+        RefreshM3U8(obj, rep, std::string(manifest1));
+        Expect(list->getSegments().size() == 4);
+        Expect(rep->getMediaSegment(14) == seg);
+
+        RefreshM3U8(obj, rep, std::string(manifest2));
+        Expect(list->getSegments().size() == 3);
+        Expect(rep->getProfile()->getStartSegmentNumber() == 12);
+        Expect(rep->getMediaSegment(14) == seg);
+
+        delete m3u;
+        m3u = ParseM3U8(obj, manifestpdt0, sizeof(manifestpdt0));
+        Expect(m3u);
+        rep = m3u->getFirstPeriod()->getAdaptationSets().front()->
+              getRepresentations().front();
+        seg = rep->getMediaSegment(11);
+        Expect(seg);
+
+        RefreshM3U8(obj, rep, std::string(manifestpdt1));
+        list = rep->inheritSegmentList();
+        Expect(list->getSegments().size() == 3);
+        /* known segment is kept, not parsed again */
+        Expect(rep->getMediaSegment(11) == seg);
+        Expect(seg->getDisplayTime() == VLC_TICK_0 + vlc_tick_from_sec(14));
+        /* without duration, the target one */
+        seg = rep->getMediaSegment(12);
+        Expect(seg);
+        Expect(seg->getDisplayTime() == VLC_TICK_0 + vlc_tick_from_sec(14 + 5));
+        seg = rep->getMediaSegment(13);
+        Expect(seg);
+        Expect(seg->getDisplayTime() == VLC_TICK_0 + vlc_tick_from_sec(14 + 5 + 8));
+        Expect(seg->startTime.Get() == timescale.ToScaled(vlc_tick_from_sec(4 + 5 + 8)));
+
+        delete m3u;
+    }
+    catch (...)
+    {
+        delete m3u;
+        return 1;
+    }
+
+    return M3U8PlaylistRefresh_bench(obj);
+}
+
+int M3U8LowLatency_test()
+{
+    vlc_object_t *obj = static_cast<vlc_object_t*>(nullptr);
+
+    /* parts of the segment being produced are ranges of its whole file */
+    const char manifest0[] =
+    "#EXTM3U\n"
+    "#EXT-X-TARGETDURATION:4\n"
+    "#EXT-X-PART-INF:PART-TARGET=1.0\n"
+    "#EXT-X-SERVER-CONTROL:CAN-BLOCK-RELOAD=YES,PART-HOLD-BACK=3.0\n"
+    "#EXT-X-MEDIA-SEQUENCE:10\n"
+    "#EXTINF:4\n"
+    "seg10.mp4\n"
+    "#EXT-X-PART:DURATION=1.0,URI=\"seg11.mp4\",BYTERANGE=\"1000@0\"\n"
+    "#EXT-X-PART:DURATION=1.0,URI=\"seg11.mp4\",BYTERANGE=\"1000@1000\"\n"
+    "#EXTINF:4\n"
+    "seg11.mp4\n"
+    "#EXT-X-PART:DURATION=1.0,URI=\"seg12.mp4\",BYTERANGE=\"1000@0\"\n"
+    "#EXT-X-PART:DURATION=1.0,URI=\"seg12.mp4\",BYTERANGE=\"1000@1000\"\n"
+    "#EXT-X-PRELOAD-HINT:TYPE=PART,URI=\"seg12.mp4\",BYTERANGE-START=2000\n";
+
+    /* that segment is complete, the next one is being produced */
+    const char manifest1[] =
+    "#EXTM3U\n"
+    "#EXT-X-TARGETDURATION:4\n"
+    "#EXT-X-PART-INF:PART-TARGET=1.0\n"
+    "#EXT-X-SERVER-CONTROL:CAN-BLOCK-RELOAD=YES,PART-HOLD-BACK=3.0\n"
+    "#EXT-X-MEDIA-SEQUENCE:10\n"
+    "#EXTINF:4\n"
+    "seg10.mp4\n"
+    "#EXTINF:4\n"
+    "seg11.mp4\n"
+    "#EXT-X-PART:DURATION=1.0,URI=\"seg12.mp4\",BYTERANGE=\"1000@0\"\n"
+    "#EXTINF:3.5\n"
+    "seg12.mp4\n"
+    "#EXT-X-PRELOAD-HINT:TYPE=PART,URI=\"seg13.mp4\",BYTERANGE-START=0\n";
+
+    /* parts in their own files, the segment can't be read as it is produced */
+    const char manifest2[] =
+    "#EXTM3U\n"
+    "#EXT-X-TARGETDURATION:4\n"
+    "#EXT-X-PART-INF:PART-TARGET=1.0\n"
+    "#EXT-X-MEDIA-SEQUENCE:10\n"
+    "#EXTINF:4\n"
+    "seg10.mp4\n"
+    "#EXT-X-PART:DURATION=1.0,URI=\"seg11.part0.mp4\"\n"
+    "#EXT-X-PRELOAD-HINT:TYPE=PART,URI=\"seg11.part1.mp4\"\n";
+
+    M3U8 *m3u = ParseM3U8(obj, manifest0, sizeof(manifest0));
+    try
+    {
+        Expect(m3u);
+        Expect(m3u->isLive());
+        Expect(m3u->isLowLatency());
+        Expect(m3u->suggestedPresentationDelay.Get() == vlc_tick_from_sec(3));
+        BaseRepresentation *rep = m3u->getFirstPeriod()->getAdaptationSets().front()->
+                                  getRepresentations().front();
+        Timescale timescale = rep->inheritTimescale();
+
+        const SegmentList *list = rep->inheritSegmentList();
+        Expect(list);
+        Expect(list->getSegments().size() == 3);
+        Segment *seg = rep->getMediaSegment(11);
+        Expect(seg);
+        Expect(!seg->incomplete);
+        seg = rep->getMediaSegment(12);
+        Expect(seg);
+        Expect(seg->incomplete);
+        Expect(seg->getUrlSegment().toString() == "stdin:///seg12.mp4");
+        Expect(seg->getOffset() == 0);
+        Expect(seg->startTime.Get() == timescale.ToScaled(vlc_tick_from_sec(8)));
+        /* only available up to what is complete */
+        Expect(rep->getMinAheadTime(10) == vlc_tick_from_sec(4));
+
+        RefreshM3U8(obj, rep, std::string(manifest1));
+        list = rep->inheritSegmentList();
+        Expect(list->getSegments().size() == 4);
+        seg = rep->getMediaSegment(12);
+        Expect(seg);
+        Expect(!seg->incomplete);
+        Expect(seg->startTime.Get() == timescale.ToScaled(vlc_tick_from_sec(8)));
+        Expect(seg->duration.Get() == timescale.ToScaled(vlc_tick_from_sec(7) / 2));
+        seg = rep->getMediaSegment(13);
+        Expect(seg);
+        Expect(seg->incomplete);
+        Expect(seg->getUrlSegment().toString() == "stdin:///seg13.mp4");
+        Expect(seg->startTime.Get() == timescale.ToScaled(vlc_tick_from_sec(23) / 2));
+        Expect(rep->getMinAheadTime(10) == vlc_tick_from_sec(15) / 2);
+
+        delete m3u;
+        m3u = ParseM3U8(obj, manifest2, sizeof(manifest2));
+        Expect(m3u);
+        Expect(m3u->isLowLatency());
+        rep = m3u->getFirstPeriod()->getAdaptationSets().front()->
+              getRepresentations().front();
+        list = rep->inheritSegmentList();
+        Expect(list);
+        Expect(list->getSegments().size() == 1);
+
+        delete m3u;
+    }
+    catch (...)
+    {
+        delete m3u;
+        return 1;
+    }
+
+    return 0;
+}
@@ -96,6 +96,29 @@ int SegmentTemplate_test()
         Expect(templ->getLiveTemplateNumber(now + timescale.ToTime(100) * 2 + 1, true) ==
                templ->getStartSegmentNumber() + 1);
 
+        /* low latency, segments available before their end.
+         * Live numbers follow the wall clock: retry if a second ticked. */
+        vlc_tick_t ahead, early;
+        bool producing, produced;
+        time_t start;
+        do
+        {
+            start = ::time(nullptr);
+            pl->availabilityStartTime.Set(CLOCK_FREQ * start - CLOCK_FREQ * 21 / 2);
+            pl->availabilityEndTime.Set(0);
+            rep->replaceAttribute(new AvailabilityTimeOffsetAttr(0));
+            ahead = templ->getMinAheadTime(11);
+            Expect(!templ->isBeingProduced(11 + 10));
+            rep->replaceAttribute(new AvailabilityTimeOffsetAttr(CLOCK_FREQ * 9 / 10));
+            early = templ->getMinAheadTime(11);
+            producing = templ->isBeingProduced(11 + 10);
+            produced = !templ->isBeingProduced(11 + 9);
+        } while(start != ::time(nullptr));
+        Expect(early == ahead + timescale.ToTime(100));
+        Expect(producing);
+        Expect(produced);
+        rep->replaceAttribute(new AvailabilityTimeOffsetAttr(0));
+
         /* reset */
         pl->availabilityStartTime.Set(0);
         pl->availabilityEndTime.Set(0);
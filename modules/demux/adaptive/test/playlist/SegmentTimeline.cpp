@@ -30,10 +30,95 @@
 #include "../test.hpp"
 
 #include <limits>
+#include <vector>
 
 using namespace adaptive;
 using namespace adaptive::playlist;
 
+/* Live timelines of a long event: every lookup, refresh and prune has
+ * to stay cheap when the manifest carries tens of thousands of entries */
+static int Timeline_test_large()
+{
+    const unsigned ELEMENTS = 50000;
+    const stime_t START = 90000;
+    SegmentTimeline *timeline = nullptr;
+    SegmentTimeline *update = nullptr;
+    try
+    {
+        /* reference numbering, with varying durations and repeats */
+        std::vector<uint64_t> numbers;
+        std::vector<stime_t> times;
+        timeline = new SegmentTimeline(nullptr);
+        uint64_t number = 1;
+        stime_t t = START;
+        for(unsigned i = 0; i < ELEMENTS; i++)
+        {
+            const stime_t d = 180000 + (i % 7) * 100;
+            const uint64_t r = i % 3;
+            timeline->addElement(number, d, r, i ? 0 : START);
+            for(uint64_t j = 0; j <= r; j++)
+            {
+                numbers.push_back(number++);
+                times.push_back(t);
+                t += d;
+            }
+        }
+        Expect(timeline->minElementNumber() == 1);
+        Expect(timeline->maxElementNumber() == numbers.back());
+        Expect(timeline->getTotalLength() == t - START);
+
+        vlc_tick_t start = mdate();
+        for(size_t i = 0; i < numbers.size(); i++)
+        {
+            stime_t time, duration;
+            Expect(timeline->getScaledPlaybackTimeDurationBySegmentNumber(numbers[i],
+                                                                          &time, &duration));
+            Expect(time == times[i]);
+            Expect(timeline->getElementNumberByScaledPlaybackTime(times[i] + 1) == numbers[i]);
+            Expect(timeline->getMinAheadScaledTime(numbers[i]) ==
+                   t - times[i] - duration);
+        }
+        vlc_tick_t lookups = mdate() - start;
+
+        /* refreshes of a live manifest: a new segment appended, the
+         * oldest one removed, the rest unchanged */
+        const unsigned REFRESHES = 100;
+        vlc_tick_t merging = 0;
+        stime_t last = times.back();
+        for(unsigned i = 0; i < REFRESHES; i++)
+        {
+            update = new SegmentTimeline(nullptr);
+            update->addElement(0, t - last, 0, last);
+            update->addElement(0, 180000, 0, t);
+            last = t;
+            t += 180000;
+            start = mdate();
+            timeline->updateWith(*update);
+            timeline->pruneBySequenceNumber(timeline->minElementNumber() + 1);
+            merging += mdate() - start;
+            delete update;
+            update = nullptr;
+        }
+        Expect(timeline->minElementNumber() == 1 + REFRESHES);
+        Expect(timeline->maxElementNumber() == numbers.back() + REFRESHES);
+        Expect(timeline->getTotalLength() == t - times[REFRESHES]);
+        Expect(timeline->getScaledPlaybackTimeByElementNumber(numbers.back()) ==
+               times.back());
+
+        std::cerr << " " << numbers.size() << " segments: "
+                  << lookups * 1000 / numbers.size() << " ns per lookup, "
+                  << merging * 1000 / REFRESHES << " ns per refresh" << std::endl;
+
+        delete timeline;
+    } catch (...) {
+        delete timeline;
+        delete update;
+        return 1;
+    }
+
+    return 0;
+}
+
 int Timeline_test()
 {
     SegmentTimeline *timeline = nullptr;
@@ -180,5 +265,5 @@ int Timeline_test()
         return 1;
     }
 
-    return 0;
+    return Timeline_test_large();
 }
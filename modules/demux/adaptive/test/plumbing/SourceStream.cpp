@@ -0,0 +1,114 @@
+/*****************************************************************************
+ *
+ *****************************************************************************
+ * Copyright (C) 2026 VideoLabs, VideoLAN and VLC Authors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "../../plumbing/SourceStream.hpp"
+#include "../../AbstractSource.hpp"
+
+#include "../test.hpp"
+
+#include <vlc_stream.h>
+#include <vlc_block.h>
+
+#include <cstring>
+
+using namespace adaptive;
+
+/* Stand-in for a segment being produced: only the chunks produced so far
+ * can be read without blocking, as with a chunked HTTP transfer */
+class ProducedSource : public AbstractSource
+{
+    public:
+        ProducedSource(size_t c, unsigned t)
+            : chunk(c), total(t), produced(0), read(0), blocked(false) {}
+        virtual ~ProducedSource() = default;
+
+        virtual block_t *readNextBlock() override
+        {
+            if(read >= total)
+                return nullptr;
+            if(read >= produced)
+            {
+                /* would wait for the server */
+                blocked = true;
+                produced = read + 1;
+            }
+            block_t *b = block_Alloc(chunk);
+            if(b)
+                memset(b->p_buffer, 'a' + read, chunk);
+            read++;
+            return b;
+        }
+
+        size_t chunk;
+        unsigned total;
+        unsigned produced;
+        unsigned read;
+        bool blocked;
+};
+
+int SourceStream_test()
+{
+    uint8_t buf[32768];
+    ProducedSource source(1000, 3);
+    ChunksSourceStream chunks(nullptr, &source);
+
+    try
+    {
+        stream_t *s = chunks.makeStream();
+        Expect(s != nullptr);
+
+        /* A read returns the produced chunk, not a full buffer */
+        source.produced = 1;
+        Expect(vlc_stream_ReadPartial(s, buf, sizeof(buf)) == 1000);
+        Expect(!source.blocked);
+        Expect(buf[0] == 'a' && buf[999] == 'a');
+
+        /* A partially read chunk is returned first */
+        source.produced = 2;
+        Expect(vlc_stream_ReadPartial(s, buf, 600) == 600);
+        Expect(vlc_stream_ReadPartial(s, buf, sizeof(buf)) == 400);
+        Expect(!source.blocked);
+        Expect(buf[0] == 'b' && buf[399] == 'b');
+
+        /* Full reads still fill the buffer, up to the end */
+        source.produced = 3;
+        Expect(vlc_stream_ReadPartial(s, buf, sizeof(buf)) == 1000);
+        Expect(vlc_stream_ReadPartial(s, buf, sizeof(buf)) == 0);
+        Expect(vlc_stream_Eof(s));
+
+        source.read = 0;
+        source.produced = 0;
+        chunks.Reset();
+        vlc_stream_Delete(s);
+        s = chunks.makeStream();
+        Expect(s != nullptr);
+        Expect(vlc_stream_Read(s, buf, sizeof(buf)) == 3000);
+        Expect(buf[0] == 'a' && buf[1000] == 'b' && buf[2999] == 'c');
+        Expect(source.blocked);
+        vlc_stream_Delete(s);
+    } catch(...) {
+        return 1;
+    }
+
+    return 0;
+}
@@ -46,9 +46,15 @@ int main()
     TEST(Conversions) ||
     TEST(TemplatedUri) ||
     TEST(BufferingLogic) ||
+    TEST(AdaptationLogic) ||
+    TEST(CatchupLogic) ||
     TEST(CommandsQueue) ||
+    TEST(SourceStream) ||
     TEST(M3U8MasterPlaylist) ||
     TEST(M3U8Playlist) ||
-    TEST(SegmentTracker)
+    TEST(M3U8PlaylistRefresh) ||
+    TEST(M3U8LowLatency) ||
+    TEST(SegmentTracker) ||
+    TEST(Downloader)
     ;
 }
@@ -45,9 +45,15 @@ int Timeline_test();
 int Conversions_test();
 int M3U8MasterPlaylist_test();
 int M3U8Playlist_test();
+int M3U8PlaylistRefresh_test();
+int M3U8LowLatency_test();
 int CommandsQueue_test();
+int SourceStream_test();
 int BufferingLogic_test();
+int AdaptationLogic_test();
 int FakeEsOut_test();
 int SegmentTracker_test();
+int Downloader_test();
+int CatchupLogic_test();
 
 #endif
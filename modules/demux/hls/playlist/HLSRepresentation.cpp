@@ -34,6 +34,7 @@
 
 #include <ctime>
 #include <limits>
+#include <algorithm>
 #include <cassert>
 
 using namespace hls;
@@ -47,6 +48,7 @@ HLSRepresentation::HLSRepresentation  ( BaseAdaptationSet *set ) :
     updateFailureCount = 0;
     lastUpdateTime = 0;
     targetDuration = 0;
+    partTarget = 0;
     streamFormat = StreamFormat::Type::Unknown;
     channels = 0;
 }
@@ -141,7 +143,10 @@ bool HLSRepresentation::needsUpdate(uint64_t number) const
                          : CLOCK_FREQ * 2;
         if(updateFailureCount)
             duration /= 2;
-        if(elapsed < duration)
+        /* low latency playlists publish parts in between segments */
+        const vlc_tick_t interval = partTarget ? std::min(partTarget, duration)
+                                               : duration;
+        if(elapsed < interval)
             return false;
 
         if(number == std::numeric_limits<uint64_t>::max())
@@ -60,6 +60,7 @@ namespace hls
 
             protected:
                 time_t targetDuration;
+                vlc_tick_t partTarget;
                 Url playlistUrl;
 
             private:
@@ -38,6 +38,7 @@
 
 #include <vlc_strings.h>
 #include <vlc_stream.h>
+#include <vlc_charset.h>
 #include <cstdio>
 #include <sstream>
 #include <array>
@@ -231,12 +232,8 @@ bool M3U8Parser::appendSegmentsFromPlaylistURI(vlc_object_t *p_obj, HLSRepresent
         stream_t *substream = vlc_stream_MemoryNew(p_obj, p_block->p_buffer, p_block->i_buffer, true);
         if(substream)
         {
-            std::list<Tag *> tagslist = parseEntries(substream);
+            appendSegmentsFromStream(p_obj, substream, rep);
             vlc_stream_Delete(substream);
-
-            parseSegments(p_obj, rep, tagslist);
-
-            releaseTagsList(tagslist);
         }
         block_Release(p_block);
         return true;
@@ -244,6 +241,28 @@ bool M3U8Parser::appendSegmentsFromPlaylistURI(vlc_object_t *p_obj, HLSRepresent
     return false;
 }
 
+void M3U8Parser::appendSegmentsFromStream(vlc_object_t *p_obj, stream_t *substream,
+                                          HLSRepresentation *rep)
+{
+    /* Segments we already have would be dropped when merging the update,
+     * so don't even create them. Only live lists are merged. */
+    uint64_t known = 0;
+    const SegmentList *segmentList = rep->inheritSegmentList();
+    if(segmentList && rep->isLive() &&
+       !segmentList->getSegments().empty())
+    {
+        const Segment *last = segmentList->getSegments().back();
+        /* an incomplete segment has to be listed again */
+        known = last->getSequenceNumber() + (last->incomplete ? 0 : 1);
+    }
+
+    std::list<Tag *> tagslist = parseEntries(substream, known);
+
+    parseSegments(p_obj, rep, tagslist);
+
+    releaseTagsList(tagslist);
+}
+
 static bool parseEncryption(const AttributesTag *keytag, const Url &playlistUrl,
                             CommonEncryption &encryption)
 {
@@ -301,6 +320,10 @@ void M3U8Parser::parseSegments(vlc_object_t *, HLSRepresentation *rep, const std
     const SingleValueTag *ctx_byterange = nullptr;
     CommonEncryption encryption;
     const ValuesListTag *ctx_extinf = nullptr;
+    uint64_t windowStart = std::numeric_limits<uint64_t>::max();
+    bool b_skipped = false;
+    std::list<const AttributesTag *> ctx_parts;
+    const AttributesTag *ctx_preloadhint = nullptr;
 
     std::list<HLSSegment *> segmentstoappend;
 
@@ -333,6 +356,12 @@ void M3U8Parser::parseSegments(vlc_object_t *, HLSRepresentation *rep, const std
                     break;
                 }
 
+                if(windowStart == std::numeric_limits<uint64_t>::max())
+                    windowStart = sequenceNumber;
+
+                /* parts were of that now complete segment */
+                ctx_parts.clear();
+
                 HLSSegment *segment = new (std::nothrow) HLSSegment(rep, sequenceNumber++);
                 if(!segment)
                     break;
@@ -446,15 +475,131 @@ void M3U8Parser::parseSegments(vlc_object_t *, HLSRepresentation *rep, const std
                 discontinuitySequence++;
                 break;
 
+            case AttributesTag::EXTXSKIP:
+            {
+                /* Already known segments, from our own refresh */
+                const Attribute *countAttr = static_cast<const AttributesTag *>(tag)->
+                                             getAttributeByName("SKIPPED-SEGMENTS");
+                if(!countAttr)
+                    break;
+                if(windowStart == std::numeric_limits<uint64_t>::max())
+                    windowStart = sequenceNumber;
+                sequenceNumber += countAttr->decimal();
+                /* dates are extrapolated from every duration */
+                const Attribute *durationAttr = static_cast<const AttributesTag *>(tag)->
+                                                getAttributeByName("SKIPPED-DURATION");
+                if(durationAttr)
+                {
+                    const vlc_tick_t skippedDuration = durationAttr->decimal();
+                    nzStartTime += skippedDuration;
+                    if(absReferenceTime > VLC_TICK_INVALID)
+                        absReferenceTime += skippedDuration;
+                }
+                if(ctx_byterange)
+                {
+                    std::pair<std::size_t,std::size_t> range = ctx_byterange->getValue().getByteRange();
+                    if(range.first == 0)
+                        range.first = prevbyterangeoffset;
+                    prevbyterangeoffset = range.first + range.second;
+                }
+                ctx_byterange = nullptr;
+                ctx_extinf = nullptr;
+                ctx_parts.clear();
+                discontinuity = false;
+                b_skipped = true;
+            }
+            break;
+
+            case AttributesTag::EXTXPARTINF:
+            {
+                const Attribute *targetAttr = static_cast<const AttributesTag *>(tag)->
+                                              getAttributeByName("PART-TARGET");
+                if(targetAttr)
+                {
+                    rep->partTarget = CLOCK_FREQ * targetAttr->floatingPoint();
+                    static_cast<M3U8 *>(rep->getPlaylist())->setLowLatency(true);
+                }
+            }
+            break;
+
+            case AttributesTag::EXTXSERVERCONTROL:
+            {
+                const AttributesTag *controltag = static_cast<const AttributesTag *>(tag);
+                const Attribute *holdbackAttr = controltag->getAttributeByName("PART-HOLD-BACK");
+                if(!holdbackAttr)
+                    holdbackAttr = controltag->getAttributeByName("HOLD-BACK");
+                if(holdbackAttr)
+                    rep->getPlaylist()->suggestedPresentationDelay.Set(
+                                CLOCK_FREQ * holdbackAttr->floatingPoint());
+            }
+            break;
+
+            case AttributesTag::EXTXPART:
+                ctx_parts.push_back(static_cast<const AttributesTag *>(tag));
+                break;
+
+            case AttributesTag::EXTXPRELOADHINT:
+            {
+                const AttributesTag *hinttag = static_cast<const AttributesTag *>(tag);
+                const Attribute *typeAttr = hinttag->getAttributeByName("TYPE");
+                if(typeAttr && typeAttr->value == "PART")
+                    ctx_preloadhint = hinttag;
+            }
+            break;
+
             case Tag::EXTXENDLIST:
                 break;
         }
     }
 
+    /* Low latency: the parts since the last segment are byte ranges of a
+     * parent segment the server already sends, as it is produced, when it
+     * is hinted. It can then be read progressively before being listed. */
+    if(!b_vod && ctx_preloadhint && ctx_preloadhint->getAttributeByName("BYTERANGE-START"))
+    {
+        const Attribute *uriAttr = ctx_preloadhint->getAttributeByName("URI");
+        for(const AttributesTag *part : ctx_parts)
+        {
+            const Attribute *partUriAttr = part->getAttributeByName("URI");
+            if(!uriAttr || !partUriAttr || !part->getAttributeByName("BYTERANGE") ||
+               partUriAttr->quotedString() != uriAttr->quotedString())
+                uriAttr = nullptr;
+        }
+
+        HLSSegment *segment;
+        if(uriAttr && (segment = new (std::nothrow) HLSSegment(rep, sequenceNumber)))
+        {
+            if(windowStart == std::numeric_limits<uint64_t>::max())
+                windowStart = sequenceNumber;
+            segment->setSourceUrl(uriAttr->quotedString());
+            /* provisional, until listed */
+            vlc_tick_t nzDuration = CLOCK_FREQ * rep->targetDuration;
+            segment->duration.Set(timescale.ToScaled(nzDuration));
+            segment->startTime.Set(timescale.ToScaled(nzStartTime));
+            if(absReferenceTime > VLC_TICK_INVALID)
+                segment->setDisplayTime(absReferenceTime);
+            segment->setDiscontinuitySequenceNumber(discontinuitySequence);
+            segment->discontinuity = discontinuity;
+            if(encryption.method != CommonEncryption::Method::None)
+                segment->setEncryption(encryption);
+            segment->incomplete = true;
+            segmentstoappend.push_back(segment);
+        }
+    }
+
     for(HLSSegment *seg : segmentstoappend)
         segmentList->addSegment(seg);
     segmentstoappend.clear();
 
+    if(b_skipped)
+        segmentList->setWindowStart(windowStart);
+
+    rep->updateSegmentList(segmentList, true);
+
+    /* The update only carried the new segments, the merged list has them all */
+    if(b_skipped && (segmentList = rep->inheritSegmentList()))
+        totalduration = timescale.ToTime(segmentList->getTotalLength());
+
     if(rep->isLive())
     {
         rep->getPlaylist()->duration.Set(0);
@@ -463,8 +608,6 @@ void M3U8Parser::parseSegments(vlc_object_t *, HLSRepresentation *rep, const std
     {
         rep->getPlaylist()->duration.Set(totalduration);
     }
-
-    rep->updateSegmentList(segmentList, true);
 }
 M3U8 * M3U8Parser::parse(vlc_object_t *p_object, stream_t *p_stream, const std::string &playlisturl)
 {
@@ -805,17 +948,50 @@ M3U8 * M3U8Parser::parse(vlc_object_t *p_object, stream_t *p_stream, const std::
     return playlist;
 }
 
-std::list<Tag *> M3U8Parser::parseEntries(stream_t *stream)
+std::list<Tag *> M3U8Parser::parseEntries(stream_t *stream, uint64_t known)
 {
     std::list<Tag *> entrieslist;
     Tag *lastTag = nullptr;
     char *psz_line;
+    uint64_t sequenceNumber = 0;
+    uint64_t skipped = 0;
+    vlc_tick_t skippedDuration = 0;
+    vlc_tick_t targetDuration = 0;
+    vlc_tick_t extinfDuration = -1;
+
+    /* Replaces the run of known segments, keeps tags order.
+     * The duration, in ticks, is not part of the standard tag. */
+    auto flushSkipped = [&]()
+    {
+        if(!skipped)
+            return;
+        Tag *tag = TagFactory::createTagByName("EXT-X-SKIP",
+                                               "SKIPPED-SEGMENTS=" + std::to_string(skipped) +
+                                               ",SKIPPED-DURATION=" + std::to_string(skippedDuration));
+        if(tag)
+            entrieslist.push_back(tag);
+        skipped = 0;
+        skippedDuration = 0;
+    };
 
     while((psz_line = vlc_stream_ReadLine(stream)))
     {
+        const bool b_known = sequenceNumber < known;
+
         if(*psz_line == '#')
         {
-            if(!strncmp(psz_line, "#EXT", 4)) //tag
+            if(b_known && !strncmp(psz_line, "#EXTINF:", 8))
+            {
+                /* segment duration, only accounted with its segment */
+                extinfDuration = CLOCK_FREQ * us_strtod(psz_line + 8, nullptr);
+                lastTag = nullptr;
+            }
+            else if(b_known && !strncmp(psz_line, "#EXT-X-PART:", 12))
+            {
+                /* parts, dropped with their segment */
+                lastTag = nullptr;
+            }
+            else if(!strncmp(psz_line, "#EXT", 4)) //tag
             {
                 std::string key;
                 std::string attributes;
@@ -832,9 +1008,17 @@ std::list<Tag *> M3U8Parser::parseEntries(stream_t *stream)
 
                 if(!key.empty())
                 {
+                    flushSkipped();
                     Tag *tag = TagFactory::createTagByName(key, attributes);
                     if(tag)
+                    {
                         entrieslist.push_back(tag);
+                        if(tag->getType() == SingleValueTag::EXTXMEDIASEQUENCE)
+                            sequenceNumber = static_cast<SingleValueTag *>(tag)->getValue().decimal();
+                        else if(tag->getType() == SingleValueTag::EXTXTARGETDURATION)
+                            targetDuration = CLOCK_FREQ *
+                                    static_cast<SingleValueTag *>(tag)->getValue().decimal();
+                    }
                     lastTag = tag;
                 }
             }
@@ -850,12 +1034,21 @@ std::list<Tag *> M3U8Parser::parseEntries(stream_t *stream)
                 if(uriAttr)
                     streaminftag->addAttribute(uriAttr);
             }
+            else if(b_known)
+            {
+                skipped++;
+                skippedDuration += extinfDuration >= 0 ? extinfDuration : targetDuration;
+                sequenceNumber++;
+            }
             else /* playlist tag, will take modifiers */
             {
+                flushSkipped();
                 Tag *tag = TagFactory::createTagByName("", std::string(psz_line));
                 if(tag)
                     entrieslist.push_back(tag);
+                sequenceNumber++;
             }
+            extinfDuration = -1;
             lastTag = nullptr;
         }
         else // drop
@@ -866,5 +1059,7 @@ std::list<Tag *> M3U8Parser::parseEntries(stream_t *stream)
         free(psz_line);
     }
 
+    flushSkipped();
+
     return entrieslist;
 }
@@ -60,6 +60,7 @@ namespace hls
 
                 M3U8 *             parse  (vlc_object_t *p_obj, stream_t *p_stream, const std::string &);
                 bool appendSegmentsFromPlaylistURI(vlc_object_t *, HLSRepresentation *);
+                void appendSegmentsFromStream(vlc_object_t *, stream_t *, HLSRepresentation *);
 
             private:
                 HLSRepresentation * createRepresentation(BaseAdaptationSet *, const AttributesTag *);
@@ -70,7 +71,9 @@ namespace hls
                 void fillAdaptsetFromMediainfo(const AttributesTag *, const std::string &,
                                                const std::string &, BaseAdaptationSet *);
                 void parseSegments(vlc_object_t *, HLSRepresentation *, const std::list<Tag *>&);
-                std::list<Tag *> parseEntries(stream_t *);
+                /* segments numbered below the second parameter are
+                 * not tokenized, but replaced with EXT-X-SKIP tags */
+                std::list<Tag *> parseEntries(stream_t *, uint64_t = 0);
                 adaptive::SharedResources *resources;
         };
     }
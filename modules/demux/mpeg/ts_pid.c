@@ -31,142 +31,6 @@
 #include <assert.h>
 #include <stdlib.h>
 
-#define PID_ALLOC_CHUNK 16
-
-void ts_pid_list_Init( ts_pid_list_t *p_list )
-{
-    p_list->dummy.i_pid = 8191;
-    p_list->dummy.i_flags = FLAG_SEEN;
-    p_list->base_si.i_pid = 0x1FFB;
-    p_list->pp_all = NULL;
-    p_list->i_all = 0;
-    p_list->i_all_alloc = 0;
-    p_list->i_last_pid = 0;
-    p_list->p_last = NULL;
-}
-
-void ts_pid_list_Release( demux_t *p_demux, ts_pid_list_t *p_list )
-{
-    for( int i = 0; i < p_list->i_all; i++ )
-    {
-        ts_pid_t *pid = p_list->pp_all[i];
-#ifndef NDEBUG
-        if( pid->type != TYPE_FREE )
-            msg_Err( p_demux, "PID %d type %d not freed refcount %d", pid->i_pid, pid->type, pid->i_refcount );
-#else
-        VLC_UNUSED(p_demux);
-#endif
-        free( pid );
-    }
-    free( p_list->pp_all );
-}
-
-struct searchkey
-{
-    int16_t i_pid;
-    ts_pid_t *const *pp_last;
-};
-
-static int ts_bsearch_searchkey_Compare( const void *key, const void *other )
-{
-    struct searchkey *p_key = (void *)key;
-    ts_pid_t *const *pp_pid = other;
-
-    ts_pid_t *p_pid = *pp_pid;
-    p_key->pp_last = other;
-    return ( p_key->i_pid >= p_pid->i_pid ) ? p_key->i_pid - p_pid->i_pid : -1;
-}
-
-ts_pid_t * ts_pid_Get( ts_pid_list_t *p_list, uint16_t i_pid )
-{
-    switch( i_pid )
-    {
-        case 0:
-            return &p_list->pat;
-        case 0x1FFB:
-            return &p_list->base_si;
-        case 0x1FFF:
-            return &p_list->dummy;
-        default:
-            if( p_list->i_last_pid == i_pid )
-                return p_list->p_last;
-        break;
-    }
-
-    size_t i_index = 0;
-    ts_pid_t *p_pid = NULL;
-
-    if( p_list->pp_all )
-    {
-        struct searchkey pidkey;
-        pidkey.i_pid = i_pid;
-        pidkey.pp_last = NULL;
-
-        ts_pid_t **pp_pidk = bsearch( &pidkey, p_list->pp_all, p_list->i_all,
-                                      sizeof(ts_pid_t *), ts_bsearch_searchkey_Compare );
-        if ( pp_pidk )
-            p_pid = *pp_pidk;
-        else
-            i_index = (pidkey.pp_last - p_list->pp_all); /* Last visited index */
-    }
-
-    if( p_pid == NULL )
-    {
-        if( p_list->i_all >= p_list->i_all_alloc )
-        {
-            ts_pid_t **p_realloc = realloc( p_list->pp_all,
-                                            (p_list->i_all_alloc + PID_ALLOC_CHUNK) * sizeof(ts_pid_t *) );
-            if( !p_realloc )
-            {
-                abort();
-                //return NULL;
-            }
-            p_list->pp_all = p_realloc;
-            p_list->i_all_alloc += PID_ALLOC_CHUNK;
-        }
-
-        p_pid = calloc( 1, sizeof(*p_pid) );
-        if( !p_pid )
-        {
-            abort();
-            //return NULL;
-        }
-
-        p_pid->i_cc  = 0xff;
-        p_pid->i_pid = i_pid;
-
-        /* Do insertion based on last bsearch mid point */
-        if( p_list->i_all )
-        {
-            if( p_list->pp_all[i_index]->i_pid < i_pid )
-                i_index++;
-
-            memmove( &p_list->pp_all[i_index + 1],
-                    &p_list->pp_all[i_index],
-                    (p_list->i_all - i_index) * sizeof(ts_pid_t *) );
-        }
-
-        p_list->pp_all[i_index] = p_pid;
-        p_list->i_all++;
-
-    }
-
-    p_list->p_last = p_pid;
-    p_list->i_last_pid = i_pid;
-
-    return p_pid;
-}
-
-ts_pid_t * ts_pid_Next( ts_pid_list_t *p_list, ts_pid_next_context_t *p_ctx )
-{
-    if( likely(p_list->i_all && p_ctx) )
-    {
-        if( p_ctx->i_pos < p_list->i_all )
-            return p_list->pp_all[p_ctx->i_pos++];
-    }
-    return NULL;
-}
-
 static void PIDReset( ts_pid_t *pid )
 {
     assert(pid->i_refcount == 0);
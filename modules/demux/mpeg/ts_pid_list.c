@@ -0,0 +1,122 @@
+/*****************************************************************************
+ * ts_pid_list.c: Transport Stream input module for VLC.
+ *****************************************************************************
+ * Copyright (C) 2004-2016 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <vlc_common.h>
+
+#include "ts_pid.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define PID_ALLOC_CHUNK 16
+
+void ts_pid_list_Init( ts_pid_list_t *p_list )
+{
+    p_list->dummy.i_pid = 8191;
+    p_list->dummy.i_flags = FLAG_SEEN;
+    p_list->base_si.i_pid = 0x1FFB;
+    p_list->pp_all = NULL;
+    p_list->i_all = 0;
+    p_list->i_all_alloc = 0;
+
+    memset( p_list->p_index, 0, sizeof(p_list->p_index) );
+    p_list->p_index[0] = &p_list->pat;
+    p_list->p_index[0x1FFB] = &p_list->base_si;
+    p_list->p_index[0x1FFF] = &p_list->dummy;
+}
+
+void ts_pid_list_Release( demux_t *p_demux, ts_pid_list_t *p_list )
+{
+    for( int i = 0; i < p_list->i_all; i++ )
+    {
+        ts_pid_t *pid = p_list->pp_all[i];
+#ifndef NDEBUG
+        if( pid->type != TYPE_FREE )
+            msg_Err( p_demux, "PID %d type %d not freed refcount %d", pid->i_pid, pid->type, pid->i_refcount );
+#else
+        VLC_UNUSED(p_demux);
+#endif
+        free( pid );
+    }
+    free( p_list->pp_all );
+}
+
+static ts_pid_t * ts_pid_New( ts_pid_list_t *p_list, uint16_t i_pid )
+{
+    if( p_list->i_all >= p_list->i_all_alloc )
+    {
+        ts_pid_t **p_realloc = realloc( p_list->pp_all,
+                                        (p_list->i_all_alloc + PID_ALLOC_CHUNK) * sizeof(ts_pid_t *) );
+        if( !p_realloc )
+        {
+            abort();
+            //return NULL;
+        }
+        p_list->pp_all = p_realloc;
+        p_list->i_all_alloc += PID_ALLOC_CHUNK;
+    }
+
+    ts_pid_t *p_pid = calloc( 1, sizeof(*p_pid) );
+    if( !p_pid )
+    {
+        abort();
+        //return NULL;
+    }
+
+    p_pid->i_cc  = 0xff;
+    p_pid->i_pid = i_pid;
+
+    /* Keep the list sorted, for ts_pid_Next() users */
+    int i_index = p_list->i_all;
+    while( i_index > 0 && p_list->pp_all[i_index - 1]->i_pid > i_pid )
+        i_index--;
+
+    memmove( &p_list->pp_all[i_index + 1],
+             &p_list->pp_all[i_index],
+             (p_list->i_all - i_index) * sizeof(ts_pid_t *) );
+    p_list->pp_all[i_index] = p_pid;
+    p_list->i_all++;
+
+    p_list->p_index[i_pid] = p_pid;
+    return p_pid;
+}
+
+ts_pid_t * ts_pid_Get( ts_pid_list_t *p_list, uint16_t i_pid )
+{
+    i_pid &= 0x1FFF;
+
+    ts_pid_t *p_pid = p_list->p_index[i_pid];
+    if( likely(p_pid != NULL) )
+        return p_pid;
+
+    return ts_pid_New( p_list, i_pid );
+}
+
+ts_pid_t * ts_pid_Next( ts_pid_list_t *p_list, ts_pid_next_context_t *p_ctx )
+{
+    if( likely(p_list->i_all && p_ctx) )
+    {
+        if( p_ctx->i_pos < p_list->i_all )
+            return p_list->pp_all[p_ctx->i_pos++];
+    }
+    return NULL;
+}
@@ -215,6 +215,8 @@ static int vlclua_input_item_stats( lua_State *L )
         STATS_INT( demux_discontinuity )
         STATS_INT( decoded_audio )
         STATS_INT( decoded_video )
+        STATS_INT( decode_time )
+        STATS_INT( decoder_queue )
         STATS_INT( displayed_pictures )
         STATS_INT( lost_pictures )
         STATS_INT( sent_packets )
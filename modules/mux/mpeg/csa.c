@@ -26,10 +26,21 @@
 # include "config.h"
 #endif
 
+#include <assert.h>
+
 #include <vlc_common.h>
+#include <vlc_cpu.h>
 
 #include "csa.h"
 
+/* A packet payload for the bit-sliced stream cypher */
+typedef struct
+{
+    uint8_t *payload;   /* first block of the payload */
+    unsigned size;      /* payload size after the first block */
+    bool     odd;       /* use the odd key */
+} csa_lane_t;
+
 struct csa_t
 {
     /* odd and even keys */
@@ -47,6 +58,10 @@ struct csa_t
     int     p, q, r;
 
     bool    use_odd;
+
+    /* bit-sliced stream cypher */
+    void     (*bs_stream)( const csa_t *, const csa_lane_t *, unsigned );
+    unsigned bs_lanes;
 };
 
 static void csa_ComputeKey( uint8_t kk[57], uint8_t ck[8] );
@@ -56,12 +71,107 @@ static void csa_StreamCypher( csa_t *c, int b_init, uint8_t *ck, uint8_t *sb, ui
 static void csa_BlockDecypher( uint8_t kk[57], uint8_t ib[8], uint8_t bd[8] );
 static void csa_BlockCypher( uint8_t kk[57], uint8_t bd[8], uint8_t ib[8] );
 
+/*****************************************************************************
+ * Bit-sliced stream cypher
+ *****************************************************************************/
+
+/* Transposes a 64x64 bits matrix: bit j of m[i] becomes bit i of m[j] */
+static void csa_Transpose64( uint64_t m[64] )
+{
+    uint64_t mask = UINT64_C(0x00000000FFFFFFFF);
+
+    for( unsigned j = 32; j != 0; j >>= 1, mask ^= mask << j )
+        for( unsigned k = 0; k < 64; k = ((k | j) + 1) & ~j )
+        {
+            const uint64_t t = ((m[k] >> j) ^ m[k | j]) & mask;
+
+            m[k | j] ^= t;
+            m[k] ^= t << j;
+        }
+}
+
+#define csa_bs_word uint64_t
+#define CSA_BS_WORDS 1
+#define CSA_BS(name) name##_c
+#define CSA_BS_TARGET
+#include "csa_bs.h"
+#undef CSA_BS_TARGET
+#undef CSA_BS
+#undef CSA_BS_WORDS
+#undef csa_bs_word
+
+#if defined (__i386__) || defined (__x86_64__)
+typedef uint64_t csa_bs_sse2_t __attribute__ ((vector_size (16)));
+# define csa_bs_word csa_bs_sse2_t
+# define CSA_BS_WORDS 2
+# define CSA_BS(name) name##_sse2
+# define CSA_BS_TARGET __attribute__ ((__target__ ("sse2")))
+# include "csa_bs.h"
+# undef CSA_BS_TARGET
+# undef CSA_BS
+# undef CSA_BS_WORDS
+# undef csa_bs_word
+# define HAVE_CSA_BS_SSE2 1
+
+# if VLC_GCC_VERSION(4,9) || defined (__clang__)
+typedef uint64_t csa_bs_avx2_t __attribute__ ((vector_size (32)));
+#  define csa_bs_word csa_bs_avx2_t
+#  define CSA_BS_WORDS 4
+#  define CSA_BS(name) name##_avx2
+#  define CSA_BS_TARGET __attribute__ ((__target__ ("avx2")))
+#  include "csa_bs.h"
+#  undef CSA_BS_TARGET
+#  undef CSA_BS
+#  undef CSA_BS_WORDS
+#  undef csa_bs_word
+#  define HAVE_CSA_BS_AVX2 1
+# endif
+
+#elif defined (__ARM_NEON) || defined (__aarch64__)
+typedef uint64_t csa_bs_neon_t __attribute__ ((vector_size (16)));
+# define csa_bs_word csa_bs_neon_t
+# define CSA_BS_WORDS 2
+# define CSA_BS(name) name##_neon
+# define CSA_BS_TARGET
+# include "csa_bs.h"
+# undef CSA_BS_TARGET
+# undef CSA_BS
+# undef CSA_BS_WORDS
+# undef csa_bs_word
+# define HAVE_CSA_BS_NEON 1
+#endif
+
 /*****************************************************************************
  * csa_New:
  *****************************************************************************/
 csa_t *csa_New( void )
 {
-    return calloc( 1, sizeof( csa_t ) );
+    csa_t *c = calloc( 1, sizeof( csa_t ) );
+    if( c == NULL )
+        return NULL;
+
+    c->bs_stream = csa_BsStream_c;
+    c->bs_lanes = 64;
+#ifdef HAVE_CSA_BS_AVX2
+    if( vlc_CPU_AVX2() )
+    {
+        c->bs_stream = csa_BsStream_avx2;
+        c->bs_lanes = 256;
+    }
+    else
+#endif
+#ifdef HAVE_CSA_BS_SSE2
+    if( vlc_CPU_SSE2() )
+    {
+        c->bs_stream = csa_BsStream_sse2;
+        c->bs_lanes = 128;
+    }
+#endif
+#ifdef HAVE_CSA_BS_NEON
+    c->bs_stream = csa_BsStream_neon;
+    c->bs_lanes = 128;
+#endif
+    return c;
 }
 
 /*****************************************************************************
@@ -307,6 +417,130 @@ void csa_Encrypt( csa_t *c, uint8_t *pkt, int i_pkt_size )
     }
 }
 
+/*****************************************************************************
+ * csa_DecryptBatch:
+ *****************************************************************************/
+void csa_DecryptBatch( csa_t *c, uint8_t *const *pkts, unsigned count,
+                       int i_pkt_size )
+{
+    csa_lane_t lanes[256];
+
+    assert( c->bs_lanes <= ARRAY_SIZE(lanes) );
+
+    while( count > 0 )
+    {
+        unsigned n = 0;
+
+        for( ; count > 0 && n < c->bs_lanes; pkts++, count-- )
+        {
+            uint8_t *pkt = *pkts;
+            int i_hdr = 4;
+
+            /* transport scrambling control */
+            if( (pkt[3]&0x80) == 0 )
+                continue;
+            if( pkt[3]&0x20 )
+                i_hdr += pkt[4] + 1;
+            if( 188 - i_hdr < 8 || i_pkt_size - i_hdr < 8 )
+            {
+                /* no complete block */
+                csa_Decrypt( c, pkt, i_pkt_size );
+                continue;
+            }
+
+            lanes[n].payload = &pkt[i_hdr];
+            lanes[n].size = i_pkt_size - i_hdr - 8;
+            lanes[n].odd = (pkt[3]&0x40) != 0;
+            n++;
+
+            /* clear transport scrambling control */
+            pkt[3] &= 0x3f;
+        }
+
+        if( n == 0 )
+            continue;
+
+        /* The stream cypher only depends on the first block */
+        c->bs_stream( c, lanes, n );
+
+        for( unsigned i = 0; i < n; i++ )
+        {
+            uint8_t *kk = lanes[i].odd ? c->o_kk : c->e_kk;
+            uint8_t *p = lanes[i].payload;
+            unsigned blocks = lanes[i].size / 8 + 1;
+            uint8_t ib[8], block[8];
+
+            memcpy( ib, p, 8 );
+            for( unsigned b = 0; b < blocks; b++ )
+            {
+                csa_BlockDecypher( kk, ib, block );
+                if( b + 1 < blocks )
+                    memcpy( ib, &p[8*(b+1)], 8 );
+                else
+                    memset( ib, 0, 8 );
+                for( int j = 0; j < 8; j++ )
+                    p[8*b+j] = ib[j] ^ block[j];
+            }
+        }
+    }
+}
+
+/*****************************************************************************
+ * csa_EncryptBatch:
+ *****************************************************************************/
+void csa_EncryptBatch( csa_t *c, uint8_t *const *pkts, unsigned count,
+                       int i_pkt_size )
+{
+    uint8_t *kk = c->use_odd ? c->o_kk : c->e_kk;
+    csa_lane_t lanes[256];
+
+    assert( c->bs_lanes <= ARRAY_SIZE(lanes) );
+
+    while( count > 0 )
+    {
+        unsigned n = 0;
+
+        for( ; count > 0 && n < c->bs_lanes; pkts++, count-- )
+        {
+            uint8_t *pkt = *pkts;
+            int i_hdr = 4;
+
+            if( pkt[3]&0x20 )
+                i_hdr += pkt[4] + 1;
+            if( i_pkt_size - i_hdr < 8 )
+            {
+                /* nothing to scramble */
+                pkt[3] &= 0x3f;
+                continue;
+            }
+
+            /* set transport scrambling control */
+            pkt[3] |= c->use_odd ? 0xc0 : 0x80;
+
+            lanes[n].payload = &pkt[i_hdr];
+            lanes[n].size = i_pkt_size - i_hdr - 8;
+            lanes[n].odd = c->use_odd;
+
+            /* Block cypher, from the last block, in place */
+            uint8_t *p = lanes[n].payload;
+            uint8_t ib[8] = { 0 }, block[8];
+
+            for( unsigned b = lanes[n].size / 8 + 1; b > 0; b-- )
+            {
+                for( int j = 0; j < 8; j++ )
+                    block[j] = p[8*(b-1)+j] ^ ib[j];
+                csa_BlockCypher( kk, block, ib );
+                memcpy( &p[8*(b-1)], ib, 8 );
+            }
+            n++;
+        }
+
+        /* The stream cypher is initialised with the first block */
+        if( n > 0 )
+            c->bs_stream( c, lanes, n );
+    }
+}
+
 /*****************************************************************************
  * Divers
  *****************************************************************************/
@@ -0,0 +1,348 @@
+/*****************************************************************************
+ * csa_bs.h: bit-sliced CSA stream cypher
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+/*
+ * This file is included by csa.c once per word type, with:
+ *  - csa_bs_word: the word type, one bit per packet,
+ *  - CSA_BS_WORDS: the number of 64-bits integers in a word,
+ *  - CSA_BS(name): the name of the functions for the word type,
+ *  - CSA_BS_TARGET: the target attribute of the functions.
+ *
+ * Each state bit of csa_StreamCypher() is stored as a word, whose bit n is
+ * the value for the packet n. The cypher is then computed with logic
+ * operations only, for 64 * CSA_BS_WORDS packets at once.
+ */
+
+#define CSA_BS_LANES (64 * CSA_BS_WORDS)
+
+typedef struct
+{
+    csa_bs_word A[11][4];
+    csa_bs_word B[11][4];
+    csa_bs_word X[4], Y[4], Z[4];
+    csa_bs_word D[4], E[4], F[4];
+    csa_bs_word p, q, r;
+} CSA_BS(csa_bs_t);
+
+/* Converts the 64-bits rows of each packet to 64 words (and back) */
+static inline CSA_BS_TARGET
+void CSA_BS(csa_BsLoad)( csa_bs_word w[64], uint64_t rows[][64] )
+{
+    uint64_t tmp[64][CSA_BS_WORDS];
+
+    for( unsigned g = 0; g < CSA_BS_WORDS; g++ )
+    {
+        csa_Transpose64( rows[g] );
+        for( unsigned i = 0; i < 64; i++ )
+            tmp[i][g] = rows[g][i];
+    }
+    memcpy( w, tmp, sizeof (tmp) );
+}
+
+static inline CSA_BS_TARGET
+void CSA_BS(csa_BsStore)( uint64_t rows[][64], const csa_bs_word w[64] )
+{
+    uint64_t tmp[64][CSA_BS_WORDS];
+
+    memcpy( tmp, w, sizeof (tmp) );
+    for( unsigned g = 0; g < CSA_BS_WORDS; g++ )
+    {
+        for( unsigned i = 0; i < 64; i++ )
+            rows[g][i] = tmp[i][g];
+        csa_Transpose64( rows[g] );
+    }
+}
+
+/* Computes the 7 s-boxes of csa_StreamCypher() from the A registers */
+static inline CSA_BS_TARGET
+void CSA_BS(csa_BsSboxes)( const csa_bs_word A[11][4], csa_bs_word s[8][2] )
+{
+    csa_bs_word x0, x1, x2, x3, x4;
+
+    /* Each output bit is the XOR of products of the 5 input bits (the
+     * algebraic normal form of the s-box table): x4 is the most significant
+     * input bit, x013 is x0 & x1 & x3, and so on. */
+
+    /* s1 */
+    x4 = A[4][0]; x3 = A[1][2]; x2 = A[6][1]; x1 = A[7][3]; x0 = A[9][0];
+    {
+        const csa_bs_word x02 = x0 & x2, x03 = x0 & x3, x01 = x0 & x1,
+            x013 = x01 & x3, x04 = x0 & x4, x34 = x3 & x4, x13 = x1 & x3,
+            x134 = x13 & x4, x23 = x2 & x3, x234 = x23 & x4, x023 = x02 & x3,
+            x0234 = x023 & x4, x12 = x1 & x2, x123 = x12 & x3,
+            x014 = x01 & x4, x24 = x2 & x4, x124 = x12 & x4,
+            x0134 = x013 & x4, x1234 = x123 & x4;
+        s[1][0] = x1 ^ x02 ^ x3 ^ x03 ^ x013 ^ x04 ^ x34 ^ x134 ^ x234 ^
+                  x0234;
+        s[1][1] = ~(x0 ^ x1 ^ x01 ^ x02 ^ x12 ^ x03 ^ x13 ^ x23 ^ x023 ^
+                  x123 ^ x4 ^ x014 ^ x24 ^ x124 ^ x34 ^ x134 ^ x0134 ^ x234 ^
+                  x1234);
+    }
+
+    /* s2 */
+    x4 = A[2][1]; x3 = A[3][2]; x2 = A[6][3]; x1 = A[7][0]; x0 = A[9][1];
+    {
+        const csa_bs_word x02 = x0 & x2, x01 = x0 & x1, x013 = x01 & x3,
+            x023 = x02 & x3, x014 = x01 & x4, x24 = x2 & x4, x34 = x3 & x4,
+            x0134 = x013 & x4, x0234 = x023 & x4, x12 = x1 & x2,
+            x012 = x01 & x2, x124 = x12 & x4, x03 = x0 & x3, x034 = x03 & x4,
+            x13 = x1 & x3, x134 = x13 & x4, x23 = x2 & x3, x234 = x23 & x4;
+        s[2][0] = ~(x1 ^ x2 ^ x02 ^ x013 ^ x023 ^ x014 ^ x24 ^ x34 ^ x0134 ^
+                  x0234);
+        s[2][1] = ~(x0 ^ x1 ^ x02 ^ x12 ^ x012 ^ x3 ^ x124 ^ x034 ^ x134 ^
+                  x0134 ^ x234);
+    }
+
+    /* s3 */
+    x4 = A[1][3]; x3 = A[2][0]; x2 = A[5][1]; x1 = A[5][3]; x0 = A[6][2];
+    {
+        const csa_bs_word x01 = x0 & x1, x02 = x0 & x2, x12 = x1 & x2,
+            x012 = x01 & x2, x03 = x0 & x3, x13 = x1 & x3, x013 = x01 & x3,
+            x23 = x2 & x3, x123 = x12 & x3, x14 = x1 & x4, x014 = x01 & x4,
+            x24 = x2 & x4, x024 = x02 & x4, x124 = x12 & x4,
+            x0124 = x012 & x4, x034 = x03 & x4, x234 = x23 & x4,
+            x1234 = x123 & x4;
+        s[3][0] = x1 ^ x01 ^ x02 ^ x3 ^ x4;
+        s[3][1] = ~(x0 ^ x1 ^ x02 ^ x12 ^ x012 ^ x3 ^ x03 ^ x13 ^ x013 ^
+                  x23 ^ x123 ^ x4 ^ x14 ^ x014 ^ x24 ^ x024 ^ x124 ^ x0124 ^
+                  x034 ^ x234 ^ x1234);
+    }
+
+    /* s4 */
+    x4 = A[3][3]; x3 = A[1][1]; x2 = A[2][3]; x1 = A[4][2]; x0 = A[8][0];
+    {
+        const csa_bs_word x01 = x0 & x1, x03 = x0 & x3, x013 = x01 & x3,
+            x23 = x2 & x3, x04 = x0 & x4, x14 = x1 & x4, x012 = x01 & x2,
+            x0124 = x012 & x4, x34 = x3 & x4, x034 = x03 & x4,
+            x0134 = x013 & x4, x234 = x23 & x4, x12 = x1 & x2,
+            x123 = x12 & x3, x1234 = x123 & x4;
+        s[4][0] = ~(x1 ^ x01 ^ x2 ^ x03 ^ x013 ^ x23 ^ x04 ^ x14 ^ x0124 ^
+                  x34 ^ x034 ^ x0134 ^ x234 ^ x1234);
+        s[4][1] = ~(x0 ^ x01 ^ x2 ^ x012 ^ x3 ^ x123 ^ x4 ^ x04 ^ x14 ^
+                  x0124 ^ x34 ^ x034 ^ x0134 ^ x234 ^ x1234);
+    }
+
+    /* s5 */
+    x4 = A[5][2]; x3 = A[4][3]; x2 = A[6][0]; x1 = A[8][1]; x0 = A[9][2];
+    {
+        const csa_bs_word x01 = x0 & x1, x02 = x0 & x2, x012 = x01 & x2,
+            x03 = x0 & x3, x13 = x1 & x3, x023 = x02 & x3, x04 = x0 & x4,
+            x24 = x2 & x4, x024 = x02 & x4, x12 = x1 & x2, x124 = x12 & x4,
+            x0124 = x012 & x4, x34 = x3 & x4, x034 = x03 & x4,
+            x134 = x13 & x4, x013 = x01 & x3, x0134 = x013 & x4,
+            x123 = x12 & x3, x14 = x1 & x4, x0234 = x023 & x4,
+            x1234 = x123 & x4;
+        s[5][0] = x01 ^ x2 ^ x02 ^ x012 ^ x03 ^ x13 ^ x023 ^ x04 ^ x24 ^
+                  x024 ^ x124 ^ x0124 ^ x34 ^ x034 ^ x134 ^ x0134;
+        s[5][1] = ~(x0 ^ x1 ^ x01 ^ x02 ^ x12 ^ x012 ^ x3 ^ x03 ^ x013 ^
+                  x023 ^ x123 ^ x04 ^ x14 ^ x24 ^ x124 ^ x0124 ^ x034 ^
+                  x134 ^ x0234 ^ x1234);
+    }
+
+    /* s6 */
+    x4 = A[3][1]; x3 = A[4][1]; x2 = A[5][0]; x1 = A[7][2]; x0 = A[9][3];
+    {
+        const csa_bs_word x12 = x1 & x2, x01 = x0 & x1, x012 = x01 & x2,
+            x13 = x1 & x3, x23 = x2 & x3, x123 = x12 & x3, x014 = x01 & x4,
+            x124 = x12 & x4, x0124 = x012 & x4, x013 = x01 & x3,
+            x0134 = x013 & x4, x1234 = x123 & x4, x02 = x0 & x2,
+            x023 = x02 & x3, x03 = x0 & x3, x034 = x03 & x4;
+        s[6][0] = x0 ^ x2 ^ x12 ^ x012 ^ x13 ^ x23 ^ x123 ^ x014 ^ x124 ^
+                  x0124 ^ x0134 ^ x1234;
+        s[6][1] = x1 ^ x02 ^ x013 ^ x23 ^ x023 ^ x4 ^ x014 ^ x034;
+    }
+
+    /* s7 */
+    x4 = A[2][2]; x3 = A[3][0]; x2 = A[7][1]; x1 = A[8][2]; x0 = A[8][3];
+    {
+        const csa_bs_word x01 = x0 & x1, x12 = x1 & x2, x012 = x01 & x2,
+            x23 = x2 & x3, x13 = x1 & x3, x134 = x13 & x4, x013 = x01 & x3,
+            x0134 = x013 & x4, x04 = x0 & x4, x014 = x01 & x4, x24 = x2 & x4,
+            x124 = x12 & x4, x0124 = x012 & x4, x123 = x12 & x3,
+            x1234 = x123 & x4;
+        s[7][0] = x0 ^ x01 ^ x2 ^ x12 ^ x012 ^ x3 ^ x23 ^ x4 ^ x134 ^ x0134;
+        s[7][1] = x0 ^ x1 ^ x01 ^ x2 ^ x3 ^ x013 ^ x04 ^ x014 ^ x24 ^ x124 ^
+                  x0124 ^ x0134 ^ x1234;
+    }
+}
+
+/* Clocks the cypher 4 times, and returns 1 byte per packet (as 8 words).
+ * in1 and in2 are the high and low nibbles of the input byte during the
+ * initialisation, or NULL. */
+static inline CSA_BS_TARGET
+void CSA_BS(csa_BsClock)( CSA_BS(csa_bs_t) *st, const csa_bs_word *in1,
+                          const csa_bs_word *in2, csa_bs_word out[8] )
+{
+    for( int j = 0; j < 4; j++ )
+    {
+        csa_bs_word s[8][2], extra_B[4];
+        csa_bs_word next_A1[4], next_B1[4], next_E[4];
+        csa_bs_word carry = st->r;
+
+        CSA_BS(csa_BsSboxes)( st->A, s );
+
+        /* use 4x4 xor to produce extra nibble for T3 */
+        extra_B[3] = st->B[3][0] ^ st->B[6][1] ^ st->B[7][2] ^ st->B[9][3];
+        extra_B[2] = st->B[6][0] ^ st->B[8][1] ^ st->B[3][3] ^ st->B[4][2];
+        extra_B[1] = st->B[5][3] ^ st->B[8][2] ^ st->B[4][0] ^ st->B[5][1];
+        extra_B[0] = st->B[9][2] ^ st->B[6][3] ^ st->B[3][1] ^ st->B[8][0];
+
+        for( int b = 0; b < 4; b++ )
+        {
+            /* T1 and T2 */
+            next_A1[b] = st->A[10][b] ^ st->X[b];
+            next_B1[b] = st->B[7][b] ^ st->B[10][b] ^ st->Y[b];
+            if( in1 != NULL )
+            {
+                next_A1[b] ^= st->D[b] ^ ((j % 2) ? in2[b] : in1[b]);
+                next_B1[b] ^= (j % 2) ? in1[b] : in2[b];
+            }
+        }
+
+        for( int b = 0; b < 4; b++ )
+        {
+            /* if p=1, rotate left */
+            const csa_bs_word rot = next_B1[(b + 3) % 4];
+            csa_bs_word sum;
+
+            st->B[0][b] = next_B1[b] ^ ((next_B1[b] ^ rot) & st->p);
+
+            /* T3 */
+            st->D[b] = st->E[b] ^ st->Z[b] ^ extra_B[b];
+
+            /* T4 = sum, carry of Z + E + r if q=1, E otherwise */
+            next_E[b] = st->F[b];
+            sum = st->Z[b] ^ st->E[b] ^ carry;
+            carry = (st->Z[b] & st->E[b]) | (carry & (st->Z[b] ^ st->E[b]));
+            st->F[b] = st->E[b] ^ ((sum ^ st->E[b]) & st->q);
+        }
+        st->r ^= (carry ^ st->r) & st->q;
+        memcpy( st->E, next_E, sizeof (next_E) );
+
+        /* B[0] holds next_B1 */
+        memmove( st->A[2], st->A[1], 9 * sizeof (st->A[1]) );
+        memmove( st->B[1], st->B[0], 10 * sizeof (st->B[0]) );
+        memcpy( st->A[1], next_A1, sizeof (next_A1) );
+
+        st->X[0] = s[1][1]; st->X[1] = s[2][1];
+        st->X[2] = s[3][0]; st->X[3] = s[4][0];
+        st->Y[0] = s[3][1]; st->Y[1] = s[4][1];
+        st->Y[2] = s[5][0]; st->Y[3] = s[6][0];
+        st->Z[0] = s[5][1]; st->Z[1] = s[6][1];
+        st->Z[2] = s[1][0]; st->Z[3] = s[2][0];
+        st->p = s[7][1];
+        st->q = s[7][0];
+
+        /* 2 output bits are a function of the 4 bits of D */
+        out[7 - 2 * j] = st->D[2] ^ st->D[3];
+        out[6 - 2 * j] = st->D[0] ^ st->D[1];
+    }
+}
+
+/* Selects the odd or even key bit for each packet */
+#define CSA_BS_KEY(byte, shift) \
+    ((((c->o_ck[byte] >> (shift)) & 1) ? odd : zero) | \
+     (((c->e_ck[byte] >> (shift)) & 1) ? ~odd : zero))
+
+/**
+ * Runs the stream cypher for up to CSA_BS_LANES packets.
+ *
+ * For each packet, the cypher is initialised with the first payload block,
+ * then the rest of the payload is XORed with the cypher output.
+ */
+static CSA_BS_TARGET
+void CSA_BS(csa_BsStream)( const csa_t *c, const csa_lane_t *lanes,
+                           unsigned count )
+{
+    CSA_BS(csa_bs_t) st;
+    csa_bs_word in[64], odd;
+    const csa_bs_word zero = { 0 };
+    uint64_t rows[CSA_BS_WORDS][64];
+    uint64_t odd_mask[CSA_BS_WORDS] = { 0 };
+    unsigned size = 0;
+
+    assert( count <= CSA_BS_LANES );
+
+    for( unsigned i = 0; i < CSA_BS_LANES; i++ )
+    {
+        uint64_t *row = &rows[i / 64][i % 64];
+
+        if( i >= count )
+        {
+            *row = 0;
+            continue;
+        }
+
+        *row = GetQWLE( lanes[i].payload );
+        if( lanes[i].odd )
+            odd_mask[i / 64] |= UINT64_C(1) << (i % 64);
+        if( size < lanes[i].size )
+            size = lanes[i].size;
+    }
+    CSA_BS(csa_BsLoad)( in, rows );
+    memcpy( &odd, odd_mask, sizeof (odd) );
+
+    /* load first 32 bits of CK into A[1]..A[8]
+     * load last  32 bits of CK into B[1]..B[8]
+     * all other regs = 0 */
+    memset( &st, 0, sizeof (st) );
+    for( int i = 0; i < 4; i++ )
+        for( int b = 0; b < 4; b++ )
+        {
+            st.A[1 + 2 * i][b] = CSA_BS_KEY( i, 4 + b );
+            st.A[2 + 2 * i][b] = CSA_BS_KEY( i, b );
+            st.B[1 + 2 * i][b] = CSA_BS_KEY( 4 + i, 4 + b );
+            st.B[2 + 2 * i][b] = CSA_BS_KEY( 4 + i, b );
+        }
+
+    for( int i = 0; i < 8; i++ )
+    {
+        csa_bs_word out[8];
+
+        CSA_BS(csa_BsClock)( &st, &in[8 * i + 4], &in[8 * i], out );
+    }
+
+    for( unsigned pos = 0; pos < size; pos += 8 )
+    {
+        csa_bs_word out[64];
+
+        for( int i = 0; i < 8; i++ )
+            CSA_BS(csa_BsClock)( &st, NULL, NULL, &out[8 * i] );
+        CSA_BS(csa_BsStore)( rows, out );
+
+        for( unsigned i = 0; i < count; i++ )
+        {
+            if( lanes[i].size <= pos )
+                continue;
+
+            uint8_t *p = lanes[i].payload + 8 + pos;
+            uint64_t stream = rows[i / 64][i % 64];
+
+            if( lanes[i].size - pos >= 8 )
+                SetQWLE( p, GetQWLE( p ) ^ stream );
+            else
+                for( unsigned j = 0; j < lanes[i].size - pos; j++ )
+                    p[j] ^= stream >> (8 * j);
+        }
+    }
+}
+
+#undef CSA_BS_KEY
+#undef CSA_BS_LANES
@@ -1157,6 +1157,10 @@ static block_t *Encap_J2K( block_t *p_data, const es_format_t *p_fmt )
     {
         p_data->p_buffer += (i_offset - 38);
         p_data->i_buffer -= (i_offset - 38);
+        /* The header overwrites the boxes in front of the codestream */
+        p_data = block_MakeWritable( p_data );
+        if( unlikely(!p_data) )
+            return NULL;
     }
 
     const int profile = j2k_get_profile( p_fmt->video.i_visible_width,
@@ -1787,6 +1791,31 @@ static void TSDate( sout_mux_t *p_mux, sout_buffer_chain_t *p_chain_ts,
         i_pcr_length = i_packet_count;
     }
 
+    /* Scramble all the packets at once */
+    if( p_sys->csa != NULL )
+    {
+        uint8_t *pkts[256];
+        unsigned i_pkts = 0;
+
+        vlc_mutex_lock( &p_sys->csa_lock );
+        for( block_t *p_ts = p_chain_ts->p_first; p_ts != NULL;
+             p_ts = p_ts->p_next )
+        {
+            if( !(p_ts->i_flags & BLOCK_FLAG_SCRAMBLED) )
+                continue;
+
+            pkts[i_pkts++] = p_ts->p_buffer;
+            if( i_pkts == ARRAY_SIZE(pkts) )
+            {
+                csa_EncryptBatch( p_sys->csa, pkts, i_pkts,
+                                  p_sys->i_csa_pkt_size );
+                i_pkts = 0;
+            }
+        }
+        csa_EncryptBatch( p_sys->csa, pkts, i_pkts, p_sys->i_csa_pkt_size );
+        vlc_mutex_unlock( &p_sys->csa_lock );
+    }
+
     /* msg_Dbg( p_mux, "real pck=%d", i_packet_count ); */
     for (int i = 0; i < i_packet_count; i++ )
     {
@@ -1801,13 +1830,6 @@ static void TSDate( sout_mux_t *p_mux, sout_buffer_chain_t *p_chain_ts,
             /* msg_Dbg( p_mux, "pcr=%lld ms", p_ts->i_dts / 1000 ); */
             TSSetPCR( p_ts, p_ts->i_dts - p_sys->first_dts );
         }
-        if( p_ts->i_flags & BLOCK_FLAG_SCRAMBLED )
-        {
-            vlc_mutex_lock( &p_sys->csa_lock );
-            csa_Encrypt( p_sys->csa, p_ts->p_buffer, p_sys->i_csa_pkt_size );
-            vlc_mutex_unlock( &p_sys->csa_lock );
-        }
-
         /* latency */
         p_ts->i_dts += p_sys->i_shaping_delay * 3 / 2;
 
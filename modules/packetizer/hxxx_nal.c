@@ -108,7 +108,13 @@ block_t *hxxx_AnnexB_to_xVC( block_t *p_block, uint8_t i_nal_length_size )
         block_t *p_newblock = block_Realloc( p_block, p_list[0].move, p_block->i_buffer );
         if( unlikely(!p_newblock) )
             goto error;
-        p_block = p_newblock;
+        /* The payload did not necessarily move */
+        p_block = block_MakeWritable( p_newblock );
+        if( unlikely(!p_block) )
+        {
+            free( p_list );
+            return NULL;
+        }
         hxxx_WritePrefix( i_nal_length_size, p_block->p_buffer , i_payload );
         free( p_list );
         return p_block;
@@ -120,7 +126,8 @@ block_t *hxxx_AnnexB_to_xVC( block_t *p_block, uint8_t i_nal_length_size )
     uint8_t *p_dest = NULL;
     const size_t i_dest = p_block->i_buffer + p_list[i_nalcount - 1].move;
 
-    if( p_list[i_nalcount - 1].move != 0 || i_nal_length_size != 4 )  /* We'll need to grow or shrink */
+    if( p_list[i_nalcount - 1].move != 0 || i_nal_length_size != 4 /* We'll need to grow or shrink */
+     || block_IsShared( p_block ) ) /* or we cannot write in place */
     {
         block_t *p_newblock = block_Alloc( i_dest );
         if( unlikely(!p_newblock) )
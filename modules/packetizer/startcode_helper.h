@@ -25,6 +25,15 @@
 #if !defined(CAN_COMPILE_SSE2) && defined(HAVE_SSE2_INTRINSICS)
    #include <emmintrin.h>
 #endif
+#if (defined(__i386__) || defined(__x86_64__)) && \
+    (VLC_GCC_VERSION(4,9) || defined(__clang__))
+   #include <immintrin.h>
+   #define STARTCODE_HAVE_AVX2
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+   #include <arm_neon.h>
+   #define STARTCODE_HAVE_NEON
+#endif
 
 /* Looks up efficiently for an AnnexB startcode 0x00 0x00 0x01
  * by using a 4 times faster trick than single byte lookup. */
@@ -109,16 +118,80 @@ static inline const uint8_t * startcode_FindAnnexB_SSE2( const uint8_t *p, const
 
 #endif
 
+#ifdef STARTCODE_HAVE_AVX2
+
+/* Compares 32 positions at once against the whole 3 bytes startcode,
+ * so that zero bytes without a startcode cost nothing. */
+__attribute__ ((__target__ ("avx2")))
+static inline const uint8_t * startcode_FindAnnexB_AVX2( const uint8_t *p, const uint8_t *end )
+{
+    const __m256i zeros = _mm256_setzero_si256();
+    const __m256i ones = _mm256_set1_epi8( 0x01 );
+
+    for( ; end - p >= 32 + 2; p += 32 )
+    {
+        __m256i v0 = _mm256_loadu_si256( (const __m256i *)p );
+        __m256i v1 = _mm256_loadu_si256( (const __m256i *)(p + 1) );
+        __m256i v2 = _mm256_loadu_si256( (const __m256i *)(p + 2) );
+        __m256i res = _mm256_and_si256(
+                        _mm256_cmpeq_epi8( _mm256_or_si256( v0, v1 ), zeros ),
+                        _mm256_cmpeq_epi8( v2, ones ) );
+        uint32_t match = _mm256_movemask_epi8( res );
+        if( match )
+            return p + ctz( match );
+    }
+
+    for (end -= 3; p <= end; p++) {
+        if (p[0] == 0 && p[1] == 0 && p[2] == 1)
+            return p;
+    }
+
+    return NULL;
+}
+
+#endif
+
+#ifdef STARTCODE_HAVE_NEON
+
+/* Same as the AVX2 version, 16 positions at once */
+static inline const uint8_t * startcode_FindAnnexB_NEON( const uint8_t *p, const uint8_t *end )
+{
+    const uint8x16_t zeros = vdupq_n_u8( 0x00 );
+    const uint8x16_t ones = vdupq_n_u8( 0x01 );
+
+    for( ; end - p >= 16 + 2; p += 16 )
+    {
+        uint8x16_t v0 = vld1q_u8( p );
+        uint8x16_t v1 = vld1q_u8( p + 1 );
+        uint8x16_t v2 = vld1q_u8( p + 2 );
+        uint8x16_t res = vandq_u8( vceqq_u8( vorrq_u8( v0, v1 ), zeros ),
+                                   vceqq_u8( v2, ones ) );
+        /* No movemask: narrow to 4 bits per position instead */
+        uint8x8_t nibbles = vshrn_n_u16( vreinterpretq_u16_u8( res ), 4 );
+        uint32_t lo = vget_lane_u32( vreinterpret_u32_u8( nibbles ), 0 );
+        uint32_t hi = vget_lane_u32( vreinterpret_u32_u8( nibbles ), 1 );
+        if( lo )
+            return p + ctz( lo ) / 4;
+        if( hi )
+            return p + 8 + ctz( hi ) / 4;
+    }
+
+    for (end -= 3; p <= end; p++) {
+        if (p[0] == 0 && p[1] == 0 && p[2] == 1)
+            return p;
+    }
+
+    return NULL;
+}
+
+#endif
+
 /* That code is adapted from libav's ff_avc_find_startcode_internal
  * and i believe the trick originated from
  * https://graphics.stanford.edu/~seander/bithacks.html#ZeroInWord
  */
-static inline const uint8_t * startcode_FindAnnexB( const uint8_t *p, const uint8_t *end )
+static inline const uint8_t * startcode_FindAnnexB_C( const uint8_t *p, const uint8_t *end )
 {
-#if defined(CAN_COMPILE_SSE2) || defined(HAVE_SSE2_INTRINSICS)
-    if (vlc_CPU_SSE2())
-        return startcode_FindAnnexB_SSE2(p, end);
-#endif
     const uint8_t *a = p + 4 - ((intptr_t)p & 3);
 
     for (end -= 3; p < a && p <= end; p++) {
@@ -143,6 +216,24 @@ static inline const uint8_t * startcode_FindAnnexB( const uint8_t *p, const uint
     return NULL;
 }
 
+/* Uses the widest implementation available on the running CPU */
+static inline const uint8_t * startcode_FindAnnexB( const uint8_t *p, const uint8_t *end )
+{
+#ifdef STARTCODE_HAVE_AVX2
+    if (vlc_CPU_AVX2())
+        return startcode_FindAnnexB_AVX2(p, end);
+#endif
+#if defined(CAN_COMPILE_SSE2) || defined(HAVE_SSE2_INTRINSICS)
+    if (vlc_CPU_SSE2())
+        return startcode_FindAnnexB_SSE2(p, end);
+#endif
+#ifdef STARTCODE_HAVE_NEON
+    return startcode_FindAnnexB_NEON(p, end);
+#else
+    return startcode_FindAnnexB_C(p, end);
+#endif
+}
+
 #undef TRY_MATCH
 
 #endif
@@ -34,6 +34,8 @@
 #include <vlc_sout.h>
 #include <vlc_block.h>
 
+#include <assert.h>
+
 /*****************************************************************************
  * Module descriptor
  *****************************************************************************/
@@ -58,6 +60,77 @@ static void              Del ( sout_stream_t *, sout_stream_id_sys_t * );
 static int               Send( sout_stream_t *, sout_stream_id_sys_t *,
                                block_t* );
 
+enum
+{
+    OVERFLOW_DROP,          /* drop the oldest non-key block */
+    OVERFLOW_BLOCK,         /* wait for the output */
+    OVERFLOW_DISCONNECT,    /* stop feeding the output */
+};
+
+/* Time given to the outputs to send their queued blocks when closing */
+#define BRANCH_DRAIN_DELAY (2 * CLOCK_FREQ)
+
+enum
+{
+    LINK_QUEUE,     /* all items, in order */
+    LINK_KIND,      /* key blocks, or other blocks */
+};
+
+typedef struct dup_item_t dup_item_t;
+
+typedef struct
+{
+    dup_item_t *p_prev;
+    dup_item_t *p_next;
+} dup_link_t;
+
+/* Queued block, or ES deletion if p_block is NULL */
+struct dup_item_t
+{
+    void       *id;
+    block_t    *p_block;
+    vlc_tick_t  i_date;     /* queuing time */
+    dup_link_t  links[2];
+};
+
+typedef struct
+{
+    dup_item_t *p_first;
+    dup_item_t *p_last;
+} dup_list_t;
+
+/* Output with its own thread, fed through a bounded queue */
+typedef struct
+{
+    sout_stream_t   *p_stream;
+    vlc_thread_t    thread;
+
+    vlc_mutex_t     lock;
+    vlc_cond_t      wait;   /* signaled to the thread */
+    vlc_cond_t      idle;   /* signaled by the thread */
+
+    dup_item_t      *p_pool;    /* items for i_size blocks */
+    dup_item_t      *p_free;    /* unused items of the pool */
+    dup_list_t      queue;      /* blocks and ES deletions */
+    dup_list_t      keys;       /* queued key blocks */
+    dup_list_t      others;     /* queued other blocks, dropped first */
+    unsigned        i_count;    /* queued blocks */
+    unsigned        i_size;
+
+    bool            b_busy;     /* sending outside of the lock */
+    bool            b_paused;   /* output owned by the caller thread */
+    bool            b_dead;     /* disconnected */
+    bool            b_dropping;
+    bool            b_exit;
+
+    /* Statistics */
+    uint64_t        i_sent;
+    uint64_t        i_dropped;
+    unsigned        i_max_count;
+    vlc_tick_t      i_total_latency;
+    vlc_tick_t      i_max_latency;
+} dup_branch_t;
+
 struct sout_stream_sys_t
 {
     int             i_nb_streams;
@@ -68,15 +141,23 @@ struct sout_stream_sys_t
 
     int             i_nb_select;
     char            **ppsz_select;
+
+    dup_branch_t    *p_branches; /* NULL if sending synchronously */
+    bool            b_threads;
+    unsigned        i_queue;
+    int             i_overflow;
 };
 
 struct sout_stream_id_sys_t
 {
     int                 i_nb_ids;
     void                **pp_ids;
+    dup_item_t          **pp_dels; /* ES deletions, with threads */
 };
 
 static bool ESSelected( const es_format_t *fmt, char *psz_select );
+static int  BranchesStart( sout_stream_t * );
+static void BranchesStop( sout_stream_t * );
 
 /*****************************************************************************
  * Open:
@@ -96,6 +177,10 @@ static int Open( vlc_object_t *p_this )
     TAB_INIT( p_sys->i_nb_streams, p_sys->pp_streams );
     TAB_INIT( p_sys->i_nb_last_streams, p_sys->pp_last_streams );
     TAB_INIT( p_sys->i_nb_select, p_sys->ppsz_select );
+    p_sys->p_branches = NULL;
+    p_sys->b_threads = false;
+    p_sys->i_queue = 500;
+    p_sys->i_overflow = OVERFLOW_DROP;
 
     for( p_cfg = p_stream->p_cfg; p_cfg != NULL; p_cfg = p_cfg->p_next )
     {
@@ -134,6 +219,36 @@ static int Open( vlc_object_t *p_this )
                 }
             }
         }
+        else if( !strcmp( p_cfg->psz_name, "threads" ) )
+        {
+            const char *psz = p_cfg->psz_value;
+
+            p_sys->b_threads = psz == NULL || !( !strcmp( psz, "0" )
+                || !strcasecmp( psz, "no" ) || !strcasecmp( psz, "false" ) );
+        }
+        else if( !strcmp( p_cfg->psz_name, "queue" ) )
+        {
+            int i_queue = p_cfg->psz_value ? atoi( p_cfg->psz_value ) : 0;
+
+            if( i_queue > 0 )
+                p_sys->i_queue = i_queue;
+            else
+                msg_Err( p_stream, " * ignore invalid queue size" );
+        }
+        else if( !strcmp( p_cfg->psz_name, "overflow" ) )
+        {
+            const char *psz = p_cfg->psz_value ? p_cfg->psz_value : "";
+
+            if( !strcmp( psz, "drop" ) )
+                p_sys->i_overflow = OVERFLOW_DROP;
+            else if( !strcmp( psz, "block" ) )
+                p_sys->i_overflow = OVERFLOW_BLOCK;
+            else if( !strcmp( psz, "disconnect" ) )
+                p_sys->i_overflow = OVERFLOW_DISCONNECT;
+            else
+                msg_Err( p_stream, " * ignore unknown overflow policy `%s'",
+                         psz );
+        }
         else
         {
             msg_Err( p_stream, " * ignore unknown option `%s'", p_cfg->psz_name );
@@ -148,12 +263,34 @@ static int Open( vlc_object_t *p_this )
         return VLC_EGENERIC;
     }
 
+    /* The outputs would share the next stream from several threads */
+    if( p_sys->b_threads && p_stream->p_next != NULL )
+    {
+        msg_Warn( p_stream, "cannot use threads with a next stream" );
+        p_sys->b_threads = false;
+    }
+
+    p_stream->p_sys = p_sys;
+
+    if( p_sys->b_threads && BranchesStart( p_stream ) )
+    {
+        for( int i = 0; i < p_sys->i_nb_streams; i++ )
+        {
+            sout_StreamChainDelete( p_sys->pp_streams[i],
+                                    p_sys->pp_last_streams[i] );
+            free( p_sys->ppsz_select[i] );
+        }
+        free( p_sys->pp_streams );
+        free( p_sys->pp_last_streams );
+        free( p_sys->ppsz_select );
+        free( p_sys );
+        return VLC_ENOMEM;
+    }
+
     p_stream->pf_add    = Add;
     p_stream->pf_del    = Del;
     p_stream->pf_send   = Send;
 
-    p_stream->p_sys     = p_sys;
-
     return VLC_SUCCESS;
 }
 
@@ -166,6 +303,9 @@ static void Close( vlc_object_t * p_this )
     sout_stream_sys_t *p_sys = p_stream->p_sys;
 
     msg_Dbg( p_stream, "closing a duplication" );
+    if( p_sys->p_branches != NULL )
+        BranchesStop( p_stream );
+
     for( int i = 0; i < p_sys->i_nb_streams; i++ )
     {
         sout_StreamChainDelete(p_sys->pp_streams[i], p_sys->pp_last_streams[i]);
@@ -178,6 +318,339 @@ static void Close( vlc_object_t * p_this )
     free( p_sys );
 }
 
+/*****************************************************************************
+ * Branches: one thread and queue per output
+ *****************************************************************************/
+static void ListAppend( dup_list_t *p_list, dup_item_t *p_item, int i_link )
+{
+    dup_link_t *p_link = &p_item->links[i_link];
+
+    p_link->p_prev = p_list->p_last;
+    p_link->p_next = NULL;
+    if( p_list->p_last != NULL )
+        p_list->p_last->links[i_link].p_next = p_item;
+    else
+        p_list->p_first = p_item;
+    p_list->p_last = p_item;
+}
+
+static void ListRemove( dup_list_t *p_list, dup_item_t *p_item, int i_link )
+{
+    dup_link_t *p_link = &p_item->links[i_link];
+
+    if( p_link->p_prev != NULL )
+        p_link->p_prev->links[i_link].p_next = p_link->p_next;
+    else
+        p_list->p_first = p_link->p_next;
+    if( p_link->p_next != NULL )
+        p_link->p_next->links[i_link].p_prev = p_link->p_prev;
+    else
+        p_list->p_last = p_link->p_prev;
+}
+
+static dup_list_t *BranchKind( dup_branch_t *p_branch, const dup_item_t *p_item )
+{
+    return ( p_item->p_block->i_flags & BLOCK_FLAG_TYPE_I ) ? &p_branch->keys
+                                                           : &p_branch->others;
+}
+
+static void BranchPush( dup_branch_t *p_branch, dup_item_t *p_item )
+{
+    ListAppend( &p_branch->queue, p_item, LINK_QUEUE );
+    if( p_item->p_block != NULL )
+    {
+        ListAppend( BranchKind( p_branch, p_item ), p_item, LINK_KIND );
+        p_branch->i_count++;
+    }
+}
+
+static void BranchUnlink( dup_branch_t *p_branch, dup_item_t *p_item )
+{
+    ListRemove( &p_branch->queue, p_item, LINK_QUEUE );
+    if( p_item->p_block != NULL )
+    {
+        ListRemove( BranchKind( p_branch, p_item ), p_item, LINK_KIND );
+        p_branch->i_count--;
+    }
+}
+
+/* Gives an unlinked block item back to the pool */
+static void BranchRecycle( dup_branch_t *p_branch, dup_item_t *p_item )
+{
+    p_item->links[LINK_QUEUE].p_next = p_branch->p_free;
+    p_branch->p_free = p_item;
+}
+
+static void BranchDrop( dup_branch_t *p_branch, dup_item_t *p_item )
+{
+    BranchUnlink( p_branch, p_item );
+    block_Release( p_item->p_block );
+    BranchRecycle( p_branch, p_item );
+    p_branch->i_dropped++;
+}
+
+/* Drops the queued blocks, but keeps the ES deletions */
+static void BranchFlush( dup_branch_t *p_branch )
+{
+    dup_item_t *p_item = p_branch->queue.p_first;
+
+    while( p_item != NULL )
+    {
+        dup_item_t *p_next = p_item->links[LINK_QUEUE].p_next;
+
+        if( p_item->p_block != NULL )
+            BranchDrop( p_branch, p_item );
+        p_item = p_next;
+    }
+}
+
+static void *BranchThread( void *data )
+{
+    dup_branch_t *p_branch = data;
+
+    vlc_mutex_lock( &p_branch->lock );
+    for( ;; )
+    {
+        while( !p_branch->b_exit
+            && ( p_branch->queue.p_first == NULL || p_branch->b_paused ) )
+            vlc_cond_wait( &p_branch->wait, &p_branch->lock );
+        if( p_branch->b_exit )
+            break;
+
+        dup_item_t *p_item = p_branch->queue.p_first;
+        dup_item_t item = *p_item;
+
+        BranchUnlink( p_branch, p_item );
+        if( item.p_block != NULL )
+            BranchRecycle( p_branch, p_item );
+        if( p_branch->i_count == 0 )
+            p_branch->b_dropping = false;
+        p_branch->b_busy = true;
+        vlc_mutex_unlock( &p_branch->lock );
+
+        if( item.p_block == NULL )
+        {
+            sout_StreamIdDel( p_branch->p_stream, item.id );
+            free( p_item );
+
+            vlc_mutex_lock( &p_branch->lock );
+            p_branch->b_busy = false;
+            vlc_cond_broadcast( &p_branch->idle );
+            continue;
+        }
+
+        sout_StreamIdSend( p_branch->p_stream, item.id, item.p_block );
+
+        vlc_tick_t i_latency = mdate() - item.i_date;
+
+        vlc_mutex_lock( &p_branch->lock );
+        p_branch->b_busy = false;
+        p_branch->i_sent++;
+        p_branch->i_total_latency += i_latency;
+        if( i_latency > p_branch->i_max_latency )
+            p_branch->i_max_latency = i_latency;
+        vlc_cond_broadcast( &p_branch->idle );
+    }
+    vlc_mutex_unlock( &p_branch->lock );
+    return NULL;
+}
+
+static int BranchesStart( sout_stream_t *p_stream )
+{
+    sout_stream_sys_t *p_sys = p_stream->p_sys;
+    int i_count = p_sys->i_nb_streams;
+
+    dup_branch_t *p_branches = calloc( i_count, sizeof( *p_branches ) );
+    if( unlikely(p_branches == NULL) )
+        return VLC_ENOMEM;
+
+    for( int i = 0; i < i_count; i++ )
+    {
+        dup_branch_t *p_branch = &p_branches[i];
+
+        p_branch->p_stream = p_sys->pp_streams[i];
+        p_branch->i_size = p_sys->i_queue;
+        p_branch->p_pool = vlc_alloc( p_branch->i_size,
+                                      sizeof( *p_branch->p_pool ) );
+        if( likely(p_branch->p_pool != NULL) )
+            for( unsigned j = 0; j < p_branch->i_size; j++ )
+                BranchRecycle( p_branch, &p_branch->p_pool[j] );
+        vlc_mutex_init( &p_branch->lock );
+        vlc_cond_init( &p_branch->wait );
+        vlc_cond_init( &p_branch->idle );
+
+        if( unlikely(p_branch->p_pool == NULL)
+         || vlc_clone( &p_branch->thread, BranchThread, p_branch,
+                       VLC_THREAD_PRIORITY_OUTPUT ) )
+        {
+            free( p_branch->p_pool );
+            vlc_cond_destroy( &p_branch->idle );
+            vlc_cond_destroy( &p_branch->wait );
+            vlc_mutex_destroy( &p_branch->lock );
+            p_sys->p_branches = p_branches;
+            p_sys->i_nb_streams = i; /* only stop the started threads */
+            BranchesStop( p_stream );
+            p_sys->i_nb_streams = i_count;
+            return VLC_ENOMEM;
+        }
+    }
+
+    msg_Dbg( p_stream, "using one thread per output, with %u blocks queues",
+             p_sys->i_queue );
+    p_sys->p_branches = p_branches;
+    return VLC_SUCCESS;
+}
+
+static void BranchesStop( sout_stream_t *p_stream )
+{
+    sout_stream_sys_t *p_sys = p_stream->p_sys;
+
+    for( int i = 0; i < p_sys->i_nb_streams; i++ )
+    {
+        dup_branch_t *p_branch = &p_sys->p_branches[i];
+
+        /* Give the output some time to send what is queued */
+        vlc_tick_t deadline = mdate() + BRANCH_DRAIN_DELAY;
+
+        vlc_mutex_lock( &p_branch->lock );
+        while( p_branch->queue.p_first != NULL || p_branch->b_busy )
+            if( vlc_cond_timedwait( &p_branch->idle, &p_branch->lock,
+                                    deadline ) )
+                break;
+        if( p_branch->i_count > 0 )
+            msg_Warn( p_stream, "output %d is too slow, dropping %u blocks",
+                      i, p_branch->i_count );
+        p_branch->b_exit = true;
+        vlc_cond_signal( &p_branch->wait );
+        vlc_mutex_unlock( &p_branch->lock );
+        vlc_join( p_branch->thread, NULL );
+
+        /* Drop the remaining blocks, but do delete the ES */
+        BranchFlush( p_branch );
+        for( dup_item_t *p_item = p_branch->queue.p_first; p_item != NULL; )
+        {
+            dup_item_t *p_next = p_item->links[LINK_QUEUE].p_next;
+
+            sout_StreamIdDel( p_branch->p_stream, p_item->id );
+            free( p_item );
+            p_item = p_next;
+        }
+
+        msg_Dbg( p_stream, "output %d: %"PRIu64" blocks sent, %"PRIu64
+                 " dropped, queue up to %u blocks, latency %"PRId64
+                 " us average, %"PRId64" us max", i, p_branch->i_sent,
+                 p_branch->i_dropped, p_branch->i_max_count,
+                 p_branch->i_sent ? p_branch->i_total_latency
+                                    / (vlc_tick_t)p_branch->i_sent : 0,
+                 p_branch->i_max_latency );
+
+        free( p_branch->p_pool );
+        vlc_cond_destroy( &p_branch->idle );
+        vlc_cond_destroy( &p_branch->wait );
+        vlc_mutex_destroy( &p_branch->lock );
+    }
+    free( p_sys->p_branches );
+    p_sys->p_branches = NULL;
+}
+
+/* Takes the output from its thread, once the current block is sent */
+static void BranchPause( dup_branch_t *p_branch )
+{
+    vlc_mutex_lock( &p_branch->lock );
+    p_branch->b_paused = true;
+    while( p_branch->b_busy )
+        vlc_cond_wait( &p_branch->idle, &p_branch->lock );
+    vlc_mutex_unlock( &p_branch->lock );
+}
+
+static void BranchResume( dup_branch_t *p_branch )
+{
+    vlc_mutex_lock( &p_branch->lock );
+    p_branch->b_paused = false;
+    if( p_branch->queue.p_first != NULL )
+        vlc_cond_signal( &p_branch->wait );
+    vlc_mutex_unlock( &p_branch->lock );
+}
+
+/* Queues the deletion of an ES, after its last blocks */
+static void BranchDel( dup_branch_t *p_branch, dup_item_t *p_del, void *id )
+{
+    p_del->id = id;
+    p_del->p_block = NULL;
+    p_del->i_date = mdate();
+
+    vlc_mutex_lock( &p_branch->lock );
+    BranchPush( p_branch, p_del );
+    if( !p_branch->b_paused )
+        vlc_cond_signal( &p_branch->wait );
+    vlc_mutex_unlock( &p_branch->lock );
+}
+
+static void BranchPut( sout_stream_t *p_stream, dup_branch_t *p_branch,
+                       void *id, block_t *p_block )
+{
+    sout_stream_sys_t *p_sys = p_stream->p_sys;
+
+    vlc_mutex_lock( &p_branch->lock );
+    if( p_branch->i_count >= p_branch->i_size && !p_branch->b_dead )
+    {
+        switch( p_sys->i_overflow )
+        {
+            case OVERFLOW_DROP:
+            {
+                /* Key frames are worth more than older frames */
+                dup_item_t *p_victim = p_branch->others.p_first;
+
+                if( p_victim == NULL )
+                    p_victim = p_branch->keys.p_first;
+                BranchDrop( p_branch, p_victim );
+
+                if( !p_branch->b_dropping )
+                {
+                    msg_Warn( p_stream, "output %td is too slow, dropping",
+                              p_branch - p_sys->p_branches );
+                    p_branch->b_dropping = true;
+                }
+                break;
+            }
+
+            case OVERFLOW_BLOCK:
+                while( p_branch->i_count >= p_branch->i_size )
+                    vlc_cond_wait( &p_branch->idle, &p_branch->lock );
+                break;
+
+            case OVERFLOW_DISCONNECT:
+                msg_Err( p_stream, "output %td is too slow, disconnecting",
+                         p_branch - p_sys->p_branches );
+                BranchFlush( p_branch );
+                p_branch->b_dead = true;
+                break;
+        }
+    }
+
+    if( p_branch->b_dead )
+    {
+        p_branch->i_dropped++;
+        vlc_mutex_unlock( &p_branch->lock );
+        block_Release( p_block );
+        return;
+    }
+
+    dup_item_t *p_item = p_branch->p_free;
+
+    assert( p_item != NULL );
+    p_branch->p_free = p_item->links[LINK_QUEUE].p_next;
+    p_item->id = id;
+    p_item->p_block = p_block;
+    p_item->i_date = mdate();
+    BranchPush( p_branch, p_item );
+    if( p_branch->i_count > p_branch->i_max_count )
+        p_branch->i_max_count = p_branch->i_count;
+    if( !p_branch->b_paused )
+        vlc_cond_signal( &p_branch->wait );
+    vlc_mutex_unlock( &p_branch->lock );
+}
+
 /*****************************************************************************
  * Add:
  *****************************************************************************/
@@ -192,6 +665,16 @@ static sout_stream_id_sys_t * Add( sout_stream_t *p_stream, const es_format_t *p
         return NULL;
 
     TAB_INIT( id->i_nb_ids, id->pp_ids );
+    id->pp_dels = NULL;
+    if( p_sys->p_branches != NULL )
+    {
+        id->pp_dels = calloc( p_sys->i_nb_streams, sizeof( *id->pp_dels ) );
+        if( unlikely(id->pp_dels == NULL) )
+        {
+            free( id );
+            return NULL;
+        }
+    }
 
     msg_Dbg( p_stream, "duplicated a new stream codec=%4.4s (es=%d group=%d)",
              (char*)&p_fmt->i_codec, p_fmt->i_id, p_fmt->i_group );
@@ -204,7 +687,21 @@ static sout_stream_id_sys_t * Add( sout_stream_t *p_stream, const es_format_t *p
         {
             sout_stream_t *out = p_sys->pp_streams[i_stream];
 
-            id_new = (void*)sout_StreamIdAdd( out, p_fmt );
+            if( p_sys->p_branches != NULL )
+            {
+                dup_branch_t *p_branch = &p_sys->p_branches[i_stream];
+
+                /* The deletion cannot fail later on */
+                id->pp_dels[i_stream] = malloc( sizeof( dup_item_t ) );
+                if( likely(id->pp_dels[i_stream] != NULL) )
+                {
+                    BranchPause( p_branch );
+                    id_new = (void*)sout_StreamIdAdd( out, p_fmt );
+                    BranchResume( p_branch );
+                }
+            }
+            else
+                id_new = (void*)sout_StreamIdAdd( out, p_fmt );
             if( id_new )
             {
                 msg_Dbg( p_stream, "    - added for output %d", i_stream );
@@ -247,10 +744,22 @@ static void Del( sout_stream_t *p_stream, sout_stream_id_sys_t *id )
         if( id->pp_ids[i_stream] )
         {
             sout_stream_t *out = p_sys->pp_streams[i_stream];
-            sout_StreamIdDel( out, id->pp_ids[i_stream] );
+
+            /* The output thread deletes the ES after its last blocks */
+            if( p_sys->p_branches != NULL )
+            {
+                BranchDel( &p_sys->p_branches[i_stream],
+                           id->pp_dels[i_stream], id->pp_ids[i_stream] );
+                id->pp_dels[i_stream] = NULL;
+            }
+            else
+                sout_StreamIdDel( out, id->pp_ids[i_stream] );
         }
+        if( id->pp_dels != NULL )
+            free( id->pp_dels[i_stream] );
     }
 
+    free( id->pp_dels );
     free( id->pp_ids );
     free( id );
 }
@@ -278,9 +787,15 @@ static int Send( sout_stream_t *p_stream, sout_stream_id_sys_t *id,
 
             if( id->pp_ids[i_stream] )
             {
-                block_t *p_dup = block_Duplicate( p_buffer );
-
-                if( p_dup )
+                /* All outputs read the same payload */
+                block_t *p_dup = block_Share( p_buffer );
+
+                if( p_dup == NULL )
+                    continue;
+                if( p_sys->p_branches != NULL )
+                    BranchPut( p_stream, &p_sys->p_branches[i_stream],
+                               id->pp_ids[i_stream], p_dup );
+                else
                     sout_StreamIdSend( p_dup_stream, id->pp_ids[i_stream], p_dup );
             }
         }
@@ -288,7 +803,11 @@ static int Send( sout_stream_t *p_stream, sout_stream_id_sys_t *id,
         if( i_stream < p_sys->i_nb_streams && id->pp_ids[i_stream] )
         {
             p_dup_stream = p_sys->pp_streams[i_stream];
-            sout_StreamIdSend( p_dup_stream, id->pp_ids[i_stream], p_buffer );
+            if( p_sys->p_branches != NULL )
+                BranchPut( p_stream, &p_sys->p_branches[i_stream],
+                           id->pp_ids[i_stream], p_buffer );
+            else
+                sout_StreamIdSend( p_dup_stream, id->pp_ids[i_stream], p_buffer );
         }
         else
         {
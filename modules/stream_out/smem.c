@@ -353,11 +353,23 @@ static void Del( sout_stream_t *p_stream, sout_stream_id_sys_t *id )
 static int Send( sout_stream_t *p_stream, sout_stream_id_sys_t *id,
                  block_t *p_buffer )
 {
-    if ( id->format.i_cat == VIDEO_ES )
-        return SendVideo( p_stream, id, p_buffer );
-    else if ( id->format.i_cat == AUDIO_ES )
-        return SendAudio( p_stream, id, p_buffer );
-    return VLC_SUCCESS;
+    int i_ret = VLC_SUCCESS;
+
+    /* Encoders may output several blocks at once */
+    while( p_buffer != NULL )
+    {
+        block_t *p_next = p_buffer->p_next;
+
+        p_buffer->p_next = NULL;
+        if ( id->format.i_cat == VIDEO_ES )
+            i_ret = SendVideo( p_stream, id, p_buffer );
+        else if ( id->format.i_cat == AUDIO_ES )
+            i_ret = SendAudio( p_stream, id, p_buffer );
+        else
+            block_Release( p_buffer );
+        p_buffer = p_next;
+    }
+    return i_ret;
 }
 
 static int SendVideo( sout_stream_t *p_stream, sout_stream_id_sys_t *id,
@@ -127,9 +127,15 @@
 #define HP_LONGTEXT N_( \
     "Runs the optional encoder thread at the OUTPUT priority instead of " \
     "VIDEO." )
+#define FILTER_THREADS_TEXT N_("Number of video filter threads")
+#define FILTER_THREADS_LONGTEXT N_( \
+    "Number of threads running the video filters, in parallel with the " \
+    "decoder and the encoder. Deinterlacing, frame rate conversion and " \
+    "user video filters, which may keep state across pictures, use a " \
+    "single filter thread." )
 #define POOL_TEXT N_("Picture pool size")
 #define POOL_LONGTEXT N_( "Defines how many pictures we allow to be in pool "\
-    "between decoder/encoder threads when threads > 0" )
+    "between decoder/encoder threads when threads > 0 or filter-threads > 0" )
 
 
 static const char *const ppsz_deinterlace_type[] =
@@ -211,6 +217,9 @@ vlc_module_begin ()
     set_section( N_("Miscellaneous"), NULL )
     add_integer( SOUT_CFG_PREFIX "threads", 0, THREADS_TEXT,
                  THREADS_LONGTEXT, true )
+    add_integer( SOUT_CFG_PREFIX "filter-threads", 0, FILTER_THREADS_TEXT,
+                 FILTER_THREADS_LONGTEXT, true )
+        change_integer_range( 0, 64 )
     add_integer( SOUT_CFG_PREFIX "pool-size", 10, POOL_TEXT, POOL_LONGTEXT, true )
         change_integer_range( 1, 1000 )
     add_bool( SOUT_CFG_PREFIX "high-priority", false, HP_TEXT, HP_LONGTEXT,
@@ -224,7 +233,7 @@ static const char *const ppsz_sout_options[] = {
     "deinterlace-module", "threads", "aenc", "acodec", "ab", "alang",
     "afilter", "samplerate", "channels", "senc", "scodec", "soverlay",
     "sfilter", "high-priority", "maxwidth", "maxheight", "pool-size",
-    NULL
+    "filter-threads", NULL
 };
 
 /*****************************************************************************
@@ -367,6 +376,17 @@ static int Open( vlc_object_t *p_this )
 
     p_sys->i_threads = var_GetInteger( p_stream, SOUT_CFG_PREFIX "threads" );
     p_sys->pool_size = var_GetInteger( p_stream, SOUT_CFG_PREFIX "pool-size" );
+    p_sys->i_filter_threads = var_GetInteger( p_stream,
+                                              SOUT_CFG_PREFIX "filter-threads" );
+    if( p_sys->i_filter_threads > 1
+     && ( p_sys->b_master_sync || p_sys->psz_deinterlace != NULL
+       || p_sys->psz_vf2 != NULL ) )
+    {
+        msg_Warn( p_stream, "deinterlacing, frame rate conversion and video "
+                  "filters may keep state across pictures, using a single "
+                  "filter thread" );
+        p_sys->i_filter_threads = 1;
+    }
     p_sys->b_high_priority = var_GetBool( p_stream, SOUT_CFG_PREFIX "high-priority" );
 
     if( p_sys->i_vcodec )
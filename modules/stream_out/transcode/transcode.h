@@ -9,11 +9,35 @@
 #include <vlc_es.h>
 #include <vlc_codec.h>
 
-#include <vlc_picture_fifo.h>
+#include <vlc_picture.h>
 
 /*100ms is around the limit where people are noticing lipsync issues*/
 #define MASTER_SYNC_MAX_DRIFT 100000
 
+/* Pictures decoded together, on their way to the encoder thread */
+typedef struct
+{
+    picture_t       *p_pics;    /* linked with p_next */
+    bool            b_filtered;
+} transcode_video_job_t;
+
+/* Video filter thread, with its own instance of the filter chains */
+typedef struct
+{
+    sout_stream_t   *p_stream;
+    filter_chain_t  *p_f_chain;
+    filter_chain_t  *p_uf_chain;
+    vlc_thread_t    thread;
+} transcode_vfilter_t;
+
+/* Time spent in a transcoding stage */
+typedef struct
+{
+    uint64_t        i_pictures;
+    vlc_tick_t      i_time;     /* processing */
+    vlc_tick_t      i_wait;     /* waiting for another stage */
+} transcode_stage_stats_t;
+
 struct sout_stream_sys_t
 {
     sout_stream_id_sys_t *id_video;
@@ -21,11 +45,25 @@ struct sout_stream_sys_t
     vlc_mutex_t     lock_out;
     vlc_cond_t      cond;
     bool            b_abort;
-    picture_fifo_t *pp_pics;
-    vlc_sem_t       picture_pool_has_room;
     uint32_t        pool_size;
     vlc_thread_t    thread;
 
+    /* Jobs between the decoder and the encoder thread, in decoding order.
+     * Jobs from i_jobs_filter to i_jobs_in are yet to be filtered, jobs from
+     * i_jobs_encode to i_jobs_in are yet to be encoded. */
+    transcode_video_job_t *p_jobs; /* circular, pool_size entries */
+    uint64_t        i_jobs_in;
+    uint64_t        i_jobs_filter;
+    uint64_t        i_jobs_encode;
+    uint64_t        i_jobs_done;
+
+    int             i_filter_threads;
+    transcode_vfilter_t *p_vfilters; /* i_filter_threads entries */
+
+    transcode_stage_stats_t stats_decode;
+    transcode_stage_stats_t stats_filter;
+    transcode_stage_stats_t stats_encode;
+
     /* Audio */
     vlc_fourcc_t    i_acodec;   /* codec audio (0 if not transcode) */
     char            *psz_aenc;
@@ -38,18 +38,24 @@
 #define ENC_FRAMERATE (25 * 1000)
 #define ENC_FRAMERATE_BASE 1000
 
-static const video_format_t* video_output_format( sout_stream_id_sys_t *id,
+static const video_format_t* video_output_format( filter_chain_t *p_f_chain,
+                                                  filter_chain_t *p_uf_chain,
                                                   picture_t *p_pic )
 {
-    assert( id && p_pic );
-    if( id->p_uf_chain )
-        return &filter_chain_GetFmtOut( id->p_uf_chain )->video;
-    else if( id->p_f_chain )
-        return &filter_chain_GetFmtOut( id->p_f_chain )->video;
+    assert( p_pic );
+    if( p_uf_chain )
+        return &filter_chain_GetFmtOut( p_uf_chain )->video;
+    else if( p_f_chain )
+        return &filter_chain_GetFmtOut( p_f_chain )->video;
     else
         return &p_pic->format;
 }
 
+static bool transcode_video_threaded( const sout_stream_sys_t *p_sys )
+{
+    return p_sys->i_threads > 0 || p_sys->i_filter_threads > 0;
+}
+
 static int video_update_format_decoder( decoder_t *p_dec )
 {
     sout_stream_t        *stream = (sout_stream_t*) p_dec->p_owner;
@@ -101,11 +107,107 @@ static picture_t *transcode_video_filter_buffer_new( filter_t *p_filter )
     return picture_NewFromFormat( &p_filter->fmt_out.video );
 }
 
+/* Runs the filter chains; first with the picture, and then with NULL as many
+ * times as we need until they stop outputting frames. */
+static picture_t *transcode_video_filter( filter_chain_t *p_f_chain,
+                                          filter_chain_t *p_uf_chain,
+                                          picture_t *p_pic )
+{
+    picture_t *p_out = NULL, **pp_last = &p_out;
+
+    for ( ;; ) {
+        picture_t *p_filtered_pic = p_pic;
+
+        /* Run filter chain */
+        if( p_f_chain )
+            p_filtered_pic = filter_chain_VideoFilter( p_f_chain, p_filtered_pic );
+        if( !p_filtered_pic )
+            break;
+
+        for ( ;; ) {
+            picture_t *p_user_filtered_pic = p_filtered_pic;
+
+            /* Run user specified filter chain */
+            if( p_uf_chain )
+                p_user_filtered_pic = filter_chain_VideoFilter( p_uf_chain, p_user_filtered_pic );
+            if( !p_user_filtered_pic )
+                break;
+
+            *pp_last = p_user_filtered_pic;
+            pp_last = &p_user_filtered_pic->p_next;
+
+            p_filtered_pic = NULL;
+        }
+
+        p_pic = NULL;
+    }
+    return p_out;
+}
+
+static picture_t *RenderSubpictures( sout_stream_t *, sout_stream_id_sys_t *,
+                                     picture_t * );
+
+static void* FilterThread( void *data )
+{
+    transcode_vfilter_t *p_vf = data;
+    sout_stream_sys_t *p_sys = p_vf->p_stream->p_sys;
+    int canc = vlc_savecancel ();
+
+    vlc_mutex_lock( &p_sys->lock_out );
+
+    for( ;; )
+    {
+        while( !p_sys->b_abort && p_sys->i_jobs_filter == p_sys->i_jobs_in )
+            vlc_cond_wait( &p_sys->cond, &p_sys->lock_out );
+        if( p_sys->i_jobs_filter == p_sys->i_jobs_in )
+            break; /* aborted, and nothing left to filter */
+
+        transcode_video_job_t *p_job =
+            &p_sys->p_jobs[p_sys->i_jobs_filter++ % p_sys->pool_size];
+        picture_t *p_pics = p_job->p_pics;
+
+        /* release lock while filtering */
+        vlc_mutex_unlock( &p_sys->lock_out );
+
+        vlc_tick_t i_start = mdate();
+        picture_t *p_out = NULL, **pp_last = &p_out;
+        uint64_t i_count = 0;
+
+        while( p_pics != NULL )
+        {
+            picture_t *p_pic = p_pics;
+
+            p_pics = p_pic->p_next;
+            p_pic->p_next = NULL;
+            *pp_last = transcode_video_filter( p_vf->p_f_chain,
+                                               p_vf->p_uf_chain, p_pic );
+            while( *pp_last != NULL )
+                pp_last = &(*pp_last)->p_next;
+            i_count++;
+        }
+
+        vlc_tick_t i_time = mdate() - i_start;
+
+        vlc_mutex_lock( &p_sys->lock_out );
+        p_job->p_pics = p_out;
+        p_job->b_filtered = true;
+        p_sys->stats_filter.i_pictures += i_count;
+        p_sys->stats_filter.i_time += i_time;
+        vlc_cond_broadcast( &p_sys->cond );
+    }
+
+    vlc_mutex_unlock( &p_sys->lock_out );
+
+    vlc_restorecancel (canc);
+
+    return NULL;
+}
+
 static void* EncoderThread( void *obj )
 {
-    sout_stream_sys_t *p_sys = (sout_stream_sys_t*)obj;
+    sout_stream_t *p_stream = obj;
+    sout_stream_sys_t *p_sys = p_stream->p_sys;
     sout_stream_id_sys_t *id = p_sys->id_video;
-    picture_t *p_pic = NULL;
     int canc = vlc_savecancel ();
     block_t *p_block = NULL;
 
@@ -113,41 +215,62 @@ static void* EncoderThread( void *obj )
 
     for( ;; )
     {
-        while( !p_sys->b_abort &&
-               (p_pic = picture_fifo_Pop( p_sys->pp_pics )) == NULL )
+        transcode_video_job_t *p_job =
+            &p_sys->p_jobs[p_sys->i_jobs_encode % p_sys->pool_size];
+        vlc_tick_t i_start = mdate();
+
+        /* Encode in decoding order, whichever filter thread is done first */
+        while( p_sys->i_jobs_encode == p_sys->i_jobs_in
+                ? !p_sys->b_abort : !p_job->b_filtered )
             vlc_cond_wait( &p_sys->cond, &p_sys->lock_out );
-        vlc_sem_post( &p_sys->picture_pool_has_room );
+        if( p_sys->i_jobs_encode == p_sys->i_jobs_in )
+            break; /* aborted, and nothing left to encode */
 
-        if( p_pic )
+        picture_t *p_pics = p_job->p_pics;
+
+        p_job->p_pics = NULL;
+        p_sys->i_jobs_encode++;
+        p_sys->stats_encode.i_wait += mdate() - i_start;
+        vlc_cond_broadcast( &p_sys->cond );
+
+        /* release lock while encoding */
+        vlc_mutex_unlock( &p_sys->lock_out );
+
+        block_t *p_blocks = NULL;
+        uint64_t i_count = 0;
+
+        i_start = mdate();
+        while( p_pics != NULL )
         {
-            /* release lock while encoding */
-            vlc_mutex_unlock( &p_sys->lock_out );
+            picture_t *p_pic = p_pics;
+
+            p_pics = p_pic->p_next;
+            p_pic->p_next = NULL;
+            p_pic = RenderSubpictures( p_stream, id, p_pic );
             p_block = id->p_encoder->pf_encode_video( id->p_encoder, p_pic );
             picture_Release( p_pic );
-            vlc_mutex_lock( &p_sys->lock_out );
-
-            block_ChainAppend( &p_sys->p_buffers, p_block );
+            block_ChainAppend( &p_blocks, p_block );
+            i_count++;
         }
+        vlc_tick_t i_time = mdate() - i_start;
 
-        if( p_sys->b_abort )
-            break;
+        vlc_mutex_lock( &p_sys->lock_out );
+        block_ChainAppend( &p_sys->p_buffers, p_blocks );
+        p_sys->i_jobs_done++;
+        p_sys->stats_encode.i_pictures += i_count;
+        p_sys->stats_encode.i_time += i_time;
+        vlc_cond_broadcast( &p_sys->cond );
     }
 
-    /*Encode what we have in the buffer on closing*/
-    while( (p_pic = picture_fifo_Pop( p_sys->pp_pics )) != NULL )
+    /*Now flush encoder*/
+    if( id->p_encoder->p_module )
     {
-        vlc_sem_post( &p_sys->picture_pool_has_room );
-        p_block = id->p_encoder->pf_encode_video( id->p_encoder, p_pic );
-        picture_Release( p_pic );
-        block_ChainAppend( &p_sys->p_buffers, p_block );
+        do {
+            p_block = id->p_encoder->pf_encode_video(id->p_encoder, NULL );
+            block_ChainAppend( &p_sys->p_buffers, p_block );
+        } while( p_block );
     }
 
-    /*Now flush encoder*/
-    do {
-        p_block = id->p_encoder->pf_encode_video(id->p_encoder, NULL );
-        block_ChainAppend( &p_sys->p_buffers, p_block );
-    } while( p_block );
-
     vlc_mutex_unlock( &p_sys->lock_out );
 
     vlc_restorecancel (canc);
@@ -155,6 +278,51 @@ static void* EncoderThread( void *obj )
     return NULL;
 }
 
+/* Queues decoded or filtered pictures for the encoder thread */
+static void transcode_video_submit( sout_stream_t *p_stream, picture_t *p_pics,
+                                    bool b_filtered )
+{
+    sout_stream_sys_t *p_sys = p_stream->p_sys;
+    vlc_tick_t i_start = mdate();
+
+    vlc_mutex_lock( &p_sys->lock_out );
+    while( p_sys->i_jobs_in - p_sys->i_jobs_encode >= p_sys->pool_size )
+        vlc_cond_wait( &p_sys->cond, &p_sys->lock_out );
+    p_sys->stats_decode.i_wait += mdate() - i_start;
+
+    transcode_video_job_t *p_job =
+        &p_sys->p_jobs[p_sys->i_jobs_in++ % p_sys->pool_size];
+
+    p_job->p_pics = p_pics;
+    p_job->b_filtered = b_filtered;
+    if( b_filtered )
+        p_sys->i_jobs_filter++;
+    vlc_cond_broadcast( &p_sys->cond );
+    vlc_mutex_unlock( &p_sys->lock_out );
+}
+
+/* Waits until all queued pictures are encoded */
+static void transcode_video_drain( sout_stream_sys_t *p_sys )
+{
+    vlc_mutex_lock( &p_sys->lock_out );
+    while( p_sys->i_jobs_done < p_sys->i_jobs_in )
+        vlc_cond_wait( &p_sys->cond, &p_sys->lock_out );
+    vlc_mutex_unlock( &p_sys->lock_out );
+}
+
+/* Encodes the queued pictures, flushes the encoder and stops the threads */
+static void transcode_video_stop( sout_stream_sys_t *p_sys )
+{
+    vlc_mutex_lock( &p_sys->lock_out );
+    p_sys->b_abort = true;
+    vlc_cond_broadcast( &p_sys->cond );
+    vlc_mutex_unlock( &p_sys->lock_out );
+
+    for( int i = 0; i < p_sys->i_filter_threads; i++ )
+        vlc_join( p_sys->p_vfilters[i].thread, NULL );
+    vlc_join( p_sys->thread, NULL );
+}
+
 static int decoder_queue_video( decoder_t *p_dec, picture_t *p_pic )
 {
     sout_stream_id_sys_t *id = p_dec->p_queue_ctx;
@@ -265,41 +433,76 @@ static int transcode_video_new( sout_stream_t *p_stream, sout_stream_id_sys_t *i
     id->p_encoder->fmt_in.video.i_chroma = id->p_encoder->fmt_in.i_codec;
     id->p_encoder->p_module = NULL;
 
-    if( p_sys->i_threads <= 0 )
+    if( !transcode_video_threaded( p_sys ) )
         return VLC_SUCCESS;
 
     int i_priority = p_sys->b_high_priority ? VLC_THREAD_PRIORITY_OUTPUT :
                        VLC_THREAD_PRIORITY_VIDEO;
     p_sys->id_video = id;
-    p_sys->pp_pics = picture_fifo_New();
-    if( p_sys->pp_pics == NULL )
+    p_sys->p_jobs = vlc_alloc( p_sys->pool_size, sizeof( *p_sys->p_jobs ) );
+    if( p_sys->i_filter_threads > 0 )
+        p_sys->p_vfilters = calloc( p_sys->i_filter_threads,
+                                    sizeof( *p_sys->p_vfilters ) );
+    if( p_sys->p_jobs == NULL
+     || ( p_sys->i_filter_threads > 0 && p_sys->p_vfilters == NULL ) )
     {
-        msg_Err( p_stream, "cannot create picture fifo" );
+        msg_Err( p_stream, "cannot create picture queue" );
+        free( p_sys->p_jobs );
+        free( p_sys->p_vfilters );
+        p_sys->p_jobs = NULL;
+        p_sys->p_vfilters = NULL;
         module_unneed( id->p_decoder, id->p_decoder->p_module );
         id->p_decoder->p_module = NULL;
         return VLC_ENOMEM;
     }
 
-    vlc_sem_init( &p_sys->picture_pool_has_room, p_sys->pool_size );
     vlc_mutex_init( &p_sys->lock_out );
     vlc_cond_init( &p_sys->cond );
     p_sys->p_buffers = NULL;
     p_sys->b_abort = false;
-    if( vlc_clone( &p_sys->thread, EncoderThread, p_sys, i_priority ) )
+    p_sys->i_jobs_in = p_sys->i_jobs_filter = 0;
+    p_sys->i_jobs_encode = p_sys->i_jobs_done = 0;
+    if( vlc_clone( &p_sys->thread, EncoderThread, p_stream, i_priority ) )
     {
         msg_Err( p_stream, "cannot spawn encoder thread" );
-        vlc_mutex_destroy( &p_sys->lock_out );
-        vlc_cond_destroy( &p_sys->cond );
-        picture_fifo_Delete( p_sys->pp_pics );
-        module_unneed( id->p_decoder, id->p_decoder->p_module );
-        id->p_decoder->p_module = NULL;
-        return VLC_EGENERIC;
+        goto error;
+    }
+
+    for( int i = 0; i < p_sys->i_filter_threads; i++ )
+    {
+        transcode_vfilter_t *p_vf = &p_sys->p_vfilters[i];
+
+        p_vf->p_stream = p_stream;
+        if( vlc_clone( &p_vf->thread, FilterThread, p_vf,
+                       VLC_THREAD_PRIORITY_VIDEO ) )
+        {
+            msg_Err( p_stream, "cannot spawn filter thread" );
+            p_sys->i_filter_threads = i;
+            transcode_video_stop( p_sys );
+            goto error;
+        }
     }
     return VLC_SUCCESS;
+
+error:
+    vlc_mutex_destroy( &p_sys->lock_out );
+    vlc_cond_destroy( &p_sys->cond );
+    free( p_sys->p_jobs );
+    free( p_sys->p_vfilters );
+    p_sys->p_jobs = NULL;
+    p_sys->p_vfilters = NULL;
+    module_unneed( id->p_decoder, id->p_decoder->p_module );
+    id->p_decoder->p_module = NULL;
+    return VLC_EGENERIC;
 }
 
-static void transcode_video_filter_init( sout_stream_t *p_stream,
-                                         sout_stream_id_sys_t *id )
+/* Builds one instance of the filter chains, for the given encoder input */
+static const es_format_t *
+transcode_video_filter_chains( sout_stream_t *p_stream,
+                               sout_stream_id_sys_t *id,
+                               const es_format_t *p_enc_in,
+                               filter_chain_t **pp_f_chain,
+                               filter_chain_t **pp_uf_chain )
 {
     filter_owner_t owner = {
         .sys = p_stream->p_sys,
@@ -309,50 +512,70 @@ static void transcode_video_filter_init( sout_stream_t *p_stream,
     };
     const es_format_t *p_fmt_out = &id->p_decoder->fmt_out;
 
-    id->p_encoder->fmt_in.video.i_chroma = id->p_encoder->fmt_in.i_codec;
-    id->p_f_chain = filter_chain_NewVideo( p_stream, false, &owner );
-    filter_chain_Reset( id->p_f_chain, p_fmt_out, p_fmt_out );
-
-    /* Check that we have visible_width/height*/
-    if( !id->p_decoder->fmt_out.video.i_visible_height )
-        id->p_decoder->fmt_out.video.i_visible_height = id->p_decoder->fmt_out.video.i_height;
-    if( !id->p_decoder->fmt_out.video.i_visible_width )
-        id->p_decoder->fmt_out.video.i_visible_width = id->p_decoder->fmt_out.video.i_width;
+    *pp_f_chain = filter_chain_NewVideo( p_stream, false, &owner );
+    filter_chain_Reset( *pp_f_chain, p_fmt_out, p_fmt_out );
 
     /* Deinterlace */
     if( p_stream->p_sys->psz_deinterlace != NULL )
     {
-        filter_chain_AppendFilter( id->p_f_chain,
+        filter_chain_AppendFilter( *pp_f_chain,
                                    p_stream->p_sys->psz_deinterlace,
                                    p_stream->p_sys->p_deinterlace_cfg,
                                    &id->p_decoder->fmt_out,
                                    &id->p_decoder->fmt_out );
 
-        p_fmt_out = filter_chain_GetFmtOut( id->p_f_chain );
+        p_fmt_out = filter_chain_GetFmtOut( *pp_f_chain );
     }
     if( p_stream->p_sys->b_master_sync )
     {
-        filter_chain_AppendFilter( id->p_f_chain,
+        filter_chain_AppendFilter( *pp_f_chain,
                                    "fps",
                                    NULL,
                                    p_fmt_out,
-                                   &id->p_encoder->fmt_in );
+                                   p_enc_in );
 
-        p_fmt_out = filter_chain_GetFmtOut( id->p_f_chain );
+        p_fmt_out = filter_chain_GetFmtOut( *pp_f_chain );
     }
 
     if( p_stream->p_sys->psz_vf2 )
     {
-        id->p_uf_chain = filter_chain_NewVideo( p_stream, true, &owner );
-        filter_chain_Reset( id->p_uf_chain, p_fmt_out,
-                            &id->p_encoder->fmt_in );
-        if( p_fmt_out->video.i_chroma != id->p_encoder->fmt_in.video.i_chroma )
+        *pp_uf_chain = filter_chain_NewVideo( p_stream, true, &owner );
+        filter_chain_Reset( *pp_uf_chain, p_fmt_out, p_enc_in );
+        if( p_fmt_out->video.i_chroma != p_enc_in->video.i_chroma )
         {
-            filter_chain_AppendConverter( id->p_uf_chain, p_fmt_out,
-                                           &id->p_encoder->fmt_in );
+            filter_chain_AppendConverter( *pp_uf_chain, p_fmt_out, p_enc_in );
         }
-        filter_chain_AppendFromString( id->p_uf_chain, p_stream->p_sys->psz_vf2 );
-        p_fmt_out = filter_chain_GetFmtOut( id->p_uf_chain );
+        filter_chain_AppendFromString( *pp_uf_chain, p_stream->p_sys->psz_vf2 );
+        p_fmt_out = filter_chain_GetFmtOut( *pp_uf_chain );
+    }
+    return p_fmt_out;
+}
+
+static void transcode_video_filter_init( sout_stream_t *p_stream,
+                                         sout_stream_id_sys_t *id )
+{
+    sout_stream_sys_t *p_sys = p_stream->p_sys;
+
+    id->p_encoder->fmt_in.video.i_chroma = id->p_encoder->fmt_in.i_codec;
+
+    /* Check that we have visible_width/height*/
+    if( !id->p_decoder->fmt_out.video.i_visible_height )
+        id->p_decoder->fmt_out.video.i_visible_height = id->p_decoder->fmt_out.video.i_height;
+    if( !id->p_decoder->fmt_out.video.i_visible_width )
+        id->p_decoder->fmt_out.video.i_visible_width = id->p_decoder->fmt_out.video.i_width;
+
+    /* Filter threads other than the first one use their own chains */
+    for( int i = 1; i < p_sys->i_filter_threads; i++ )
+        transcode_video_filter_chains( p_stream, id, &id->p_encoder->fmt_in,
+                                       &p_sys->p_vfilters[i].p_f_chain,
+                                       &p_sys->p_vfilters[i].p_uf_chain );
+
+    const es_format_t *p_fmt_out =
+        transcode_video_filter_chains( p_stream, id, &id->p_encoder->fmt_in,
+                                       &id->p_f_chain, &id->p_uf_chain );
+
+    if( id->p_uf_chain )
+    {
         es_format_Copy( &id->p_encoder->fmt_in, p_fmt_out );
         id->p_encoder->fmt_out.video.i_width =
             id->p_encoder->fmt_in.video.i_width;
@@ -373,9 +596,12 @@ static void transcode_video_filter_init( sout_stream_t *p_stream,
 
 /* Take care of the scaling and chroma conversions. */
 static int conversion_video_filter_append( sout_stream_id_sys_t *id,
+                                           filter_chain_t *p_f_chain,
+                                           filter_chain_t *p_uf_chain,
                                            picture_t *p_pic )
 {
-    const video_format_t *p_vid_out = video_output_format( id, p_pic );
+    const video_format_t *p_vid_out = video_output_format( p_f_chain,
+                                                           p_uf_chain, p_pic );
 
     if( ( p_vid_out->i_chroma != id->p_encoder->fmt_in.video.i_chroma ) ||
         ( p_vid_out->i_width != id->p_encoder->fmt_in.video.i_width ) ||
@@ -384,12 +610,62 @@ static int conversion_video_filter_append( sout_stream_id_sys_t *id,
         es_format_t fmt_out;
         es_format_Init( &fmt_out, VIDEO_ES, p_vid_out->i_chroma );
         fmt_out.video = *p_vid_out;
-        return filter_chain_AppendConverter( id->p_uf_chain ? id->p_uf_chain : id->p_f_chain,
+        return filter_chain_AppendConverter( p_uf_chain ? p_uf_chain : p_f_chain,
                                              &fmt_out, &id->p_encoder->fmt_in );
     }
     return VLC_SUCCESS;
 }
 
+/* Builds the filter chains of every filter thread */
+static int transcode_video_filter_setup( sout_stream_t *p_stream,
+                                         sout_stream_id_sys_t *id,
+                                         picture_t *p_pic )
+{
+    sout_stream_sys_t *p_sys = p_stream->p_sys;
+
+    transcode_video_filter_init( p_stream, id );
+    if( conversion_video_filter_append( id, id->p_f_chain, id->p_uf_chain,
+                                        p_pic ) != VLC_SUCCESS )
+        return VLC_EGENERIC;
+
+    for( int i = 1; i < p_sys->i_filter_threads; i++ )
+        if( conversion_video_filter_append( id, p_sys->p_vfilters[i].p_f_chain,
+                                            p_sys->p_vfilters[i].p_uf_chain,
+                                            p_pic ) != VLC_SUCCESS )
+            return VLC_EGENERIC;
+
+    if( p_sys->i_filter_threads > 0 )
+    {
+        p_sys->p_vfilters[0].p_f_chain = id->p_f_chain;
+        p_sys->p_vfilters[0].p_uf_chain = id->p_uf_chain;
+    }
+    return VLC_SUCCESS;
+}
+
+static void transcode_video_filter_clean( sout_stream_t *p_stream,
+                                          sout_stream_id_sys_t *id )
+{
+    sout_stream_sys_t *p_sys = p_stream->p_sys;
+
+    if( id->p_f_chain )
+        filter_chain_Delete( id->p_f_chain );
+    if( id->p_uf_chain )
+        filter_chain_Delete( id->p_uf_chain );
+    id->p_f_chain = id->p_uf_chain = NULL;
+
+    /* The first filter thread uses the chains above */
+    for( int i = 0; i < p_sys->i_filter_threads; i++ )
+    {
+        transcode_vfilter_t *p_vf = &p_sys->p_vfilters[i];
+
+        if( i > 0 && p_vf->p_f_chain )
+            filter_chain_Delete( p_vf->p_f_chain );
+        if( i > 0 && p_vf->p_uf_chain )
+            filter_chain_Delete( p_vf->p_uf_chain );
+        p_vf->p_f_chain = p_vf->p_uf_chain = NULL;
+    }
+}
+
 static void transcode_video_framerate_init( sout_stream_t *p_stream,
                                             sout_stream_id_sys_t *id,
                                             const video_format_t *p_vid_out )
@@ -603,7 +879,9 @@ static void transcode_video_encoder_init( sout_stream_t *p_stream,
                                           sout_stream_id_sys_t *id,
                                           picture_t *p_pic )
 {
-    const video_format_t *p_vid_out = video_output_format( id, p_pic );
+    const video_format_t *p_vid_out = video_output_format( id->p_f_chain,
+                                                           id->p_uf_chain,
+                                                           p_pic );
 
     id->p_encoder->fmt_in.video.orientation =
         id->p_encoder->fmt_out.video.orientation =
@@ -658,25 +936,45 @@ static int transcode_video_encoder_open( sout_stream_t *p_stream,
 void transcode_video_close( sout_stream_t *p_stream,
                                    sout_stream_id_sys_t *id )
 {
-    if( p_stream->p_sys->i_threads >= 1 && !p_stream->p_sys->b_abort )
+    sout_stream_sys_t *p_sys = p_stream->p_sys;
+
+    if( transcode_video_threaded( p_sys ) )
     {
-        vlc_mutex_lock( &p_stream->p_sys->lock_out );
-        p_stream->p_sys->b_abort = true;
-        vlc_cond_signal( &p_stream->p_sys->cond );
-        vlc_mutex_unlock( &p_stream->p_sys->lock_out );
+        if( !p_sys->b_abort )
+            transcode_video_stop( p_sys );
+
+        /* Pictures of jobs the threads did not get to */
+        for( uint64_t i = p_sys->i_jobs_encode; i < p_sys->i_jobs_in; i++ )
+        {
+            transcode_video_job_t *p_job = &p_sys->p_jobs[i % p_sys->pool_size];
 
-        vlc_join( p_stream->p_sys->thread, NULL );
+            while( p_job->p_pics != NULL )
+            {
+                picture_t *p_pic = p_job->p_pics;
 
-        picture_fifo_Delete( p_stream->p_sys->pp_pics );
-        block_ChainRelease( p_stream->p_sys->p_buffers );
-    }
+                p_job->p_pics = p_pic->p_next;
+                picture_Release( p_pic );
+            }
+        }
+        block_ChainRelease( p_sys->p_buffers );
+        p_sys->p_buffers = NULL;
 
-    if( p_stream->p_sys->i_threads >= 1 )
-    {
-        vlc_mutex_destroy( &p_stream->p_sys->lock_out );
-        vlc_cond_destroy( &p_stream->p_sys->cond );
+        vlc_mutex_destroy( &p_sys->lock_out );
+        vlc_cond_destroy( &p_sys->cond );
     }
 
+    msg_Dbg( p_stream, "decoder: %"PRIu64" pictures in %"PRId64" ms, "
+             "%"PRId64" ms waiting", p_sys->stats_decode.i_pictures,
+             p_sys->stats_decode.i_time / 1000,
+             p_sys->stats_decode.i_wait / 1000 );
+    msg_Dbg( p_stream, "filters (%d threads): %"PRIu64" pictures in %"PRId64
+             " ms", p_sys->i_filter_threads, p_sys->stats_filter.i_pictures,
+             p_sys->stats_filter.i_time / 1000 );
+    msg_Dbg( p_stream, "encoder: %"PRIu64" pictures in %"PRId64" ms, "
+             "%"PRId64" ms waiting", p_sys->stats_encode.i_pictures,
+             p_sys->stats_encode.i_time / 1000,
+             p_sys->stats_encode.i_wait / 1000 );
+
     /* Close decoder */
     if( id->p_decoder->p_module )
         module_unneed( id->p_decoder, id->p_decoder->p_module );
@@ -688,77 +986,81 @@ void transcode_video_close( sout_stream_t *p_stream,
         module_unneed( id->p_encoder, id->p_encoder->p_module );
 
     /* Close filters */
-    if( id->p_f_chain )
-        filter_chain_Delete( id->p_f_chain );
-    if( id->p_uf_chain )
-        filter_chain_Delete( id->p_uf_chain );
+    transcode_video_filter_clean( p_stream, id );
+    free( p_sys->p_jobs );
+    free( p_sys->p_vfilters );
+    p_sys->p_jobs = NULL;
+    p_sys->p_vfilters = NULL;
 }
 
-static void OutputFrame( sout_stream_t *p_stream, picture_t *p_pic, sout_stream_id_sys_t *id, block_t **out )
+/* Overlays the subpictures due at the picture date, if any */
+static picture_t *RenderSubpictures( sout_stream_t *p_stream,
+                                     sout_stream_id_sys_t *id,
+                                     picture_t *p_pic )
 {
     sout_stream_sys_t *p_sys = p_stream->p_sys;
 
-    /*
-     * Encoding
-     */
-    /* Check if we have a subpicture to overlay */
-    if( p_sys->p_spu )
+    if( !p_sys->p_spu )
+        return p_pic;
+
+    video_format_t fmt = id->p_encoder->fmt_in.video;
+    if( fmt.i_visible_width <= 0 || fmt.i_visible_height <= 0 )
     {
-        video_format_t fmt = id->p_encoder->fmt_in.video;
-        if( fmt.i_visible_width <= 0 || fmt.i_visible_height <= 0 )
-        {
-            fmt.i_visible_width  = fmt.i_width;
-            fmt.i_visible_height = fmt.i_height;
-            fmt.i_x_offset       = 0;
-            fmt.i_y_offset       = 0;
-        }
+        fmt.i_visible_width  = fmt.i_width;
+        fmt.i_visible_height = fmt.i_height;
+        fmt.i_x_offset       = 0;
+        fmt.i_y_offset       = 0;
+    }
 
-        subpicture_t *p_subpic = spu_Render( p_sys->p_spu, NULL, &fmt,
-                                             &id->p_decoder->fmt_out.video,
-                                             p_pic->date, p_pic->date, false );
+    subpicture_t *p_subpic = spu_Render( p_sys->p_spu, NULL, &fmt,
+                                         &id->p_decoder->fmt_out.video,
+                                         p_pic->date, p_pic->date, false );
 
-        /* Overlay subpicture */
-        if( p_subpic )
+    /* Overlay subpicture */
+    if( p_subpic )
+    {
+        if( filter_chain_IsEmpty( id->p_f_chain ) )
         {
-            if( filter_chain_IsEmpty( id->p_f_chain ) )
+            /* We can't modify the picture, we need to duplicate it,
+             * in this point the picture is already p_encoder->fmt.in format*/
+            picture_t *p_tmp = video_new_buffer_encoder( id->p_encoder );
+            if( likely( p_tmp ) )
             {
-                /* We can't modify the picture, we need to duplicate it,
-                 * in this point the picture is already p_encoder->fmt.in format*/
-                picture_t *p_tmp = video_new_buffer_encoder( id->p_encoder );
-                if( likely( p_tmp ) )
-                {
-                    picture_Copy( p_tmp, p_pic );
-                    picture_Release( p_pic );
-                    p_pic = p_tmp;
-                }
+                picture_Copy( p_tmp, p_pic );
+                picture_Release( p_pic );
+                p_pic = p_tmp;
             }
-            if( unlikely( !p_sys->p_spu_blend ) )
-                p_sys->p_spu_blend = filter_NewBlend( VLC_OBJECT( p_sys->p_spu ), &fmt );
-            if( likely( p_sys->p_spu_blend ) )
-                picture_BlendSubpicture( p_pic, p_sys->p_spu_blend, p_subpic );
-            subpicture_Delete( p_subpic );
         }
+        if( unlikely( !p_sys->p_spu_blend ) )
+            p_sys->p_spu_blend = filter_NewBlend( VLC_OBJECT( p_sys->p_spu ), &fmt );
+        if( likely( p_sys->p_spu_blend ) )
+            picture_BlendSubpicture( p_pic, p_sys->p_spu_blend, p_subpic );
+        subpicture_Delete( p_subpic );
     }
+    return p_pic;
+}
+
+static void OutputFrame( sout_stream_t *p_stream, picture_t *p_pic, sout_stream_id_sys_t *id, block_t **out )
+{
+    sout_stream_sys_t *p_sys = p_stream->p_sys;
 
-    if( p_sys->i_threads == 0 )
+    /*
+     * Encoding
+     */
+    if( !transcode_video_threaded( p_sys ) )
     {
         block_t *p_block;
+        vlc_tick_t i_start = mdate();
 
+        p_pic = RenderSubpictures( p_stream, id, p_pic );
         p_block = id->p_encoder->pf_encode_video( id->p_encoder, p_pic );
         block_ChainAppend( out, p_block );
-    }
-
-    if( p_sys->i_threads )
-    {
-        vlc_sem_wait( &p_sys->picture_pool_has_room );
-        vlc_mutex_lock( &p_sys->lock_out );
-        picture_fifo_Push( p_sys->pp_pics, p_pic );
-        vlc_cond_signal( &p_sys->cond );
-        vlc_mutex_unlock( &p_sys->lock_out );
-    }
-
-    if ( p_sys->i_threads == 0 )
+        p_sys->stats_encode.i_time += mdate() - i_start;
+        p_sys->stats_encode.i_pictures++;
         picture_Release( p_pic );
+    }
+    else
+        transcode_video_submit( p_stream, p_pic, true );
 }
 
 int transcode_video_process( sout_stream_t *p_stream, sout_stream_id_sys_t *id,
@@ -767,7 +1069,9 @@ int transcode_video_process( sout_stream_t *p_stream, sout_stream_id_sys_t *id,
     sout_stream_sys_t *p_sys = p_stream->p_sys;
     *out = NULL;
 
+    vlc_tick_t i_start = mdate();
     int ret = id->p_decoder->pf_decode( id->p_decoder, in );
+    p_sys->stats_decode.i_time += mdate() - i_start;
     if( ret != VLCDEC_SUCCESS )
         return VLC_EGENERIC;
 
@@ -780,6 +1084,7 @@ int transcode_video_process( sout_stream_t *p_stream, sout_stream_id_sys_t *id,
         picture_t *p_pic = p_pics;
         p_pics = p_pics->p_next;
         p_pic->p_next = NULL;
+        p_sys->stats_decode.i_pictures++;
 
         if( id->b_error )
         {
@@ -797,13 +1102,12 @@ int transcode_video_process( sout_stream_t *p_stream, sout_stream_id_sys_t *id,
                         id->fmt_input_video.i_sar_num, p_pic->format.i_sar_num,
                         id->fmt_input_video.i_sar_den, p_pic->format.i_sar_den
                     );
+            /* The threads must be done with the filters */
+            if( transcode_video_threaded( p_sys ) )
+                transcode_video_drain( p_sys );
+
             /* Close filters */
-            if( id->p_f_chain )
-                filter_chain_Delete( id->p_f_chain );
-            id->p_f_chain = NULL;
-            if( id->p_uf_chain )
-                filter_chain_Delete( id->p_uf_chain );
-            id->p_uf_chain = NULL;
+            transcode_video_filter_clean( p_stream, id );
 
             /* Reinitialize filters */
             id->p_encoder->fmt_out.video.i_visible_width  = p_sys->i_width & ~1;
@@ -811,8 +1115,7 @@ int transcode_video_process( sout_stream_t *p_stream, sout_stream_id_sys_t *id,
             id->p_encoder->fmt_out.video.i_sar_num = id->p_encoder->fmt_out.video.i_sar_den = 0;
 
             transcode_video_encoder_init( p_stream, id, p_pic );
-            transcode_video_filter_init( p_stream, id );
-            if( conversion_video_filter_append( id, p_pic ) != VLC_SUCCESS )
+            if( transcode_video_filter_setup( p_stream, id, p_pic ) != VLC_SUCCESS )
                 goto error;
             memcpy( &id->fmt_input_video, &p_pic->format, sizeof(video_format_t));
         }
@@ -820,15 +1123,10 @@ int transcode_video_process( sout_stream_t *p_stream, sout_stream_id_sys_t *id,
 
         if( unlikely( !id->p_encoder->p_module && p_pic ) )
         {
-            if( id->p_f_chain )
-                filter_chain_Delete( id->p_f_chain );
-            if( id->p_uf_chain )
-                filter_chain_Delete( id->p_uf_chain );
-            id->p_f_chain = id->p_uf_chain = NULL;
+            transcode_video_filter_clean( p_stream, id );
 
             transcode_video_encoder_init( p_stream, id, p_pic );
-            transcode_video_filter_init( p_stream, id );
-            if( conversion_video_filter_append( id, p_pic ) != VLC_SUCCESS )
+            if( transcode_video_filter_setup( p_stream, id, p_pic ) != VLC_SUCCESS )
                 goto error;
             memcpy( &id->fmt_input_video, &p_pic->format, sizeof(video_format_t));
 
@@ -836,34 +1134,25 @@ int transcode_video_process( sout_stream_t *p_stream, sout_stream_id_sys_t *id,
                 goto error;
         }
 
-        /* Run the filter and output chains; first with the picture,
-         * and then with NULL as many times as we need until they
-         * stop outputting frames.
-         */
-        for ( ;; ) {
-            picture_t *p_filtered_pic = p_pic;
-
-            /* Run filter chain */
-            if( id->p_f_chain )
-                p_filtered_pic = filter_chain_VideoFilter( id->p_f_chain, p_filtered_pic );
-            if( !p_filtered_pic )
-                break;
-
-            for ( ;; ) {
-                picture_t *p_user_filtered_pic = p_filtered_pic;
-
-                /* Run user specified filter chain */
-                if( id->p_uf_chain )
-                    p_user_filtered_pic = filter_chain_VideoFilter( id->p_uf_chain, p_user_filtered_pic );
-                if( !p_user_filtered_pic )
-                    break;
+        if( p_sys->i_filter_threads > 0 )
+        {
+            transcode_video_submit( p_stream, p_pic, false );
+            continue;
+        }
 
-                OutputFrame( p_stream, p_user_filtered_pic, id, out );
+        i_start = mdate();
+        picture_t *p_out = transcode_video_filter( id->p_f_chain,
+                                                   id->p_uf_chain, p_pic );
+        p_sys->stats_filter.i_time += mdate() - i_start;
+        p_sys->stats_filter.i_pictures++;
 
-                p_filtered_pic = NULL;
-            }
+        while( p_out != NULL )
+        {
+            picture_t *p_next = p_out->p_next;
 
-            p_pic = NULL;
+            p_out->p_next = NULL;
+            OutputFrame( p_stream, p_out, id, out );
+            p_out = p_next;
         }
         continue;
 error:
@@ -872,7 +1161,7 @@ error:
         id->b_error = true;
     } while( p_pics );
 
-    if( p_sys->i_threads >= 1 )
+    if( transcode_video_threaded( p_sys ) )
     {
         /* Pick up any return data the encoder thread wants to output. */
         vlc_mutex_lock( &p_sys->lock_out );
@@ -885,7 +1174,7 @@ end:
     /* Drain encoder */
     if( unlikely( !id->b_error && in == NULL ) )
     {
-        if( p_sys->i_threads == 0 )
+        if( !transcode_video_threaded( p_sys ) )
         {
             if( id->p_encoder->p_module )
             {
@@ -899,14 +1188,10 @@ end:
         else
         {
             msg_Dbg( p_stream, "Flushing thread and waiting that");
-            vlc_mutex_lock( &p_stream->p_sys->lock_out );
-            p_stream->p_sys->b_abort = true;
-            vlc_cond_signal( &p_stream->p_sys->cond );
-            vlc_mutex_unlock( &p_stream->p_sys->lock_out );
+            transcode_video_stop( p_sys );
 
-            vlc_join( p_stream->p_sys->thread, NULL );
             vlc_mutex_lock( &p_sys->lock_out );
-            *out = p_sys->p_buffers;
+            block_ChainAppend( out, p_sys->p_buffers );
             p_sys->p_buffers = NULL;
             vlc_mutex_unlock( &p_sys->lock_out );
 
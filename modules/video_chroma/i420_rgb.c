@@ -296,17 +296,42 @@ static void Deactivate( vlc_object_t *p_this )
     free( p_filter->p_sys );
 }
 
+/* Unless the picture is scaled, lines are converted independently of each
+ * other, so slices of them can be converted in parallel. */
+#define I420_RGB_WRAPPER( name )                                        \
+    static picture_t *name ## _Filter ( filter_t *p_filter,             \
+                                        picture_t *p_pic )              \
+    {                                                                   \
+        const video_format_t *p_in = &p_filter->fmt_in.video;           \
+        const video_format_t *p_out = &p_filter->fmt_out.video;         \
+        unsigned i_lines = p_in->i_y_offset + p_in->i_visible_height;   \
+        picture_t *p_outpic = filter_NewPicture( p_filter );            \
+        if( p_outpic )                                                  \
+        {                                                               \
+            if( p_in->i_x_offset + p_in->i_visible_width                \
+                 == p_out->i_x_offset + p_out->i_visible_width          \
+             && i_lines == p_out->i_y_offset + p_out->i_visible_height )\
+                filter_ExecutePictureSlices( p_filter, name, p_pic,     \
+                                             p_outpic, i_lines, 2 );    \
+            else                                                        \
+                name( p_filter, p_pic, p_outpic, i_lines );             \
+            picture_CopyProperties( p_outpic, p_pic );                  \
+        }                                                               \
+        picture_Release( p_pic );                                       \
+        return p_outpic;                                                \
+    }
+
 #ifndef PLAIN
-VIDEO_FILTER_WRAPPER( I420_R5G5B5 )
-VIDEO_FILTER_WRAPPER( I420_R5G6B5 )
-VIDEO_FILTER_WRAPPER( I420_A8R8G8B8 )
-VIDEO_FILTER_WRAPPER( I420_R8G8B8A8 )
-VIDEO_FILTER_WRAPPER( I420_B8G8R8A8 )
-VIDEO_FILTER_WRAPPER( I420_A8B8G8R8 )
+I420_RGB_WRAPPER( I420_R5G5B5 )
+I420_RGB_WRAPPER( I420_R5G6B5 )
+I420_RGB_WRAPPER( I420_A8R8G8B8 )
+I420_RGB_WRAPPER( I420_R8G8B8A8 )
+I420_RGB_WRAPPER( I420_B8G8R8A8 )
+I420_RGB_WRAPPER( I420_A8B8G8R8 )
 #else
 VIDEO_FILTER_WRAPPER( I420_RGB8 )
-VIDEO_FILTER_WRAPPER( I420_RGB16 )
-VIDEO_FILTER_WRAPPER( I420_RGB32 )
+I420_RGB_WRAPPER( I420_RGB16 )
+I420_RGB_WRAPPER( I420_RGB32 )
 
 /*****************************************************************************
  * SetGammaTable: return intensity table transformed by gamma curve.
@@ -61,15 +61,23 @@ struct filter_sys_t
  *****************************************************************************/
 #ifdef PLAIN
 void I420_RGB8         ( filter_t *, picture_t *, picture_t * );
-void I420_RGB16        ( filter_t *, picture_t *, picture_t * );
-void I420_RGB32        ( filter_t *, picture_t *, picture_t * );
+void I420_RGB16        ( filter_t *, picture_t *, picture_t *,
+                         unsigned );
+void I420_RGB32        ( filter_t *, picture_t *, picture_t *,
+                         unsigned );
 #else
-void I420_R5G5B5       ( filter_t *, picture_t *, picture_t * );
-void I420_R5G6B5       ( filter_t *, picture_t *, picture_t * );
-void I420_A8R8G8B8     ( filter_t *, picture_t *, picture_t * );
-void I420_R8G8B8A8     ( filter_t *, picture_t *, picture_t * );
-void I420_B8G8R8A8     ( filter_t *, picture_t *, picture_t * );
-void I420_A8B8G8R8     ( filter_t *, picture_t *, picture_t * );
+void I420_R5G5B5       ( filter_t *, picture_t *, picture_t *,
+                         unsigned );
+void I420_R5G6B5       ( filter_t *, picture_t *, picture_t *,
+                         unsigned );
+void I420_A8R8G8B8     ( filter_t *, picture_t *, picture_t *,
+                         unsigned );
+void I420_R8G8B8A8     ( filter_t *, picture_t *, picture_t *,
+                         unsigned );
+void I420_B8G8R8A8     ( filter_t *, picture_t *, picture_t *,
+                         unsigned );
+void I420_A8B8G8R8     ( filter_t *, picture_t *, picture_t *,
+                         unsigned );
 #endif
 
 /*****************************************************************************
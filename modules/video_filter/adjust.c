@@ -49,6 +49,8 @@ static int  Create    ( vlc_object_t * );
 static void Destroy   ( vlc_object_t * );
 
 static picture_t *FilterPlanar( filter_t *, picture_t * );
+static void FilterPlanarSlice( filter_t *, picture_t *, picture_t *,
+                               unsigned );
 static picture_t *FilterPacked( filter_t *, picture_t * );
 static int AdjustCallback( vlc_object_t *p_this, char const *psz_var,
                            vlc_value_t oldval, vlc_value_t newval,
@@ -123,6 +125,12 @@ struct filter_sys_t
                                int, int );
     int (*pf_process_sat_hue_clip)( picture_t *, picture_t *, int, int,
                                     int, int, int );
+
+    /* Parameters of the planar picture being filtered, for its slices */
+    int pi_luma[1024]; /* The full range will only be used for 10-bit */
+    bool b_16bit;
+    bool b_sat_clip;
+    int i_sin, i_cos, i_sat, i_x, i_y;
 };
 
 /*****************************************************************************
@@ -230,8 +238,7 @@ static void Destroy( vlc_object_t *p_this )
  *****************************************************************************/
 static picture_t *FilterPlanar( filter_t *p_filter, picture_t *p_pic )
 {
-    /* The full range will only be used for 10-bit */
-    int pi_luma[1024];
+    int *pi_luma = p_filter->p_sys->pi_luma;
     int pi_gamma[1024];
 
     picture_t *p_outpic;
@@ -316,10 +323,41 @@ static picture_t *FilterPlanar( filter_t *p_filter, picture_t *p_pic )
         i_sat = 0;
     }
 
+    p_sys->b_16bit = b_16bit;
+    p_sys->b_sat_clip = i_sat > i_range;
+    p_sys->i_sat = i_sat;
+    p_sys->i_sin = sinf(f_hue) * f_max;
+    p_sys->i_cos = cosf(f_hue) * f_max;
+
+    /* pow(2, (bpp * 2) - 1) */
+    p_sys->i_x = ( cosf(f_hue) + sinf(f_hue) ) * f_range * i_mid;
+    p_sys->i_y = ( cosf(f_hue) - sinf(f_hue) ) * f_range * i_mid;
+
+    /* Slices must not split the subsampled chroma lines */
+    unsigned i_align = p_pic->p[Y_PLANE].i_lines / p_pic->p[U_PLANE].i_lines;
+
+    filter_ExecutePictureSlices( p_filter, FilterPlanarSlice, p_pic, p_outpic,
+                                 p_pic->p[Y_PLANE].i_visible_lines,
+                                 __MAX(i_align, 1) );
+
+    return CopyInfoAndRelease( p_outpic, p_pic );
+}
+
+/*****************************************************************************
+ * Run the filter on a slice of a Planar YUV picture
+ *****************************************************************************/
+static void FilterPlanarSlice( filter_t *p_filter, picture_t *p_pic,
+                               picture_t *p_outpic, unsigned i_lines )
+{
+    filter_sys_t *p_sys = p_filter->p_sys;
+    const int *pi_luma = p_sys->pi_luma;
+
+    VLC_UNUSED(i_lines);
+
     /*
      * Do the Y plane
      */
-    if ( b_16bit )
+    if ( p_sys->b_16bit )
     {
         uint16_t *p_in, *p_in_end, *p_line_end;
         uint16_t *p_out;
@@ -396,29 +434,22 @@ static picture_t *FilterPlanar( filter_t *p_filter, picture_t *p_pic )
      * Do the U and V planes
      */
 
-    int i_sin = sinf(f_hue) * f_max;
-    int i_cos = cosf(f_hue) * f_max;
-
-    /* pow(2, (bpp * 2) - 1) */
-    int i_x = ( cosf(f_hue) + sinf(f_hue) ) * f_range * i_mid;
-    int i_y = ( cosf(f_hue) - sinf(f_hue) ) * f_range * i_mid;
-
-    if ( i_sat > i_range )
+    if ( p_sys->b_sat_clip )
     {
         /* Currently no errors are implemented in the function, if any are added
          * check them here */
-        p_sys->pf_process_sat_hue_clip( p_pic, p_outpic, i_sin, i_cos, i_sat,
-                                        i_x, i_y );
+        p_sys->pf_process_sat_hue_clip( p_pic, p_outpic, p_sys->i_sin,
+                                        p_sys->i_cos, p_sys->i_sat,
+                                        p_sys->i_x, p_sys->i_y );
     }
     else
     {
         /* Currently no errors are implemented in the function, if any are added
          * check them here */
-        p_sys->pf_process_sat_hue( p_pic, p_outpic, i_sin, i_cos, i_sat,
-                                        i_x, i_y );
+        p_sys->pf_process_sat_hue( p_pic, p_outpic, p_sys->i_sin,
+                                   p_sys->i_cos, p_sys->i_sat,
+                                   p_sys->i_x, p_sys->i_y );
     }
-
-    return CopyInfoAndRelease( p_outpic, p_pic );
 }
 
 /*****************************************************************************
@@ -32,6 +32,7 @@
 #include <vlc_plugin.h>
 #include <vlc_filter.h>
 #include <vlc_picture.h>
+#include <vlc_cpu.h>
 #include "filter_picture.h"
 
 /*****************************************************************************
@@ -40,9 +41,14 @@
 static int  Open (vlc_object_t *);
 static void Close(vlc_object_t *);
 
+#define SIMD_TEXT N_("Use SIMD blending")
+#define SIMD_LONGTEXT N_("Blend the most common formats with SIMD " \
+    "instructions when the CPU supports them.")
+
 vlc_module_begin()
     set_description(N_("Video pictures blending"))
     set_capability("video blending", 100)
+    add_bool("blend-simd", true, SIMD_TEXT, SIMD_LONGTEXT, true)
     set_callbacks(Open, Close)
 vlc_module_end()
 
@@ -623,13 +629,711 @@ static const struct {
 #undef YUV
 };
 
+/*****************************************************************************
+ * Line based blending
+ *
+ * The most common blendings (subtitles and OSD in YUVA or RGBA onto I420,
+ * NV12 or RGB32 pictures) are done one line at a time by a few simple
+ * kernels. Each kernel has a SIMD version, and all of them give exactly the
+ * same results as the generic code above.
+ *****************************************************************************/
+struct blend_kernels_t {
+    const char *name;
+    /* a[i] = alpha * src_a[i] / 255 */
+    void (*alpha)(uint8_t *a, const uint8_t *src_a, unsigned alpha, unsigned n);
+    /* dst[i] = (dst[i] * (255 - a[i]) + src[i] * a[i]) / 255 */
+    void (*merge)(uint8_t *dst, const uint8_t *src, const uint8_t *a, unsigned n);
+    /* dst[i] = src[2 * i], src holding at least 2 * n - 1 bytes */
+    void (*even)(uint8_t *dst, const uint8_t *src, unsigned n);
+    void (*interleave2)(uint8_t *dst, const uint8_t *src0, const uint8_t *src1,
+                        unsigned n);
+    void (*interleave4)(uint8_t *dst, const uint8_t *const src[4], unsigned n);
+    void (*deinterleave4)(uint8_t *const dst[4], const uint8_t *src, unsigned n);
+    /* Conversions, which may be done in place */
+    void (*yuv_to_rgb)(uint8_t *const dst[3], const uint8_t *const src[3],
+                       unsigned n);
+    void (*rgb_to_yuv)(uint8_t *const dst[3], const uint8_t *const src[3],
+                       unsigned n);
+};
+
+/* Same constants as yuv_to_rgb() */
+#define YUV_FIX(x) ((int) ((x) * (1 << 10) + 0.5))
+enum {
+    YUV_FIX_Y  = YUV_FIX(255.0/219.0),
+    YUV_FIX_RV = YUV_FIX(1.40200*255.0/224.0),
+    YUV_FIX_GU = YUV_FIX(0.34414*255.0/224.0),
+    YUV_FIX_GV = YUV_FIX(0.71414*255.0/224.0),
+    YUV_FIX_BU = YUV_FIX(1.77200*255.0/224.0),
+    YUV_ONE_HALF = 1 << 9,
+};
+#undef YUV_FIX
+
+static void AlphaC(uint8_t *a, const uint8_t *src_a, unsigned alpha, unsigned n)
+{
+    for (unsigned i = 0; i < n; i++)
+        a[i] = div255(alpha * src_a[i]);
+}
+
+static void MergeC(uint8_t *dst, const uint8_t *src, const uint8_t *a, unsigned n)
+{
+    for (unsigned i = 0; i < n; i++)
+        merge(&dst[i], src[i], a[i]);
+}
+
+static void EvenC(uint8_t *dst, const uint8_t *src, unsigned n)
+{
+    for (unsigned i = 0; i < n; i++)
+        dst[i] = src[2 * i];
+}
+
+static void Interleave2C(uint8_t *dst, const uint8_t *src0, const uint8_t *src1,
+                         unsigned n)
+{
+    for (unsigned i = 0; i < n; i++) {
+        dst[2 * i + 0] = src0[i];
+        dst[2 * i + 1] = src1[i];
+    }
+}
+
+static void Interleave4C(uint8_t *dst, const uint8_t *const src[4], unsigned n)
+{
+    for (unsigned i = 0; i < n; i++)
+        for (unsigned c = 0; c < 4; c++)
+            dst[4 * i + c] = src[c][i];
+}
+
+static void Deinterleave4C(uint8_t *const dst[4], const uint8_t *src, unsigned n)
+{
+    for (unsigned i = 0; i < n; i++)
+        for (unsigned c = 0; c < 4; c++)
+            dst[c][i] = src[4 * i + c];
+}
+
+static void YuvToRgbC(uint8_t *const dst[3], const uint8_t *const src[3],
+                      unsigned n)
+{
+    for (unsigned i = 0; i < n; i++) {
+        int r, g, b;
+        yuv_to_rgb(&r, &g, &b, src[0][i], src[1][i], src[2][i]);
+        dst[0][i] = r;
+        dst[1][i] = g;
+        dst[2][i] = b;
+    }
+}
+
+static void RgbToYuvC(uint8_t *const dst[3], const uint8_t *const src[3],
+                      unsigned n)
+{
+    for (unsigned i = 0; i < n; i++) {
+        uint8_t y, u, v;
+        rgb_to_yuv(&y, &u, &v, src[0][i], src[1][i], src[2][i]);
+        dst[0][i] = y;
+        dst[1][i] = u;
+        dst[2][i] = v;
+    }
+}
+
+/* Calls the C kernel on the samples left by a SIMD loop */
+#define TAIL3(f, i, n, d, s) do { \
+    uint8_t *const td[3] = { &(d)[0][i], &(d)[1][i], &(d)[2][i] }; \
+    const uint8_t *const ts[3] = { &(s)[0][i], &(s)[1][i], &(s)[2][i] }; \
+    f(td, ts, (n) - (i)); \
+} while (0)
+
+#if (defined(__i386__) || defined(__x86_64__)) && \
+    (VLC_GCC_VERSION(4,9) || defined(__clang__))
+# include <immintrin.h>
+# define BLEND_HAVE_X86
+
+/* Coefficients for _mm_madd_epi16(): lo for the low sample of each pair */
+# define PAIR16(lo, hi) \
+    ((int)(((uint32_t)(uint16_t)(hi) << 16) | (uint16_t)(lo)))
+
+__attribute__ ((__target__ ("sse2")))
+static inline __m128i Div255SSE2(__m128i v)
+{
+    const __m128i one = _mm_set1_epi16(1);
+    return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(_mm_srli_epi16(v, 8), v),
+                                        one), 8);
+}
+
+__attribute__ ((__target__ ("sse2")))
+static void AlphaSSE2(uint8_t *a, const uint8_t *src_a, unsigned alpha, unsigned n)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i k = _mm_set1_epi16(alpha);
+    unsigned i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        __m128i s = _mm_loadu_si128((const __m128i *)&src_a[i]);
+        __m128i lo = Div255SSE2(_mm_mullo_epi16(_mm_unpacklo_epi8(s, zero), k));
+        __m128i hi = Div255SSE2(_mm_mullo_epi16(_mm_unpackhi_epi8(s, zero), k));
+        _mm_storeu_si128((__m128i *)&a[i], _mm_packus_epi16(lo, hi));
+    }
+    AlphaC(&a[i], &src_a[i], alpha, n - i);
+}
+
+__attribute__ ((__target__ ("sse2")))
+static void MergeSSE2(uint8_t *dst, const uint8_t *src, const uint8_t *a, unsigned n)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i k255 = _mm_set1_epi16(255);
+    unsigned i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        __m128i d = _mm_loadu_si128((const __m128i *)&dst[i]);
+        __m128i s = _mm_loadu_si128((const __m128i *)&src[i]);
+        __m128i f = _mm_loadu_si128((const __m128i *)&a[i]);
+        __m128i flo = _mm_unpacklo_epi8(f, zero);
+        __m128i fhi = _mm_unpackhi_epi8(f, zero);
+        /* At most 255 * 255, so unsigned 16 bits are enough */
+        __m128i lo = _mm_add_epi16(
+            _mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), _mm_sub_epi16(k255, flo)),
+            _mm_mullo_epi16(_mm_unpacklo_epi8(s, zero), flo));
+        __m128i hi = _mm_add_epi16(
+            _mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), _mm_sub_epi16(k255, fhi)),
+            _mm_mullo_epi16(_mm_unpackhi_epi8(s, zero), fhi));
+        _mm_storeu_si128((__m128i *)&dst[i],
+                         _mm_packus_epi16(Div255SSE2(lo), Div255SSE2(hi)));
+    }
+    MergeC(&dst[i], &src[i], &a[i], n - i);
+}
+
+__attribute__ ((__target__ ("sse2")))
+static void EvenSSE2(uint8_t *dst, const uint8_t *src, unsigned n)
+{
+    const __m128i mask = _mm_set1_epi16(0x00ff);
+    unsigned i = 0;
+
+    for (; i + 16 < n; i += 16) {
+        __m128i s0 = _mm_loadu_si128((const __m128i *)&src[2 * i]);
+        __m128i s1 = _mm_loadu_si128((const __m128i *)&src[2 * i + 16]);
+        _mm_storeu_si128((__m128i *)&dst[i],
+                         _mm_packus_epi16(_mm_and_si128(s0, mask),
+                                          _mm_and_si128(s1, mask)));
+    }
+    EvenC(&dst[i], &src[2 * i], n - i);
+}
+
+__attribute__ ((__target__ ("sse2")))
+static void Interleave2SSE2(uint8_t *dst, const uint8_t *src0, const uint8_t *src1,
+                            unsigned n)
+{
+    unsigned i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        __m128i s0 = _mm_loadu_si128((const __m128i *)&src0[i]);
+        __m128i s1 = _mm_loadu_si128((const __m128i *)&src1[i]);
+        _mm_storeu_si128((__m128i *)&dst[2 * i +  0], _mm_unpacklo_epi8(s0, s1));
+        _mm_storeu_si128((__m128i *)&dst[2 * i + 16], _mm_unpackhi_epi8(s0, s1));
+    }
+    Interleave2C(&dst[2 * i], &src0[i], &src1[i], n - i);
+}
+
+__attribute__ ((__target__ ("sse2")))
+static void Interleave4SSE2(uint8_t *dst, const uint8_t *const src[4], unsigned n)
+{
+    unsigned i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        __m128i s0 = _mm_loadu_si128((const __m128i *)&src[0][i]);
+        __m128i s1 = _mm_loadu_si128((const __m128i *)&src[1][i]);
+        __m128i s2 = _mm_loadu_si128((const __m128i *)&src[2][i]);
+        __m128i s3 = _mm_loadu_si128((const __m128i *)&src[3][i]);
+        __m128i lo01 = _mm_unpacklo_epi8(s0, s1);
+        __m128i hi01 = _mm_unpackhi_epi8(s0, s1);
+        __m128i lo23 = _mm_unpacklo_epi8(s2, s3);
+        __m128i hi23 = _mm_unpackhi_epi8(s2, s3);
+        _mm_storeu_si128((__m128i *)&dst[4 * i +  0], _mm_unpacklo_epi16(lo01, lo23));
+        _mm_storeu_si128((__m128i *)&dst[4 * i + 16], _mm_unpackhi_epi16(lo01, lo23));
+        _mm_storeu_si128((__m128i *)&dst[4 * i + 32], _mm_unpacklo_epi16(hi01, hi23));
+        _mm_storeu_si128((__m128i *)&dst[4 * i + 48], _mm_unpackhi_epi16(hi01, hi23));
+    }
+    const uint8_t *const tail[4] = { &src[0][i], &src[1][i], &src[2][i], &src[3][i] };
+    Interleave4C(&dst[4 * i], tail, n - i);
+}
+
+__attribute__ ((__target__ ("sse2")))
+static void Deinterleave4SSE2(uint8_t *const dst[4], const uint8_t *src, unsigned n)
+{
+    const __m128i mask = _mm_set1_epi32(0xff);
+    unsigned i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        __m128i s[4];
+        for (unsigned j = 0; j < 4; j++)
+            s[j] = _mm_loadu_si128((const __m128i *)&src[4 * i + 16 * j]);
+        for (unsigned c = 0; c < 4; c++) {
+            __m128i v[4];
+            for (unsigned j = 0; j < 4; j++)
+                v[j] = _mm_and_si128(_mm_srli_epi32(s[j], 8 * c), mask);
+            _mm_storeu_si128((__m128i *)&dst[c][i],
+                             _mm_packus_epi16(_mm_packs_epi32(v[0], v[1]),
+                                              _mm_packs_epi32(v[2], v[3])));
+        }
+    }
+    uint8_t *const tail[4] = { &dst[0][i], &dst[1][i], &dst[2][i], &dst[3][i] };
+    Deinterleave4C(tail, &src[4 * i], n - i);
+}
+
+/* Computes 8 components in 32 bits from 8 pairs of 16 bits samples */
+__attribute__ ((__target__ ("sse2")))
+static inline __m128i YuvToRgbComponentSSE2(__m128i a, __m128i b, __m128i c,
+                                            __m128i kab, __m128i kc)
+{
+    const __m128i half = _mm_set1_epi32(YUV_ONE_HALF);
+    __m128i lo = _mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(a, b), kab),
+                               _mm_madd_epi16(_mm_unpacklo_epi16(c, c), kc));
+    __m128i hi = _mm_add_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(a, b), kab),
+                               _mm_madd_epi16(_mm_unpackhi_epi16(c, c), kc));
+    lo = _mm_srai_epi32(_mm_add_epi32(lo, half), 10);
+    hi = _mm_srai_epi32(_mm_add_epi32(hi, half), 10);
+    return _mm_packs_epi32(lo, hi);
+}
+
+__attribute__ ((__target__ ("sse2")))
+static void YuvToRgbSSE2(uint8_t *const dst[3], const uint8_t *const src[3],
+                         unsigned n)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i k16 = _mm_set1_epi16(16);
+    const __m128i k128 = _mm_set1_epi16(128);
+    const __m128i kr = _mm_set1_epi32(PAIR16(YUV_FIX_Y, YUV_FIX_RV));
+    const __m128i kgb = _mm_set1_epi32(PAIR16(YUV_FIX_Y, -YUV_FIX_GU));
+    const __m128i kgc = _mm_set1_epi32(PAIR16(-YUV_FIX_GV, 0));
+    const __m128i kb = _mm_set1_epi32(PAIR16(YUV_FIX_Y, YUV_FIX_BU));
+    unsigned i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        __m128i y = _mm_loadu_si128((const __m128i *)&src[0][i]);
+        __m128i u = _mm_loadu_si128((const __m128i *)&src[1][i]);
+        __m128i v = _mm_loadu_si128((const __m128i *)&src[2][i]);
+        __m128i r[2], g[2], b[2];
+
+        for (unsigned h = 0; h < 2; h++) {
+            __m128i y16, u16, v16;
+            if (h == 0) {
+                y16 = _mm_unpacklo_epi8(y, zero);
+                u16 = _mm_unpacklo_epi8(u, zero);
+                v16 = _mm_unpacklo_epi8(v, zero);
+            } else {
+                y16 = _mm_unpackhi_epi8(y, zero);
+                u16 = _mm_unpackhi_epi8(u, zero);
+                v16 = _mm_unpackhi_epi8(v, zero);
+            }
+            y16 = _mm_sub_epi16(y16, k16);
+            u16 = _mm_sub_epi16(u16, k128);
+            v16 = _mm_sub_epi16(v16, k128);
+
+            r[h] = YuvToRgbComponentSSE2(y16, v16, zero, kr, zero);
+            g[h] = YuvToRgbComponentSSE2(y16, u16, v16, kgb, kgc);
+            b[h] = YuvToRgbComponentSSE2(y16, u16, zero, kb, zero);
+        }
+        _mm_storeu_si128((__m128i *)&dst[0][i], _mm_packus_epi16(r[0], r[1]));
+        _mm_storeu_si128((__m128i *)&dst[1][i], _mm_packus_epi16(g[0], g[1]));
+        _mm_storeu_si128((__m128i *)&dst[2][i], _mm_packus_epi16(b[0], b[1]));
+    }
+    TAIL3(YuvToRgbC, i, n, dst, src);
+}
+
+__attribute__ ((__target__ ("sse2")))
+static void RgbToYuvSSE2(uint8_t *const dst[3], const uint8_t *const src[3],
+                         unsigned n)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i k16 = _mm_set1_epi16(16);
+    const __m128i k128 = _mm_set1_epi16(128);
+    unsigned i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        __m128i r = _mm_loadu_si128((const __m128i *)&src[0][i]);
+        __m128i g = _mm_loadu_si128((const __m128i *)&src[1][i]);
+        __m128i b = _mm_loadu_si128((const __m128i *)&src[2][i]);
+        __m128i y[2], u[2], v[2];
+
+        for (unsigned h = 0; h < 2; h++) {
+            __m128i r16, g16, b16;
+            if (h == 0) {
+                r16 = _mm_unpacklo_epi8(r, zero);
+                g16 = _mm_unpacklo_epi8(g, zero);
+                b16 = _mm_unpacklo_epi8(b, zero);
+            } else {
+                r16 = _mm_unpackhi_epi8(r, zero);
+                g16 = _mm_unpackhi_epi8(g, zero);
+                b16 = _mm_unpackhi_epi8(b, zero);
+            }
+            /* Luma fits in unsigned 16 bits, chroma in signed 16 bits */
+            __m128i ys = _mm_add_epi16(
+                _mm_add_epi16(_mm_mullo_epi16(r16, _mm_set1_epi16(66)),
+                              _mm_mullo_epi16(g16, _mm_set1_epi16(129))),
+                _mm_add_epi16(_mm_mullo_epi16(b16, _mm_set1_epi16(25)), k128));
+            __m128i us = _mm_add_epi16(
+                _mm_sub_epi16(_mm_mullo_epi16(b16, _mm_set1_epi16(112)),
+                              _mm_mullo_epi16(r16, _mm_set1_epi16(38))),
+                _mm_sub_epi16(k128, _mm_mullo_epi16(g16, _mm_set1_epi16(74))));
+            __m128i vs = _mm_add_epi16(
+                _mm_sub_epi16(_mm_mullo_epi16(r16, _mm_set1_epi16(112)),
+                              _mm_mullo_epi16(g16, _mm_set1_epi16(94))),
+                _mm_sub_epi16(k128, _mm_mullo_epi16(b16, _mm_set1_epi16(18))));
+            y[h] = _mm_add_epi16(_mm_srli_epi16(ys, 8), k16);
+            u[h] = _mm_add_epi16(_mm_srai_epi16(us, 8), k128);
+            v[h] = _mm_add_epi16(_mm_srai_epi16(vs, 8), k128);
+        }
+        _mm_storeu_si128((__m128i *)&dst[0][i], _mm_packus_epi16(y[0], y[1]));
+        _mm_storeu_si128((__m128i *)&dst[1][i], _mm_packus_epi16(u[0], u[1]));
+        _mm_storeu_si128((__m128i *)&dst[2][i], _mm_packus_epi16(v[0], v[1]));
+    }
+    TAIL3(RgbToYuvC, i, n, dst, src);
+}
+
+static const blend_kernels_t blend_sse2 = {
+    "sse2",
+    AlphaSSE2, MergeSSE2, EvenSSE2, Interleave2SSE2,
+    Interleave4SSE2, Deinterleave4SSE2, YuvToRgbSSE2, RgbToYuvSSE2,
+};
+
+/* The AVX2 kernels work on 32 samples with the same code as SSE2: unpacking
+ * and packing back are both done within each 128 bits lane, so the samples
+ * keep their order. The shuffling kernels are left to SSE2. */
+__attribute__ ((__target__ ("avx2")))
+static inline __m256i Div255AVX2(__m256i v)
+{
+    const __m256i one = _mm256_set1_epi16(1);
+    return _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(
+                                _mm256_srli_epi16(v, 8), v), one), 8);
+}
+
+__attribute__ ((__target__ ("avx2")))
+static void AlphaAVX2(uint8_t *a, const uint8_t *src_a, unsigned alpha, unsigned n)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i k = _mm256_set1_epi16(alpha);
+    unsigned i = 0;
+
+    for (; i + 32 <= n; i += 32) {
+        __m256i s = _mm256_loadu_si256((const __m256i *)&src_a[i]);
+        __m256i lo = Div255AVX2(_mm256_mullo_epi16(_mm256_unpacklo_epi8(s, zero), k));
+        __m256i hi = Div255AVX2(_mm256_mullo_epi16(_mm256_unpackhi_epi8(s, zero), k));
+        _mm256_storeu_si256((__m256i *)&a[i], _mm256_packus_epi16(lo, hi));
+    }
+    AlphaSSE2(&a[i], &src_a[i], alpha, n - i);
+}
+
+__attribute__ ((__target__ ("avx2")))
+static void MergeAVX2(uint8_t *dst, const uint8_t *src, const uint8_t *a, unsigned n)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i k255 = _mm256_set1_epi16(255);
+    unsigned i = 0;
+
+    for (; i + 32 <= n; i += 32) {
+        __m256i d = _mm256_loadu_si256((const __m256i *)&dst[i]);
+        __m256i s = _mm256_loadu_si256((const __m256i *)&src[i]);
+        __m256i f = _mm256_loadu_si256((const __m256i *)&a[i]);
+        __m256i flo = _mm256_unpacklo_epi8(f, zero);
+        __m256i fhi = _mm256_unpackhi_epi8(f, zero);
+        __m256i lo = _mm256_add_epi16(
+            _mm256_mullo_epi16(_mm256_unpacklo_epi8(d, zero),
+                               _mm256_sub_epi16(k255, flo)),
+            _mm256_mullo_epi16(_mm256_unpacklo_epi8(s, zero), flo));
+        __m256i hi = _mm256_add_epi16(
+            _mm256_mullo_epi16(_mm256_unpackhi_epi8(d, zero),
+                               _mm256_sub_epi16(k255, fhi)),
+            _mm256_mullo_epi16(_mm256_unpackhi_epi8(s, zero), fhi));
+        _mm256_storeu_si256((__m256i *)&dst[i],
+                            _mm256_packus_epi16(Div255AVX2(lo), Div255AVX2(hi)));
+    }
+    MergeSSE2(&dst[i], &src[i], &a[i], n - i);
+}
+
+__attribute__ ((__target__ ("avx2")))
+static inline __m256i YuvToRgbComponentAVX2(__m256i a, __m256i b, __m256i c,
+                                            __m256i kab, __m256i kc)
+{
+    const __m256i half = _mm256_set1_epi32(YUV_ONE_HALF);
+    __m256i lo = _mm256_add_epi32(_mm256_madd_epi16(_mm256_unpacklo_epi16(a, b), kab),
+                                  _mm256_madd_epi16(_mm256_unpacklo_epi16(c, c), kc));
+    __m256i hi = _mm256_add_epi32(_mm256_madd_epi16(_mm256_unpackhi_epi16(a, b), kab),
+                                  _mm256_madd_epi16(_mm256_unpackhi_epi16(c, c), kc));
+    lo = _mm256_srai_epi32(_mm256_add_epi32(lo, half), 10);
+    hi = _mm256_srai_epi32(_mm256_add_epi32(hi, half), 10);
+    return _mm256_packs_epi32(lo, hi);
+}
+
+__attribute__ ((__target__ ("avx2")))
+static void YuvToRgbAVX2(uint8_t *const dst[3], const uint8_t *const src[3],
+                         unsigned n)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i k16 = _mm256_set1_epi16(16);
+    const __m256i k128 = _mm256_set1_epi16(128);
+    const __m256i kr = _mm256_set1_epi32(PAIR16(YUV_FIX_Y, YUV_FIX_RV));
+    const __m256i kgb = _mm256_set1_epi32(PAIR16(YUV_FIX_Y, -YUV_FIX_GU));
+    const __m256i kgc = _mm256_set1_epi32(PAIR16(-YUV_FIX_GV, 0));
+    const __m256i kb = _mm256_set1_epi32(PAIR16(YUV_FIX_Y, YUV_FIX_BU));
+    unsigned i = 0;
+
+    for (; i + 32 <= n; i += 32) {
+        __m256i y = _mm256_loadu_si256((const __m256i *)&src[0][i]);
+        __m256i u = _mm256_loadu_si256((const __m256i *)&src[1][i]);
+        __m256i v = _mm256_loadu_si256((const __m256i *)&src[2][i]);
+        __m256i r[2], g[2], b[2];
+
+        for (unsigned h = 0; h < 2; h++) {
+            __m256i y16, u16, v16;
+            if (h == 0) {
+                y16 = _mm256_unpacklo_epi8(y, zero);
+                u16 = _mm256_unpacklo_epi8(u, zero);
+                v16 = _mm256_unpacklo_epi8(v, zero);
+            } else {
+                y16 = _mm256_unpackhi_epi8(y, zero);
+                u16 = _mm256_unpackhi_epi8(u, zero);
+                v16 = _mm256_unpackhi_epi8(v, zero);
+            }
+            y16 = _mm256_sub_epi16(y16, k16);
+            u16 = _mm256_sub_epi16(u16, k128);
+            v16 = _mm256_sub_epi16(v16, k128);
+
+            r[h] = YuvToRgbComponentAVX2(y16, v16, zero, kr, zero);
+            g[h] = YuvToRgbComponentAVX2(y16, u16, v16, kgb, kgc);
+            b[h] = YuvToRgbComponentAVX2(y16, u16, zero, kb, zero);
+        }
+        _mm256_storeu_si256((__m256i *)&dst[0][i], _mm256_packus_epi16(r[0], r[1]));
+        _mm256_storeu_si256((__m256i *)&dst[1][i], _mm256_packus_epi16(g[0], g[1]));
+        _mm256_storeu_si256((__m256i *)&dst[2][i], _mm256_packus_epi16(b[0], b[1]));
+    }
+    TAIL3(YuvToRgbSSE2, i, n, dst, src);
+}
+
+__attribute__ ((__target__ ("avx2")))
+static void RgbToYuvAVX2(uint8_t *const dst[3], const uint8_t *const src[3],
+                         unsigned n)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i k16 = _mm256_set1_epi16(16);
+    const __m256i k128 = _mm256_set1_epi16(128);
+    unsigned i = 0;
+
+    for (; i + 32 <= n; i += 32) {
+        __m256i r = _mm256_loadu_si256((const __m256i *)&src[0][i]);
+        __m256i g = _mm256_loadu_si256((const __m256i *)&src[1][i]);
+        __m256i b = _mm256_loadu_si256((const __m256i *)&src[2][i]);
+        __m256i y[2], u[2], v[2];
+
+        for (unsigned h = 0; h < 2; h++) {
+            __m256i r16, g16, b16;
+            if (h == 0) {
+                r16 = _mm256_unpacklo_epi8(r, zero);
+                g16 = _mm256_unpacklo_epi8(g, zero);
+                b16 = _mm256_unpacklo_epi8(b, zero);
+            } else {
+                r16 = _mm256_unpackhi_epi8(r, zero);
+                g16 = _mm256_unpackhi_epi8(g, zero);
+                b16 = _mm256_unpackhi_epi8(b, zero);
+            }
+            __m256i ys = _mm256_add_epi16(
+                _mm256_add_epi16(_mm256_mullo_epi16(r16, _mm256_set1_epi16(66)),
+                                 _mm256_mullo_epi16(g16, _mm256_set1_epi16(129))),
+                _mm256_add_epi16(_mm256_mullo_epi16(b16, _mm256_set1_epi16(25)),
+                                 k128));
+            __m256i us = _mm256_add_epi16(
+                _mm256_sub_epi16(_mm256_mullo_epi16(b16, _mm256_set1_epi16(112)),
+                                 _mm256_mullo_epi16(r16, _mm256_set1_epi16(38))),
+                _mm256_sub_epi16(k128,
+                                 _mm256_mullo_epi16(g16, _mm256_set1_epi16(74))));
+            __m256i vs = _mm256_add_epi16(
+                _mm256_sub_epi16(_mm256_mullo_epi16(r16, _mm256_set1_epi16(112)),
+                                 _mm256_mullo_epi16(g16, _mm256_set1_epi16(94))),
+                _mm256_sub_epi16(k128,
+                                 _mm256_mullo_epi16(b16, _mm256_set1_epi16(18))));
+            y[h] = _mm256_add_epi16(_mm256_srli_epi16(ys, 8), k16);
+            u[h] = _mm256_add_epi16(_mm256_srai_epi16(us, 8), k128);
+            v[h] = _mm256_add_epi16(_mm256_srai_epi16(vs, 8), k128);
+        }
+        _mm256_storeu_si256((__m256i *)&dst[0][i], _mm256_packus_epi16(y[0], y[1]));
+        _mm256_storeu_si256((__m256i *)&dst[1][i], _mm256_packus_epi16(u[0], u[1]));
+        _mm256_storeu_si256((__m256i *)&dst[2][i], _mm256_packus_epi16(v[0], v[1]));
+    }
+    TAIL3(RgbToYuvSSE2, i, n, dst, src);
+}
+
+static const blend_kernels_t blend_avx2 = {
+    "avx2",
+    AlphaAVX2, MergeAVX2, EvenSSE2, Interleave2SSE2,
+    Interleave4SSE2, Deinterleave4SSE2, YuvToRgbAVX2, RgbToYuvAVX2,
+};
+# undef PAIR16
+#endif
+
+#undef TAIL3
+
+enum blend_layout_t {
+    BLEND_PLANAR_420,
+    BLEND_SEMIPLANAR_420,
+    BLEND_PACKED_RGB32,
+};
+
+static const struct {
+    vlc_fourcc_t  chroma;
+    blend_layout_t layout;
+    bool          swap_uv;
+} blend_lines[] = {
+    { VLC_CODEC_I420,  BLEND_PLANAR_420,     false },
+    { VLC_CODEC_J420,  BLEND_PLANAR_420,     false },
+    { VLC_CODEC_YV12,  BLEND_PLANAR_420,     true  },
+    { VLC_CODEC_NV12,  BLEND_SEMIPLANAR_420, false },
+    { VLC_CODEC_NV21,  BLEND_SEMIPLANAR_420, true  },
+    { VLC_CODEC_RGB32, BLEND_PACKED_RGB32,   false },
+};
+
 struct filter_sys_t {
-    filter_sys_t() : blend(NULL)
+    filter_sys_t() : blend(NULL), kernels(NULL), buffer(NULL), buffer_size(0)
+    {
+    }
+    ~filter_sys_t()
     {
+        free(buffer);
     }
     blend_function_t blend;
+
+    /* Line based blending, if kernels is not NULL */
+    const blend_kernels_t *kernels;
+    blend_layout_t layout;
+    bool           swap_uv;
+    bool           src_rgba;
+    uint8_t        *buffer;
+    size_t         buffer_size;
 };
 
+/**
+ * It blends 2 pictures together using the line kernels, and returns false
+ * if it cannot.
+ */
+static bool BlendLines(filter_sys_t *sys,
+                       picture_t *dst, const video_format_t *dst_fmt,
+                       unsigned dst_x, unsigned dst_y,
+                       const picture_t *src,
+                       unsigned src_x, unsigned src_y,
+                       unsigned width, unsigned height, int alpha)
+{
+    const blend_kernels_t *k = sys->kernels;
+
+    /* Byte offsets of the RGB32 components, as in CPictureRGBX */
+    unsigned offset[4] = { 0, 1, 2, 3 };
+    if (sys->layout == BLEND_PACKED_RGB32) {
+#ifdef WORDS_BIGENDIAN
+        offset[0] = (32 - dst_fmt->i_lrshift) / 8;
+        offset[1] = (32 - dst_fmt->i_lgshift) / 8;
+        offset[2] = (32 - dst_fmt->i_lbshift) / 8;
+#else
+        offset[0] = dst_fmt->i_lrshift / 8;
+        offset[1] = dst_fmt->i_lgshift / 8;
+        offset[2] = dst_fmt->i_lbshift / 8;
+#endif
+        if (offset[0] > 3 || offset[1] > 3 || offset[2] > 3 ||
+            offset[0] == offset[1] || offset[1] == offset[2] ||
+            offset[0] == offset[2])
+            return false;
+        offset[3] = 6 - offset[0] - offset[1] - offset[2];
+    }
+
+    /* Line buffers: 3 components, source alpha, alpha, zeros, 3 subsampled
+     * chroma lines and 2 interleaved lines */
+    const size_t n = width + 16;
+    const size_t size = 6 * n + 3 * n + 2 * 4 * n;
+    if (sys->buffer_size < size) {
+        uint8_t *buffer = (uint8_t *)realloc(sys->buffer, size);
+        if (!buffer)
+            return false;
+        sys->buffer = buffer;
+        sys->buffer_size = size;
+    }
+    uint8_t *const comp[3] = { &sys->buffer[0], &sys->buffer[n], &sys->buffer[2 * n] };
+    uint8_t *src_a = &sys->buffer[3 * n];
+    uint8_t *a     = &sys->buffer[4 * n];
+    uint8_t *zero  = &sys->buffer[5 * n];
+    uint8_t *even[3] = { &sys->buffer[6 * n], &sys->buffer[7 * n], &sys->buffer[8 * n] };
+    uint8_t *inter[2] = { &sys->buffer[9 * n], &sys->buffer[13 * n] };
+    memset(zero, 0, width);
+
+    const int u_plane = sys->swap_uv ? 2 : 1;
+    const int v_plane = sys->swap_uv ? 1 : 2;
+
+    for (unsigned y = 0; y < height; y++) {
+        const unsigned sy = src_y + y;
+        const unsigned dy = dst_y + y;
+        const uint8_t *s[4];
+
+        /* Fetch the source line in the destination color space */
+        if (sys->src_rgba) {
+            uint8_t *const d[4] = { comp[0], comp[1], comp[2], src_a };
+            k->deinterleave4(d, &src->p[0].p_pixels[sy * src->p[0].i_pitch + 4 * src_x],
+                             width);
+            for (int i = 0; i < 4; i++)
+                s[i] = d[i];
+            if (sys->layout != BLEND_PACKED_RGB32)
+                k->rgb_to_yuv(comp, s, width);
+        } else {
+            for (int i = 0; i < 4; i++)
+                s[i] = &src->p[i].p_pixels[sy * src->p[i].i_pitch + src_x];
+            if (sys->layout == BLEND_PACKED_RGB32) {
+                k->yuv_to_rgb(comp, s, width);
+                for (int i = 0; i < 3; i++)
+                    s[i] = comp[i];
+            }
+        }
+        k->alpha(a, s[3], alpha, width);
+
+        if (sys->layout == BLEND_PACKED_RGB32) {
+            const uint8_t *color[4], *factor[4];
+            for (int i = 0; i < 3; i++) {
+                color[offset[i]]  = s[i];
+                factor[offset[i]] = a;
+            }
+            /* Leave the padding byte untouched */
+            color[offset[3]]  = zero;
+            factor[offset[3]] = zero;
+
+            k->interleave4(inter[0], color, width);
+            k->interleave4(inter[1], factor, width);
+            k->merge(&dst->p[0].p_pixels[dy * dst->p[0].i_pitch + 4 * dst_x],
+                     inter[0], inter[1], 4 * width);
+            continue;
+        }
+
+        k->merge(&dst->p[0].p_pixels[dy * dst->p[0].i_pitch + dst_x],
+                 s[0], a, width);
+
+        /* Chroma is merged from the samples at even destination positions */
+        const unsigned start = dst_x % 2;
+        if ((dy % 2) != 0 || width <= start)
+            continue;
+        const unsigned count = (width - start + 1) / 2;
+        const unsigned cx = (dst_x + start) / 2;
+        const unsigned cy = dy / 2;
+
+        k->even(even[0], &s[1][start], count);
+        k->even(even[1], &s[2][start], count);
+        k->even(even[2], &a[start], count);
+
+        if (sys->layout == BLEND_PLANAR_420) {
+            k->merge(&dst->p[u_plane].p_pixels[cy * dst->p[u_plane].i_pitch + cx],
+                     even[0], even[2], count);
+            k->merge(&dst->p[v_plane].p_pixels[cy * dst->p[v_plane].i_pitch + cx],
+                     even[1], even[2], count);
+        } else {
+            if (sys->swap_uv)
+                k->interleave2(inter[0], even[1], even[0], count);
+            else
+                k->interleave2(inter[0], even[0], even[1], count);
+            k->interleave2(inter[1], even[2], even[2], count);
+            k->merge(&dst->p[1].p_pixels[cy * dst->p[1].i_pitch + 2 * cx],
+                     inter[0], inter[1], 2 * count);
+        }
+    }
+    return true;
+}
+
 /**
  * It blends 2 picture together.
  */
@@ -655,6 +1359,16 @@ static void Blend(filter_t *filter,
     video_format_FixRgb(&filter->fmt_out.video);
     video_format_FixRgb(&filter->fmt_in.video);
 
+    if (sys->kernels &&
+        BlendLines(sys, dst, &filter->fmt_out.video,
+                   filter->fmt_out.video.i_x_offset + x_offset,
+                   filter->fmt_out.video.i_y_offset + y_offset,
+                   src,
+                   filter->fmt_in.video.i_x_offset,
+                   filter->fmt_in.video.i_y_offset,
+                   width, height, alpha))
+        return;
+
     sys->blend(CPicture(dst, &filter->fmt_out.video,
                         filter->fmt_out.video.i_x_offset + x_offset,
                         filter->fmt_out.video.i_y_offset + y_offset),
@@ -683,6 +1397,27 @@ static int Open(vlc_object_t *object)
         return VLC_EGENERIC;
     }
 
+    /* Use the line kernels for the common cases */
+    const blend_kernels_t *kernels = NULL;
+#if defined(BLEND_HAVE_X86)
+    if (vlc_CPU_AVX2())
+        kernels = &blend_avx2;
+    else if (vlc_CPU_SSE2())
+        kernels = &blend_sse2;
+#endif
+    if (kernels && var_InheritBool(filter, "blend-simd") &&
+        (src == VLC_CODEC_YUVA || src == VLC_CODEC_RGBA)) {
+        for (size_t i = 0; i < sizeof(blend_lines) / sizeof(*blend_lines); i++) {
+            if (blend_lines[i].chroma != dst)
+                continue;
+            sys->kernels  = kernels;
+            sys->layout   = blend_lines[i].layout;
+            sys->swap_uv  = blend_lines[i].swap_uv;
+            sys->src_rgba = src == VLC_CODEC_RGBA;
+            msg_Dbg(filter, "using %s line blending", kernels->name);
+        }
+    }
+
     filter->pf_video_blend = Blend;
     filter->p_sys          = sys;
     return VLC_SUCCESS;
@@ -69,6 +69,19 @@ static picture_t *Filter( filter_t *, picture_t * );
 #define BLEND_CHROMA_LONGTEXT N_("Chroma which the blend image will be loaded" \
                                  " in")
 
+#define WIDTH_TEXT N_("Width of the generated images")
+#define WIDTH_LONGTEXT N_("Width of the images generated when no image " \
+                          "file is given")
+
+#define HEIGHT_TEXT N_("Height of the generated images")
+#define HEIGHT_LONGTEXT N_("Height of the images generated when no image " \
+                           "file is given")
+
+#define CHECK_TEXT N_("Check the optimized blending")
+#define CHECK_LONGTEXT N_("Compare the output of the optimized blending " \
+                          "with the generic one, and drop the video if " \
+                          "they differ")
+
 #define CFG_PREFIX "blendbench-"
 
 vlc_module_begin ()
@@ -83,6 +96,10 @@ vlc_module_begin ()
               LOOPS_LONGTEXT, false )
     add_integer_with_range( CFG_PREFIX "alpha", 128, 0, 255, ALPHA_TEXT,
               ALPHA_LONGTEXT, false )
+    add_bool( CFG_PREFIX "check", true, CHECK_TEXT, CHECK_LONGTEXT, false )
+    add_integer( CFG_PREFIX "width", 1920, WIDTH_TEXT, WIDTH_LONGTEXT, false )
+    add_integer( CFG_PREFIX "height", 1080, HEIGHT_TEXT, HEIGHT_LONGTEXT,
+                 false )
 
     set_section( N_("Base image"), NULL )
     add_loadfile( CFG_PREFIX "base-image", NULL, BASE_IMAGE_TEXT,
@@ -100,8 +117,8 @@ vlc_module_begin ()
 vlc_module_end ()
 
 static const char *const ppsz_filter_options[] = {
-    "loops", "alpha", "base-image", "base-chroma", "blend-image",
-    "blend-chroma", NULL
+    "loops", "alpha", "check", "width", "height", "base-image", "base-chroma",
+    "blend-image", "blend-chroma", NULL
 };
 
 /*****************************************************************************
@@ -110,6 +127,7 @@ static const char *const ppsz_filter_options[] = {
 struct filter_sys_t
 {
     bool b_done;
+    bool b_check;
     int i_loops, i_alpha;
 
     picture_t *p_base_image;
@@ -119,12 +137,65 @@ struct filter_sys_t
     vlc_fourcc_t i_blend_chroma;
 };
 
+/* Fills a picture with noise, mostly transparent or opaque if it has an
+ * alpha channel, as subtitles are */
+static void blendbench_GenerateImage( picture_t *p_pic )
+{
+    uint32_t i_seed = p_pic->format.i_chroma;
+    const bool b_rgba = p_pic->format.i_chroma == VLC_CODEC_RGBA ||
+                        p_pic->format.i_chroma == VLC_CODEC_BGRA;
+    const bool b_yuva = p_pic->format.i_chroma == VLC_CODEC_YUVA;
+
+    for( int i_plane = 0; i_plane < p_pic->i_planes; i_plane++ )
+    {
+        plane_t *p = &p_pic->p[i_plane];
+
+        for( int y = 0; y < p->i_lines; y++ )
+            for( int x = 0; x < p->i_pitch; x++ )
+            {
+                i_seed = i_seed * 1103515245 + 12345;
+                uint8_t i_value = i_seed >> 16;
+
+                if( ( b_yuva && i_plane == A_PLANE ) || ( b_rgba && x % 4 == 3 ) )
+                {
+                    if( i_value < 96 )
+                        i_value = 0;
+                    else if( i_value < 192 )
+                        i_value = 255;
+                }
+                p->p_pixels[y * p->i_pitch + x] = i_value;
+            }
+    }
+}
+
 static int blendbench_LoadImage( vlc_object_t *p_this, picture_t **pp_pic,
                                  vlc_fourcc_t i_chroma, char *psz_file, const char *psz_name )
 {
     image_handler_t *p_image;
     video_format_t fmt_in, fmt_out;
 
+    if( psz_file == NULL || *psz_file == '\0' )
+    {
+        if( i_chroma == 0 || i_chroma == VLC_CODEC_YUVP )
+        {
+            msg_Err( p_this, "Cannot generate %s image", psz_name );
+            return VLC_EGENERIC;
+        }
+        video_format_Init( &fmt_out, i_chroma );
+        video_format_Setup( &fmt_out, i_chroma,
+                            var_GetInteger( p_this, CFG_PREFIX "width" ),
+                            var_GetInteger( p_this, CFG_PREFIX "height" ),
+                            var_GetInteger( p_this, CFG_PREFIX "width" ),
+                            var_GetInteger( p_this, CFG_PREFIX "height" ),
+                            1, 1 );
+        video_format_FixRgb( &fmt_out );
+        *pp_pic = picture_NewFromFormat( &fmt_out );
+        if( *pp_pic == NULL )
+            return VLC_ENOMEM;
+        blendbench_GenerateImage( *pp_pic );
+        return VLC_SUCCESS;
+    }
+
     memset( &fmt_in, 0, sizeof(video_format_t) );
     memset( &fmt_out, 0, sizeof(video_format_t) );
 
@@ -175,6 +246,11 @@ static int Create( vlc_object_t *p_this )
                                                   CFG_PREFIX "loops" );
     p_sys->i_alpha = var_CreateGetIntegerCommand( p_filter,
                                                   CFG_PREFIX "alpha" );
+    p_sys->b_check = var_CreateGetBool( p_filter, CFG_PREFIX "check" );
+    var_Create( p_filter, CFG_PREFIX "width",
+                VLC_VAR_INTEGER | VLC_VAR_DOINHERIT );
+    var_Create( p_filter, CFG_PREFIX "height",
+                VLC_VAR_INTEGER | VLC_VAR_DOINHERIT );
 
     psz_temp = var_CreateGetStringCommand( p_filter, CFG_PREFIX "base-chroma" );
     p_sys->i_base_chroma = !psz_temp || strlen( psz_temp ) != 4 ? 0 :
@@ -222,34 +298,84 @@ static void Destroy( vlc_object_t *p_this )
 
     picture_Release( p_sys->p_base_image );
     picture_Release( p_sys->p_blend_image );
+    free( p_sys );
 }
 
-/*****************************************************************************
- * Render: displays previously rendered output
- *****************************************************************************/
-static picture_t *Filter( filter_t *p_filter, picture_t *p_pic )
+static filter_t *blendbench_CreateBlend( filter_t *p_filter, bool b_simd )
 {
     filter_sys_t *p_sys = p_filter->p_sys;
-    filter_t *p_blend;
-
-    if( p_sys->b_done )
-        return p_pic;
-
-    p_blend = vlc_object_create( p_filter, sizeof(filter_t) );
+    filter_t *p_blend = vlc_object_create( p_filter, sizeof(filter_t) );
     if( !p_blend )
-    {
-        picture_Release( p_pic );
         return NULL;
-    }
+
+    var_Create( p_blend, "blend-simd", VLC_VAR_BOOL );
+    var_SetBool( p_blend, "blend-simd", b_simd );
+
     p_blend->fmt_out.video = p_sys->p_base_image->format;
     p_blend->fmt_in.video = p_sys->p_blend_image->format;
     p_blend->p_module = module_need( p_blend, "video blending", NULL, false );
     if( !p_blend->p_module )
     {
-        picture_Release( p_pic );
         vlc_object_release( p_blend );
         return NULL;
     }
+    return p_blend;
+}
+
+static void blendbench_DeleteBlend( filter_t *p_blend )
+{
+    module_unneed( p_blend, p_blend->p_module );
+    vlc_object_release( p_blend );
+}
+
+/* Blends once onto a copy of the base image, at an odd position so that
+ * chroma subsampling is exercised */
+static picture_t *blendbench_BlendCopy( filter_t *p_filter, filter_t *p_blend )
+{
+    filter_sys_t *p_sys = p_filter->p_sys;
+    picture_t *p_pic = picture_NewFromFormat( &p_sys->p_base_image->format );
+    if( !p_pic )
+        return NULL;
+
+    picture_Copy( p_pic, p_sys->p_base_image );
+    p_blend->pf_video_blend( p_blend, p_pic, p_sys->p_blend_image,
+                             1, 1, p_sys->i_alpha );
+    return p_pic;
+}
+
+static bool blendbench_Compare( const picture_t *p_a, const picture_t *p_b )
+{
+    for( int i_plane = 0; i_plane < p_a->i_planes; i_plane++ )
+    {
+        const plane_t *a = &p_a->p[i_plane];
+        const plane_t *b = &p_b->p[i_plane];
+
+        for( int y = 0; y < a->i_visible_lines; y++ )
+            if( memcmp( &a->p_pixels[y * a->i_pitch],
+                        &b->p_pixels[y * b->i_pitch], a->i_visible_pitch ) )
+                return false;
+    }
+    return true;
+}
+
+static bool blendbench_Check( filter_t *p_filter, filter_t *p_generic,
+                              filter_t *p_simd )
+{
+    picture_t *p_ref = blendbench_BlendCopy( p_filter, p_generic );
+    picture_t *p_out = blendbench_BlendCopy( p_filter, p_simd );
+    bool b_ok = p_ref && p_out && blendbench_Compare( p_ref, p_out );
+
+    if( p_ref )
+        picture_Release( p_ref );
+    if( p_out )
+        picture_Release( p_out );
+    return b_ok;
+}
+
+static vlc_tick_t blendbench_Run( filter_t *p_filter, filter_t *p_blend,
+                                  const char *psz_name )
+{
+    filter_sys_t *p_sys = p_filter->p_sys;
 
     vlc_tick_t time = mdate();
     for( int i_iter = 0; i_iter < p_sys->i_loops; ++i_iter )
@@ -259,19 +385,65 @@ static picture_t *Filter( filter_t *p_filter, picture_t *p_pic )
                                  0, 0, p_sys->i_alpha );
     }
     time = mdate() - time;
+    if( time <= 0 )
+        time = 1;
 
-    msg_Info( p_filter, "Blended %d images in %f sec", p_sys->i_loops,
-              time / 1000000.0f );
-    msg_Info( p_filter, "Speed is: %f images/second, %f pixels/second",
+    msg_Info( p_filter, "%s: blended %d images in %f sec", psz_name,
+              p_sys->i_loops, time / 1000000.0f );
+    msg_Info( p_filter, "%s: speed is %f images/second, %f pixels/second",
+              psz_name,
               (float) p_sys->i_loops / time * 1000000,
               (float) p_sys->i_loops / time * 1000000 *
                   p_sys->p_blend_image->p[Y_PLANE].i_visible_pitch *
                   p_sys->p_blend_image->p[Y_PLANE].i_visible_lines );
+    return time;
+}
 
-    module_unneed( p_blend, p_blend->p_module );
-
-    vlc_object_release( p_blend );
+/*****************************************************************************
+ * Render: displays previously rendered output
+ *****************************************************************************/
+static picture_t *Filter( filter_t *p_filter, picture_t *p_pic )
+{
+    filter_sys_t *p_sys = p_filter->p_sys;
 
+    if( p_sys->b_done )
+        return p_pic;
     p_sys->b_done = true;
+
+    filter_t *p_generic = blendbench_CreateBlend( p_filter, false );
+    filter_t *p_simd = blendbench_CreateBlend( p_filter, true );
+    if( !p_generic || !p_simd )
+    {
+        if( p_generic )
+            blendbench_DeleteBlend( p_generic );
+        if( p_simd )
+            blendbench_DeleteBlend( p_simd );
+        picture_Release( p_pic );
+        return NULL;
+    }
+
+    bool b_ok = true;
+    if( p_sys->b_check && !blendbench_Check( p_filter, p_generic, p_simd ) )
+    {
+        msg_Err( p_filter, "Optimized blending (chroma: %4.4s -> %4.4s) "
+                 "differs from the generic one",
+                 (const char *)&p_sys->i_blend_chroma,
+                 (const char *)&p_sys->i_base_chroma );
+        b_ok = false;
+    }
+
+    vlc_tick_t generic = blendbench_Run( p_filter, p_generic, "Generic" );
+    vlc_tick_t simd = blendbench_Run( p_filter, p_simd, "Optimized" );
+    msg_Info( p_filter, "Optimized blending is %.2f times faster",
+              (float) generic / simd );
+
+    blendbench_DeleteBlend( p_generic );
+    blendbench_DeleteBlend( p_simd );
+
+    if( !b_ok )
+    {
+        picture_Release( p_pic );
+        return NULL;
+    }
     return p_pic;
 }
@@ -47,6 +47,77 @@
    Necessary preprocessor macros are defined in common.h. */
 #include "yadif.h"
 
+struct yadif_slices
+{
+    void (*filter)(uint8_t *dst, uint8_t *prev, uint8_t *cur, uint8_t *next,
+                   int w, int prefs, int mrefs, int parity, int mode);
+    picture_t *p_prev, *p_cur, *p_next;
+    picture_t *p_dst;
+    int i_field;
+    int i_parity;
+};
+
+/* Renders the lines of a slice of each plane. Lines only depend on the
+ * source pictures, so slices are independent. */
+static void RenderYadifSlice( filter_t *p_filter, void *opaque,
+                              unsigned i_slice, unsigned i_slices )
+{
+    const struct yadif_slices *p_slices = opaque;
+    picture_t *p_dst = p_slices->p_dst;
+    const int i_field = p_slices->i_field;
+    const int yadif_parity = p_slices->i_parity;
+
+    VLC_UNUSED(p_filter);
+
+    for( int n = 0; n < p_dst->i_planes; n++ )
+    {
+        const plane_t *prevp = &p_slices->p_prev->p[n];
+        const plane_t *curp  = &p_slices->p_cur->p[n];
+        const plane_t *nextp = &p_slices->p_next->p[n];
+        plane_t *dstp        = &p_dst->p[n];
+        const unsigned i_lines = dstp->i_visible_lines;
+        const int i_start = __MAX( i_lines * i_slice / i_slices, 1u );
+        const int i_end = __MIN( i_lines * (i_slice + 1) / i_slices,
+                                 i_lines - 1 );
+
+        for( int y = i_start; y < i_end; y++ )
+        {
+            if( (y % 2) == i_field  ||  yadif_parity == 2 )
+            {
+                memcpy( &dstp->p_pixels[y * dstp->i_pitch],
+                            &curp->p_pixels[y * curp->i_pitch], dstp->i_visible_pitch );
+            }
+            else
+            {
+                int mode;
+                /* Spatial checks only when enough data */
+                mode = (y >= 2 && y < dstp->i_visible_lines - 2) ? 0 : 2;
+
+                assert( prevp->i_pitch == curp->i_pitch && curp->i_pitch == nextp->i_pitch );
+                p_slices->filter( &dstp->p_pixels[y * dstp->i_pitch],
+                                  &prevp->p_pixels[y * prevp->i_pitch],
+                                  &curp->p_pixels[y * curp->i_pitch],
+                                  &nextp->p_pixels[y * nextp->i_pitch],
+                                  dstp->i_visible_pitch,
+                                  y < dstp->i_visible_lines - 2  ? curp->i_pitch : -curp->i_pitch,
+                                  y  - 1  ?  -curp->i_pitch : curp->i_pitch,
+                                  yadif_parity,
+                                  mode );
+            }
+
+            /* We duplicate the first and last lines */
+            if( y == 1 )
+                memcpy(&dstp->p_pixels[(y-1) * dstp->i_pitch],
+                           &dstp->p_pixels[ y    * dstp->i_pitch],
+                           dstp->i_pitch);
+            else if( y == dstp->i_visible_lines - 2 )
+                memcpy(&dstp->p_pixels[(y+1) * dstp->i_pitch],
+                           &dstp->p_pixels[ y    * dstp->i_pitch],
+                           dstp->i_pitch);
+        }
+    }
+}
+
 int RenderYadifSingle( filter_t *p_filter, picture_t *p_dst, picture_t *p_src )
 {
     return RenderYadif( p_filter, p_dst, p_src, 0, 0 );
@@ -113,72 +184,44 @@ int RenderYadif( filter_t *p_filter, picture_t *p_dst, picture_t *p_src,
         void (*filter)(uint8_t *dst, uint8_t *prev, uint8_t *cur, uint8_t *next,
                        int w, int prefs, int mrefs, int parity, int mode);
 
+        if( !p_sys->b_simd )
+            filter = yadif_filter_line_c;
+#if defined(HAVE_YADIF_AVX2)
+        else if( vlc_CPU_AVX2() )
+            filter = yadif_filter_line_avx2;
+#endif
 /* android clang build for x86 fails as not enough registers are available */
 #if !defined(__ANDROID__)
 # if defined(HAVE_YADIF_SSSE3)
-        if( vlc_CPU_SSSE3() )
+        else if( vlc_CPU_SSSE3() )
             filter = yadif_filter_line_ssse3;
-        else
 # endif
 # if defined(HAVE_YADIF_SSE2)
-        if( vlc_CPU_SSE2() )
+        else if( vlc_CPU_SSE2() )
             filter = yadif_filter_line_sse2;
-        else
 # endif
 # if defined(HAVE_YADIF_MMX)
-        if( vlc_CPU_MMX() )
+        else if( vlc_CPU_MMX() )
             filter = yadif_filter_line_mmx;
-        else
 # endif
 #endif
+        else
             filter = yadif_filter_line_c;
 
         if( p_sys->chroma->pixel_size == 2 )
             filter = yadif_filter_line_c_16bit;
 
-        for( int n = 0; n < p_dst->i_planes; n++ )
-        {
-            const plane_t *prevp = &p_prev->p[n];
-            const plane_t *curp  = &p_cur->p[n];
-            const plane_t *nextp = &p_next->p[n];
-            plane_t *dstp        = &p_dst->p[n];
-
-            for( int y = 1; y < dstp->i_visible_lines - 1; y++ )
-            {
-                if( (y % 2) == i_field  ||  yadif_parity == 2 )
-                {
-                    memcpy( &dstp->p_pixels[y * dstp->i_pitch],
-                                &curp->p_pixels[y * curp->i_pitch], dstp->i_visible_pitch );
-                }
-                else
-                {
-                    int mode;
-                    /* Spatial checks only when enough data */
-                    mode = (y >= 2 && y < dstp->i_visible_lines - 2) ? 0 : 2;
-
-                    assert( prevp->i_pitch == curp->i_pitch && curp->i_pitch == nextp->i_pitch );
-                    filter( &dstp->p_pixels[y * dstp->i_pitch],
-                            &prevp->p_pixels[y * prevp->i_pitch],
-                            &curp->p_pixels[y * curp->i_pitch],
-                            &nextp->p_pixels[y * nextp->i_pitch],
-                            dstp->i_visible_pitch,
-                            y < dstp->i_visible_lines - 2  ? curp->i_pitch : -curp->i_pitch,
-                            y  - 1  ?  -curp->i_pitch : curp->i_pitch,
-                            yadif_parity,
-                            mode );
-                }
-
-                /* We duplicate the first and last lines */
-                if( y == 1 )
-                    memcpy(&dstp->p_pixels[(y-1) * dstp->i_pitch],
-                               &dstp->p_pixels[ y    * dstp->i_pitch],
-                               dstp->i_pitch);
-                else if( y == dstp->i_visible_lines - 2 )
-                    memcpy(&dstp->p_pixels[(y+1) * dstp->i_pitch],
-                               &dstp->p_pixels[ y    * dstp->i_pitch],
-                               dstp->i_pitch);
-            }
-        }
+        struct yadif_slices slices = {
+            .filter = filter,
+            .p_prev = p_prev,
+            .p_cur  = p_cur,
+            .p_next = p_next,
+            .p_dst  = p_dst,
+            .i_field = i_field,
+            .i_parity = yadif_parity,
+        };
+        filter_ExecuteSlices( p_filter, RenderYadifSlice, &slices,
+                              p_dst->p[0].i_visible_lines / 32 );
 
         p_sys->context.i_frame_offset = 1; /* p_cur will be rendered at next frame, too */
 
@@ -295,6 +295,10 @@ static void Close( vlc_object_t *p_this );
                                     "in the Phosphor framerate doubler. "\
                                     "Default: Low.")
 
+#define SIMD_TEXT N_("Use SIMD routines")
+#define SIMD_LONGTEXT N_("Use the vectorized merge and Yadif routines when " \
+                         "the CPU supports them.")
+
 vlc_module_begin ()
     set_description( N_("Deinterlacing video filter") )
     set_shortname( N_("Deinterlace" ))
@@ -314,6 +318,8 @@ vlc_module_begin ()
                 PHOSPHOR_DIMMER_LONGTEXT, true )
         change_integer_list( phosphor_dimmer_list, phosphor_dimmer_list_text )
         change_safe ()
+    add_bool( FILTER_CFG_PREFIX "simd", true, SIMD_TEXT, SIMD_LONGTEXT,
+              true )
     add_shortcut( "deinterlace" )
     set_callbacks( Open, Close )
 vlc_module_end ()
@@ -329,7 +335,7 @@ vlc_module_end ()
  * and reading logic for them implemented in Open().
  */
 static const char *const ppsz_filter_options[] = {
-    "mode", "phosphor-chroma", "phosphor-dimmer",
+    "mode", "phosphor-chroma", "phosphor-dimmer", "simd",
     NULL
 };
 
@@ -529,6 +535,24 @@ notsupp:
 
     IVTCClearState( p_filter );
 
+    p_sys->b_simd = var_InheritBool( p_filter, FILTER_CFG_PREFIX "simd" );
+
+    if( !p_sys->b_simd )
+    {
+        p_sys->pf_merge = pixel_size == 1 ? Merge8BitGeneric : Merge16BitGeneric;
+#if defined(__i386__) || defined(__x86_64__)
+        p_sys->pf_end_merge = NULL;
+#endif
+    }
+    else
+#if defined(MERGE_HAVE_AVX2)
+    if( vlc_CPU_AVX2() )
+    {
+        p_sys->pf_merge = pixel_size == 1 ? Merge8BitAVX2 : Merge16BitAVX2;
+        p_sys->pf_end_merge = NULL;
+    }
+    else
+#endif
 #if defined(CAN_COMPILE_C_ALTIVEC)
     if( pixel_size == 1 && vlc_CPU_ALTIVEC() )
         p_sys->pf_merge = MergeAltivec;
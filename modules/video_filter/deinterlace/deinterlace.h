@@ -75,6 +75,8 @@ struct filter_sys_t
     /** Merge finalization routine for SSE */
     void (*pf_end_merge) ( void );
 #endif
+    /** Whether the SIMD merge and Yadif routines may be used */
+    bool b_simd;
 
     struct deinterlace_ctx   context;
 
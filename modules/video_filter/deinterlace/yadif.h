@@ -151,3 +151,125 @@ static void yadif_filter_line_c_16bit(uint8_t *dst8, uint8_t *prev8, uint8_t *cu
     prefs /= 2;
     FILTER
 }
+
+#if (defined(__i386__) || defined(__x86_64__)) && \
+    (VLC_GCC_VERSION(4,9) || defined(__clang__))
+// ================ AVX2 =================
+#include <immintrin.h>
+#define HAVE_YADIF_AVX2
+
+/* 16 pixels widened to 16 bits */
+__attribute__ ((__target__ ("avx2")))
+static inline __m256i yadif_load_avx2(const uint8_t *p)
+{
+    return _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)p));
+}
+
+/* FFABS(a[0] - b[0]) for 16 pixels, widened to 16 bits */
+__attribute__ ((__target__ ("avx2")))
+static inline __m256i yadif_absdiff_avx2(__m128i a, __m128i b)
+{
+    return _mm256_cvtepu8_epi16(_mm_or_si128(_mm_subs_epu8(a, b),
+                                             _mm_subs_epu8(b, a)));
+}
+
+#define yadif_loadu_avx2(p) _mm_loadu_si128((const __m128i *)(p))
+
+/* Score and prediction of the direction j, see CHECK() */
+__attribute__ ((__target__ ("avx2")))
+static inline __m256i yadif_score_avx2(const uint8_t *cur, int prefs,
+                                       int mrefs, int j, __m256i *pred)
+{
+    __m128i a = yadif_loadu_avx2(&cur[mrefs+j]);
+    __m128i b = yadif_loadu_avx2(&cur[prefs-j]);
+
+    *pred = _mm256_srli_epi16(_mm256_add_epi16(_mm256_cvtepu8_epi16(a),
+                                               _mm256_cvtepu8_epi16(b)), 1);
+    return _mm256_add_epi16(
+               _mm256_add_epi16(yadif_absdiff_avx2(yadif_loadu_avx2(&cur[mrefs-1+j]),
+                                                   yadif_loadu_avx2(&cur[prefs-1-j])),
+                                yadif_absdiff_avx2(a, b)),
+               yadif_absdiff_avx2(yadif_loadu_avx2(&cur[mrefs+1+j]),
+                                  yadif_loadu_avx2(&cur[prefs+1-j])));
+}
+
+/* Same as FILTER, 16 pixels at a time. The nested CHECK()s become masks:
+ * the second direction only counts if the first one was better. */
+__attribute__ ((__target__ ("avx2")))
+static void yadif_filter_line_avx2(uint8_t *dst, uint8_t *prev, uint8_t *cur, uint8_t *next, int w, int prefs, int mrefs, int parity, int mode) {
+    uint8_t *prev2= parity ? prev : cur ;
+    uint8_t *next2= parity ? cur  : next;
+    const __m256i one = _mm256_set1_epi16(1);
+    int x;
+
+    for (x = 0; x + 16 <= w; x += 16) {
+        __m256i c = yadif_load_avx2(&cur[x+mrefs]);
+        __m256i e = yadif_load_avx2(&cur[x+prefs]);
+        __m256i p2 = yadif_load_avx2(&prev2[x]);
+        __m256i n2 = yadif_load_avx2(&next2[x]);
+        __m256i d = _mm256_srli_epi16(_mm256_add_epi16(p2, n2), 1);
+        __m256i temporal_diff0 = _mm256_abs_epi16(_mm256_sub_epi16(p2, n2));
+        __m256i temporal_diff1 = _mm256_srli_epi16(_mm256_add_epi16(
+            _mm256_abs_epi16(_mm256_sub_epi16(yadif_load_avx2(&prev[x+mrefs]), c)),
+            _mm256_abs_epi16(_mm256_sub_epi16(yadif_load_avx2(&prev[x+prefs]), e))), 1);
+        __m256i temporal_diff2 = _mm256_srli_epi16(_mm256_add_epi16(
+            _mm256_abs_epi16(_mm256_sub_epi16(yadif_load_avx2(&next[x+mrefs]), c)),
+            _mm256_abs_epi16(_mm256_sub_epi16(yadif_load_avx2(&next[x+prefs]), e))), 1);
+        __m256i diff = _mm256_max_epi16(_mm256_max_epi16(
+            _mm256_srli_epi16(temporal_diff0, 1), temporal_diff1), temporal_diff2);
+        __m256i spatial_pred = _mm256_srli_epi16(_mm256_add_epi16(c, e), 1);
+        __m256i spatial_score = _mm256_sub_epi16(_mm256_add_epi16(_mm256_add_epi16(
+            yadif_absdiff_avx2(yadif_loadu_avx2(&cur[x+mrefs-1]),
+                               yadif_loadu_avx2(&cur[x+prefs-1])),
+            _mm256_abs_epi16(_mm256_sub_epi16(c, e))),
+            yadif_absdiff_avx2(yadif_loadu_avx2(&cur[x+mrefs+1]),
+                               yadif_loadu_avx2(&cur[x+prefs+1]))), one);
+
+        for (int j = -1; j <= 1; j += 2) {
+            __m256i pred, score, better;
+
+            score = yadif_score_avx2(&cur[x], prefs, mrefs, j, &pred);
+            better = _mm256_cmpgt_epi16(spatial_score, score);
+            spatial_score = _mm256_min_epi16(spatial_score, score);
+            spatial_pred = _mm256_blendv_epi8(spatial_pred, pred, better);
+
+            score = yadif_score_avx2(&cur[x], prefs, mrefs, 2 * j, &pred);
+            better = _mm256_and_si256(better,
+                                      _mm256_cmpgt_epi16(spatial_score, score));
+            spatial_score = _mm256_blendv_epi8(spatial_score, score, better);
+            spatial_pred = _mm256_blendv_epi8(spatial_pred, pred, better);
+        }
+
+        if (mode < 2) {
+            __m256i b = _mm256_srli_epi16(_mm256_add_epi16(
+                yadif_load_avx2(&prev2[x+2*mrefs]),
+                yadif_load_avx2(&next2[x+2*mrefs])), 1);
+            __m256i f = _mm256_srli_epi16(_mm256_add_epi16(
+                yadif_load_avx2(&prev2[x+2*prefs]),
+                yadif_load_avx2(&next2[x+2*prefs])), 1);
+            __m256i de = _mm256_sub_epi16(d, e);
+            __m256i dc = _mm256_sub_epi16(d, c);
+            __m256i bc = _mm256_sub_epi16(b, c);
+            __m256i fe = _mm256_sub_epi16(f, e);
+            __m256i max = _mm256_max_epi16(_mm256_max_epi16(de, dc),
+                                           _mm256_min_epi16(bc, fe));
+            __m256i min = _mm256_min_epi16(_mm256_min_epi16(de, dc),
+                                           _mm256_max_epi16(bc, fe));
+
+            diff = _mm256_max_epi16(_mm256_max_epi16(diff, min),
+                                    _mm256_sub_epi16(_mm256_setzero_si256(), max));
+        }
+
+        spatial_pred = _mm256_max_epi16(spatial_pred, _mm256_sub_epi16(d, diff));
+        spatial_pred = _mm256_min_epi16(spatial_pred, _mm256_add_epi16(d, diff));
+        _mm_storeu_si128((__m128i *)&dst[x],
+                         _mm_packus_epi16(_mm256_castsi256_si128(spatial_pred),
+                                          _mm256_extracti128_si256(spatial_pred, 1)));
+    }
+
+    if (x < w)
+        yadif_filter_line_c(&dst[x], &prev[x], &cur[x], &next[x], w - x,
+                            prefs, mrefs, parity, mode);
+}
+
+#endif
@@ -108,6 +108,7 @@ struct filter_sys_t {
     int              radius;
     const vlc_chroma_description_t *chroma;
     struct vf_priv_s cfg;
+    size_t           buf_size; /* per plane, in cfg.buf */
 };
 
 static int Open(vlc_object_t *object)
@@ -173,6 +174,41 @@ static void Close(vlc_object_t *object)
     free(sys);
 }
 
+struct gradfun_slices {
+    picture_t *src;
+    picture_t *dst;
+};
+
+/* The blur runs down each plane, so planes are filtered in parallel rather
+ * than slices of them; each plane has its own part of the buffer. */
+static void FilterSlice(filter_t *filter, void *opaque,
+                        unsigned slice, unsigned slices)
+{
+    filter_sys_t *sys = filter->p_sys;
+    const struct gradfun_slices *s = opaque;
+    const video_format_t *fmt = &filter->fmt_in.video;
+
+    for (int i = slice; i < s->dst->i_planes; i += slices) {
+        const plane_t *srcp = &s->src->p[i];
+        plane_t       *dstp = &s->dst->p[i];
+        struct vf_priv_s cfg = sys->cfg;
+
+        const vlc_chroma_description_t *chroma = sys->chroma;
+        int w = fmt->i_width  * chroma->p[i].w.num / chroma->p[i].w.den;
+        int h = fmt->i_height * chroma->p[i].h.num / chroma->p[i].h.den;
+        int r = (cfg.radius  * chroma->p[i].w.num / chroma->p[i].w.den +
+                 cfg.radius  * chroma->p[i].h.num / chroma->p[i].h.den) / 2;
+        r = VLC_CLIP((r + 1) & ~1, RADIUS_MIN, RADIUS_MAX);
+        if (__MIN(w, h) > 2 * r && cfg.buf) {
+            cfg.buf += i * sys->buf_size;
+            filter_plane(&cfg, dstp->p_pixels, srcp->p_pixels,
+                         w, h, dstp->i_pitch, srcp->i_pitch, r);
+        } else {
+            plane_CopyPixels(dstp, srcp);
+        }
+    }
+}
+
 static picture_t *Filter(filter_t *filter, picture_t *src)
 {
     filter_sys_t *sys = filter->p_sys;
@@ -193,28 +229,15 @@ static picture_t *Filter(filter_t *filter, picture_t *src)
 
     cfg->thresh = (1 << 15) / strength;
     if (cfg->radius != radius) {
-        cfg->radius = radius;
-        cfg->buf    = aligned_alloc(16,
-                                   (((fmt->i_width + 15) & ~15) * (cfg->radius + 1) / 2 + 32) * sizeof(*cfg->buf));
+        cfg->radius   = radius;
+        sys->buf_size = ((fmt->i_width + 15) & ~15) * (cfg->radius + 1) / 2 + 32;
+        aligned_free(cfg->buf);
+        cfg->buf      = aligned_alloc(16,
+                                      PICTURE_PLANE_MAX * sys->buf_size * sizeof(*cfg->buf));
     }
 
-    for (int i = 0; i < dst->i_planes; i++) {
-        const plane_t *srcp = &src->p[i];
-        plane_t       *dstp = &dst->p[i];
-
-        const vlc_chroma_description_t *chroma = sys->chroma;
-        int w = fmt->i_width  * chroma->p[i].w.num / chroma->p[i].w.den;
-        int h = fmt->i_height * chroma->p[i].h.num / chroma->p[i].h.den;
-        int r = (cfg->radius  * chroma->p[i].w.num / chroma->p[i].w.den +
-                 cfg->radius  * chroma->p[i].h.num / chroma->p[i].h.den) / 2;
-        r = VLC_CLIP((r + 1) & ~1, RADIUS_MIN, RADIUS_MAX);
-        if (__MIN(w, h) > 2 * r && cfg->buf) {
-            filter_plane(cfg, dstp->p_pixels, srcp->p_pixels,
-                         w, h, dstp->i_pitch, srcp->i_pitch, r);
-        } else {
-            plane_CopyPixels(dstp, srcp);
-        }
-    }
+    struct gradfun_slices slices = { .src = src, .dst = dst };
+    filter_ExecuteSlices(filter, FilterSlice, &slices, dst->i_planes);
 
     picture_CopyProperties(dst, src);
     picture_Release(src);
@@ -91,6 +91,7 @@ struct filter_sys_t
 {
     const vlc_chroma_description_t *chroma;
     int w[3], h[3];
+    int wmax;
 
     struct vf_priv_s cfg;
     bool   b_recalc_coefs;
@@ -138,7 +139,9 @@ static int Open(vlc_object_t *this)
         if (sys->w[i] > wmax) wmax = sys->w[i];
         sys->h[i] = fmt_out->i_height * chroma->p[i].h.num / chroma->p[i].h.den;
     }
-    cfg->Line = malloc(wmax*sizeof(unsigned int));
+    /* One line buffer per plane, as planes are denoised in parallel */
+    sys->wmax = wmax;
+    cfg->Line = malloc(3*wmax*sizeof(unsigned int));
     if (!cfg->Line) {
         free(sys);
         return VLC_ENOMEM;
@@ -189,6 +192,35 @@ static void Close(vlc_object_t *this)
     free(sys);
 }
 
+/*****************************************************************************
+ * FilterSlice: denoises whole planes, as the filter is recursive along both
+ * directions
+ *****************************************************************************/
+struct hqdn3d_slices
+{
+    picture_t *src;
+    picture_t *dst;
+};
+
+static void FilterSlice(filter_t *filter, void *opaque,
+                        unsigned slice, unsigned slices)
+{
+    filter_sys_t *sys = filter->p_sys;
+    struct vf_priv_s *cfg = &sys->cfg;
+    const struct hqdn3d_slices *s = opaque;
+
+    for (unsigned i = slice; i < 3; i += slices) {
+        int spat = i == 0 ? 0 : 2;
+
+        deNoise(s->src->p[i].p_pixels, s->dst->p[i].p_pixels,
+                cfg->Line + i * sys->wmax, &cfg->Frame[i], sys->w[i], sys->h[i],
+                s->src->p[i].i_pitch, s->dst->p[i].i_pitch,
+                cfg->Coefs[spat],
+                cfg->Coefs[spat],
+                cfg->Coefs[spat + 1]);
+    }
+}
+
 /*****************************************************************************
  * Filter
  *****************************************************************************/
@@ -221,24 +253,8 @@ static picture_t *Filter(filter_t *filter, picture_t *src)
     }
     vlc_mutex_unlock( &sys->coefs_mutex );
 
-    deNoise(src->p[0].p_pixels, dst->p[0].p_pixels,
-            cfg->Line, &cfg->Frame[0], sys->w[0], sys->h[0],
-            src->p[0].i_pitch, dst->p[0].i_pitch,
-            cfg->Coefs[0],
-            cfg->Coefs[0],
-            cfg->Coefs[1]);
-    deNoise(src->p[1].p_pixels, dst->p[1].p_pixels,
-            cfg->Line, &cfg->Frame[1], sys->w[1], sys->h[1],
-            src->p[1].i_pitch, dst->p[1].i_pitch,
-            cfg->Coefs[2],
-            cfg->Coefs[2],
-            cfg->Coefs[3]);
-    deNoise(src->p[2].p_pixels, dst->p[2].p_pixels,
-            cfg->Line, &cfg->Frame[2], sys->w[2], sys->h[2],
-            src->p[2].i_pitch, dst->p[2].i_pitch,
-            cfg->Coefs[2],
-            cfg->Coefs[2],
-            cfg->Coefs[3]);
+    struct hqdn3d_slices slices = { .src = src, .dst = dst };
+    filter_ExecuteSlices(filter, FilterSlice, &slices, 3);
 
     if(unlikely(!cfg->Frame[0] || !cfg->Frame[1] || !cfg->Frame[2]))
     {
@@ -39,6 +39,7 @@ struct aout_volume
     audio_replay_gain_t replay_gain;
     vlc_atomic_float gain_factor;
     float output_factor;
+    float applied_factor; /**< last applied factor, negative if none */
     module_t *module;
 };
 
@@ -95,6 +96,8 @@ int aout_volume_SetFormat(aout_volume_t *vol, vlc_fourcc_t format)
     }
 
     obj->format = format;
+    obj->amplify_ramp = NULL;
+    vol->applied_factor = -1.f;
     vol->module = module_need(obj, "audio volume", NULL, false);
     if (vol->module == NULL)
         return -1;
@@ -137,7 +140,14 @@ int aout_volume_Amplify(aout_volume_t *vol, block_t *block)
     float amp = vol->output_factor
               * vlc_atomic_load_float (&vol->gain_factor);
 
-    vol->object.amplify(&vol->object, block, amp);
+    /* Ramp gain changes over one block to avoid zipper noise */
+    if (amp != vol->applied_factor && vol->applied_factor >= 0.f
+     && vol->object.amplify_ramp != NULL && block->i_nb_samples > 0)
+        vol->object.amplify_ramp(&vol->object, block, vol->applied_factor,
+                                 amp);
+    else
+        vol->object.amplify(&vol->object, block, amp);
+    vol->applied_factor = amp;
     return 0;
 }
 
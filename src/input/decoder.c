@@ -141,6 +141,11 @@ struct decoder_owner_sys_t
 
     /* Delay */
     vlc_tick_t i_ts_delay;
+
+    /* Video decoding statistics, written by the decoder thread and
+     * published with the other statistics of each picture */
+    atomic_llong i_decode_time; /* moving average per block */
+    atomic_uint  i_queue_depth; /* blocks left in the fifo */
 };
 
 /* Pictures which are DECODER_BOGUS_VIDEO_DELAY or more in advance probably have
@@ -1113,10 +1118,17 @@ static void DecoderUpdateStatVideo( decoder_owner_sys_t *p_owner,
         lost += vout_lost;
     }
 
+    vlc_tick_t decode_time = atomic_load_explicit( &p_owner->i_decode_time,
+                                                   memory_order_relaxed );
+    unsigned queue_depth = atomic_load_explicit( &p_owner->i_queue_depth,
+                                                 memory_order_relaxed );
+
     vlc_mutex_lock( &input_priv(p_input)->counters.counters_lock );
     stats_Update( input_priv(p_input)->counters.p_decoded_video, decoded, NULL );
     stats_Update( input_priv(p_input)->counters.p_lost_pictures, lost , NULL);
     stats_Update( input_priv(p_input)->counters.p_displayed_pictures, displayed, NULL);
+    stats_Update( input_priv(p_input)->counters.p_decode_time, decode_time, NULL );
+    stats_Update( input_priv(p_input)->counters.p_decoder_queue, queue_depth, NULL );
     vlc_mutex_unlock( &input_priv(p_input)->counters.counters_lock );
 }
 
@@ -1337,12 +1349,40 @@ static int DecoderQueueSpu( decoder_t *p_dec, subpicture_t *p_spu )
     return i_ret;
 }
 
+static void DecoderUpdateStatTiming( decoder_t *p_dec, vlc_tick_t duration )
+{
+    decoder_owner_sys_t *p_owner = p_dec->p_owner;
+    vlc_tick_t average = atomic_load_explicit( &p_owner->i_decode_time,
+                                               memory_order_relaxed );
+
+    /* Moving average over about 16 blocks, published by
+     * DecoderUpdateStatVideo() along with the next picture */
+    if( average == 0 )
+        average = duration;
+    else
+        average += (duration - average) / 16;
+    atomic_store_explicit( &p_owner->i_decode_time, average,
+                           memory_order_relaxed );
+}
+
 static void DecoderProcess( decoder_t *p_dec, block_t *p_block );
 static void DecoderDecode( decoder_t *p_dec, block_t *p_block )
 {
     decoder_owner_sys_t *p_owner = p_dec->p_owner;
+    bool b_timed = p_block != NULL && p_dec->fmt_in.i_cat == VIDEO_ES;
 
+    if( b_timed )
+    {   /* Waiting for the buffering to end is not decoding time */
+        vlc_mutex_lock( &p_owner->lock );
+        b_timed = !p_owner->b_waiting;
+        vlc_mutex_unlock( &p_owner->lock );
+    }
+
+    vlc_tick_t start = mdate();
     int ret = p_dec->pf_decode( p_dec, p_block );
+    if( b_timed )
+        DecoderUpdateStatTiming( p_dec, mdate() - start );
+
     switch( ret )
     {
         case VLCDEC_SUCCESS:
@@ -1604,6 +1644,9 @@ static void *DecoderThread( void *p_data )
         vlc_testcancel(); /* forced expedited cancellation in case of stop */
 
         block_t *p_block = vlc_fifo_DequeueUnlocked( p_owner->p_fifo );
+        atomic_store_explicit( &p_owner->i_queue_depth,
+                               vlc_fifo_GetCount( p_owner->p_fifo ),
+                               memory_order_relaxed );
         if( p_block == NULL )
         {
             if( likely(!p_owner->b_draining) )
@@ -1706,6 +1749,9 @@ static decoder_t * CreateDecoder( vlc_object_t *p_parent,
     atomic_init( &p_owner->reload, RELOAD_NO_REQUEST );
     p_owner->b_idle = false;
 
+    atomic_init( &p_owner->i_decode_time, 0 );
+    atomic_init( &p_owner->i_queue_depth, 0 );
+
     es_format_Init( &p_owner->fmt, fmt->i_cat, 0 );
 
     /* decoder fifo */
@@ -74,6 +74,9 @@ enum es_out_query_private_e
     /* Set a new time */
     ES_OUT_SET_TIME,                                /* arg1=vlc_tick_t          res=can fail */
 
+    /* Skip forward through the data buffered by the timeshift */
+    ES_OUT_SKIP_TIME,                               /* arg1=vlc_tick_t i_delay  res=can fail */
+
     /* Set next frame */
     ES_OUT_SET_FRAME_NEXT,                          /*                          res=can fail */
 
@@ -140,6 +143,10 @@ static inline int es_out_SetTime( es_out_t *p_out, vlc_tick_t i_date )
 {
     return es_out_Control( p_out, ES_OUT_SET_TIME, i_date );
 }
+static inline int es_out_SkipTime( es_out_t *p_out, vlc_tick_t i_delay )
+{
+    return es_out_Control( p_out, ES_OUT_SKIP_TIME, i_delay );
+}
 static inline int es_out_SetFrameNext( es_out_t *p_out )
 {
     return es_out_Control( p_out, ES_OUT_SET_FRAME_NEXT );
@@ -32,6 +32,7 @@
 #include <stdio.h>
 #include <assert.h>
 #include <errno.h>
+#include <limits.h>
 #if defined (_WIN32)
 #  include <direct.h>
 #endif
@@ -49,6 +50,7 @@
 #include "input_internal.h"
 #include "es_out.h"
 #include "es_out_timeshift.h"
+#include "timeshift_buffer.h"
 
 /*****************************************************************************
  * Local prototypes
@@ -85,6 +87,7 @@ typedef struct attribute_packed
     es_out_id_t *p_es;
     block_t *p_block;
     int     i_offset;  /* We do not use file > INT_MAX */
+    size_t  i_buffer;
 } ts_cmd_send_t;
 
 typedef struct attribute_packed
@@ -161,32 +164,53 @@ typedef struct attribute_packed
     } u;
 } ts_cmd_t;
 
-typedef struct ts_storage_t ts_storage_t;
-struct ts_storage_t
+/* PTS index entry, pointing at a queued C_SEND command */
+typedef struct
 {
-    ts_storage_t *p_next;
+    vlc_tick_t i_pts;
+    uint64_t   i_cmd;
+} ts_index_t;
 
-    /* */
-#ifdef _WIN32
-    char    *psz_file;  /* Filename */
-#endif
-    size_t  i_file_max; /* Max size in bytes */
-    int64_t i_file_size;/* Current size in bytes */
-    FILE    *p_filew;   /* FILE handle for data writing */
-    FILE    *p_filer;   /* FILE handle for data reading */
+/* Minimal PTS distance between two index entries */
+#define TS_INDEX_INTERVAL (CLOCK_FREQ/4)
 
-    /* */
-    int      i_cmd_r;
-    int      i_cmd_w;
-    int      i_cmd_max;
+/* The timeshift storage is a fixed size circular buffer for the block
+ * data. The commands themselves are queued in memory. When the buffer is
+ * full, the oldest commands are dropped and the playback jumps forward. */
+typedef struct
+{
+    /* Circular data buffer */
+    ts_buffer_t *p_buffer;
+
+    /* Command queue (circular, grows as needed) */
     ts_cmd_t *p_cmd;
-};
+    size_t   i_cmd_max; /* Power of two */
+    uint64_t i_cmd_r;
+    uint64_t i_cmd_w;
+
+    /* Commands that cannot be dropped with their data, to be executed
+     * before the queue */
+    int      i_held;
+    ts_cmd_t *p_held;
+
+    /* Timestamp of the last block read */
+    vlc_tick_t i_pts_r;
+
+    /* Sparse PTS index of the queued data, sorted */
+    size_t   i_index_first;
+    size_t   i_index;
+    size_t   i_index_max;
+    ts_index_t *p_index;
+
+    bool     b_warned;
+} ts_storage_t;
 
 typedef struct
 {
     vlc_thread_t   thread;
     input_thread_t *p_input;
     es_out_t       *p_out;
+    int64_t        i_tmp_size;
     int64_t        i_tmp_size_max;
     const char     *psz_tmp_path;
 
@@ -208,8 +232,7 @@ typedef struct
     vlc_tick_t     i_buffering_delay;
 
     /* */
-    ts_storage_t   *p_storage_r;
-    ts_storage_t   *p_storage_w;
+    ts_storage_t   *p_storage;
 
     vlc_tick_t     i_cmd_delay;
 
@@ -218,6 +241,7 @@ typedef struct
 struct es_out_id_t
 {
     es_out_id_t *p_es;
+    bool        b_discontinuity; /* Data was dropped, protected by the ts lock */
 };
 
 struct es_out_sys_t
@@ -226,7 +250,8 @@ struct es_out_sys_t
     es_out_t       *p_out;
 
     /* Configuration */
-    int64_t        i_tmp_size_max;    /* Maximal temporary file size in byte */
+    int64_t        i_tmp_size;        /* Timeshift buffer size in byte */
+    int64_t        i_tmp_size_max;    /* Disk space reserved at once */
     char           *psz_tmp_path;     /* Path for temporary files */
 
     /* Lock for all following fields */
@@ -259,6 +284,8 @@ static void         TsAutoStop( es_out_t * );
 static void         TsStop( ts_thread_t * );
 static void         TsPushCmd( ts_thread_t *, ts_cmd_t * );
 static int          TsPopCmdLocked( ts_thread_t *, ts_cmd_t *, bool b_flush );
+static int          TsSkip( ts_thread_t *, vlc_tick_t i_delay );
+static void         TsUpdateStats( ts_thread_t * );
 static bool         TsHasCmd( ts_thread_t * );
 static bool         TsIsUnused( ts_thread_t * );
 static int          TsChangePause( ts_thread_t *, bool b_source_paused, bool b_paused, vlc_tick_t i_date );
@@ -266,13 +293,15 @@ static int          TsChangeRate( ts_thread_t *, int i_src_rate, int i_rate );
 
 static void         *TsRun( void * );
 
-static ts_storage_t *TsStorageNew( const char *psz_path, int64_t i_tmp_size_max );
+static ts_storage_t *TsStorageNew( const char *psz_path, int64_t i_tmp_size, int64_t i_tmp_size_max );
+static bool         TsStorageReserve( ts_storage_t *, const ts_cmd_t *p_cmd );
 static void         TsStorageDelete( ts_storage_t * );
-static void         TsStoragePack( ts_storage_t *p_storage );
-static bool         TsStorageIsFull( ts_storage_t *, const ts_cmd_t *p_cmd );
+static bool         TsStorageHasRoom( ts_storage_t *, const ts_cmd_t *p_cmd );
 static bool         TsStorageIsEmpty( ts_storage_t * );
-static void         TsStoragePushCmd( ts_storage_t *, const ts_cmd_t *p_cmd, bool b_flush );
+static void         TsStoragePushCmd( ts_storage_t *, const ts_cmd_t *p_cmd );
 static void         TsStoragePopCmd( ts_storage_t *p_storage, ts_cmd_t *p_cmd, bool b_flush );
+static vlc_tick_t   TsStorageDropCmd( ts_storage_t * );
+static bool         TsStorageFind( ts_storage_t *, vlc_tick_t i_pts, uint64_t *pi_cmd );
 
 static void CmdClean( ts_cmd_t * );
 static void cmd_cleanup_routine( void *p ) { CmdClean( p ); }
@@ -294,7 +323,6 @@ static void CmdExecuteDel    ( es_out_t *, ts_cmd_t * );
 static int  CmdExecuteControl( es_out_t *, ts_cmd_t * );
 
 /* File helpers */
-static int GetTmpFile( char **ppsz_file, const char *psz_path );
 
 /*****************************************************************************
  * input_EsOutTimeshiftNew:
@@ -336,13 +364,21 @@ es_out_t *input_EsOutTimeshiftNew( input_thread_t *p_input, es_out_t *p_next_out
     TAB_INIT( p_sys->i_es, p_sys->pp_es );
 
     /* */
-    const int i_tmp_size_max = var_CreateGetInteger( p_input, "input-timeshift-granularity" );
+    const int64_t i_tmp_size = var_CreateGetInteger( p_input, "input-timeshift-size" );
+    if( i_tmp_size < 0 )
+        p_sys->i_tmp_size = (SIZE_MAX > UINT32_MAX ? 1024 : 256) * 1024*1024;
+    else
+        p_sys->i_tmp_size = VLC_CLIP( i_tmp_size, 1*1024*1024, INT_MAX );
+    msg_Dbg( p_input, "using timeshift buffer of %d MiB",
+             (int)(p_sys->i_tmp_size/(1024*1024)) );
+
+    const int64_t i_tmp_size_max = var_CreateGetInteger( p_input, "input-timeshift-granularity" );
     if( i_tmp_size_max < 0 )
         p_sys->i_tmp_size_max = 50*1024*1024;
     else
-        p_sys->i_tmp_size_max = __MAX( i_tmp_size_max, 1*1024*1024 );
+        p_sys->i_tmp_size_max = VLC_CLIP( i_tmp_size_max, 1*1024*1024, INT_MAX );
     msg_Dbg( p_input, "using timeshift granularity of %d MiB",
-             (int)p_sys->i_tmp_size_max/(1024*1024) );
+             (int)(p_sys->i_tmp_size_max/(1024*1024)) );
 
     p_sys->psz_tmp_path = var_InheritString( p_input, "input-timeshift-path" );
 #if defined (_WIN32) && !VLC_WINSTORE_APP
@@ -615,6 +651,17 @@ static int ControlLockedSetTime( es_out_t *p_out, vlc_tick_t i_date )
     msg_Err( p_sys->p_input, "EsOutTimeshift does not yet support time change" );
     return VLC_EGENERIC;
 }
+static int ControlLockedSkipTime( es_out_t *p_out, vlc_tick_t i_delay )
+{
+    es_out_sys_t *p_sys = p_out->p_sys;
+
+    /* Only the buffered data can be skipped */
+    if( !p_sys->b_delayed || i_delay <= 0 || TsSkip( p_sys->p_ts, i_delay ) )
+        return VLC_EGENERIC;
+
+    /* Reset the decoders and the clock, as for a seek */
+    return es_out_SetTime( p_sys->p_out, -1 );
+}
 static int ControlLockedSetFrameNext( es_out_t *p_out )
 {
     es_out_sys_t *p_sys = p_out->p_sys;
@@ -714,6 +761,12 @@ static int ControlLocked( es_out_t *p_out, int i_query, va_list args )
 
         return ControlLockedSetTime( p_out, i_date );
     }
+    case ES_OUT_SKIP_TIME:
+    {
+        const vlc_tick_t i_delay = (vlc_tick_t)va_arg( args, vlc_tick_t );
+
+        return ControlLockedSkipTime( p_out, i_delay );
+    }
     case ES_OUT_SET_FRAME_NEXT:
     {
         return ControlLockedSetFrameNext( p_out );
@@ -788,6 +841,7 @@ static int TsStart( es_out_t *p_out )
     if( !p_ts )
         return VLC_EGENERIC;
 
+    p_ts->i_tmp_size = p_sys->i_tmp_size;
     p_ts->i_tmp_size_max = p_sys->i_tmp_size_max;
     p_ts->psz_tmp_path = p_sys->psz_tmp_path;
     p_ts->p_input = p_sys->p_input;
@@ -802,8 +856,7 @@ static int TsStart( es_out_t *p_out )
     p_ts->i_rate_delay = 0;
     p_ts->i_buffering_delay = 0;
     p_ts->i_cmd_delay = 0;
-    p_ts->p_storage_r = NULL;
-    p_ts->p_storage_w = NULL;
+    p_ts->p_storage = NULL;
 
     p_sys->b_delayed = true;
     if( vlc_clone( &p_ts->thread, TsRun, p_ts, VLC_THREAD_PRIORITY_INPUT ) )
@@ -845,43 +898,81 @@ static void TsStop( ts_thread_t *p_ts )
 
         CmdClean( &cmd );
     }
-    assert( !p_ts->p_storage_r || !p_ts->p_storage_r->p_next );
-    if( p_ts->p_storage_r )
-        TsStorageDelete( p_ts->p_storage_r );
+    if( p_ts->p_storage )
+        TsStorageDelete( p_ts->p_storage );
+    p_ts->p_storage = NULL;
+    TsUpdateStats( p_ts );
     vlc_mutex_unlock( &p_ts->lock );
 
     TsDestroy( p_ts );
 }
+static void TsUpdateStats( ts_thread_t *p_ts )
+{
+    input_thread_private_t *priv = input_priv( p_ts->p_input );
+    const ts_storage_t *p_storage = p_ts->p_storage;
+    uint64_t i_fill = 0, i_index = 0;
+
+    if( p_storage )
+    {
+        i_fill = p_storage->p_buffer->i_data_w - p_storage->p_buffer->i_data_r;
+        i_index = p_storage->i_index;
+    }
+
+    vlc_mutex_lock( &priv->counters.counters_lock );
+    stats_Update( priv->counters.p_timeshift_fill, i_fill, NULL );
+    stats_Update( priv->counters.p_timeshift_index, i_index, NULL );
+    vlc_mutex_unlock( &priv->counters.counters_lock );
+}
+static void TsDropCmdLocked( ts_thread_t *p_ts, vlc_tick_t i_next )
+{
+    ts_storage_t *p_storage = p_ts->p_storage;
+
+    if( !p_storage->b_warned )
+    {
+        msg_Warn( p_ts->p_input, "es out timeshift: buffer full, dropping data" );
+        p_storage->b_warned = true;
+    }
+
+    const vlc_tick_t i_date = TsStorageDropCmd( p_storage );
+    if( p_storage->i_cmd_r < p_storage->i_cmd_w )
+        i_next = p_storage->p_cmd[p_storage->i_cmd_r & (p_storage->i_cmd_max - 1)].i_date;
+
+    /* Jump forward: the next command is due when the dropped one was */
+    p_ts->i_cmd_delay -= i_next - i_date;
+}
 static void TsPushCmd( ts_thread_t *p_ts, ts_cmd_t *p_cmd )
 {
     vlc_mutex_lock( &p_ts->lock );
 
-    if( !p_ts->p_storage_w || TsStorageIsFull( p_ts->p_storage_w, p_cmd ) )
+    if( !p_ts->p_storage )
     {
-        ts_storage_t *p_storage = TsStorageNew( p_ts->psz_tmp_path, p_ts->i_tmp_size_max );
-
-        if( !p_storage )
+        p_ts->p_storage = TsStorageNew( p_ts->psz_tmp_path, p_ts->i_tmp_size,
+                                        p_ts->i_tmp_size_max );
+        if( !p_ts->p_storage )
         {
             CmdClean( p_cmd );
             vlc_mutex_unlock( &p_ts->lock );
             /* TODO warn the user (but only once) */
             return;
         }
-
-        if( !p_ts->p_storage_w )
-        {
-            p_ts->p_storage_r = p_ts->p_storage_w = p_storage;
-        }
-        else
-        {
-            TsStoragePack( p_ts->p_storage_w );
-            p_ts->p_storage_w->p_next = p_storage;
-            p_ts->p_storage_w = p_storage;
-        }
     }
 
-    /* TODO return error and warn the user (but only once) */
-    TsStoragePushCmd( p_ts->p_storage_w, p_cmd, p_ts->p_storage_r == p_ts->p_storage_w );
+    if( p_cmd->i_type == C_SEND &&
+        ts_buffer_RecordSize( p_cmd->u.send.p_block->i_buffer ) >
+        p_ts->p_storage->p_buffer->i_data_size )
+        msg_Warn( p_ts->p_input, "es out timeshift: block too large, dropped" );
+
+    if( !TsStorageReserve( p_ts->p_storage, p_cmd ) )
+        msg_Warn( p_ts->p_input, "es out timeshift: disk full, "
+                  "buffer limited to %zu MiB",
+                  p_ts->p_storage->p_buffer->i_data_size >> 20 );
+
+    /* Make room by dropping the oldest commands */
+    while( !TsStorageHasRoom( p_ts->p_storage, p_cmd ) )
+        TsDropCmdLocked( p_ts, p_cmd->i_date );
+
+    TsStoragePushCmd( p_ts->p_storage, p_cmd );
+    TsUpdateStats( p_ts );
 
     vlc_cond_signal( &p_ts->wait );
 
@@ -891,21 +982,42 @@ static int TsPopCmdLocked( ts_thread_t *p_ts, ts_cmd_t *p_cmd, bool b_flush )
 {
     vlc_assert_locked( &p_ts->lock );
 
-    if( TsStorageIsEmpty( p_ts->p_storage_r ) )
+    if( TsStorageIsEmpty( p_ts->p_storage ) )
         return VLC_EGENERIC;
 
-    TsStoragePopCmd( p_ts->p_storage_r, p_cmd, b_flush );
+    TsStoragePopCmd( p_ts->p_storage, p_cmd, b_flush );
+    TsUpdateStats( p_ts );
 
-    while( TsStorageIsEmpty( p_ts->p_storage_r ) )
-    {
-        ts_storage_t *p_next = p_ts->p_storage_r->p_next;
-        if( !p_next )
-            break;
+    return VLC_SUCCESS;
+}
+/* Skips the given duration of buffered data, from the last block read */
+static int TsSkip( ts_thread_t *p_ts, vlc_tick_t i_delay )
+{
+    uint64_t i_cmd;
 
-        TsStorageDelete( p_ts->p_storage_r );
-        p_ts->p_storage_r = p_next;
+    vlc_mutex_lock( &p_ts->lock );
+    if( !p_ts->p_storage || p_ts->p_storage->i_pts_r <= VLC_TS_INVALID ||
+        !TsStorageFind( p_ts->p_storage, p_ts->p_storage->i_pts_r + i_delay, &i_cmd ) )
+    {
+        vlc_mutex_unlock( &p_ts->lock );
+        return VLC_EGENERIC;
     }
 
+    /* Skip the commands before the indexed one */
+    while( p_ts->p_storage->i_cmd_r < i_cmd )
+        TsStorageDropCmd( p_ts->p_storage );
+    TsUpdateStats( p_ts );
+
+    /* The found command is due now */
+    const ts_storage_t *p_storage = p_ts->p_storage;
+    const vlc_tick_t i_date = p_storage->p_cmd[i_cmd & (p_storage->i_cmd_max - 1)].i_date;
+    p_ts->i_cmd_delay = (p_ts->b_paused ? p_ts->i_pause_date : mdate()) - i_date;
+    p_ts->i_rate_date = -1;
+    p_ts->i_rate_delay = 0;
+    p_ts->i_buffering_delay = 0;
+
+    vlc_cond_signal( &p_ts->wait );
+    vlc_mutex_unlock( &p_ts->lock );
     return VLC_SUCCESS;
 }
 static bool TsHasCmd( ts_thread_t *p_ts )
@@ -913,7 +1025,7 @@ static bool TsHasCmd( ts_thread_t *p_ts )
     bool b_cmd;
 
     vlc_mutex_lock( &p_ts->lock );
-    b_cmd = !TsStorageIsEmpty( p_ts->p_storage_r );
+    b_cmd = !TsStorageIsEmpty( p_ts->p_storage );
     vlc_mutex_unlock( &p_ts->lock );
 
     return b_cmd;
@@ -925,7 +1037,7 @@ static bool TsIsUnused( ts_thread_t *p_ts )
     vlc_mutex_lock( &p_ts->lock );
     b_unused = !p_ts->b_paused &&
                p_ts->i_rate == p_ts->i_rate_source &&
-               TsStorageIsEmpty( p_ts->p_storage_r );
+               TsStorageIsEmpty( p_ts->p_storage );
     vlc_mutex_unlock( &p_ts->lock );
 
     return b_unused;
@@ -1102,70 +1214,26 @@ static void *TsRun( void *p_data )
 /*****************************************************************************
  *
  *****************************************************************************/
-static ts_storage_t *TsStorageNew( const char *psz_tmp_path, int64_t i_tmp_size_max )
+static ts_storage_t *TsStorageNew( const char *psz_tmp_path, int64_t i_tmp_size,
+                                   int64_t i_tmp_size_max )
 {
-    ts_storage_t *p_storage = malloc( sizeof (*p_storage) );
+    ts_storage_t *p_storage = calloc( 1, sizeof (*p_storage) );
     if( unlikely(p_storage == NULL) )
         return NULL;
 
-    char *psz_file;
-    int fd = GetTmpFile( &psz_file, psz_tmp_path );
-    if( fd == -1 )
+    p_storage->p_buffer = ts_buffer_New( psz_tmp_path, i_tmp_size, i_tmp_size_max );
+    if( !p_storage->p_buffer )
     {
         free( p_storage );
         return NULL;
     }
-
-    p_storage->p_filew = fdopen( fd, "w+b" );
-    if( p_storage->p_filew == NULL )
-    {
-        vlc_close( fd );
-        vlc_unlink( psz_file );
-        goto error;
-    }
-
-    p_storage->p_filer = vlc_fopen( psz_file, "rb" );
-    if( p_storage->p_filer == NULL )
-    {
-        fclose( p_storage->p_filew );
-        vlc_unlink( psz_file );
-        goto error;
-    }
-
-#ifndef _WIN32
-    vlc_unlink( psz_file );
-    free( psz_file );
-#else
-    p_storage->psz_file = psz_file;
-#endif
-    p_storage->p_next = NULL;
-
-    /* */
-    p_storage->i_file_max = i_tmp_size_max;
-    p_storage->i_file_size = 0;
-
-    /* */
-    p_storage->i_cmd_w = 0;
-    p_storage->i_cmd_r = 0;
-    p_storage->i_cmd_max = 30000;
-    p_storage->p_cmd = vlc_alloc( p_storage->i_cmd_max, sizeof(*p_storage->p_cmd) );
-    //fprintf( stderr, "\nSTORAGE name=%s size=%d KiB\n", p_storage->psz_file, p_storage->i_cmd_max * sizeof(*p_storage->p_cmd) /1024 );
-
-    if( !p_storage->p_cmd )
-    {
-        TsStorageDelete( p_storage );
-        return NULL;
-    }
+    p_storage->i_pts_r = VLC_TS_INVALID;
     return p_storage;
-error:
-    free( psz_file );
-    free( p_storage );
-    return NULL;
 }
 
 static void TsStorageDelete( ts_storage_t *p_storage )
 {
-    while( p_storage->i_cmd_r < p_storage->i_cmd_w )
+    while( !TsStorageIsEmpty( p_storage ) )
     {
         ts_cmd_t cmd;
 
@@ -1174,109 +1242,231 @@ static void TsStorageDelete( ts_storage_t *p_storage )
         CmdClean( &cmd );
     }
     free( p_storage->p_cmd );
+    free( p_storage->p_index );
 
-    fclose( p_storage->p_filer );
-    fclose( p_storage->p_filew );
-#ifdef _WIN32
-    vlc_unlink( p_storage->psz_file );
-    free( p_storage->psz_file );
-#endif
+    ts_buffer_Delete( p_storage->p_buffer );
     free( p_storage );
 }
 
-static void TsStoragePack( ts_storage_t *p_storage )
+static bool TsStorageHasRoom( ts_storage_t *p_storage, const ts_cmd_t *p_cmd )
 {
-    /* Try to release a bit of memory */
-    if( p_storage->i_cmd_w >= p_storage->i_cmd_max )
-        return;
+    if( p_cmd->i_type != C_SEND )
+        return true;
+    return ts_buffer_HasRoom( p_storage->p_buffer, p_cmd->u.send.p_block->i_buffer );
+}
+/* Reserves the disk space for the given command before it is written.
+ * Returns false if the disk is full: the buffer is then limited to the space
+ * reserved so far. */
+static bool TsStorageReserve( ts_storage_t *p_storage, const ts_cmd_t *p_cmd )
+{
+    if( p_cmd->i_type != C_SEND )
+        return true;
+    return ts_buffer_Reserve( p_storage->p_buffer, p_cmd->u.send.p_block->i_buffer );
+}
+static bool TsStorageIsEmpty( ts_storage_t *p_storage )
+{
+    return !p_storage ||
+           ( p_storage->i_held <= 0 && p_storage->i_cmd_r >= p_storage->i_cmd_w );
+}
+
+static int TsStorageGrow( ts_storage_t *p_storage )
+{
+    const size_t i_max = p_storage->i_cmd_max > 0 ? 2 * p_storage->i_cmd_max : 1024;
+    ts_cmd_t *p_cmd = vlc_alloc( i_max, sizeof(*p_cmd) );
+    if( unlikely(p_cmd == NULL) )
+        return VLC_ENOMEM;
 
-    p_storage->i_cmd_max = __MAX( p_storage->i_cmd_w, 1 );
+    /* Positions are absolute, so commands just move to their new slot */
+    for( uint64_t i = p_storage->i_cmd_r; i < p_storage->i_cmd_w; i++ )
+        p_cmd[i & (i_max - 1)] = p_storage->p_cmd[i & (p_storage->i_cmd_max - 1)];
 
-    ts_cmd_t *p_new = realloc( p_storage->p_cmd, p_storage->i_cmd_max * sizeof(*p_storage->p_cmd) );
-    if( p_new )
-        p_storage->p_cmd = p_new;
+    free( p_storage->p_cmd );
+    p_storage->p_cmd = p_cmd;
+    p_storage->i_cmd_max = i_max;
+    return VLC_SUCCESS;
 }
-static bool TsStorageIsFull( ts_storage_t *p_storage, const ts_cmd_t *p_cmd )
+
+static void TsStorageIndexAdd( ts_storage_t *p_storage, vlc_tick_t i_pts, uint64_t i_cmd )
 {
-    if( p_cmd && p_cmd->i_type == C_SEND && p_storage->i_cmd_w > 0 )
+    if( i_pts <= VLC_TS_INVALID )
+        return;
+
+    if( p_storage->i_index > 0 )
     {
-        size_t i_size = sizeof(*p_cmd->u.send.p_block) + p_cmd->u.send.p_block->i_buffer;
+        const ts_index_t *p_last =
+            &p_storage->p_index[p_storage->i_index_first + p_storage->i_index - 1];
 
-        if( p_storage->i_file_size + i_size >= p_storage->i_file_max )
-            return true;
+        if( i_pts + 10 * CLOCK_FREQ < p_last->i_pts )
+        {
+            /* Timestamps went backward, restart the index */
+            p_storage->i_index_first = 0;
+            p_storage->i_index = 0;
+        }
+        else if( i_pts < p_last->i_pts + TS_INDEX_INTERVAL )
+            return;
     }
-    return p_storage->i_cmd_w >= p_storage->i_cmd_max;
+
+    if( p_storage->i_index_first + p_storage->i_index >= p_storage->i_index_max )
+    {
+        if( p_storage->i_index_first > p_storage->i_index_max / 2 )
+        {
+            memmove( p_storage->p_index, &p_storage->p_index[p_storage->i_index_first],
+                     p_storage->i_index * sizeof(*p_storage->p_index) );
+        }
+        else
+        {
+            const size_t i_max = __MAX( 2 * p_storage->i_index_max, 256 );
+            ts_index_t *p_index = realloc( p_storage->p_index,
+                                           i_max * sizeof(*p_index) );
+            if( unlikely(p_index == NULL) )
+                return;
+            memmove( p_index, &p_index[p_storage->i_index_first],
+                     p_storage->i_index * sizeof(*p_index) );
+            p_storage->p_index = p_index;
+            p_storage->i_index_max = i_max;
+        }
+        p_storage->i_index_first = 0;
+    }
+
+    ts_index_t *p_entry = &p_storage->p_index[p_storage->i_index_first + p_storage->i_index++];
+    p_entry->i_pts = i_pts;
+    p_entry->i_cmd = i_cmd;
 }
-static bool TsStorageIsEmpty( ts_storage_t *p_storage )
+static void TsStorageIndexTrim( ts_storage_t *p_storage )
 {
-    return !p_storage || p_storage->i_cmd_r >= p_storage->i_cmd_w;
+    while( p_storage->i_index > 0 &&
+           p_storage->p_index[p_storage->i_index_first].i_cmd < p_storage->i_cmd_r )
+    {
+        p_storage->i_index_first++;
+        p_storage->i_index--;
+    }
+    if( p_storage->i_index == 0 )
+        p_storage->i_index_first = 0;
 }
-static void TsStoragePushCmd( ts_storage_t *p_storage, const ts_cmd_t *p_cmd, bool b_flush )
+/* Finds the first indexed command at or after the given PTS */
+static bool TsStorageFind( ts_storage_t *p_storage, vlc_tick_t i_pts, uint64_t *pi_cmd )
+{
+    if( p_storage->i_index == 0 )
+        return false;
+
+    const ts_index_t *p_index = &p_storage->p_index[p_storage->i_index_first];
+    size_t i_low = 0, i_high = p_storage->i_index;
+
+    while( i_low < i_high )
+    {
+        const size_t i_mid = i_low + (i_high - i_low) / 2;
+
+        if( p_index[i_mid].i_pts < i_pts )
+            i_low = i_mid + 1;
+        else
+            i_high = i_mid;
+    }
+    if( i_low >= p_storage->i_index )
+        return false;
+
+    *pi_cmd = p_index[i_low].i_cmd;
+    return true;
+}
+
+static void TsStoragePushCmd( ts_storage_t *p_storage, const ts_cmd_t *p_cmd )
 {
     ts_cmd_t cmd = *p_cmd;
 
-    assert( !TsStorageIsFull( p_storage, p_cmd ) );
+    if( p_storage->i_cmd_w - p_storage->i_cmd_r >= p_storage->i_cmd_max &&
+        TsStorageGrow( p_storage ) )
+    {
+        CmdClean( &cmd );
+        return;
+    }
 
     if( cmd.i_type == C_SEND )
     {
         block_t *p_block = cmd.u.send.p_block;
 
         cmd.u.send.p_block = NULL;
-        cmd.u.send.i_offset = ftell( p_storage->p_filew );
+        cmd.u.send.i_buffer = p_block->i_buffer;
+        cmd.u.send.i_offset = ts_buffer_Write( p_storage->p_buffer, p_block );
 
-        if( fwrite( p_block, sizeof(*p_block), 1, p_storage->p_filew ) != 1 )
-        {
-            block_Release( p_block );
-            return;
-        }
-        p_storage->i_file_size += sizeof(*p_block);
-        if( p_block->i_buffer > 0 )
-        {
-            if( fwrite( p_block->p_buffer, p_block->i_buffer, 1, p_storage->p_filew ) != 1 )
-            {
-                block_Release( p_block );
-                return;
-            }
-        }
-        p_storage->i_file_size += p_block->i_buffer;
+        if( cmd.u.send.i_offset >= 0 )
+            TsStorageIndexAdd( p_storage, p_block->i_pts > VLC_TS_INVALID
+                                          ? p_block->i_pts : p_block->i_dts,
+                               p_storage->i_cmd_w );
+        else
+            cmd.u.send.p_es->b_discontinuity = true;
         block_Release( p_block );
-
-        if( b_flush )
-            fflush( p_storage->p_filew );
     }
-    p_storage->p_cmd[p_storage->i_cmd_w++] = cmd;
+    p_storage->p_cmd[p_storage->i_cmd_w++ & (p_storage->i_cmd_max - 1)] = cmd;
 }
 static void TsStoragePopCmd( ts_storage_t *p_storage, ts_cmd_t *p_cmd, bool b_flush )
 {
     assert( !TsStorageIsEmpty( p_storage ) );
 
-    *p_cmd = p_storage->p_cmd[p_storage->i_cmd_r++];
+    if( p_storage->i_held > 0 )
+    {
+        *p_cmd = p_storage->p_held[0];
+        TAB_ERASE( p_storage->i_held, p_storage->p_held, 0 );
+        return;
+    }
+
+    *p_cmd = p_storage->p_cmd[p_storage->i_cmd_r++ & (p_storage->i_cmd_max - 1)];
     if( p_cmd->i_type == C_SEND )
     {
-        block_t block;
+        block_t *p_block = NULL;
+
+        if( p_cmd->u.send.i_offset >= 0 )
+            p_block = ts_buffer_Read( p_storage->p_buffer, p_cmd->u.send.i_offset,
+                                      p_cmd->u.send.i_buffer, b_flush );
 
-        if( !b_flush &&
-            !fseek( p_storage->p_filer, p_cmd->u.send.i_offset, SEEK_SET ) &&
-            fread( &block, sizeof(block), 1, p_storage->p_filer ) == 1 )
+        if( p_block && p_block->i_pts > VLC_TS_INVALID )
+            p_storage->i_pts_r = p_block->i_pts;
+        if( p_block && p_cmd->u.send.p_es->b_discontinuity )
         {
-            block_t *p_block = block_Alloc( block.i_buffer );
-            if( p_block )
-            {
-                p_block->i_dts      = block.i_dts;
-                p_block->i_pts      = block.i_pts;
-                p_block->i_flags    = block.i_flags;
-                p_block->i_length   = block.i_length;
-                p_block->i_nb_samples = block.i_nb_samples;
-                p_block->i_buffer = fread( p_block->p_buffer, 1, block.i_buffer, p_storage->p_filer );
-            }
-            p_cmd->u.send.p_block = p_block;
+            p_block->i_flags |= BLOCK_FLAG_DISCONTINUITY;
+            p_cmd->u.send.p_es->b_discontinuity = false;
         }
-        else
+        p_cmd->u.send.p_block = p_block;
+    }
+    TsStorageIndexTrim( p_storage );
+}
+/* Drops the oldest queued command, and returns its date. Commands that
+ * do not depend on the dropped data are kept aside to be executed first. */
+static vlc_tick_t TsStorageDropCmd( ts_storage_t *p_storage )
+{
+    assert( p_storage->i_cmd_r < p_storage->i_cmd_w );
+
+    ts_cmd_t cmd = p_storage->p_cmd[p_storage->i_cmd_r++ & (p_storage->i_cmd_max - 1)];
+
+    switch( cmd.i_type )
+    {
+    case C_SEND:
+        if( cmd.u.send.i_offset >= 0 )
+            ts_buffer_Read( p_storage->p_buffer, cmd.u.send.i_offset,
+                            cmd.u.send.i_buffer, true );
+        cmd.u.send.p_es->b_discontinuity = true;
+        break;
+
+    case C_CONTROL:
+        switch( cmd.u.control.i_query )
         {
-            //perror( "TsStoragePopCmd" );
-            p_cmd->u.send.p_block = block_Alloc( 1 );
+        case ES_OUT_SET_PCR:
+        case ES_OUT_SET_GROUP_PCR:
+        case ES_OUT_SET_NEXT_DISPLAY_TIME:
+        case ES_OUT_SET_TIMES:
+            /* Clock updates are meaningless without their data */
+            CmdClean( &cmd );
+            break;
+        default:
+            TAB_APPEND( p_storage->i_held, p_storage->p_held, cmd );
+            break;
         }
+        break;
+
+    default:
+        TAB_APPEND( p_storage->i_held, p_storage->p_held, cmd );
+        break;
     }
+    TsStorageIndexTrim( p_storage );
+    return cmd.i_date;
 }
 
 /*****************************************************************************
@@ -1640,30 +1830,3 @@ static void CmdCleanControl( ts_cmd_t *p_cmd )
         break;
     }
 }
-
-static int GetTmpFile( char **filename, const char *dirname )
-{
-    if( dirname != NULL
-     && asprintf( filename, "%s"DIR_SEP PACKAGE_NAME"-timeshift.XXXXXX",
-                  dirname ) >= 0 )
-    {
-        vlc_mkdir( dirname, 0700 );
-
-        int fd = vlc_mkstemp( *filename );
-        if( fd != -1 )
-            return fd;
-
-        free( *filename );
-    }
-
-    *filename = strdup( DIR_SEP"tmp"DIR_SEP PACKAGE_NAME"-timeshift.XXXXXX" );
-    if( unlikely(*filename == NULL) )
-        return -1;
-
-    int fd = vlc_mkstemp( *filename );
-    if( fd != -1 )
-        return fd;
-
-    free( *filename );
-    return -1;
-}
@@ -839,6 +839,10 @@ static void InitStatistics( input_thread_t *p_input )
         INIT_COUNTER( decoded_audio, COUNTER );
         INIT_COUNTER( decoded_video, COUNTER );
         INIT_COUNTER( decoded_sub, COUNTER );
+        INIT_COUNTER( timeshift_fill, LAST );
+        INIT_COUNTER( timeshift_index, LAST );
+        INIT_COUNTER( decode_time, LAST );
+        INIT_COUNTER( decoder_queue, LAST );
         priv->counters.p_sout_send_bitrate = NULL;
         priv->counters.p_sout_sent_packets = NULL;
         priv->counters.p_sout_sent_bytes = NULL;
@@ -1476,6 +1480,10 @@ error:
         EXIT_COUNTER( decoded_audio );
         EXIT_COUNTER( decoded_video );
         EXIT_COUNTER( decoded_sub );
+        EXIT_COUNTER( timeshift_fill );
+        EXIT_COUNTER( timeshift_index );
+        EXIT_COUNTER( decode_time );
+        EXIT_COUNTER( decoder_queue );
 
         if( input_priv(p_input)->p_sout )
         {
@@ -1552,6 +1560,10 @@ do { \
             CL_CO( decoded_audio) ;
             CL_CO( decoded_video );
             CL_CO( decoded_sub) ;
+            CL_CO( timeshift_fill );
+            CL_CO( timeshift_index );
+            CL_CO( decode_time );
+            CL_CO( decoder_queue );
         }
 
         /* Close optional stream output instance */
@@ -2062,6 +2074,15 @@ static bool Control( input_thread_t *p_input,
             if( i_time < 0 )
                 i_time = 0;
 
+            /* Skip forward within the timeshift buffer if the time is there */
+            const int64_t i_current = var_GetInteger( p_input, "time" );
+            if( i_time > i_current &&
+                !es_out_SkipTime( input_priv(p_input)->p_es_out, i_time - i_current ) )
+            {
+                b_force_update = true;
+                break;
+            }
+
             /* Reset the decoders states and clock sync (before calling the demuxer */
             es_out_SetTime( input_priv(p_input)->p_es_out, -1 );
 
@@ -166,6 +166,10 @@ typedef struct input_thread_private_t
         counter_t *p_lost_abuffers;
         counter_t *p_displayed_pictures;
         counter_t *p_lost_pictures;
+        counter_t *p_timeshift_fill;
+        counter_t *p_timeshift_index;
+        counter_t *p_decode_time;
+        counter_t *p_decoder_queue;
         vlc_mutex_t counters_lock;
     } counters;
 
@@ -100,6 +100,8 @@ void stats_ComputeInputStats(input_thread_t *input, input_stats_t *st)
     /* Decoders */
     st->i_decoded_video = stats_GetTotal(priv->counters.p_decoded_video);
     st->i_decoded_audio = stats_GetTotal(priv->counters.p_decoded_audio);
+    st->i_decode_time = stats_GetTotal(priv->counters.p_decode_time);
+    st->i_decoder_queue = stats_GetTotal(priv->counters.p_decoder_queue);
 
     /* Sout */
     if (priv->counters.p_sout_send_bitrate)
@@ -117,6 +119,10 @@ void stats_ComputeInputStats(input_thread_t *input, input_stats_t *st)
     st->i_displayed_pictures = stats_GetTotal(priv->counters.p_displayed_pictures);
     st->i_lost_pictures = stats_GetTotal(priv->counters.p_lost_pictures);
 
+    /* Timeshift */
+    st->i_timeshift_fill = stats_GetTotal(priv->counters.p_timeshift_fill);
+    st->i_timeshift_index = stats_GetTotal(priv->counters.p_timeshift_index);
+
     vlc_mutex_unlock(&st->lock);
     vlc_mutex_unlock(&priv->counters.counters_lock);
 }
@@ -132,7 +138,9 @@ void stats_ReinitInputStats( input_stats_t *p_stats )
     p_stats->i_displayed_pictures = p_stats->i_lost_pictures =
     p_stats->i_played_abuffers = p_stats->i_lost_abuffers =
     p_stats->i_decoded_video = p_stats->i_decoded_audio =
-    p_stats->i_sent_bytes = p_stats->i_sent_packets = p_stats->f_send_bitrate
+    p_stats->i_decode_time = p_stats->i_decoder_queue =
+    p_stats->i_sent_bytes = p_stats->i_sent_packets = p_stats->f_send_bitrate =
+    p_stats->i_timeshift_fill = p_stats->i_timeshift_index
      = 0;
     vlc_mutex_unlock( &p_stats->lock );
 }
@@ -186,6 +194,7 @@ void stats_Update( counter_t *p_counter, uint64_t val, uint64_t *new_val )
         }
         break;
     }
+    case STATS_LAST:
     case STATS_COUNTER:
         if( p_counter->i_samples == 0 )
         {
@@ -200,7 +209,10 @@ void stats_Update( counter_t *p_counter, uint64_t val, uint64_t *new_val )
         }
         if( p_counter->i_samples == 1 )
         {
-            p_counter->pp_samples[0]->value += val;
+            if( p_counter->i_compute_type == STATS_LAST )
+                p_counter->pp_samples[0]->value = val;
+            else
+                p_counter->pp_samples[0]->value += val;
             if( new_val )
                 *new_val = p_counter->pp_samples[0]->value;
         }
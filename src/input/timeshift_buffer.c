@@ -0,0 +1,322 @@
+/*****************************************************************************
+ * timeshift_buffer.c: timeshift circular data buffer
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <stdlib.h>
+#include <errno.h>
+#include <unistd.h>
+#ifdef HAVE_MMAP
+#  include <sys/mman.h>
+#endif
+#include <fcntl.h>
+
+#include <vlc_common.h>
+#include <vlc_fs.h>
+#include <vlc_block.h>
+#include "timeshift_buffer.h"
+
+/* The memory can only be mapped if the disk space can be reserved before it
+ * is written to: a full disk would otherwise fault instead of failing */
+#if defined (HAVE_MMAP) && defined (HAVE_POSIX_FALLOCATE)
+#  define TS_BUFFER_MMAP 1
+#endif
+
+/* Block header, as stored in the data buffer before the block payload */
+typedef struct
+{
+    uint32_t   i_flags;
+    unsigned   i_nb_samples;
+    vlc_tick_t i_pts;
+    vlc_tick_t i_dts;
+    vlc_tick_t i_length;
+} ts_block_header_t;
+
+#define TS_RECORD_ALIGN 16
+
+static int GetTmpFile( char **filename, const char *dirname )
+{
+    if( dirname != NULL
+     && asprintf( filename, "%s"DIR_SEP PACKAGE_NAME"-timeshift.XXXXXX",
+                  dirname ) >= 0 )
+    {
+        vlc_mkdir( dirname, 0700 );
+
+        int fd = vlc_mkstemp( *filename );
+        if( fd != -1 )
+            return fd;
+
+        free( *filename );
+    }
+
+    *filename = strdup( DIR_SEP"tmp"DIR_SEP PACKAGE_NAME"-timeshift.XXXXXX" );
+    if( unlikely(*filename == NULL) )
+        return -1;
+
+    int fd = vlc_mkstemp( *filename );
+    if( fd != -1 )
+        return fd;
+
+    free( *filename );
+    return -1;
+}
+
+#ifdef TS_BUFFER_MMAP
+/* Reserves the disk space up to the given offset, a whole step at once */
+static bool ReserveUpTo( ts_buffer_t *p_buffer, size_t i_end )
+{
+    if( i_end <= p_buffer->i_data_reserved )
+        return true;
+
+    size_t i_reserved = p_buffer->i_data_reserved + p_buffer->i_reserve_step;
+    if( i_reserved < i_end )
+        i_reserved = i_end;
+    if( i_reserved > p_buffer->i_data_size )
+        i_reserved = p_buffer->i_data_size;
+
+    if( posix_fallocate( p_buffer->i_fd, p_buffer->i_data_reserved,
+                         i_reserved - p_buffer->i_data_reserved ) != 0 )
+    {
+        /* Whatever the error, the space past the reserved one cannot be
+         * written safely. Nothing was written there yet: wrap around before
+         * it from now on. */
+        p_buffer->i_data_size = p_buffer->i_data_reserved
+                              & ~(size_t)(TS_RECORD_ALIGN - 1);
+        return false;
+    }
+    p_buffer->i_data_reserved = i_reserved;
+    return true;
+}
+#endif
+
+ts_buffer_t *ts_buffer_New( const char *psz_tmp_path, size_t i_size,
+                            size_t i_reserve_step )
+{
+    ts_buffer_t *p_buffer = calloc( 1, sizeof (*p_buffer) );
+    if( unlikely(p_buffer == NULL) )
+        return NULL;
+
+    p_buffer->i_data_size = i_size & ~(size_t)(TS_RECORD_ALIGN - 1);
+    p_buffer->i_map_size = p_buffer->i_data_size;
+    p_buffer->i_reserve_step = i_reserve_step & ~(size_t)(TS_RECORD_ALIGN - 1);
+
+    char *psz_file;
+    p_buffer->i_fd = GetTmpFile( &psz_file, psz_tmp_path );
+    if( p_buffer->i_fd == -1 )
+    {
+        free( p_buffer );
+        return NULL;
+    }
+    vlc_unlink( psz_file );
+    free( psz_file );
+
+    /* With file I/O, a full disk only fails the writes */
+    p_buffer->i_data_reserved = p_buffer->i_data_size;
+
+#ifdef TS_BUFFER_MMAP
+    /* The file is sparse: disk space is reserved as the buffer fills up */
+    if( ftruncate( p_buffer->i_fd, p_buffer->i_data_size ) == 0 )
+    {
+        void *p_data = mmap( NULL, p_buffer->i_data_size, PROT_READ|PROT_WRITE,
+                             MAP_SHARED, p_buffer->i_fd, 0 );
+        if( p_data != MAP_FAILED )
+        {
+            p_buffer->p_data = p_data;
+            p_buffer->i_data_reserved = 0;
+            if( !ReserveUpTo( p_buffer, p_buffer->i_reserve_step ) )
+            {
+                ts_buffer_Delete( p_buffer );
+                return NULL;
+            }
+        }
+    }
+#else
+    VLC_UNUSED( psz_tmp_path );
+#endif
+    return p_buffer;
+}
+
+void ts_buffer_Delete( ts_buffer_t *p_buffer )
+{
+#ifdef TS_BUFFER_MMAP
+    if( p_buffer->p_data != NULL )
+        munmap( p_buffer->p_data, p_buffer->i_map_size );
+#endif
+    vlc_close( p_buffer->i_fd );
+    free( p_buffer );
+}
+
+size_t ts_buffer_RecordSize( size_t i_buffer )
+{
+    return (sizeof(ts_block_header_t) + i_buffer + TS_RECORD_ALIGN - 1)
+           & ~(size_t)(TS_RECORD_ALIGN - 1);
+}
+
+/* Returns the absolute position of the next record, which must be
+ * contiguous in the buffer */
+static uint64_t RecordPos( const ts_buffer_t *p_buffer, size_t i_size )
+{
+    const size_t i_offset = p_buffer->i_data_w % p_buffer->i_data_size;
+
+    if( i_offset + i_size > p_buffer->i_data_size )
+        return p_buffer->i_data_w + p_buffer->i_data_size - i_offset;
+    return p_buffer->i_data_w;
+}
+
+bool ts_buffer_Reserve( ts_buffer_t *p_buffer, size_t i_buffer )
+{
+#ifdef TS_BUFFER_MMAP
+    /* Once wrapped around, the whole buffer is reserved */
+    if( p_buffer->i_data_w >= p_buffer->i_data_size )
+        return true;
+
+    /* Before the first wrap around, the write position is the offset. When
+     * the record wraps around, the end of the buffer is for the next lap. */
+    size_t i_end = p_buffer->i_data_w + ts_buffer_RecordSize( i_buffer );
+    if( i_end > p_buffer->i_data_size )
+        i_end = p_buffer->i_data_size;
+
+    return ReserveUpTo( p_buffer, i_end );
+#else
+    VLC_UNUSED( p_buffer ); VLC_UNUSED( i_buffer );
+    return true;
+#endif
+}
+
+bool ts_buffer_HasRoom( const ts_buffer_t *p_buffer, size_t i_buffer )
+{
+    const size_t i_size = ts_buffer_RecordSize( i_buffer );
+    if( i_size > p_buffer->i_data_size )
+        return true; /* Will be dropped anyway */
+
+    return RecordPos( p_buffer, i_size ) + i_size
+           - p_buffer->i_data_r <= p_buffer->i_data_size;
+}
+
+static bool WriteAll( int fd, const void *p_data, size_t i_size )
+{
+    const uint8_t *p = p_data;
+
+    while( i_size > 0 )
+    {
+        ssize_t i_ret = write( fd, p, i_size );
+        if( i_ret < 0 && errno == EINTR )
+            continue;
+        if( i_ret <= 0 )
+            return false;
+        p += i_ret;
+        i_size -= i_ret;
+    }
+    return true;
+}
+
+static bool ReadAll( int fd, void *p_data, size_t i_size )
+{
+    uint8_t *p = p_data;
+
+    while( i_size > 0 )
+    {
+        ssize_t i_ret = read( fd, p, i_size );
+        if( i_ret < 0 && errno == EINTR )
+            continue;
+        if( i_ret <= 0 )
+            return false;
+        p += i_ret;
+        i_size -= i_ret;
+    }
+    return true;
+}
+
+int ts_buffer_Write( ts_buffer_t *p_buffer, const block_t *p_block )
+{
+    const size_t i_size = ts_buffer_RecordSize( p_block->i_buffer );
+    if( i_size > p_buffer->i_data_size )
+        return -1;
+
+    const uint64_t i_pos = RecordPos( p_buffer, i_size );
+    const size_t i_offset = i_pos % p_buffer->i_data_size;
+    const ts_block_header_t header = {
+        .i_flags = p_block->i_flags,
+        .i_nb_samples = p_block->i_nb_samples,
+        .i_pts = p_block->i_pts,
+        .i_dts = p_block->i_dts,
+        .i_length = p_block->i_length,
+    };
+
+    if( p_buffer->p_data != NULL )
+    {
+        uint8_t *p = &p_buffer->p_data[i_offset];
+
+        memcpy( p, &header, sizeof(header) );
+        if( p_block->i_buffer > 0 )
+            memcpy( p + sizeof(header), p_block->p_buffer, p_block->i_buffer );
+    }
+    else if( lseek( p_buffer->i_fd, i_offset, SEEK_SET ) != (off_t)i_offset
+          || !WriteAll( p_buffer->i_fd, &header, sizeof(header) )
+          || !WriteAll( p_buffer->i_fd, p_block->p_buffer, p_block->i_buffer ) )
+        return -1;
+
+    p_buffer->i_data_w = i_pos + i_size;
+    return i_offset;
+}
+
+block_t *ts_buffer_Read( ts_buffer_t *p_buffer, int i_offset, size_t i_buffer,
+                         bool b_drop )
+{
+    uint64_t i_pos = p_buffer->i_data_r - p_buffer->i_data_r % p_buffer->i_data_size
+                   + i_offset;
+    if( i_pos < p_buffer->i_data_r )
+        i_pos += p_buffer->i_data_size;
+    p_buffer->i_data_r = i_pos + ts_buffer_RecordSize( i_buffer );
+
+    if( b_drop )
+        return NULL;
+
+    block_t *p_block = block_Alloc( i_buffer );
+    if( unlikely(p_block == NULL) )
+        return NULL;
+
+    ts_block_header_t header;
+
+    if( p_buffer->p_data != NULL )
+    {
+        const uint8_t *p = &p_buffer->p_data[i_offset];
+
+        memcpy( &header, p, sizeof(header) );
+        if( i_buffer > 0 )
+            memcpy( p_block->p_buffer, p + sizeof(header), i_buffer );
+    }
+    else if( lseek( p_buffer->i_fd, i_offset, SEEK_SET ) != (off_t)i_offset
+          || !ReadAll( p_buffer->i_fd, &header, sizeof(header) )
+          || !ReadAll( p_buffer->i_fd, p_block->p_buffer, i_buffer ) )
+    {
+        block_Release( p_block );
+        return NULL;
+    }
+
+    p_block->i_flags      = header.i_flags;
+    p_block->i_nb_samples = header.i_nb_samples;
+    p_block->i_pts        = header.i_pts;
+    p_block->i_dts        = header.i_dts;
+    p_block->i_length     = header.i_length;
+    return p_block;
+}
@@ -0,0 +1,85 @@
+/*****************************************************************************
+ * timeshift_buffer.h: timeshift circular data buffer
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef LIBVLC_INPUT_TIMESHIFT_BUFFER_H
+#define LIBVLC_INPUT_TIMESHIFT_BUFFER_H 1
+
+#include <vlc_common.h>
+#include <vlc_block.h>
+
+/* The timeshift data buffer is a fixed size circular buffer in a temporary
+ * file, holding the blocks as records. The file is mapped if its disk space
+ * can be reserved, and accessed with plain file I/O otherwise. Records are
+ * written and read in the same order, and never span the end of the buffer.
+ */
+typedef struct
+{
+    uint8_t  *p_data;   /* Mapped file, or NULL for file I/O */
+    size_t   i_data_size;
+    size_t   i_map_size;
+    int      i_fd;
+    size_t   i_data_reserved; /* Disk space reserved from the start */
+    size_t   i_reserve_step;
+    uint64_t i_data_r;  /* Absolute read position */
+    uint64_t i_data_w;  /* Absolute write position */
+} ts_buffer_t;
+
+/**
+ * Creates a data buffer of the given size.
+ *
+ * The first i_reserve_step bytes of disk space are reserved at once, so that
+ * a full disk fails now rather than later.
+ */
+ts_buffer_t *ts_buffer_New( const char *psz_tmp_path, size_t i_size,
+                            size_t i_reserve_step );
+void ts_buffer_Delete( ts_buffer_t * );
+
+/** Returns the size of the record holding a block of the given size. */
+size_t ts_buffer_RecordSize( size_t i_buffer );
+
+/**
+ * Reserves the disk space for a block of the given size before it is written.
+ *
+ * @return false if the space could not be reserved: the buffer is then
+ * limited to the space reserved so far.
+ */
+bool ts_buffer_Reserve( ts_buffer_t *, size_t i_buffer );
+
+/** Checks that a block of the given size can be written without dropping. */
+bool ts_buffer_HasRoom( const ts_buffer_t *, size_t i_buffer );
+
+/**
+ * Writes a block at the end of the buffer.
+ *
+ * @return the offset of the record, or -1 if the block was not stored
+ */
+int ts_buffer_Write( ts_buffer_t *, const block_t * );
+
+/**
+ * Reads the oldest record, written at the given offset for a block of
+ * i_buffer bytes, and releases it with any unused space before it.
+ *
+ * @param b_drop only release the record
+ * @return the block, or NULL if dropped or on error
+ */
+block_t *ts_buffer_Read( ts_buffer_t *, int i_offset, size_t i_buffer,
+                         bool b_drop );
+
+#endif
@@ -472,6 +472,7 @@ void input_ConfigVarInit ( input_thread_t *p_input )
                     VLC_VAR_INTEGER | VLC_VAR_DOINHERIT );
         var_Create( p_input, "clock-synchro",
                     VLC_VAR_INTEGER | VLC_VAR_DOINHERIT);
+        var_Create( p_input, "low-delay", VLC_VAR_BOOL | VLC_VAR_DOINHERIT );
     }
 
     var_Create( p_input, "can-seek", VLC_VAR_BOOL );
@@ -386,6 +386,11 @@ static const char *const ppsz_pos_descriptions[] =
     "picture quality, for instance deinterlacing, or distort " \
     "the video.")
 
+#define SLICE_THREADS_TEXT N_("Video filter threads")
+#define SLICE_THREADS_LONGTEXT N_( \
+    "Number of threads processing slices of pictures in the video filters " \
+    "and converters supporting it (0 = one per CPU, 1 = disabled).")
+
 #define SNAP_PATH_TEXT N_("Video snapshot directory (or filename)")
 #define SNAP_PATH_LONGTEXT N_( \
     "Directory where the video snapshots will be stored.")
@@ -530,6 +535,12 @@ static const char *const ppsz_pos_descriptions[] =
     "This defines the maximum input delay jitter that the synchronization " \
     "algorithms should try to compensate (in milliseconds)." )
 
+#define LOW_DELAY_TEXT N_("Low delay mode")
+#define LOW_DELAY_LONGTEXT N_( \
+    "Favor latency over throughput: decoders avoid buffering pictures, " \
+    "for instance by using slice threads instead of frame threads. This " \
+    "can be set per input, for instance for interactive live sources.")
+
 #define NETSYNC_TEXT N_("Network synchronisation" )
 #define NETSYNC_LONGTEXT N_( "This allows you to remotely " \
         "synchronise clocks for server and client. The detailed settings " \
@@ -686,6 +697,12 @@ static const char *const ppsz_prefres[] = {
     "This is the maximum size in bytes of the temporary files " \
     "that will be used to store the timeshifted streams." )
 
+#define INPUT_TIMESHIFT_SIZE_TEXT N_("Timeshift buffer size")
+#define INPUT_TIMESHIFT_SIZE_LONGTEXT N_( \
+    "This is the size in bytes of the circular buffer " \
+    "that will be used to store the timeshifted streams. When it is full, " \
+    "the oldest data is discarded. -1 selects a default size." )
+
 #define INPUT_TITLE_FORMAT_TEXT N_( "Change title according to current media" )
 #define INPUT_TITLE_FORMAT_LONGTEXT N_( "This option allows you to set the title according to what's being played<br>"  \
     "$a: Artist<br>$b: Album<br>$c: Copyright<br>$t: Title<br>$g: Genre<br>"  \
@@ -806,6 +823,11 @@ static const char *const ppsz_prefres[] = {
     "Specify an IP address (e.g. ::1 or 127.0.0.1) or a host name " \
     "(e.g. localhost) to restrict them to a specific network interface." )
 
+#define HTTP_WORKERS_TEXT N_( "HTTP stream threads" )
+#define HTTP_WORKERS_LONGTEXT N_( \
+    "Number of threads sending HTTP streams to the connected clients. " \
+    "0 sends them from the server thread, -1 uses one thread per CPU." )
+
 #define RTSP_HOST_TEXT N_( "RTSP server address" )
 #define RTSP_HOST_LONGTEXT N_( \
     "This defines the address the RTSP server will listen on, along " \
@@ -1660,6 +1682,9 @@ vlc_module_begin ()
     set_subcategory( SUBCAT_VIDEO_VFILTER )
     add_module_list( "video-filter", "video filter", NULL,
                      VIDEO_FILTER_TEXT, VIDEO_FILTER_LONGTEXT, false )
+    add_integer( "slice-threads", 0, SLICE_THREADS_TEXT,
+                 SLICE_THREADS_LONGTEXT, true )
+        change_integer_range( 0, 64 )
 
     set_subcategory( SUBCAT_VIDEO_SPLITTER )
     add_module_list( "video-splitter", "video splitter", NULL,
@@ -1800,6 +1825,9 @@ vlc_module_begin ()
         change_integer_range( 1, 65535 )
     add_integer( "https-port", 8443, HTTPS_PORT_TEXT, HTTPS_PORT_LONGTEXT, true )
         change_integer_range( 1, 65535 )
+    add_integer( "http-workers", -1, HTTP_WORKERS_TEXT,
+                 HTTP_WORKERS_LONGTEXT, true )
+        change_integer_range( -1, 16 )
     add_string( "rtsp-host", NULL, RTSP_HOST_TEXT, RTSP_HOST_LONGTEXT, true )
     add_integer( "rtsp-port", 554, RTSP_PORT_TEXT, RTSP_PORT_LONGTEXT, true )
         change_integer_range( 1, 65535 )
@@ -1914,6 +1942,8 @@ vlc_module_begin ()
     add_integer( "clock-jitter", 5 * CLOCK_FREQ/1000, CLOCK_JITTER_TEXT,
               CLOCK_JITTER_LONGTEXT, true )
         change_safe()
+    add_bool( "low-delay", false, LOW_DELAY_TEXT, LOW_DELAY_LONGTEXT, true )
+        change_safe()
 
     add_bool( "network-synchronisation", false, NETSYNC_TEXT,
               NETSYNC_LONGTEXT, true )
@@ -1927,6 +1957,8 @@ vlc_module_begin ()
                 INPUT_TIMESHIFT_PATH_LONGTEXT, true )
     add_integer( "input-timeshift-granularity", -1, INPUT_TIMESHIFT_GRANULARITY_TEXT,
                  INPUT_TIMESHIFT_GRANULARITY_LONGTEXT, true )
+    add_integer( "input-timeshift-size", -1, INPUT_TIMESHIFT_SIZE_TEXT,
+                 INPUT_TIMESHIFT_SIZE_LONGTEXT, true )
 
     add_string( "input-title-format", "$Z", INPUT_TITLE_FORMAT_TEXT, INPUT_TITLE_FORMAT_LONGTEXT, false );
 
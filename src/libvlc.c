@@ -237,6 +237,9 @@ int libvlc_InternalInit( libvlc_int_t *p_libvlc, int i_argc,
     if( libvlc_InternalActionsInit( p_libvlc ) != VLC_SUCCESS )
         goto error;
 
+    if( libvlc_InternalSlicesInit( p_libvlc ) != VLC_SUCCESS )
+        goto error;
+
     /*
      * Meta data handling
      */
@@ -417,6 +420,7 @@ void libvlc_InternalCleanup( libvlc_int_t *p_libvlc )
         playlist_preparser_Delete(priv->parser);
 
     libvlc_InternalActionsClean( p_libvlc );
+    libvlc_InternalSlicesClean( p_libvlc );
 
     /* Save the configuration */
     if( !var_InheritBool( p_libvlc, "ignore-config" ) )
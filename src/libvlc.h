@@ -191,6 +191,7 @@ typedef struct libvlc_priv_t
     struct playlist_t *playlist; ///< Playlist for interfaces
     struct playlist_preparser_t *parser; ///< Input item meta data handler
     vlc_actions_t *actions; ///< Hotkeys handler
+    struct vlc_slices *slices; ///< Video filter slice threads
 
     /* Exit callback */
     vlc_exit_t       exit;
@@ -211,6 +212,12 @@ int vlc_MetadataRequest(libvlc_int_t *libvlc, input_item_t *item,
                         input_item_meta_request_option_t i_options,
                         int timeout, void *id);
 
+/*
+ * Video filter slices
+ */
+int libvlc_InternalSlicesInit( libvlc_int_t * );
+void libvlc_InternalSlicesClean( libvlc_int_t * );
+
 /*
  * Variables stuff
  */
@@ -223,6 +230,7 @@ enum
 {
     STATS_COUNTER,
     STATS_DERIVATIVE,
+    STATS_LAST,
 };
 
 typedef struct counter_sample_t
@@ -33,6 +33,7 @@
 
 #include <vlc_common.h>
 #include <vlc_block.h>
+#include <vlc_atomic.h>
 #include <vlc_fs.h>
 
 #ifndef NDEBUG
@@ -117,6 +118,306 @@ static void BlockMetaCopy( block_t *restrict out, const block_t *in )
 /** Initial reserved header and footer size. */
 #define BLOCK_PADDING      32
 
+/** Total allocation size for a given payload size. */
+#define BLOCK_ALLOC_SIZE(size) \
+    (sizeof (block_t) + BLOCK_ALIGN + (2 * BLOCK_PADDING) + (size))
+
+static void block_InitAligned (block_t *b, size_t alloc, size_t size)
+{
+    block_Init (b, b + 1, alloc - sizeof (*b));
+    static_assert ((BLOCK_PADDING % BLOCK_ALIGN) == 0,
+                   "BLOCK_PADDING must be a multiple of BLOCK_ALIGN");
+    b->p_buffer += BLOCK_PADDING + BLOCK_ALIGN - 1;
+    b->p_buffer = (void *)(((uintptr_t)b->p_buffer) & ~(BLOCK_ALIGN - 1));
+    b->i_buffer = size;
+}
+
+/*****************************************************************************
+ * Block recycling
+ *****************************************************************************
+ * Blocks of common payload sizes are not returned to the heap on release.
+ * Each thread keeps a small magazine of free blocks per size class, so that
+ * the allocation and release fast paths do not take any lock. Magazines
+ * overflow into (and refill from) a global bounded depot, which lets blocks
+ * migrate from the consumer thread back to the producer thread.
+ *
+ * Magazines are freed when their thread exits. The depot is bounded, and the
+ * blocks that it held unused for a whole trim period are freed, so that the
+ * pool shrinks back once the traffic is gone.
+ *****************************************************************************/
+
+#define BLOCK_POOL_CLASSES 6
+
+/** Payload size classes (must be sorted in increasing order). */
+static const size_t block_pool_sizes[BLOCK_POOL_CLASSES] = {
+    188,        /* one TS packet */
+    188 * 7,    /* one TS over UDP/RTP datagram */
+    1500,       /* Ethernet MTU */
+    4096,
+    16384,
+    65536,      /* largest IPv4 datagram */
+};
+
+/** Blocks per thread magazine and size class. */
+#define BLOCK_MAGAZINE_SIZE 32
+
+/** Byte budget of a thread magazine per size class. */
+#define BLOCK_MAGAZINE_BUDGET (256 << 10)
+
+/** Byte budget of the global depot per size class. */
+#define BLOCK_DEPOT_BUDGET  (1 << 20)
+
+/** Period after which unused depot blocks are freed. */
+#define BLOCK_DEPOT_TRIM_PERIOD (5 * CLOCK_FREQ)
+
+struct block_magazine
+{
+    struct
+    {
+        block_t *blocks[BLOCK_MAGAZINE_SIZE];
+        unsigned count;
+        uint64_t hits, misses, frees;
+    } classes[BLOCK_POOL_CLASSES];
+};
+
+static struct
+{
+    vlc_mutex_t lock;
+    bool initialized;
+    vlc_threadvar_t key;
+    mtime_t trim_deadline;
+    struct
+    {
+        block_t *first;
+        unsigned count;
+        unsigned low; /**< Lowest count since the last trim */
+        uint64_t hits, misses, frees;
+    } classes[BLOCK_POOL_CLASSES];
+} block_depot = { .lock = VLC_STATIC_MUTEX, .initialized = false };
+
+static thread_local struct block_magazine *block_magazine = NULL;
+
+static unsigned block_pool_Class (size_t size)
+{
+    for (unsigned i = 0; i < BLOCK_POOL_CLASSES; i++)
+        if (size <= block_pool_sizes[i])
+            return i;
+    return BLOCK_POOL_CLASSES;
+}
+
+static unsigned block_magazine_Max (unsigned i)
+{
+    unsigned max = BLOCK_MAGAZINE_BUDGET / BLOCK_ALLOC_SIZE(block_pool_sizes[i]);
+
+    return (max < 2) ? 2 : (max > BLOCK_MAGAZINE_SIZE) ? BLOCK_MAGAZINE_SIZE : max;
+}
+
+static unsigned block_depot_Max (unsigned i)
+{
+    return BLOCK_DEPOT_BUDGET / BLOCK_ALLOC_SIZE(block_pool_sizes[i]);
+}
+
+/** Moves blocks from a magazine to the depot, or frees them if it is full.
+ * The depot lock must be held. */
+static void block_depot_PutLocked (struct block_magazine *mag, unsigned i,
+                                   unsigned n)
+{
+    const unsigned max = block_depot_Max (i);
+
+    assert (n <= mag->classes[i].count);
+    while (n-- > 0)
+    {
+        block_t *b = mag->classes[i].blocks[--mag->classes[i].count];
+
+        if (block_depot.classes[i].count < max)
+        {
+            b->p_next = block_depot.classes[i].first;
+            block_depot.classes[i].first = b;
+            block_depot.classes[i].count++;
+        }
+        else
+            free (b);
+    }
+}
+
+/** Frees the depot blocks that were not used since the last trim.
+ * The depot lock must be held. */
+static void block_depot_TrimLocked (void)
+{
+    mtime_t now = mdate ();
+
+    if (now < block_depot.trim_deadline)
+        return;
+
+    for (unsigned i = 0; i < BLOCK_POOL_CLASSES; i++)
+    {
+        while (block_depot.classes[i].low > 0)
+        {
+            block_t *b = block_depot.classes[i].first;
+
+            block_depot.classes[i].first = b->p_next;
+            block_depot.classes[i].count--;
+            block_depot.classes[i].low--;
+            free (b);
+        }
+        block_depot.classes[i].low = block_depot.classes[i].count;
+    }
+    block_depot.trim_deadline = now + BLOCK_DEPOT_TRIM_PERIOD;
+}
+
+/** Merges the thread statistics into the global ones.
+ * The depot lock must be held. */
+static void block_depot_StatsLocked (struct block_magazine *mag, unsigned i)
+{
+    block_depot.classes[i].hits += mag->classes[i].hits;
+    block_depot.classes[i].misses += mag->classes[i].misses;
+    block_depot.classes[i].frees += mag->classes[i].frees;
+    mag->classes[i].hits = mag->classes[i].misses = mag->classes[i].frees = 0;
+}
+
+static void block_magazine_Destroy (void *data)
+{
+    struct block_magazine *mag = data;
+
+    /* The thread is gone: its blocks are unlikely to be reused soon */
+    vlc_mutex_lock (&block_depot.lock);
+    for (unsigned i = 0; i < BLOCK_POOL_CLASSES; i++)
+        block_depot_StatsLocked (mag, i);
+    block_depot_TrimLocked ();
+    vlc_mutex_unlock (&block_depot.lock);
+
+    for (unsigned i = 0; i < BLOCK_POOL_CLASSES; i++)
+        while (mag->classes[i].count > 0)
+            free (mag->classes[i].blocks[--mag->classes[i].count]);
+    block_magazine = NULL;
+    free (mag);
+}
+
+static struct block_magazine *block_magazine_Get (void)
+{
+    struct block_magazine *mag = block_magazine;
+
+    if (likely(mag != NULL))
+        return mag;
+
+    vlc_mutex_lock (&block_depot.lock);
+    if (!block_depot.initialized)
+        block_depot.initialized =
+            !vlc_threadvar_create (&block_depot.key, block_magazine_Destroy);
+    bool initialized = block_depot.initialized;
+    vlc_mutex_unlock (&block_depot.lock);
+
+    if (unlikely(!initialized))
+        return NULL;
+
+    mag = calloc (1, sizeof (*mag));
+    if (unlikely(mag == NULL))
+        return NULL;
+    /* The thread variable only serves to flush the magazine on thread exit.
+     * Fast paths use the native thread-local pointer instead. */
+    if (unlikely(vlc_threadvar_set (block_depot.key, mag)))
+    {
+        free (mag);
+        return NULL;
+    }
+    block_magazine = mag;
+    return mag;
+}
+
+static void block_pool_Release (block_t *block)
+{
+    unsigned i = block_pool_Class (block->i_size - BLOCK_ALIGN
+                                   - (2 * BLOCK_PADDING));
+    struct block_magazine *mag = block_magazine_Get ();
+
+    assert (block->p_start == (unsigned char *)(block + 1));
+    assert (i < BLOCK_POOL_CLASSES);
+    block_Invalidate (block);
+
+    if (unlikely(mag == NULL))
+    {
+        free (block);
+        return;
+    }
+
+    if (mag->classes[i].count >= block_magazine_Max (i))
+    {   /* Magazine full: hand half of it over to other threads */
+        vlc_mutex_lock (&block_depot.lock);
+        block_depot_PutLocked (mag, i, block_magazine_Max (i) / 2);
+        block_depot_StatsLocked (mag, i);
+        block_depot_TrimLocked ();
+        vlc_mutex_unlock (&block_depot.lock);
+    }
+
+    mag->classes[i].blocks[mag->classes[i].count++] = block;
+    mag->classes[i].frees++;
+}
+
+static block_t *block_pool_Alloc (unsigned i)
+{
+    struct block_magazine *mag = block_magazine_Get ();
+
+    if (unlikely(mag == NULL))
+        return NULL;
+
+    if (mag->classes[i].count == 0)
+    {   /* Magazine empty: refill half of it from the depot */
+        vlc_mutex_lock (&block_depot.lock);
+        while (mag->classes[i].count < block_magazine_Max (i) / 2
+            && block_depot.classes[i].first != NULL)
+        {
+            block_t *b = block_depot.classes[i].first;
+
+            block_depot.classes[i].first = b->p_next;
+            block_depot.classes[i].count--;
+            mag->classes[i].blocks[mag->classes[i].count++] = b;
+        }
+        if (block_depot.classes[i].low > block_depot.classes[i].count)
+            block_depot.classes[i].low = block_depot.classes[i].count;
+        block_depot_StatsLocked (mag, i);
+        block_depot_TrimLocked ();
+        vlc_mutex_unlock (&block_depot.lock);
+
+        if (mag->classes[i].count == 0)
+        {
+            mag->classes[i].misses++;
+            return NULL;
+        }
+    }
+
+    mag->classes[i].hits++;
+    return mag->classes[i].blocks[--mag->classes[i].count];
+}
+
+size_t block_PoolGetStats (block_pool_stats_t *stats, size_t max)
+{
+    if (max > BLOCK_POOL_CLASSES)
+        max = BLOCK_POOL_CLASSES;
+
+    vlc_mutex_lock (&block_depot.lock);
+    for (size_t i = 0; i < max; i++)
+    {
+        stats[i].size = block_pool_sizes[i];
+        stats[i].hits = block_depot.classes[i].hits;
+        stats[i].misses = block_depot.classes[i].misses;
+        stats[i].frees = block_depot.classes[i].frees;
+        stats[i].depot = block_depot.classes[i].count;
+    }
+    vlc_mutex_unlock (&block_depot.lock);
+
+    /* Also account for the calling thread, which is usually the one of
+     * interest (e.g. a benchmark or an input thread). */
+    struct block_magazine *mag = block_magazine;
+    if (mag != NULL)
+        for (size_t i = 0; i < max; i++)
+        {
+            stats[i].hits += mag->classes[i].hits;
+            stats[i].misses += mag->classes[i].misses;
+            stats[i].frees += mag->classes[i].frees;
+        }
+    return max;
+}
+
 block_t *block_Alloc (size_t size)
 {
     if (unlikely(size >> 27))
@@ -126,25 +427,232 @@ block_t *block_Alloc (size_t size)
     }
 
     /* 2 * BLOCK_PADDING: pre + post padding */
-    const size_t alloc = sizeof (block_t) + BLOCK_ALIGN + (2 * BLOCK_PADDING)
-                       + size;
+    size_t alloc = BLOCK_ALLOC_SIZE(size);
     if (unlikely(alloc <= size))
         return NULL;
 
+    unsigned i = block_pool_Class (size);
+    if (i < BLOCK_POOL_CLASSES)
+    {
+        alloc = BLOCK_ALLOC_SIZE(block_pool_sizes[i]);
+
+        block_t *b = block_pool_Alloc (i);
+        if (b == NULL)
+            b = malloc (alloc);
+        if (unlikely(b == NULL))
+            return NULL;
+
+        block_InitAligned (b, alloc, size);
+        b->pf_release = block_pool_Release;
+        return b;
+    }
+
     block_t *b = malloc (alloc);
     if (unlikely(b == NULL))
         return NULL;
 
-    block_Init (b, b + 1, alloc - sizeof (*b));
-    static_assert ((BLOCK_PADDING % BLOCK_ALIGN) == 0,
-                   "BLOCK_PADDING must be a multiple of BLOCK_ALIGN");
-    b->p_buffer += BLOCK_PADDING + BLOCK_ALIGN - 1;
-    b->p_buffer = (void *)(((uintptr_t)b->p_buffer) & ~(BLOCK_ALIGN - 1));
-    b->i_buffer = size;
+    block_InitAligned (b, alloc, size);
     b->pf_release = block_generic_Release;
     return b;
 }
 
+/**
+ * Shared payloads.
+ *
+ * The block that owns the memory becomes one of the references to the shared
+ * payload: its release callback is swapped, and only called back once the
+ * last reference is gone. The other references are views, allocated by
+ * block_Share() along with a pointer to the shared state. block_t has no room
+ * for that pointer, so the state of the owners is found in a hash table.
+ */
+struct block_shared
+{
+    atomic_uint refs;
+    block_t *owner;
+    block_free_t release; /**< Original release callback of the owner */
+    struct block_shared *next; /**< Next in the owners table bucket */
+};
+
+struct block_view
+{
+    block_t self;
+    struct block_shared *shared;
+};
+
+#define BLOCK_OWNERS_BUCKETS 64
+
+static struct
+{
+    vlc_mutex_t lock;
+    struct block_shared *buckets[BLOCK_OWNERS_BUCKETS];
+} block_owners = { .lock = VLC_STATIC_MUTEX };
+
+static struct block_shared **block_owners_Bucket (const block_t *owner)
+{
+    return &block_owners.buckets[((uintptr_t)owner >> 4)
+                                 % BLOCK_OWNERS_BUCKETS];
+}
+
+static void block_owners_Add (struct block_shared *shared)
+{
+    struct block_shared **pp = block_owners_Bucket (shared->owner);
+
+    vlc_mutex_lock (&block_owners.lock);
+    shared->next = *pp;
+    *pp = shared;
+    vlc_mutex_unlock (&block_owners.lock);
+}
+
+static struct block_shared *block_owners_Find (const block_t *owner)
+{
+    struct block_shared *shared;
+
+    vlc_mutex_lock (&block_owners.lock);
+    shared = *block_owners_Bucket (owner);
+    while (shared->owner != owner)
+        shared = shared->next;
+    vlc_mutex_unlock (&block_owners.lock);
+    return shared;
+}
+
+static void block_owners_Remove (struct block_shared *shared)
+{
+    struct block_shared **pp = block_owners_Bucket (shared->owner);
+
+    vlc_mutex_lock (&block_owners.lock);
+    while (*pp != shared)
+        pp = &(*pp)->next;
+    *pp = shared->next;
+    vlc_mutex_unlock (&block_owners.lock);
+}
+
+static void block_owner_Release (block_t *);
+static void block_view_Release (block_t *);
+
+/** Gets the shared state of a block, or NULL if the payload is not shared. */
+static struct block_shared *block_GetShared (const block_t *block)
+{
+    if (block->pf_release == block_view_Release)
+        return container_of (block, struct block_view, self)->shared;
+    if (block->pf_release == block_owner_Release)
+        return block_owners_Find (block);
+    return NULL;
+}
+
+/** Gives the payload back to its owner. */
+static void block_shared_Destroy (struct block_shared *shared)
+{
+    block_t *owner = shared->owner;
+
+    block_owners_Remove (shared);
+    owner->pf_release = shared->release;
+    free (shared);
+}
+
+static void block_shared_Unref (struct block_shared *shared)
+{
+    if (atomic_fetch_sub_explicit (&shared->refs, 1,
+                                   memory_order_acq_rel) == 1)
+    {
+        block_t *owner = shared->owner;
+
+        block_shared_Destroy (shared);
+        block_Release (owner);
+    }
+}
+
+static void block_owner_Release (block_t *block)
+{
+    /* The owner memory is kept until the last reference is gone */
+    block_shared_Unref (block_owners_Find (block));
+}
+
+static void block_view_Release (block_t *block)
+{
+    struct block_view *view = container_of (block, struct block_view, self);
+    struct block_shared *shared = view->shared;
+
+    block_Invalidate (block);
+    free (view);
+    block_shared_Unref (shared);
+}
+
+/** Takes the payload back if the block is its owner and last reference. */
+static bool block_TryUnshare (block_t *block)
+{
+    if (block->pf_release == block_view_Release)
+        return false;
+    if (block->pf_release != block_owner_Release)
+        return true;
+
+    struct block_shared *shared = block_owners_Find (block);
+
+    if (atomic_load_explicit (&shared->refs, memory_order_acquire) != 1)
+        return false;
+
+    block_shared_Destroy (shared);
+    return true;
+}
+
+bool block_IsShared (const block_t *block)
+{
+    struct block_shared *shared = block_GetShared (block);
+
+    return shared != NULL
+        && atomic_load_explicit (&shared->refs, memory_order_acquire) > 1;
+}
+
+block_t *block_Share (block_t *block)
+{
+    struct block_shared *shared = block_GetShared (block);
+
+    block_Check (block);
+
+    struct block_view *view = malloc (sizeof (*view));
+    if (unlikely(view == NULL))
+        return NULL;
+
+    if (shared == NULL)
+    {
+        shared = malloc (sizeof (*shared));
+        if (unlikely(shared == NULL))
+        {
+            free (view);
+            return NULL;
+        }
+        atomic_init (&shared->refs, 1);
+        shared->owner = block;
+        shared->release = block->pf_release;
+        block_owners_Add (shared);
+        block->pf_release = block_owner_Release;
+    }
+
+    atomic_fetch_add_explicit (&shared->refs, 1, memory_order_relaxed);
+
+    block_Init (&view->self, block->p_start, block->i_size);
+    view->self.p_buffer = block->p_buffer;
+    view->self.i_buffer = block->i_buffer;
+    block_CopyProperties (&view->self, block);
+    view->self.pf_release = block_view_Release;
+    view->shared = shared;
+    return &view->self;
+}
+
+block_t *block_MakeWritable (block_t *block)
+{
+    if (block_TryUnshare (block))
+        return block;
+
+    block_t *copy = block_Alloc (block->i_buffer);
+    if (likely(copy != NULL))
+    {
+        memcpy (copy->p_buffer, block->p_buffer, block->i_buffer);
+        BlockMetaCopy (copy, block);
+    }
+    block_Release (block);
+    return copy;
+}
+
 block_t *block_TryRealloc (block_t *p_block, ssize_t i_prebody, size_t i_body)
 {
     block_Check( p_block );
@@ -179,6 +687,21 @@ block_t *block_TryRealloc (block_t *p_block, ssize_t i_prebody, size_t i_body)
 
     size_t requested = i_prebody + i_body;
 
+    /* Never write to a shared payload: copy it if it must grow */
+    if( (i_prebody > 0 || i_body > p_block->i_buffer)
+     && !block_TryUnshare( p_block ) )
+    {
+        block_t *p_rea = block_Alloc( requested );
+        if( p_rea == NULL )
+            return NULL;
+
+        memcpy( p_rea->p_buffer + i_prebody, p_block->p_buffer,
+                p_block->i_buffer );
+        BlockMetaCopy( p_rea, p_block );
+        block_Release( p_block );
+        return p_rea;
+    }
+
     if( p_block->i_buffer == 0 )
     {   /* Corner case: nothing to preserve */
         if( requested <= p_block->i_size )
@@ -30,6 +30,7 @@
 
 #include <vlc_common.h>
 #include <vlc_block.h>
+#include <vlc_atomic.h>
 #include "libvlc.h"
 
 /**
@@ -233,3 +234,243 @@ size_t block_FifoCount (block_fifo_t *fifo)
     vlc_mutex_unlock (&fifo->lock);
     return depth;
 }
+
+/*****************************************************************************
+ * Single producer single consumer FIFO
+ *****************************************************************************
+ * Blocks are stored in a linked list of fixed-size segments of slots.
+ * Only the producer writes slots and links new segments; only the consumer
+ * reads slots and frees used segments. The mutex and condition variable are
+ * only used when the consumer has to sleep on an empty queue.
+ *****************************************************************************/
+
+#define SPSC_SEGMENT_SLOTS 255
+
+struct block_spsc_segment
+{
+    _Atomic(struct block_spsc_segment *) next;
+    _Atomic(block_t *) slots[SPSC_SEGMENT_SLOTS];
+};
+
+struct block_spsc_t
+{
+    /* Producer side */
+    struct block_spsc_segment *write_seg;
+    unsigned write_index;
+    atomic_size_t in_depth;
+    atomic_size_t in_size;
+
+    /* Consumer side */
+    struct block_spsc_segment *read_seg;
+    unsigned read_index;
+    atomic_size_t out_depth;
+    atomic_size_t out_size;
+
+    /* Shared */
+    _Atomic(struct block_spsc_segment *) spare;
+    atomic_bool waiting;
+
+    vlc_mutex_t lock;
+    vlc_cond_t wait;
+};
+
+static struct block_spsc_segment *block_spsc_SegmentNew(block_spsc_t *fifo)
+{
+    struct block_spsc_segment *seg = atomic_exchange(&fifo->spare, NULL);
+
+    if (seg == NULL)
+        return malloc(sizeof (*seg));
+    return seg;
+}
+
+static void block_spsc_SegmentInit(struct block_spsc_segment *seg)
+{
+    atomic_init(&seg->next, NULL);
+    for (unsigned i = 0; i < SPSC_SEGMENT_SLOTS; i++)
+        atomic_init(&seg->slots[i], NULL);
+}
+
+block_spsc_t *block_SpscNew(void)
+{
+    block_spsc_t *fifo = malloc(sizeof (*fifo));
+    if (unlikely(fifo == NULL))
+        return NULL;
+
+    struct block_spsc_segment *seg = malloc(sizeof (*seg));
+    if (unlikely(seg == NULL))
+    {
+        free(fifo);
+        return NULL;
+    }
+    block_spsc_SegmentInit(seg);
+
+    fifo->write_seg = fifo->read_seg = seg;
+    fifo->write_index = fifo->read_index = 0;
+    atomic_init(&fifo->spare, NULL);
+    atomic_init(&fifo->in_depth, 0);
+    atomic_init(&fifo->in_size, 0);
+    atomic_init(&fifo->out_depth, 0);
+    atomic_init(&fifo->out_size, 0);
+    atomic_init(&fifo->waiting, false);
+    vlc_mutex_init(&fifo->lock);
+    vlc_cond_init(&fifo->wait);
+    return fifo;
+}
+
+void block_SpscRelease(block_spsc_t *fifo)
+{
+    block_t *block;
+
+    while ((block = block_SpscTryGet(fifo)) != NULL)
+        block_Release(block);
+
+    free(fifo->read_seg);
+    free(atomic_load(&fifo->spare));
+    vlc_cond_destroy(&fifo->wait);
+    vlc_mutex_destroy(&fifo->lock);
+    free(fifo);
+}
+
+static int block_spsc_Push(block_spsc_t *fifo, block_t *block)
+{
+    struct block_spsc_segment *seg = fifo->write_seg;
+
+    if (fifo->write_index == SPSC_SEGMENT_SLOTS)
+    {
+        struct block_spsc_segment *next = block_spsc_SegmentNew(fifo);
+        if (unlikely(next == NULL))
+            return VLC_ENOMEM;
+
+        block_spsc_SegmentInit(next);
+        atomic_store_explicit(&seg->next, next, memory_order_release);
+        fifo->write_seg = seg = next;
+        fifo->write_index = 0;
+    }
+
+    /* Account before publishing, so that the counters never underflow.
+     * Each counter has a single writer, so no read-modify-write is needed. */
+    atomic_store_explicit(&fifo->in_depth,
+        atomic_load_explicit(&fifo->in_depth, memory_order_relaxed) + 1,
+        memory_order_relaxed);
+    atomic_store_explicit(&fifo->in_size,
+        atomic_load_explicit(&fifo->in_size, memory_order_relaxed)
+            + block->i_buffer, memory_order_relaxed);
+    atomic_store_explicit(&seg->slots[fifo->write_index++], block,
+                          memory_order_release);
+    return VLC_SUCCESS;
+}
+
+int block_SpscPut(block_spsc_t *fifo, block_t *block)
+{
+    int ret = VLC_SUCCESS;
+
+    if (block == NULL)
+        return ret;
+
+    while (block != NULL)
+    {
+        block_t *next = block->p_next;
+
+        block->p_next = NULL;
+        if (unlikely(block_spsc_Push(fifo, block)))
+        {   /* Out of memory: drop the rest of the chain */
+            block->p_next = next;
+            block_ChainRelease(block);
+            ret = VLC_ENOMEM;
+            break;
+        }
+        block = next;
+    }
+
+    /* Wake the consumer up only if it is, or is about to be, sleeping. */
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&fifo->waiting, memory_order_relaxed)
+     && atomic_exchange_explicit(&fifo->waiting, false, memory_order_relaxed))
+    {
+        vlc_mutex_lock(&fifo->lock);
+        vlc_cond_signal(&fifo->wait);
+        vlc_mutex_unlock(&fifo->lock);
+    }
+    return ret;
+}
+
+block_t *block_SpscTryGet(block_spsc_t *fifo)
+{
+    struct block_spsc_segment *seg = fifo->read_seg;
+
+    if (fifo->read_index == SPSC_SEGMENT_SLOTS)
+    {
+        struct block_spsc_segment *next =
+            atomic_load_explicit(&seg->next, memory_order_acquire);
+        if (next == NULL)
+            return NULL;
+
+        /* The producer is done with the segment: recycle it. */
+        free(atomic_exchange(&fifo->spare, seg));
+        fifo->read_seg = seg = next;
+        fifo->read_index = 0;
+    }
+
+    block_t *block = atomic_load_explicit(&seg->slots[fifo->read_index],
+                                          memory_order_acquire);
+    if (block == NULL)
+        return NULL;
+
+    fifo->read_index++;
+    atomic_store_explicit(&fifo->out_size,
+        atomic_load_explicit(&fifo->out_size, memory_order_relaxed)
+            + block->i_buffer, memory_order_release);
+    atomic_store_explicit(&fifo->out_depth,
+        atomic_load_explicit(&fifo->out_depth, memory_order_relaxed) + 1,
+        memory_order_release);
+    return block;
+}
+
+static void block_spsc_Cleanup(void *data)
+{
+    block_spsc_t *fifo = data;
+
+    atomic_store_explicit(&fifo->waiting, false, memory_order_relaxed);
+    vlc_mutex_unlock(&fifo->lock);
+}
+
+block_t *block_SpscGet(block_spsc_t *fifo)
+{
+    vlc_testcancel();
+
+    block_t *block = block_SpscTryGet(fifo);
+    if (likely(block != NULL))
+        return block;
+
+    vlc_mutex_lock(&fifo->lock);
+    vlc_cleanup_push(block_spsc_Cleanup, fifo);
+    for (;;)
+    {
+        /* The producer clears the flag when it signals. */
+        atomic_store_explicit(&fifo->waiting, true, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+
+        block = block_SpscTryGet(fifo);
+        if (block != NULL)
+            break;
+        vlc_cond_wait(&fifo->wait, &fifo->lock);
+    }
+    vlc_cleanup_pop();
+
+    block_spsc_Cleanup(fifo);
+    return block;
+}
+
+/* The consumer counter is read first: as the producer accounts blocks before
+ * publishing them, the difference cannot be negative. */
+size_t block_SpscCount(block_spsc_t *fifo)
+{
+    size_t out = atomic_load_explicit(&fifo->out_depth, memory_order_acquire);
+    return atomic_load_explicit(&fifo->in_depth, memory_order_relaxed) - out;
+}
+
+size_t block_SpscSize(block_spsc_t *fifo)
+{
+    size_t out = atomic_load_explicit(&fifo->out_size, memory_order_acquire);
+    return atomic_load_explicit(&fifo->in_size, memory_order_relaxed) - out;
+}
@@ -365,6 +365,34 @@ void picture_CopyProperties( picture_t *p_dst, const picture_t *p_src )
     p_dst->b_top_field_first = p_src->b_top_field_first;
 }
 
+void picture_GetSlice( picture_t *p_view, const picture_t *p_pic,
+                       unsigned i_start, unsigned i_end )
+{
+    const unsigned i_lines = p_pic->p[0].i_lines;
+
+    assert( i_start <= i_end );
+    memset( p_view, 0, sizeof( *p_view ) );
+    p_view->format = p_pic->format;
+    p_view->format.i_y_offset = 0;
+    p_view->format.i_height = p_view->format.i_visible_height = i_end - i_start;
+    picture_CopyProperties( p_view, p_pic );
+
+    p_view->i_planes = p_pic->i_planes;
+    for( int i = 0; i < p_pic->i_planes; i++ )
+    {
+        const plane_t *p = &p_pic->p[i];
+        /* Round the end up, for odd heights with subsampled chroma */
+        unsigned i_first = i_start * p->i_lines / i_lines;
+        unsigned i_last = (i_end * p->i_lines + i_lines - 1) / i_lines;
+
+        i_last = __MIN( i_last, (unsigned)p->i_lines );
+        i_first = __MIN( i_first, i_last );
+        p_view->p[i] = *p;
+        p_view->p[i].p_pixels = p->p_pixels + i_first * p->i_pitch;
+        p_view->p[i].i_lines = p_view->p[i].i_visible_lines = i_last - i_first;
+    }
+}
+
 void picture_CopyPixels( picture_t *p_dst, const picture_t *p_src )
 {
     for( int i = 0; i < p_src->i_planes ; i++ )
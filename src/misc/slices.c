@@ -0,0 +1,255 @@
+/*****************************************************************************
+ * slices.c: parallel execution of video filters on picture slices
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <assert.h>
+
+#include <vlc_common.h>
+#include <vlc_filter.h>
+#include <vlc_picture.h>
+#include "../libvlc.h"
+
+/* Below this, a slice costs more to dispatch than to process */
+#define SLICE_MIN_LINES 32
+#define SLICE_MAX_THREADS 63 /* besides the caller */
+
+typedef struct vlc_slices_job vlc_slices_job_t;
+
+struct vlc_slices_job
+{
+    filter_t *p_filter;
+    filter_slice_cb pf_slice;
+    void *opaque;
+    unsigned i_slices;
+    unsigned i_next;  /* next slice to run */
+    unsigned i_done;  /* slices done */
+    vlc_slices_job_t *p_next;
+};
+
+/* Worker threads shared by all the filters of a libvlc instance. They are
+ * only started once a filter actually needs them. */
+struct vlc_slices
+{
+    vlc_mutex_t lock;
+    vlc_cond_t  wait;   /* for the workers: a job was queued */
+    vlc_cond_t  done;   /* for the callers: a slice was done */
+    vlc_slices_job_t *p_first;
+    vlc_slices_job_t **pp_last;
+    bool        b_exit;
+    unsigned    i_threads;
+    vlc_thread_t threads[SLICE_MAX_THREADS];
+};
+
+/* Takes the next slice of the first queued job. Called with the lock held. */
+static vlc_slices_job_t *TakeSlice( struct vlc_slices *p_slices,
+                                    unsigned *pi_slice )
+{
+    vlc_slices_job_t *p_job = p_slices->p_first;
+
+    *pi_slice = p_job->i_next++;
+    if( p_job->i_next == p_job->i_slices )
+    {   /* all slices are taken, dequeue the job */
+        p_slices->p_first = p_job->p_next;
+        if( p_slices->p_first == NULL )
+            p_slices->pp_last = &p_slices->p_first;
+    }
+    return p_job;
+}
+
+static void RunSlice( struct vlc_slices *p_slices, vlc_slices_job_t *p_job,
+                      unsigned i_slice )
+{
+    vlc_mutex_unlock( &p_slices->lock );
+    p_job->pf_slice( p_job->p_filter, p_job->opaque, i_slice,
+                     p_job->i_slices );
+    vlc_mutex_lock( &p_slices->lock );
+
+    if( ++p_job->i_done == p_job->i_slices )
+        vlc_cond_broadcast( &p_slices->done );
+}
+
+static void *Thread( void *data )
+{
+    struct vlc_slices *p_slices = data;
+
+    vlc_mutex_lock( &p_slices->lock );
+    for( ;; )
+    {
+        while( p_slices->p_first == NULL && !p_slices->b_exit )
+            vlc_cond_wait( &p_slices->wait, &p_slices->lock );
+        if( p_slices->p_first == NULL )
+            break;
+
+        unsigned i_slice;
+        vlc_slices_job_t *p_job = TakeSlice( p_slices, &i_slice );
+
+        RunSlice( p_slices, p_job, i_slice );
+    }
+    vlc_mutex_unlock( &p_slices->lock );
+    return NULL;
+}
+
+int libvlc_InternalSlicesInit( libvlc_int_t *p_libvlc )
+{
+    struct vlc_slices *p_slices = malloc( sizeof( *p_slices ) );
+    if( unlikely(p_slices == NULL) )
+        return VLC_ENOMEM;
+
+    vlc_mutex_init( &p_slices->lock );
+    vlc_cond_init( &p_slices->wait );
+    vlc_cond_init( &p_slices->done );
+    p_slices->p_first = NULL;
+    p_slices->pp_last = &p_slices->p_first;
+    p_slices->b_exit = false;
+    p_slices->i_threads = 0;
+
+    libvlc_priv( p_libvlc )->slices = p_slices;
+    return VLC_SUCCESS;
+}
+
+void libvlc_InternalSlicesClean( libvlc_int_t *p_libvlc )
+{
+    struct vlc_slices *p_slices = libvlc_priv( p_libvlc )->slices;
+
+    if( p_slices == NULL )
+        return;
+
+    vlc_mutex_lock( &p_slices->lock );
+    assert( p_slices->p_first == NULL );
+    p_slices->b_exit = true;
+    vlc_cond_broadcast( &p_slices->wait );
+    vlc_mutex_unlock( &p_slices->lock );
+
+    for( unsigned i = 0; i < p_slices->i_threads; i++ )
+        vlc_join( p_slices->threads[i], NULL );
+
+    vlc_cond_destroy( &p_slices->done );
+    vlc_cond_destroy( &p_slices->wait );
+    vlc_mutex_destroy( &p_slices->lock );
+    free( p_slices );
+    libvlc_priv( p_libvlc )->slices = NULL;
+}
+
+/* Returns how many threads may run slices, including the caller */
+static unsigned GetThreads( filter_t *p_filter )
+{
+    int i_threads = var_InheritInteger( p_filter, "slice-threads" );
+
+    if( i_threads <= 0 )
+        i_threads = vlc_GetCPUCount();
+    return VLC_CLIP( i_threads, 1, SLICE_MAX_THREADS + 1 );
+}
+
+void filter_ExecuteSlices( filter_t *p_filter, filter_slice_cb pf_slice,
+                           void *opaque, unsigned i_slices )
+{
+    struct vlc_slices *p_slices = libvlc_priv( p_filter->obj.libvlc )->slices;
+
+    i_slices = __MIN( i_slices, GetThreads( p_filter ) );
+    if( i_slices <= 1 || p_slices == NULL )
+    {
+        pf_slice( p_filter, opaque, 0, 1 );
+        return;
+    }
+
+    vlc_slices_job_t job = {
+        .p_filter = p_filter,
+        .pf_slice = pf_slice,
+        .opaque = opaque,
+        .i_slices = i_slices,
+        .i_next = 0,
+        .i_done = 0,
+        .p_next = NULL,
+    };
+
+    vlc_mutex_lock( &p_slices->lock );
+
+    /* The caller runs slices too, so one thread less is needed */
+    while( p_slices->i_threads < i_slices - 1 )
+    {
+        if( vlc_clone( &p_slices->threads[p_slices->i_threads], Thread,
+                       p_slices, VLC_THREAD_PRIORITY_VIDEO ) )
+            break;
+        p_slices->i_threads++;
+    }
+
+    *p_slices->pp_last = &job;
+    p_slices->pp_last = &job.p_next;
+    vlc_cond_broadcast( &p_slices->wait );
+
+    /* Help with this job and any job queued before it */
+    while( job.i_next < job.i_slices )
+    {
+        unsigned i_slice;
+        vlc_slices_job_t *p_job = TakeSlice( p_slices, &i_slice );
+
+        RunSlice( p_slices, p_job, i_slice );
+    }
+    while( job.i_done < job.i_slices )
+        vlc_cond_wait( &p_slices->done, &p_slices->lock );
+
+    vlc_mutex_unlock( &p_slices->lock );
+}
+
+struct picture_slices
+{
+    filter_picture_slice_cb pf_slice;
+    picture_t *p_src;
+    picture_t *p_dst;
+    unsigned i_lines;
+    unsigned i_align;
+};
+
+static void PictureSlice( filter_t *p_filter, void *opaque,
+                          unsigned i_slice, unsigned i_slices )
+{
+    const struct picture_slices *p_ps = opaque;
+    unsigned i_units = p_ps->i_lines / p_ps->i_align;
+    unsigned i_start = i_units * i_slice / i_slices * p_ps->i_align;
+    unsigned i_end = i_slice + 1 < i_slices
+                   ? i_units * (i_slice + 1) / i_slices * p_ps->i_align
+                   : p_ps->i_lines;
+    picture_t src, dst;
+
+    picture_GetSlice( &src, p_ps->p_src, i_start, i_end );
+    picture_GetSlice( &dst, p_ps->p_dst, i_start, i_end );
+    p_ps->pf_slice( p_filter, &src, &dst, i_end - i_start );
+}
+
+void filter_ExecutePictureSlices( filter_t *p_filter,
+                                  filter_picture_slice_cb pf_slice,
+                                  picture_t *p_src, picture_t *p_dst,
+                                  unsigned i_lines, unsigned i_align )
+{
+    struct picture_slices ps = {
+        .pf_slice = pf_slice,
+        .p_src = p_src,
+        .p_dst = p_dst,
+        .i_lines = i_lines,
+        .i_align = i_align,
+    };
+
+    assert( i_align > 0 );
+    filter_ExecuteSlices( p_filter, PictureSlice, &ps,
+                          i_lines / __MAX(i_align, SLICE_MIN_LINES) );
+}
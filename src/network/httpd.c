@@ -40,6 +40,7 @@
 #include <vlc_url.h>
 #include <vlc_mime.h>
 #include <vlc_block.h>
+#include <vlc_atomic.h>
 #include "../libvlc.h"
 
 #include <string.h>
@@ -52,6 +53,9 @@
 #ifdef HAVE_POLL
 # include <poll.h>
 #endif
+#ifdef __linux__
+# include <sys/epoll.h>
+#endif
 
 #if defined(_WIN32)
 #   include <winsock2.h>
@@ -66,8 +70,13 @@
 #define HTTPD_CL_BUFSIZE 10000
 #endif
 
+/* maximum number of stream workers per host */
+#define HTTPD_MAX_WORKERS 16
+
+typedef struct httpd_worker_t httpd_worker_t;
+
 static void httpd_ClientDestroy(httpd_client_t *cl);
-static void httpd_AppendData(httpd_stream_t *stream, uint8_t *p_data, int i_data);
+static void httpd_AppendData(httpd_stream_t *stream, const block_t *p_block);
 
 /* each host run in his own thread */
 struct httpd_host_t
@@ -98,6 +107,11 @@ struct httpd_host_t
     httpd_client_t **client;
     unsigned timeout_sec;
 
+    /* stream workers, started on demand */
+    unsigned        i_worker_max;
+    unsigned        i_worker_next;
+    httpd_worker_t *worker[HTTPD_MAX_WORKERS];
+
     /* TLS data */
     vlc_tls_creds_t *p_tls;
 };
@@ -588,6 +602,19 @@ void httpd_RedirectDelete(httpd_redirect_t *rdir)
 /*****************************************************************************
  * High Level Funtions: httpd_stream_t
  *****************************************************************************/
+
+/* Stream data is kept in reference-counted chunks, so that clients served
+ * by the stream workers can send them without holding the stream lock, and
+ * without copying them. Each chunk shares the payload of a sent block. */
+typedef struct httpd_chunk
+{
+    atomic_uint refs;
+    int64_t     pos;                /* absolute position of the first byte */
+    size_t      size;
+    const uint8_t *data;
+    block_t    *block;
+} httpd_chunk_t;
+
 struct httpd_stream_t
 {
     vlc_mutex_t lock;
@@ -607,17 +634,84 @@ struct httpd_stream_t
     bool        b_has_keyframes;
     int64_t     i_last_keyframe_seen_pos;
 
-    /* circular buffer */
+    /* ring of chunks, oldest first */
+    httpd_chunk_t **pp_chunk;
+    size_t      i_chunk_max;        /* ring capacity, a power of two */
+    size_t      i_chunk_first;
+    size_t      i_chunk;
+    size_t      i_chunk_bytes;      /* total size of the chunks */
+
     int         i_buffer_size;      /* buffer size, can't be reallocated smaller */
-    uint8_t     *p_buffer;          /* buffer */
     int64_t     i_buffer_pos;       /* absolute position from beginning */
     int64_t     i_buffer_last_pos;  /* a new connection will start with that */
 
+    /* stream workers serving some clients of this stream (bit mask) */
+    uint32_t    i_workers;
+
     /* custom headers */
     size_t        i_http_headers;
     httpd_header * p_http_headers;
 };
 
+static void httpd_ChunkRelease(httpd_chunk_t *chunk)
+{
+    if (atomic_fetch_sub_explicit(&chunk->refs, 1, memory_order_acq_rel) == 1) {
+        block_Release(chunk->block);
+        free(chunk);
+    }
+}
+
+static httpd_chunk_t *httpd_StreamChunk(const httpd_stream_t *stream, size_t i)
+{
+    assert(i < stream->i_chunk);
+    return stream->pp_chunk[(stream->i_chunk_first + i)
+                            & (stream->i_chunk_max - 1)];
+}
+
+/* Finds the chunk holding the byte at the given position.
+ * Returns the number of chunks if the position is not buffered anymore. */
+static size_t httpd_StreamFind(const httpd_stream_t *stream, int64_t pos)
+{
+    size_t lo = 0, hi = stream->i_chunk;
+
+    if (hi == 0 || pos < httpd_StreamChunk(stream, 0)->pos)
+        return stream->i_chunk;
+
+    while (hi - lo > 1) {
+        size_t mid = (lo + hi) / 2;
+
+        if (httpd_StreamChunk(stream, mid)->pos <= pos)
+            lo = mid;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+/* Computes where a stream client should resume sending, handling the
+ * keyframe wait and clients that are not fast enough.
+ * Returns false if there is no data to send yet. */
+static bool httpd_StreamSeek(const httpd_stream_t *stream, int64_t *pos,
+                             int64_t *keyframe_wait)
+{
+    if (*pos >= stream->i_buffer_pos)
+        return false;   /* wait, no data available */
+
+    if (*keyframe_wait >= 0) {
+        if (stream->i_last_keyframe_seen_pos <= *keyframe_wait)
+            /* still waiting for the next keyframe */
+            return false;
+
+        /* seek to the new keyframe */
+        *pos = stream->i_last_keyframe_seen_pos;
+        *keyframe_wait = -1;
+    }
+
+    if (httpd_StreamFind(stream, *pos) == stream->i_chunk)
+        *pos = stream->i_buffer_last_pos; /* this client isn't fast enough */
+    return true;
+}
+
 static int httpd_StreamCallBack(httpd_callback_sys_t *p_sys,
                                  httpd_client_t *cl, httpd_message_t *answer,
                                  const httpd_message_t *query)
@@ -628,34 +722,19 @@ static int httpd_StreamCallBack(httpd_callback_sys_t *p_sys,
         return VLC_SUCCESS;
 
     if (answer->i_body_offset > 0) {
-        int     i_pos;
-
-        if (answer->i_body_offset >= stream->i_buffer_pos)
+        /* Clients are only served here if no stream worker is available. */
+        vlc_mutex_lock(&stream->lock);
+        if (!httpd_StreamSeek(stream, &answer->i_body_offset,
+                              &cl->i_keyframe_wait_to_pass)) {
+            vlc_mutex_unlock(&stream->lock);
             return VLC_EGENERIC;    /* wait, no data available */
-
-        if (cl->i_keyframe_wait_to_pass >= 0) {
-            if (stream->i_last_keyframe_seen_pos <= cl->i_keyframe_wait_to_pass)
-                /* still waiting for the next keyframe */
-                return VLC_EGENERIC;
-
-            /* seek to the new keyframe */
-            answer->i_body_offset = stream->i_last_keyframe_seen_pos;
-            cl->i_keyframe_wait_to_pass = -1;
         }
 
-        if (answer->i_body_offset + stream->i_buffer_size < stream->i_buffer_pos)
-            answer->i_body_offset = stream->i_buffer_last_pos; /* this client isn't fast enough */
-
-        i_pos   = answer->i_body_offset % stream->i_buffer_size;
-        int64_t i_write = stream->i_buffer_pos - answer->i_body_offset;
-
-        if (i_write > HTTPD_CL_BUFSIZE)
-            i_write = HTTPD_CL_BUFSIZE;
-        else if (i_write <= 0)
-            return VLC_EGENERIC;    /* wait, no data available */
-
-        /* Don't go past the end of the circular buffer */
-        i_write = __MIN(i_write, stream->i_buffer_size - i_pos);
+        httpd_chunk_t *chunk =
+            httpd_StreamChunk(stream, httpd_StreamFind(stream,
+                                                       answer->i_body_offset));
+        size_t i_offset = answer->i_body_offset - chunk->pos;
+        size_t i_write = __MIN(chunk->size - i_offset, HTTPD_CL_BUFSIZE);
 
         /* using HTTPD_MSG_ANSWER -> data available */
         answer->i_proto  = HTTPD_PROTO_HTTP;
@@ -664,9 +743,10 @@ static int httpd_StreamCallBack(httpd_callback_sys_t *p_sys,
 
         answer->i_body = i_write;
         answer->p_body = xmalloc(i_write);
-        memcpy(answer->p_body, &stream->p_buffer[i_pos], i_write);
+        memcpy(answer->p_body, chunk->data + i_offset, i_write);
 
         answer->i_body_offset += i_write;
+        vlc_mutex_unlock(&stream->lock);
 
         return VLC_SUCCESS;
     } else {
@@ -765,11 +845,16 @@ httpd_stream_t *httpd_StreamNew(httpd_host_t *host,
     stream->i_header = 0;
     stream->p_header = NULL;
     stream->i_buffer_size = 5000000;    /* 5 Mo per stream */
-    stream->p_buffer = xmalloc(stream->i_buffer_size);
+    stream->i_chunk_max = 64;
+    stream->pp_chunk = xmalloc(stream->i_chunk_max * sizeof (*stream->pp_chunk));
+    stream->i_chunk_first = 0;
+    stream->i_chunk = 0;
+    stream->i_chunk_bytes = 0;
     /* We set to 1 to make life simpler
      * (this way i_body_offset can never be 0) */
     stream->i_buffer_pos = 1;
     stream->i_buffer_last_pos = 1;
+    stream->i_workers = 0;
     stream->b_has_keyframes = false;
     stream->i_last_keyframe_seen_pos = 0;
     stream->i_http_headers = 0;
@@ -801,24 +886,59 @@ int httpd_StreamHeader(httpd_stream_t *stream, uint8_t *p_data, int i_data)
     return VLC_SUCCESS;
 }
 
-static void httpd_AppendData(httpd_stream_t *stream, uint8_t *p_data, int i_data)
+static void httpd_AppendData(httpd_stream_t *stream, const block_t *p_block)
 {
-    int i_pos = stream->i_buffer_pos % stream->i_buffer_size;
-    int i_count = i_data;
-    while (i_count > 0) {
-        int i_copy = __MIN(i_count, stream->i_buffer_size - i_pos);
+    httpd_chunk_t *chunk = malloc(sizeof (*chunk));
+    if (unlikely(chunk == NULL))
+        return;
 
-        /* Ok, we can't go past the end of our buffer */
-        memcpy(&stream->p_buffer[i_pos], p_data, i_copy);
+    size_t i_data = p_block->i_buffer;
 
-        i_pos = (i_pos + i_copy) % stream->i_buffer_size;
-        i_count -= i_copy;
-        p_data  += i_copy;
+    /* The caller keeps its block: copy it once for all the clients */
+    chunk->block = block_Alloc(i_data);
+    if (unlikely(chunk->block == NULL)) {
+        free(chunk);
+        return;
+    }
+    memcpy(chunk->block->p_buffer, p_block->p_buffer, i_data);
+
+    atomic_init(&chunk->refs, 1);
+    chunk->pos = stream->i_buffer_pos;
+    chunk->size = i_data;
+    chunk->data = chunk->block->p_buffer;
+
+    if (stream->i_chunk == stream->i_chunk_max) {
+        /* Grow the ring, unwrapping it */
+        httpd_chunk_t **pp = xmalloc(2 * stream->i_chunk_max * sizeof (*pp));
+
+        for (size_t i = 0; i < stream->i_chunk; i++)
+            pp[i] = httpd_StreamChunk(stream, i);
+        free(stream->pp_chunk);
+        stream->pp_chunk = pp;
+        stream->i_chunk_max *= 2;
+        stream->i_chunk_first = 0;
     }
 
+    stream->pp_chunk[(stream->i_chunk_first + stream->i_chunk++)
+                     & (stream->i_chunk_max - 1)] = chunk;
+    stream->i_chunk_bytes += i_data;
     stream->i_buffer_pos += i_data;
+
+    /* Drop the oldest chunks, but always keep the last one */
+    while (stream->i_chunk > 1
+        && stream->i_chunk_bytes > (size_t)stream->i_buffer_size) {
+        chunk = httpd_StreamChunk(stream, 0);
+        stream->i_chunk_first = (stream->i_chunk_first + 1)
+                                & (stream->i_chunk_max - 1);
+        stream->i_chunk--;
+        stream->i_chunk_bytes -= chunk->size;
+        httpd_ChunkRelease(chunk);
+    }
 }
 
+static void httpd_WorkerWake(httpd_worker_t *);
+static void httpd_WorkerDetach(httpd_worker_t *, const httpd_stream_t *);
+
 int httpd_StreamSend(httpd_stream_t *stream, const block_t *p_block)
 {
     if (!p_block || !p_block->p_buffer)
@@ -834,15 +954,29 @@ int httpd_StreamSend(httpd_stream_t *stream, const block_t *p_block)
         stream->i_last_keyframe_seen_pos = stream->i_buffer_pos;
     }
 
-    httpd_AppendData(stream, p_block->p_buffer, p_block->i_buffer);
+    httpd_AppendData(stream, p_block);
 
+    uint32_t workers = stream->i_workers;
     vlc_mutex_unlock(&stream->lock);
+
+    for (unsigned i = 0; workers != 0; i++, workers >>= 1)
+        if (workers & 1)
+            httpd_WorkerWake(stream->url->host->worker[i]);
     return VLC_SUCCESS;
 }
 
 void httpd_StreamDelete(httpd_stream_t *stream)
 {
+    httpd_host_t *host = stream->url->host;
+
+    /* No clients can be handed over to the workers after this */
     httpd_UrlDelete(stream->url);
+
+    uint32_t workers = stream->i_workers;
+    for (unsigned i = 0; workers != 0; i++, workers >>= 1)
+        if (workers & 1)
+            httpd_WorkerDetach(host->worker[i], stream);
+
     for (size_t i = 0; i < stream->i_http_headers; i++) {
         free(stream->p_http_headers[i].name);
         free(stream->p_http_headers[i].value);
@@ -851,10 +985,414 @@ void httpd_StreamDelete(httpd_stream_t *stream)
     vlc_mutex_destroy(&stream->lock);
     free(stream->psz_mime);
     free(stream->p_header);
-    free(stream->p_buffer);
+    for (size_t i = 0; i < stream->i_chunk; i++)
+        httpd_ChunkRelease(httpd_StreamChunk(stream, i));
+    free(stream->pp_chunk);
     free(stream);
 }
 
+/*****************************************************************************
+ * Stream workers
+ *****************************************************************************
+ * Once a client of a httpd_stream_t has been sent the answer headers, it is
+ * handed over from the host thread to one of the host stream workers. Each
+ * worker sends the shared stream chunks to its clients with writev(), and
+ * only watches the sockets of clients whose send buffer is full.
+ *****************************************************************************/
+typedef struct httpd_stream_client
+{
+    vlc_tls_t      *sock;
+    httpd_stream_t *stream;         /* NULL once the stream is deleted */
+    int64_t         i_pos;          /* position of the next byte to send */
+    int64_t         i_keyframe_wait_to_pass;
+    vlc_tick_t      i_timeout_date;
+    bool            b_blocked;      /* waiting for the socket to be writable */
+    bool            b_dead;
+} httpd_stream_client_t;
+
+struct httpd_worker_t
+{
+    httpd_host_t *host;
+    unsigned      index;
+    vlc_tick_t    timeout;
+
+    vlc_thread_t  thread;
+    vlc_mutex_t   lock;
+    int           wakefd[2];
+    atomic_bool   wake_pending;
+#ifdef __linux__
+    int           epfd;
+#else
+    struct pollfd *ufd;
+    httpd_stream_client_t **ufd_client;
+    unsigned      ufd_max;
+#endif
+
+    int                     i_client;
+    httpd_stream_client_t **client;
+};
+
+#define HTTPD_WORKER_IOV 64
+
+static void httpd_WorkerWake(httpd_worker_t *w)
+{
+    if (!atomic_exchange(&w->wake_pending, true))
+        send(w->wakefd[1], "", 1, MSG_NOSIGNAL);
+}
+
+static void httpd_StreamClientDestroy(httpd_worker_t *w,
+                                      httpd_stream_client_t *sc)
+{
+#ifdef __linux__
+    epoll_ctl(w->epfd, EPOLL_CTL_DEL, vlc_tls_GetFD(sc->sock), NULL);
+#else
+    (void) w;
+#endif
+    vlc_tls_Close(sc->sock);
+    free(sc);
+}
+
+/* Sends as much stream data as the socket accepts.
+ * Returns the number of bytes sent. */
+static size_t httpd_StreamClientSend(httpd_stream_client_t *sc)
+{
+    httpd_stream_t *stream = sc->stream;
+    size_t total = 0;
+
+    for (;;) {
+        struct iovec iov[HTTPD_WORKER_IOV];
+        httpd_chunk_t *chunks[HTTPD_WORKER_IOV];
+        unsigned n = 0;
+        size_t len = 0;
+
+        vlc_mutex_lock(&stream->lock);
+        if (httpd_StreamSeek(stream, &sc->i_pos,
+                             &sc->i_keyframe_wait_to_pass)) {
+            size_t i = httpd_StreamFind(stream, sc->i_pos);
+            size_t offset = sc->i_pos - httpd_StreamChunk(stream, i)->pos;
+
+            for (; i < stream->i_chunk && n < HTTPD_WORKER_IOV; i++, n++) {
+                httpd_chunk_t *chunk = httpd_StreamChunk(stream, i);
+
+                atomic_fetch_add_explicit(&chunk->refs, 1,
+                                          memory_order_relaxed);
+                chunks[n] = chunk;
+                iov[n].iov_base = (uint8_t *)chunk->data + offset;
+                iov[n].iov_len = chunk->size - offset;
+                len += iov[n].iov_len;
+                offset = 0;
+            }
+        }
+        vlc_mutex_unlock(&stream->lock);
+
+        if (n == 0)
+            break; /* nothing left to send */
+
+        ssize_t val = sc->sock->writev(sc->sock, iov, n);
+
+        for (unsigned i = 0; i < n; i++)
+            httpd_ChunkRelease(chunks[i]);
+
+        if (val < 0) {
+#if defined(_WIN32)
+            if (WSAGetLastError() == WSAEWOULDBLOCK)
+#else
+            if (errno == EAGAIN)
+#endif
+                sc->b_blocked = true;
+            else /* Connection failed, or hung up (EPIPE) */
+                sc->b_dead = true;
+            break;
+        }
+
+        sc->i_pos += val;
+        total += val;
+        if ((size_t)val < len) {
+            sc->b_blocked = true;
+            break;
+        }
+    }
+    return total;
+}
+
+/* Sends pending data to the clients, and reaps the dead ones.
+ * Returns the next poll() timeout. */
+static int httpd_WorkerSend(httpd_worker_t *w)
+{
+    const vlc_tick_t timeout = w->timeout;
+    vlc_tick_t now = mdate();
+    int delay = -1;
+
+    vlc_mutex_lock(&w->lock);
+    for (int i = 0; i < w->i_client; i++) {
+        httpd_stream_client_t *sc = w->client[i];
+
+        if (sc->stream != NULL && !sc->b_blocked && !sc->b_dead)
+            httpd_StreamClientSend(sc);
+
+        /* Only a client that does not drain its socket can time out; an idle
+         * client merely waits for the stream to produce more data. */
+        if (!sc->b_blocked)
+            sc->i_timeout_date = now + timeout;
+
+        if (sc->stream == NULL || sc->b_dead
+         || (timeout > 0 && sc->i_timeout_date < now)) {
+            TAB_REMOVE(w->i_client, w->client, sc);
+            i--;
+            httpd_StreamClientDestroy(w, sc);
+            continue;
+        }
+
+        /* check timeouts once per second */
+        if (timeout > 0)
+            delay = 1000;
+    }
+    vlc_mutex_unlock(&w->lock);
+    return delay;
+}
+
+static void httpd_WorkerWakeClear(httpd_worker_t *w)
+{
+    char dummy[64];
+
+    while (recv(w->wakefd[0], dummy, sizeof (dummy), 0) > 0);
+    /* Only clear the flag after draining, so that no wake-up is lost */
+    atomic_store(&w->wake_pending, false);
+}
+
+#ifdef __linux__
+static void httpd_WorkerWait(httpd_worker_t *w, int delay)
+{
+    struct epoll_event ev[64];
+    int n = epoll_wait(w->epfd, ev, ARRAY_SIZE(ev), delay);
+    int canc = vlc_savecancel();
+
+    vlc_mutex_lock(&w->lock);
+    for (int i = 0; i < n; i++) {
+        httpd_stream_client_t *sc = ev[i].data.ptr;
+
+        if (sc == NULL)
+            httpd_WorkerWakeClear(w);
+        else if (ev[i].events & (EPOLLERR|EPOLLHUP))
+            sc->b_dead = true;
+        else
+            sc->b_blocked = false;
+    }
+    vlc_mutex_unlock(&w->lock);
+    vlc_restorecancel(canc);
+}
+#else
+static void httpd_WorkerWait(httpd_worker_t *w, int delay)
+{
+    unsigned nfd = 1;
+
+    /* Only the clients with a full send buffer are watched */
+    vlc_mutex_lock(&w->lock);
+    if (w->ufd_max < (unsigned)w->i_client + 1) {
+        w->ufd_max = w->i_client + 1;
+        w->ufd = xrealloc(w->ufd, w->ufd_max * sizeof (*w->ufd));
+        w->ufd_client = xrealloc(w->ufd_client,
+                                 w->ufd_max * sizeof (*w->ufd_client));
+    }
+    w->ufd[0].fd = w->wakefd[0];
+    w->ufd[0].events = POLLIN;
+    for (int i = 0; i < w->i_client; i++) {
+        httpd_stream_client_t *sc = w->client[i];
+
+        if (!sc->b_blocked)
+            continue;
+        w->ufd[nfd].fd = vlc_tls_GetFD(sc->sock);
+        w->ufd[nfd].events = POLLOUT;
+        w->ufd_client[nfd++] = sc;
+    }
+    vlc_mutex_unlock(&w->lock);
+
+    /* Clients are only removed by this thread, so ufd remains valid */
+    int n = poll(w->ufd, nfd, delay);
+    int canc = vlc_savecancel();
+
+    vlc_mutex_lock(&w->lock);
+    for (unsigned i = 0; n > 0 && i < nfd; i++) {
+        if (w->ufd[i].revents == 0)
+            continue;
+        n--;
+        if (i == 0)
+            httpd_WorkerWakeClear(w);
+        else if (w->ufd[i].revents & (POLLERR|POLLHUP|POLLNVAL))
+            w->ufd_client[i]->b_dead = true;
+        else
+            w->ufd_client[i]->b_blocked = false;
+    }
+    vlc_mutex_unlock(&w->lock);
+    vlc_restorecancel(canc);
+}
+#endif
+
+static void *httpd_WorkerThread(void *data)
+{
+    httpd_worker_t *w = data;
+
+    for (;;) {
+        int canc = vlc_savecancel();
+        int delay = httpd_WorkerSend(w);
+        vlc_restorecancel(canc);
+
+        httpd_WorkerWait(w, delay);
+    }
+    vlc_assert_unreachable();
+}
+
+static httpd_worker_t *httpd_WorkerNew(httpd_host_t *host, unsigned index)
+{
+    httpd_worker_t *w = malloc(sizeof (*w));
+    if (unlikely(w == NULL))
+        return NULL;
+
+    w->host = host;
+    w->index = index;
+    w->timeout = host->b_no_timeout ? 0 : host->timeout_sec * CLOCK_FREQ;
+    vlc_mutex_init(&w->lock);
+    atomic_init(&w->wake_pending, false);
+    w->i_client = 0;
+    w->client = NULL;
+
+    if (vlc_socketpair(AF_UNIX, SOCK_STREAM, 0, w->wakefd, true))
+        goto error;
+
+#ifdef __linux__
+    struct epoll_event ev = { .events = EPOLLIN, .data.ptr = NULL };
+
+    w->epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (w->epfd == -1)
+        goto error_pair;
+    if (epoll_ctl(w->epfd, EPOLL_CTL_ADD, w->wakefd[0], &ev))
+        goto error_ep;
+#else
+    w->ufd = NULL;
+    w->ufd_client = NULL;
+    w->ufd_max = 0;
+#endif
+
+    if (vlc_clone(&w->thread, httpd_WorkerThread, w,
+                  VLC_THREAD_PRIORITY_LOW)) {
+        msg_Err(host, "cannot spawn http stream worker thread");
+        goto error_ep;
+    }
+    return w;
+
+error_ep:
+#ifdef __linux__
+    vlc_close(w->epfd);
+error_pair:
+#endif
+    vlc_close(w->wakefd[1]);
+    vlc_close(w->wakefd[0]);
+error:
+    vlc_mutex_destroy(&w->lock);
+    free(w);
+    return NULL;
+}
+
+static void httpd_WorkerDelete(httpd_worker_t *w)
+{
+    vlc_cancel(w->thread);
+    vlc_join(w->thread, NULL);
+
+    for (int i = 0; i < w->i_client; i++) {
+        msg_Warn(w->host, "client still connected");
+        httpd_StreamClientDestroy(w, w->client[i]);
+    }
+    TAB_CLEAN(w->i_client, w->client);
+
+#ifdef __linux__
+    vlc_close(w->epfd);
+#else
+    free(w->ufd_client);
+    free(w->ufd);
+#endif
+    vlc_close(w->wakefd[1]);
+    vlc_close(w->wakefd[0]);
+    vlc_mutex_destroy(&w->lock);
+    free(w);
+}
+
+/* Marks all clients of a deleted stream for removal by the worker */
+static void httpd_WorkerDetach(httpd_worker_t *w, const httpd_stream_t *stream)
+{
+    bool warn = true;
+
+    vlc_mutex_lock(&w->lock);
+    for (int i = 0; i < w->i_client; i++)
+        if (w->client[i]->stream == stream) {
+            if (warn)
+                msg_Warn(w->host, "force closing connections");
+            warn = false;
+            w->client[i]->stream = NULL;
+        }
+    vlc_mutex_unlock(&w->lock);
+    httpd_WorkerWake(w);
+}
+
+/* Hands a streaming client over to a stream worker. The host lock is held.
+ * Returns false if no worker is available. */
+static bool httpd_StreamHandOver(httpd_host_t *host, httpd_client_t *cl)
+{
+    const httpd_url_t *url = cl->url;
+    int i_msg = cl->query.i_type;
+
+    if (host->i_worker_max == 0 || cl->i_ref != 0
+     || url->catch[i_msg].cb != httpd_StreamCallBack)
+        return false;
+
+    httpd_stream_t *stream = (httpd_stream_t *)url->catch[i_msg].p_sys;
+    unsigned index = host->i_worker_next;
+    httpd_worker_t *w = host->worker[index];
+
+    if (w == NULL) {
+        w = httpd_WorkerNew(host, index);
+        if (w == NULL) {
+            if (index == 0)
+                return false;
+            index = 0; /* use the first one instead */
+            w = host->worker[0];
+        } else
+            host->worker[index] = w;
+    }
+    host->i_worker_next = (index + 1) % host->i_worker_max;
+
+    httpd_stream_client_t *sc = malloc(sizeof (*sc));
+    if (unlikely(sc == NULL))
+        return false;
+
+    sc->sock = cl->sock;
+    sc->stream = stream;
+    sc->i_pos = cl->answer.i_body_offset;
+    sc->i_keyframe_wait_to_pass = cl->i_keyframe_wait_to_pass;
+    sc->i_timeout_date = cl->i_timeout_date;
+    sc->b_blocked = false;
+    sc->b_dead = false;
+
+#ifdef __linux__
+    struct epoll_event ev = { .events = EPOLLOUT|EPOLLET, .data.ptr = sc };
+
+    if (epoll_ctl(w->epfd, EPOLL_CTL_ADD, vlc_tls_GetFD(sc->sock), &ev)) {
+        free(sc);
+        return false;
+    }
+#endif
+    cl->sock = NULL;
+
+    vlc_mutex_lock(&stream->lock);
+    stream->i_workers |= 1u << index;
+    vlc_mutex_unlock(&stream->lock);
+
+    vlc_mutex_lock(&w->lock);
+    TAB_APPEND(w->i_client, w->client, sc);
+    vlc_mutex_unlock(&w->lock);
+    httpd_WorkerWake(w);
+    return true;
+}
+
 /*****************************************************************************
  * Low level
  *****************************************************************************/
@@ -974,6 +1512,14 @@ static httpd_host_t *httpd_HostCreate(vlc_object_t *p_this,
     host->timeout_sec = timeout_sec;
     host->p_tls    = p_tls;
 
+    int workers = var_InheritInteger(p_this, "http-workers");
+    if (workers < 0)
+        workers = vlc_GetCPUCount();
+    host->i_worker_max = __MIN((unsigned)workers, HTTPD_MAX_WORKERS);
+    host->i_worker_next = 0;
+    for (unsigned i = 0; i < HTTPD_MAX_WORKERS; i++)
+        host->worker[i] = NULL;
+
     /* create the thread */
     if (vlc_clone(&host->thread, httpd_HostThread, host,
                    VLC_THREAD_PRIORITY_LOW)) {
@@ -1024,6 +1570,10 @@ void httpd_HostDelete(httpd_host_t *host)
     vlc_cancel(host->thread);
     vlc_join(host->thread, NULL);
 
+    for (unsigned i = 0; i < HTTPD_MAX_WORKERS; i++)
+        if (host->worker[i] != NULL)
+            httpd_WorkerDelete(host->worker[i]);
+
     msg_Dbg(host, "HTTP host removed");
 
     for (int i = 0; i < host->i_url; i++)
@@ -1213,7 +1763,8 @@ char* httpd_ServerIP(const httpd_client_t *cl, char *ip, int *port)
 
 static void httpd_ClientDestroy(httpd_client_t *cl)
 {
-    vlc_tls_Close(cl->sock);
+    if (cl->sock != NULL) /* NULL if handed over to a stream worker */
+        vlc_tls_Close(cl->sock);
     httpd_MsgClean(&cl->answer);
     httpd_MsgClean(&cl->query);
 
@@ -1940,6 +2491,11 @@ static void httpdLoop(httpd_host_t *host)
                     } else
                         cl->i_state = HTTPD_CLIENT_DEAD;
                     httpd_MsgClean(&cl->answer);
+                } else if (httpd_StreamHandOver(host, cl)) {
+                    TAB_REMOVE(host->i_client, host->client, cl);
+                    i_client--;
+                    httpd_ClientDestroy(cl);
+                    continue;
                 } else {
                     int64_t i_offset = cl->answer.i_body_offset;
                     httpd_MsgClean(&cl->answer);
@@ -0,0 +1,207 @@
+/*****************************************************************************
+ * block_bench.c: block allocator micro-benchmark
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#undef NDEBUG
+#include <assert.h>
+
+#include <vlc_common.h>
+#include <vlc_block.h>
+
+#define ITERATIONS 1000000
+#define BURST      64
+
+static const size_t sizes[] = { 188, 188 * 7, 1500, 65536 };
+
+static void bench_malloc (size_t size)
+{
+    void *ptrs[BURST];
+    mtime_t start = mdate ();
+
+    for (unsigned i = 0; i < ITERATIONS / BURST; i++)
+    {
+        for (unsigned j = 0; j < BURST; j++)
+        {
+            ptrs[j] = malloc (size + 160);
+            assert (ptrs[j] != NULL);
+            *(volatile uint8_t *)ptrs[j] = j;
+        }
+        for (unsigned j = 0; j < BURST; j++)
+            free (ptrs[j]);
+    }
+
+    mtime_t d = mdate () - start;
+    printf ("malloc      %6zu bytes: %6.1f ns/op\n", size,
+            d * 1000. / ITERATIONS);
+}
+
+static void bench_block (size_t size)
+{
+    block_t *blocks[BURST];
+    mtime_t start = mdate ();
+
+    for (unsigned i = 0; i < ITERATIONS / BURST; i++)
+    {
+        for (unsigned j = 0; j < BURST; j++)
+        {
+            blocks[j] = block_Alloc (size);
+            assert (blocks[j] != NULL);
+            blocks[j]->p_buffer[0] = j;
+        }
+        for (unsigned j = 0; j < BURST; j++)
+            block_Release (blocks[j]);
+    }
+
+    mtime_t d = mdate () - start;
+    printf ("block_Alloc %6zu bytes: %6.1f ns/op\n", size,
+            d * 1000. / ITERATIONS);
+}
+
+/* Producer allocates, consumer releases, as in access -> demux paths. */
+static void *consumer (void *data)
+{
+    block_fifo_t *fifo = data;
+
+    for (;;)
+    {
+        block_t *block = block_FifoGet (fifo);
+        bool last = block->i_flags & BLOCK_FLAG_END_OF_SEQUENCE;
+
+        block_Release (block);
+        if (last)
+            break;
+    }
+    return NULL;
+}
+
+static void bench_threads (size_t size)
+{
+    block_fifo_t *fifo = block_FifoNew ();
+    vlc_thread_t th;
+
+    assert (fifo != NULL);
+    if (vlc_clone (&th, consumer, fifo, VLC_THREAD_PRIORITY_LOW))
+        abort ();
+
+    mtime_t start = mdate ();
+    for (unsigned i = 0; i < ITERATIONS; i++)
+    {
+        block_t *block = block_Alloc (size);
+        assert (block != NULL);
+        if (i == ITERATIONS - 1)
+            block->i_flags |= BLOCK_FLAG_END_OF_SEQUENCE;
+        block_FifoPut (fifo, block);
+    }
+    vlc_join (th, NULL);
+
+    mtime_t d = mdate () - start;
+    printf ("2 threads   %6zu bytes: %6.1f ns/op\n", size,
+            d * 1000. / ITERATIONS);
+    block_FifoRelease (fifo);
+}
+
+/* One input fanned out to several outputs, as in the duplicate stream
+ * output. Each output holds on to its last blocks, as muxers and network
+ * outputs do. */
+#define FANOUT_BITRATE 50000000 /* bits per second */
+#define FANOUT_SECONDS 20
+#define FANOUT_QUEUE   256
+
+static void bench_fanout (unsigned ways, bool share)
+{
+    const size_t size = 188 * 7;
+    const unsigned count = FANOUT_BITRATE / 8 / size * FANOUT_SECONDS;
+    block_t *queues[ways][FANOUT_QUEUE];
+    size_t copied = 0;
+
+    memset (queues, 0, sizeof (queues));
+
+    mtime_t start = mdate ();
+    for (unsigned i = 0; i < count; i++)
+    {
+        block_t *block = block_Alloc (size);
+        assert (block != NULL);
+        memset (block->p_buffer, i, size);
+
+        for (unsigned j = 0; j < ways; j++)
+        {
+            block_t *out = block;
+
+            if (j < ways - 1)
+            {
+                out = share ? block_Share (block) : block_Duplicate (block);
+                assert (out != NULL);
+                if (!share)
+                    copied += size;
+            }
+
+            block_t **slot = &queues[j][i % FANOUT_QUEUE];
+            if (*slot != NULL)
+                block_Release (*slot);
+            *slot = out;
+        }
+    }
+
+    for (unsigned j = 0; j < ways; j++)
+        for (unsigned i = 0; i < FANOUT_QUEUE; i++)
+            if (queues[j][i] != NULL)
+                block_Release (queues[j][i]);
+
+    mtime_t d = mdate () - start;
+    printf ("fan-out %u x %2u Mbit/s, %s: %5.2f ms CPU per second, "
+            "%5.1f MB/s copied\n", ways, FANOUT_BITRATE / 1000000,
+            share ? "shared" : "copied", d / 1000. / FANOUT_SECONDS,
+            copied / 1e6 / FANOUT_SECONDS);
+}
+
+int main (void)
+{
+    for (size_t i = 0; i < ARRAY_SIZE(sizes); i++)
+    {
+        bench_malloc (sizes[i]);
+        bench_block (sizes[i]);
+        bench_threads (sizes[i]);
+    }
+
+    for (unsigned ways = 2; ways <= 4; ways += 2)
+    {
+        bench_fanout (ways, false);
+        bench_fanout (ways, true);
+    }
+
+    block_pool_stats_t stats[16];
+    size_t n = block_PoolGetStats (stats, ARRAY_SIZE(stats));
+
+    for (size_t i = 0; i < n; i++)
+    {
+        uint64_t total = stats[i].hits + stats[i].misses;
+
+        printf ("class %6zu: %10"PRIu64" allocs, %5.1f%% recycled, "
+                "%u in depot\n", stats[i].size, total,
+                total ? stats[i].hits * 100. / total : 0., stats[i].depot);
+    }
+    return 0;
+}
@@ -86,11 +86,146 @@ static void test_block (void)
     //assert (block == NULL);
 }
 
+static void test_block_pool (void)
+{
+    block_pool_stats_t before[16], after[16];
+    size_t n = block_PoolGetStats (before, 16);
+
+    assert (n > 0);
+    for (size_t i = 1; i < n; i++)
+        assert (before[i - 1].size < before[i].size);
+
+    /* A released block shall be recycled for the next allocation */
+    block_t *block = block_Alloc (188);
+    assert (block != NULL);
+    assert (block->i_buffer == 188);
+    assert (((uintptr_t)block->p_buffer % 32) == 0);
+    memset (block->p_buffer, 0xAA, block->i_buffer);
+    block_Release (block);
+
+    block = block_Alloc (100);
+    assert (block != NULL);
+    assert (block->i_buffer == 100);
+    assert (block->i_flags == 0 && block->p_next == NULL);
+    assert (block->i_pts == VLC_TICK_INVALID);
+
+    /* Growing within the size class shall not move the payload */
+    uint8_t *payload = block->p_buffer;
+    block = block_Realloc (block, 0, 188);
+    assert (block != NULL);
+    assert (block->p_buffer == payload);
+    block_Release (block);
+
+    assert (block_PoolGetStats (after, 16) == n);
+    assert (after[0].size == 188);
+    assert (after[0].hits >= before[0].hits + 1);
+    assert (after[0].frees == before[0].frees + 2);
+
+    /* Large blocks bypass the pool */
+    block = block_Alloc (after[n - 1].size + 1);
+    assert (block != NULL);
+    block_Release (block);
+}
+
+static void *test_block_pool_thread (void *data)
+{
+    block_t *blocks[64];
+
+    for (size_t i = 0; i < ARRAY_SIZE(blocks); i++)
+    {
+        blocks[i] = block_Alloc (188);
+        assert (blocks[i] != NULL);
+    }
+    for (size_t i = 0; i < ARRAY_SIZE(blocks); i++)
+        block_Release (blocks[i]);
+    return data;
+}
+
+static void test_block_pool_drain (void)
+{
+    block_pool_stats_t before, after;
+    vlc_thread_t th;
+
+    block_PoolGetStats (&before, 1);
+    assert (!vlc_clone (&th, test_block_pool_thread, NULL,
+                        VLC_THREAD_PRIORITY_LOW));
+    vlc_join (th, NULL);
+    block_PoolGetStats (&after, 1);
+
+    /* The magazine of the thread is freed, not moved to the depot */
+    assert (after.frees >= before.frees + 64);
+    assert (after.depot < before.depot + 64);
+}
+
+static void test_block_Share (void)
+{
+    block_t *block = block_Alloc (sizeof (text));
+    assert (block != NULL);
+    memcpy (block->p_buffer, text, sizeof (text));
+    block->i_pts = 42;
+
+    block_t *a = block_Share (block);
+    block_t *b = block_Share (a);
+    assert (a != NULL && b != NULL);
+    assert (a->p_buffer == block->p_buffer && b->p_buffer == block->p_buffer);
+    assert (a->i_buffer == sizeof (text) && a->i_pts == 42);
+    assert (block_IsShared (block) && block_IsShared (a));
+
+    /* The payload outlives the block that allocated it */
+    block_Release (block);
+    assert (!memcmp (a->p_buffer, text, sizeof (text)));
+
+    /* Skipping bytes does not copy */
+    uint8_t *payload = a->p_buffer;
+    a = block_Realloc (a, -5, sizeof (text));
+    assert (a != NULL && a->p_buffer == payload + 5);
+
+    /* Growing copies */
+    a = block_Realloc (a, 5, sizeof (text) - 5);
+    assert (a != NULL && a->p_buffer != payload);
+    assert (!memcmp (a->p_buffer + 5, text + 5, sizeof (text) - 5));
+    memset (a->p_buffer, 'A', 5);
+    assert (!memcmp (b->p_buffer, text, sizeof (text)));
+
+    /* Writing copies */
+    block_t *c = block_Share (b);
+    assert (c != NULL);
+    c = block_MakeWritable (c);
+    assert (c != NULL && c->p_buffer != payload);
+    memset (c->p_buffer, 'B', c->i_buffer);
+    assert (!memcmp (b->p_buffer, text, sizeof (text)));
+    block_Release (c);
+    block_Release (a);
+
+    block_Release (b);
+
+    /* The owner takes its payload back once it is not shared anymore */
+    block = block_Alloc (sizeof (text));
+    assert (block != NULL);
+    payload = block->p_buffer;
+    block_Release (block_Share (block));
+    assert (!block_IsShared (block));
+    block = block_MakeWritable (block);
+    assert (block != NULL && block->p_buffer == payload);
+
+    block_t *view = block_Share (block);
+    assert (view != NULL);
+    block_Release (view);
+    block = block_Realloc (block, -5, sizeof (text));
+    assert (block != NULL);
+    block = block_Realloc (block, 5, sizeof (text) - 5);
+    assert (block != NULL && block->p_buffer == payload);
+    block_Release (block);
+}
+
 int main (void)
 {
     test_block_File(false);
     test_block_File(true);
     test_block ();
+    test_block_pool ();
+    test_block_pool_drain ();
+    test_block_Share ();
     return 0;
 }
 
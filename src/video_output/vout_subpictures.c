@@ -61,11 +61,38 @@ typedef struct {
     spu_heap_entry_t entry[VOUT_MAX_SUBPICTURES];
 } spu_heap_t;
 
+/* Scaled region cache limits */
+#define SPU_CACHE_ENTRIES  16
+#define SPU_CACHE_MAX_SIZE (64 << 20)
+
+/* */
+typedef struct {
+    uint64_t       hash;        /**< hash of the source pixels and palette */
+    picture_t      *source;     /**< source picture, NULL if the entry is free */
+    video_format_t fmt;         /**< source format, without palette */
+    video_palette_t palette;    /**< source palette, if any */
+    vlc_fourcc_t   chroma;      /**< requested chroma, 0 if kept */
+    unsigned       width;       /**< scaled visible width */
+    unsigned       height;      /**< scaled visible height */
+    picture_t      *picture;    /**< scaled picture */
+    size_t         size;        /**< size of the scaled picture in bytes */
+    uint64_t       last_use;
+} spu_cache_entry_t;
+
+typedef struct {
+    spu_cache_entry_t entry[SPU_CACHE_ENTRIES];
+    size_t   size;
+    uint64_t tick;
+    unsigned hits;
+    unsigned misses;
+} spu_cache_t;
+
 struct spu_private_t {
     vlc_mutex_t  lock;            /* lock to protect all followings fields */
     vlc_object_t *input;
 
     spu_heap_t   heap;
+    spu_cache_t  cache;              /**< scaled regions, shared by all */
 
     int channel;             /**< number of subpicture channels registered */
     filter_t *text;                              /**< text renderer module */
@@ -98,6 +125,182 @@ struct spu_private_t {
     vout_thread_t       *vout;
 };
 
+/*****************************************************************************
+ * scaled region cache
+ *
+ * Each region keeps its own scaled picture in p_private, but it is lost
+ * whenever the region is recreated (a DVB page refresh, a subtitle updater
+ * rebuilding its regions) or when the output size goes back and forth.
+ * This cache keeps the last scaled pictures keyed by the content of the
+ * source region, so identical regions are scaled only once.
+ *****************************************************************************/
+static uint64_t SpuCacheHash(const picture_t *picture,
+                             const video_palette_t *palette)
+{
+    uint64_t hash = UINT64_C(14695981039346656037);
+
+    for (int i = 0; i < picture->i_planes; i++) {
+        const plane_t *p = &picture->p[i];
+
+        for (int y = 0; y < p->i_visible_lines; y++) {
+            const uint8_t *line = &p->p_pixels[y * p->i_pitch];
+
+            for (int x = 0; x < p->i_visible_pitch; x++)
+                hash = (hash ^ line[x]) * UINT64_C(1099511628211);
+        }
+    }
+    if (palette) {
+        const uint8_t *data = &palette->palette[0][0];
+
+        for (int i = 0; i < 4 * palette->i_entries; i++)
+            hash = (hash ^ data[i]) * UINT64_C(1099511628211);
+    }
+    return hash;
+}
+
+static bool SpuCacheIsSameSource(const spu_cache_entry_t *entry,
+                                 const video_format_t *fmt,
+                                 const picture_t *picture)
+{
+    const video_format_t *ref = &entry->fmt;
+
+    if (ref->i_chroma         != fmt->i_chroma ||
+        ref->i_x_offset       != fmt->i_x_offset ||
+        ref->i_y_offset       != fmt->i_y_offset ||
+        ref->i_visible_width  != fmt->i_visible_width ||
+        ref->i_visible_height != fmt->i_visible_height ||
+        ref->transfer         != fmt->transfer ||
+        ref->primaries        != fmt->primaries ||
+        ref->space            != fmt->space ||
+        ref->b_color_range_full != fmt->b_color_range_full)
+        return false;
+
+    if (fmt->p_palette) {
+        if (entry->palette.i_entries != fmt->p_palette->i_entries ||
+            memcmp(entry->palette.palette, fmt->p_palette->palette,
+                   4 * fmt->p_palette->i_entries))
+            return false;
+    }
+
+    /* Do not trust the hash alone */
+    if (entry->source->i_planes != picture->i_planes)
+        return false;
+    for (int i = 0; i < picture->i_planes; i++) {
+        const plane_t *a = &entry->source->p[i];
+        const plane_t *b = &picture->p[i];
+
+        if (a->i_visible_lines != b->i_visible_lines ||
+            a->i_visible_pitch != b->i_visible_pitch)
+            return false;
+        for (int y = 0; y < b->i_visible_lines; y++)
+            if (memcmp(&a->p_pixels[y * a->i_pitch],
+                       &b->p_pixels[y * b->i_pitch], b->i_visible_pitch))
+                return false;
+    }
+    return true;
+}
+
+static void SpuCacheEvict(spu_cache_t *cache, spu_cache_entry_t *entry)
+{
+    if (!entry->source)
+        return;
+    picture_Release(entry->source);
+    picture_Release(entry->picture);
+    cache->size -= entry->size;
+    entry->source  = NULL;
+    entry->picture = NULL;
+}
+
+static void SpuCacheInit(spu_cache_t *cache)
+{
+    for (int i = 0; i < SPU_CACHE_ENTRIES; i++) {
+        cache->entry[i].source  = NULL;
+        cache->entry[i].picture = NULL;
+    }
+    cache->size   = 0;
+    cache->tick   = 0;
+    cache->hits   = 0;
+    cache->misses = 0;
+}
+
+static void SpuCacheClean(spu_cache_t *cache)
+{
+    for (int i = 0; i < SPU_CACHE_ENTRIES; i++)
+        SpuCacheEvict(cache, &cache->entry[i]);
+}
+
+/**
+ * Returns a held scaled picture for the given source, or NULL.
+ */
+static picture_t *SpuCacheGet(spu_cache_t *cache, uint64_t hash,
+                              const video_format_t *fmt,
+                              const picture_t *picture,
+                              vlc_fourcc_t chroma,
+                              unsigned width, unsigned height)
+{
+    for (int i = 0; i < SPU_CACHE_ENTRIES; i++) {
+        spu_cache_entry_t *entry = &cache->entry[i];
+
+        if (!entry->source || entry->hash != hash ||
+            entry->chroma != chroma ||
+            entry->width != width || entry->height != height ||
+            !SpuCacheIsSameSource(entry, fmt, picture))
+            continue;
+
+        entry->last_use = ++cache->tick;
+        cache->hits++;
+        return picture_Hold(entry->picture);
+    }
+    cache->misses++;
+    return NULL;
+}
+
+static void SpuCachePut(spu_cache_t *cache, uint64_t hash,
+                        const video_format_t *fmt, picture_t *source,
+                        vlc_fourcc_t chroma,
+                        unsigned width, unsigned height,
+                        picture_t *picture)
+{
+    size_t size = 0;
+    for (int i = 0; i < picture->i_planes; i++)
+        size += (size_t)picture->p[i].i_pitch * picture->p[i].i_lines;
+    if (size > SPU_CACHE_MAX_SIZE)
+        return;
+
+    /* Evict the least recently used entries until it fits */
+    spu_cache_entry_t *entry;
+    for (;;) {
+        spu_cache_entry_t *lru = NULL;
+
+        entry = NULL;
+        for (int i = 0; i < SPU_CACHE_ENTRIES; i++) {
+            spu_cache_entry_t *e = &cache->entry[i];
+
+            if (!e->source)
+                entry = e;
+            else if (!lru || e->last_use < lru->last_use)
+                lru = e;
+        }
+        if (entry && cache->size + size <= SPU_CACHE_MAX_SIZE)
+            break;
+        SpuCacheEvict(cache, lru);
+    }
+
+    entry->hash     = hash;
+    entry->source   = picture_Hold(source);
+    entry->fmt      = *fmt;
+    entry->fmt.p_palette = NULL;
+    if (fmt->p_palette)
+        entry->palette = *fmt->p_palette;
+    entry->chroma   = chroma;
+    entry->width    = width;
+    entry->height   = height;
+    entry->picture  = picture_Hold(picture);
+    entry->size     = size;
+    entry->last_use = ++cache->tick;
+    cache->size    += size;
+}
+
 /*****************************************************************************
  * heap management
  *****************************************************************************/
@@ -837,6 +1040,27 @@ static void SpuRenderRegion(spu_t *spu,
             }
         }
 
+        /* Look for an identical region scaled previously, unless the
+         * region is rendered again on every frame anyway */
+        const vlc_fourcc_t cache_chroma =
+            using_palette || convert_chroma ? chroma_list[0] : 0;
+        uint64_t cache_hash = 0;
+        picture_t *cached = NULL;
+        if (!region->p_private && dst_width > 0 && dst_height > 0 &&
+            !restore_text) {
+            cache_hash = SpuCacheHash(region->p_picture, region->fmt.p_palette);
+            cached = SpuCacheGet(&sys->cache, cache_hash,
+                                 &region->fmt, region->p_picture,
+                                 cache_chroma, dst_width, dst_height);
+            if (cached) {
+                region->p_private = subpicture_region_private_New(&cached->format);
+                if (region->p_private)
+                    region->p_private->p_picture = cached;
+                else
+                    picture_Release(cached);
+            }
+        }
+
         /* Scale if needed into cache */
         if (!region->p_private && dst_width > 0 && dst_height > 0) {
             filter_t *scale = sys->scale;
@@ -890,6 +1114,10 @@ static void SpuRenderRegion(spu_t *spu,
             }
 
             /* */
+            if (picture && !restore_text)
+                SpuCachePut(&sys->cache, cache_hash,
+                            &region->fmt, region->p_picture,
+                            cache_chroma, dst_width, dst_height, picture);
             if (picture) {
                 region->p_private = subpicture_region_private_New(&picture->format);
                 if (region->p_private) {
@@ -1306,6 +1534,7 @@ spu_t *spu_Create(vlc_object_t *object, vout_thread_t *vout)
     vlc_mutex_init(&sys->lock);
 
     SpuHeapInit(&sys->heap);
+    SpuCacheInit(&sys->cache);
 
     sys->text = NULL;
     sys->scale = NULL;
@@ -1380,6 +1609,10 @@ void spu_Destroy(spu_t *spu)
     /* Destroy all remaining subpictures */
     SpuHeapClean(&sys->heap);
 
+    msg_Dbg(spu, "scaled region cache: %u hits, %u misses",
+            sys->cache.hits, sys->cache.misses);
+    SpuCacheClean(&sys->cache);
+
     vlc_mutex_destroy(&sys->lock);
 
     vlc_object_release(spu);
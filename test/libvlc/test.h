@@ -40,6 +40,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
 #include <unistd.h>
 
 
@@ -72,4 +74,44 @@ static inline void test_init (void)
     setenv( "VLC_PLUGIN_PATH", "../modules", 1 );
 }
 
+/* Instance for the core and module tests: no interface, no configuration
+ * and no media library */
+static inline libvlc_instance_t *test_libvlc_new (void)
+{
+    static const char *argv[] = {
+        "-v", "--ignore-config", "-I", "dummy", "--no-media-library",
+    };
+    libvlc_instance_t *vlc =
+        libvlc_new (sizeof (argv) / sizeof (argv[0]), argv);
+
+    assert (vlc != NULL);
+    return vlc;
+}
+
+/* Pseudo-random numbers (xorshift), the same on every run so that failures
+ * can be reproduced */
+static inline uint32_t test_rand (void)
+{
+    static uint32_t state = 0x12345678;
+
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+#ifdef CLOCK_PROCESS_CPUTIME_ID
+/* CPU time in microseconds, of the whole process with
+ * CLOCK_PROCESS_CPUTIME_ID, or of the calling thread with
+ * CLOCK_THREAD_CPUTIME_ID */
+static inline int64_t test_cputime (clockid_t clock)
+{
+    struct timespec ts;
+
+    if (clock_gettime (clock, &ts))
+        return 0;
+    return INT64_C(1000000) * ts.tv_sec + ts.tv_nsec / 1000;
+}
+#endif
+
 #endif /* TEST_H */
@@ -0,0 +1,153 @@
+/*****************************************************************************
+ * udp.c: UDP access loopback test and benchmark
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#include "../../libvlc/test.h"
+#include "../lib/libvlc_internal.h"
+
+#include <vlc_common.h>
+#include <vlc_access.h>
+#include <vlc_block.h>
+#include <vlc_network.h>
+
+#define PACKETS     5000
+#define PACKET_SIZE (7 * 188)
+#define BURST       32
+#define BITRATE     100000000 /* 100 Mbit/s */
+
+struct sender
+{
+    int fd;
+    unsigned port;
+};
+
+static void *Send(void *data)
+{
+    struct sender *sender = data;
+    uint8_t buf[PACKET_SIZE];
+    mtime_t deadline = mdate();
+
+    for (unsigned i = 0; i < PACKETS; i++)
+    {
+        for (size_t j = 0; j < PACKET_SIZE; j += 188)
+        {
+            buf[j] = 0x47;
+            memset(buf + j + 1, i, 187);
+        }
+        if (send(sender->fd, buf, sizeof (buf), 0) < 0)
+            perror("send");
+        if ((i % BURST) == BURST - 1)
+        {   /* Pace bursts, so as not to overflow the receive buffer */
+            deadline += CLOCK_FREQ * BURST * PACKET_SIZE * 8 / BITRATE;
+            mwait(deadline);
+        }
+    }
+    return NULL;
+}
+
+static void test_udp(unsigned batch, bool gro, unsigned port)
+{
+    char batch_opt[20];
+    const char *argv[8] = {
+        "-v", "--ignore-config", "-I", "dummy", "--no-media-library",
+        "--udp-timeout=1",
+    };
+    int argc = 6;
+
+#ifdef HAVE_RECVMMSG
+    sprintf(batch_opt, "--udp-batch=%u", batch);
+    argv[argc++] = batch_opt;
+#endif
+#ifdef __linux__
+    argv[argc++] = gro ? "--udp-gro" : "--no-udp-gro";
+#endif
+
+    libvlc_instance_t *vlc = libvlc_new(argc, argv);
+    assert(vlc != NULL);
+
+    char url[40];
+    sprintf(url, "udp://@127.0.0.1:%u", port);
+
+    /* Use the bare access, without any stream filter */
+    stream_t *s = vlc_access_NewMRL(VLC_OBJECT(vlc->p_libvlc_int), url);
+    assert(s != NULL);
+
+    struct sender sender = { .port = port };
+    sender.fd = net_ConnectUDP(VLC_OBJECT(vlc->p_libvlc_int), "127.0.0.1", port, -1);
+    assert(sender.fd != -1);
+
+    vlc_thread_t th;
+    if (vlc_clone(&th, Send, &sender, VLC_THREAD_PRIORITY_LOW))
+        abort();
+
+    unsigned packets = 0;
+    size_t bytes = 0;
+    mtime_t start = 0, cpu_start = 0, end = 0, cpu_end = 0;
+
+    while (!vlc_stream_Eof(s))
+    {
+        block_t *block = vlc_stream_ReadBlock(s);
+        if (block == NULL)
+            continue;
+
+        if (packets == 0)
+        {
+            start = mdate();
+            cpu_start = test_cputime(CLOCK_THREAD_CPUTIME_ID);
+        }
+        assert(!(block->i_flags & BLOCK_FLAG_CORRUPTED));
+        assert(block->i_buffer > 0 && block->p_buffer[0] == 0x47);
+        packets++;
+        bytes += block->i_buffer;
+        end = mdate();
+        cpu_end = test_cputime(CLOCK_THREAD_CPUTIME_ID);
+        block_Release(block);
+    }
+
+    vlc_join(th, NULL);
+    net_Close(sender.fd);
+    vlc_stream_Delete(s);
+    libvlc_release(vlc);
+
+    assert(packets > 0);
+    assert(bytes % 188 == 0);
+
+    unsigned datagrams = bytes / PACKET_SIZE;
+    double secs = (end - start) / (double)CLOCK_FREQ;
+    printf("batch %3u%s: %u/%u datagrams in %u blocks, %.0f datagrams/s, "
+           "%.2f us CPU/datagram\n", batch, gro ? " (GRO)" : "", datagrams, PACKETS, packets,
+           secs > 0 ? datagrams / secs : 0.,
+           datagrams ? (cpu_end - cpu_start) / (double)datagrams : 0.);
+}
+
+int main(void)
+{
+    test_init();
+
+    unsigned port = 20000 + (getpid() % 20000);
+
+    test_udp(1, false, port);
+#ifdef HAVE_RECVMMSG
+    test_udp(32, false, port + 1);
+#endif
+#ifdef __linux__
+    test_udp(8, true, port + 2);
+#endif
+    return 0;
+}
@@ -0,0 +1,161 @@
+/*****************************************************************************
+ * bandlimited.c: band-limited resampler polyphase check and benchmark
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#include "../lib/libvlc_internal.h"
+
+#include <math.h>
+#include <string.h>
+
+#include <vlc_common.h>
+#include <vlc_aout.h>
+#include <vlc_filter.h>
+#include <vlc_block.h>
+
+#include "filter.h"
+
+#include "../../libvlc/test.h" /* last, as it enables assert() again */
+
+#define BLOCK_FRAMES 1024
+#define BLOCKS 100
+
+struct output
+{
+    float *samples;
+    size_t count;
+    mtime_t duration;
+};
+
+static const uint32_t layouts[] = {
+    [1] = AOUT_CHAN_CENTER,
+    [2] = AOUT_CHANS_STEREO,
+    [6] = AOUT_CHANS_5_1,
+};
+
+/* A few tones, different for each channel */
+static void Fill(float *p, unsigned rate, unsigned channels, size_t frame)
+{
+    for (unsigned i = 0; i < BLOCK_FRAMES; i++, frame++)
+        for (unsigned j = 0; j < channels; j++)
+        {
+            double t = (double)frame / rate;
+
+            *p++ = .3 * sin(2 * M_PI * 440. * (j + 1) * t)
+                 + .2 * sin(2 * M_PI * 5000. * t + j)
+                 + .1 * sin(2 * M_PI * 15000. * t + 2 * j);
+        }
+}
+
+static void Run(vlc_object_t *obj, unsigned in_rate, unsigned out_rate,
+                unsigned channels, bool polyphase, struct output *out)
+{
+    filter_t *filter = test_audio_filter_New(obj,
+                                             VLC_CODEC_FL32, in_rate,
+                                             layouts[channels],
+                                             VLC_CODEC_FL32, out_rate,
+                                             layouts[channels]);
+    var_Create(filter, "bandlimited-polyphase", VLC_VAR_BOOL);
+    var_SetBool(filter, "bandlimited-polyphase", polyphase);
+    test_audio_filter_Load(filter, "bandlimited");
+
+    size_t max = (size_t)BLOCKS * BLOCK_FRAMES * channels
+               * (out_rate / in_rate + 2);
+    out->samples = malloc(max * sizeof (float));
+    assert(out->samples != NULL);
+    out->count = 0;
+    out->duration = 0;
+
+    for (unsigned i = 0; i < BLOCKS; i++)
+    {
+        block_t *block = block_Alloc(BLOCK_FRAMES * channels * 4);
+        assert(block != NULL);
+        Fill((float *)block->p_buffer, in_rate, channels, i * BLOCK_FRAMES);
+        block->i_nb_samples = BLOCK_FRAMES;
+        block->i_pts = block->i_dts =
+            VLC_TS_0 + (mtime_t)i * BLOCK_FRAMES * CLOCK_FREQ / in_rate;
+
+        mtime_t start = mdate();
+        block = filter->pf_audio_filter(filter, block);
+        out->duration += mdate() - start;
+
+        if (block == NULL)
+            continue;
+        size_t count = block->i_nb_samples * channels;
+        assert(out->count + count <= max);
+        memcpy(out->samples + out->count, block->p_buffer, count * 4);
+        out->count += count;
+        block_Release(block);
+    }
+
+    test_audio_filter_Delete(filter);
+}
+
+static void Test(vlc_object_t *obj, unsigned in_rate, unsigned out_rate,
+                 unsigned channels)
+{
+    struct output ref, poly;
+
+    Run(obj, in_rate, out_rate, channels, false, &ref);
+    Run(obj, in_rate, out_rate, channels, true, &poly);
+
+    /* Same number of samples, same signal up to rounding errors */
+    assert(ref.count == poly.count);
+    assert(ref.count > 0);
+
+    double signal = 0., noise = 0.;
+    for (size_t i = 0; i < ref.count; i++)
+    {
+        double diff = poly.samples[i] - ref.samples[i];
+
+        signal += ref.samples[i] * (double)ref.samples[i];
+        noise += diff * diff;
+    }
+
+    double snr = noise > 0. ? 10. * log10(signal / noise) : INFINITY;
+    double frames = (double)BLOCKS * BLOCK_FRAMES * CLOCK_FREQ / 1e6;
+
+    printf("%6u->%6u Hz, %u ch: %7.2f -> %7.2f Mframes/s, SNR %.1f dB\n",
+           in_rate, out_rate, channels, frames / ref.duration,
+           frames / poly.duration, snr);
+    assert(snr >= 100.);
+
+    free(poly.samples);
+    free(ref.samples);
+}
+
+int main(void)
+{
+    test_init();
+
+    libvlc_instance_t *vlc = test_libvlc_new();
+    vlc_object_t *obj = VLC_OBJECT(vlc->p_libvlc_int);
+
+    static const unsigned rates[][2] = {
+        { 44100, 48000 }, { 48000, 44100 }, { 48000, 96000 },
+        { 96000, 48000 }, { 22050, 48000 }, { 32000, 44100 },
+    };
+    static const unsigned channels[] = { 1, 2, 6 };
+
+    for (size_t i = 0; i < ARRAY_SIZE(rates); i++)
+        for (size_t j = 0; j < ARRAY_SIZE(channels); j++)
+            Test(obj, rates[i][0], rates[i][1], channels[j]);
+
+    libvlc_release(vlc);
+    return 0;
+}
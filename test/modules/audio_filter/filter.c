@@ -0,0 +1,71 @@
+/*****************************************************************************
+ * filter.c: audio filter test helpers
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#undef NDEBUG
+#include <assert.h>
+
+#include <vlc_common.h>
+#include <vlc_modules.h>
+#include <vlc_aout.h>
+
+#include "filter.h"
+
+static void SetAudio(es_format_t *fmt, vlc_fourcc_t format, unsigned rate,
+                     uint32_t chans)
+{
+    es_format_Init(fmt, AUDIO_ES, format);
+    fmt->audio.i_format = format;
+    fmt->audio.i_rate = rate;
+    fmt->audio.i_physical_channels = chans;
+    aout_FormatPrepare(&fmt->audio);
+}
+
+filter_t *test_audio_filter_New(vlc_object_t *obj,
+                                vlc_fourcc_t in, unsigned in_rate,
+                                uint32_t in_chans,
+                                vlc_fourcc_t out, unsigned out_rate,
+                                uint32_t out_chans)
+{
+    filter_t *filter = vlc_object_create(obj, sizeof (*filter));
+    assert(filter != NULL);
+
+    SetAudio(&filter->fmt_in, in, in_rate, in_chans);
+    SetAudio(&filter->fmt_out, out, out_rate, out_chans);
+    return filter;
+}
+
+void test_audio_filter_Load(filter_t *filter, const char *module)
+{
+    filter->p_module = module_need(filter, "audio converter", module, true);
+    assert(filter->p_module != NULL);
+}
+
+void test_audio_filter_Delete(filter_t *filter)
+{
+    if (filter->p_module != NULL)
+        module_unneed(filter, filter->p_module);
+    es_format_Clean(&filter->fmt_in);
+    es_format_Clean(&filter->fmt_out);
+    vlc_object_release(filter);
+}
@@ -0,0 +1,35 @@
+/*****************************************************************************
+ * filter.h: audio filter test helpers
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#include <vlc_common.h>
+#include <vlc_filter.h>
+
+/* Audio filter object from one sample format, rate and channel layout to
+ * another. The caller creates the filter variables, if any, then loads the
+ * module. */
+filter_t *test_audio_filter_New(vlc_object_t *obj,
+                                vlc_fourcc_t in, unsigned in_rate,
+                                uint32_t in_chans,
+                                vlc_fourcc_t out, unsigned out_rate,
+                                uint32_t out_chans);
+/* Loads the given audio converter module, which must succeed */
+void test_audio_filter_Load(filter_t *filter, const char *module);
+/* Unloads the module, if any, and releases the filter */
+void test_audio_filter_Delete(filter_t *filter);
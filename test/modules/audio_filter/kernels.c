@@ -0,0 +1,376 @@
+/*****************************************************************************
+ * kernels.c: audio volume, conversion and downmix check and benchmark
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#include "../lib/libvlc_internal.h"
+
+#include <math.h>
+#include <string.h>
+
+#include <vlc_common.h>
+#include <vlc_modules.h>
+#include <vlc_aout.h>
+#include <vlc_aout_volume.h>
+#include <vlc_filter.h>
+#include <vlc_block.h>
+
+#include "filter.h"
+
+#include "../../libvlc/test.h" /* last, as it enables assert() again */
+
+/* One second of 48 kHz audio per block, plus a few frames for the tails */
+#define FRAMES (48000 + 5)
+#define RUNS 20
+
+static uint32_t seed = 1;
+
+static float Random(void)
+{
+    seed = seed * 1103515245u + 12345u;
+    return (int32_t)seed / 2147483648.f;
+}
+
+/* Random samples in [-1, 1], with some out of range and tricky values */
+static void FillFloat(float *p, size_t count)
+{
+    static const float special[] = {
+        0.f, -0.f, 1.f, -1.f, 1.5f, -1.5f, 1e30f, -1e30f,
+        .5f / 32768.f, -.5f / 32768.f, 1.5f / 32768.f, -2.5f / 32768.f,
+        32767.5f / 32768.f, -32768.5f / 32768.f, 32766.5f / 32768.f,
+        .5f / 2147483648.f, -.5f / 2147483648.f, 1.5f / 2147483648.f,
+        -2.5f / 2147483648.f, 0x1.fffffep-1f, -0x1.fffffep-1f,
+    };
+
+    for (size_t i = 0; i < count; i++)
+        p[i] = Random();
+    for (size_t i = 0; i < ARRAY_SIZE(special) && i < count; i++)
+        p[i * 7 % count] = special[i];
+}
+
+static double Rate(size_t samples, mtime_t duration)
+{
+    return samples * (double)RUNS * CLOCK_FREQ / (duration ? duration : 1)
+           / 1e6;
+}
+
+/*** Volume ***/
+static void TestVolume(vlc_object_t *obj, vlc_fourcc_t format,
+                       unsigned channels)
+{
+    audio_volume_t *vol = vlc_object_create(obj, sizeof (*vol));
+    assert(vol != NULL);
+    vol->format = format;
+    vol->amplify_ramp = NULL;
+
+    module_t *module = module_need(vol, "audio volume", "float_mixer", true);
+    assert(module != NULL);
+
+    size_t count = FRAMES * channels;
+    size_t size = format == VLC_CODEC_FL32 ? 4 : 8;
+    float *ref = malloc(count * sizeof (*ref));
+    block_t *block = block_Alloc(count * size);
+    assert(ref != NULL && block != NULL);
+    block->i_nb_samples = FRAMES;
+
+    /* Gain */
+    FillFloat(ref, count);
+    if (format == VLC_CODEC_FL32)
+        memcpy(block->p_buffer, ref, count * size);
+    else
+        for (size_t i = 0; i < count; i++)
+            ((double *)block->p_buffer)[i] = ref[i];
+
+    vol->amplify(vol, block, .3f);
+    for (size_t i = 0; i < count; i++)
+        if (format == VLC_CODEC_FL32)
+            assert(((float *)block->p_buffer)[i] == ref[i] * .3f);
+        else
+            assert(((double *)block->p_buffer)[i] == ref[i] * (double).3f);
+
+    mtime_t start = mdate();
+    for (unsigned i = 0; i < RUNS; i++)
+        vol->amplify(vol, block, (i & 1) ? 1.25f : .8f);
+    mtime_t gain = mdate() - start;
+
+    /* Ramp */
+    mtime_t ramp = 0;
+    if (vol->amplify_ramp != NULL)
+    {
+        FillFloat(ref, count);
+        if (format == VLC_CODEC_FL32)
+            memcpy(block->p_buffer, ref, count * size);
+        else
+            for (size_t i = 0; i < count; i++)
+                ((double *)block->p_buffer)[i] = ref[i];
+
+        vol->amplify_ramp(vol, block, .2f, .9f);
+        for (size_t i = 0; i < count; i++)
+        {
+            unsigned frame = i / channels;
+            double g = .2 + (.9 - .2) * (frame + 1) / FRAMES;
+            double out = format == VLC_CODEC_FL32
+                       ? ((float *)block->p_buffer)[i]
+                       : ((double *)block->p_buffer)[i];
+            assert(fabs(out - ref[i] * g) <= 1e-6 * fabs(ref[i]) + 1e-30);
+        }
+
+        start = mdate();
+        for (unsigned i = 0; i < RUNS; i++)
+            vol->amplify_ramp(vol, block, (i & 1) ? .8f : 1.25f,
+                              (i & 1) ? 1.25f : .8f);
+        ramp = mdate() - start;
+    }
+
+    printf("volume %4.4s %u ch: gain %8.1f, ramp %8.1f Msamples/s\n",
+           (const char *)&format, channels, Rate(count, gain),
+           ramp ? Rate(count, ramp) : 0.);
+
+    block_Release(block);
+    free(ref);
+    module_unneed(vol, module);
+    vlc_object_release(vol);
+}
+
+/*** Conversions ***/
+static block_t *Run(filter_t *filter, const void *in, size_t size,
+                    unsigned frames, mtime_t *duration)
+{
+    block_t *block = block_Alloc(size);
+    assert(block != NULL);
+    memcpy(block->p_buffer, in, size);
+    block->i_nb_samples = frames;
+
+    mtime_t start = mdate();
+    block = filter->pf_audio_filter(filter, block);
+    *duration += mdate() - start;
+    assert(block != NULL);
+    return block;
+}
+
+static int16_t RefFl32toS16(float f)
+{
+    float s = f * 32768.f;
+    if (s >= 32767.f)
+        return 32767;
+    if (s <= -32768.f)
+        return -32768;
+    return nearbyintf(s); /* round half to even */
+}
+
+static int32_t RefFl32toS32(float f)
+{
+    float s = f * 2147483648.f;
+    if (s >= 2147483647.f)
+        return INT32_MAX;
+    if (s <= -2147483648.f)
+        return INT32_MIN;
+    return lroundf(s);
+}
+
+static void TestConversions(vlc_object_t *obj)
+{
+    const size_t count = FRAMES * 2;
+    float *fl = malloc(count * sizeof (*fl));
+    int16_t *s16 = malloc(count * sizeof (*s16));
+    int32_t *s32 = malloc(count * sizeof (*s32));
+    assert(fl != NULL && s16 != NULL && s32 != NULL);
+
+    FillFloat(fl, count);
+    for (size_t i = 0; i < count; i++)
+    {
+        seed = seed * 1103515245u + 12345u;
+        s32[i] = seed;
+        s16[i] = seed >> 16;
+    }
+    s16[0] = INT16_MIN; s16[1] = INT16_MAX;
+    s32[0] = INT32_MIN; s32[1] = INT32_MAX;
+
+    filter_t *filter;
+    mtime_t duration;
+    block_t *out;
+
+    /* S16 -> FL32 */
+    filter = test_audio_filter_New(obj,
+                                   VLC_CODEC_S16N, 48000, AOUT_CHANS_STEREO,
+                                   VLC_CODEC_FL32, 48000, AOUT_CHANS_STEREO);
+    test_audio_filter_Load(filter, "audio_format");
+    duration = 0;
+    out = Run(filter, s16, count * 2, FRAMES, &duration);
+    assert(out->i_buffer == count * 4);
+    for (size_t i = 0; i < count; i++)
+        assert(((float *)out->p_buffer)[i] == s16[i] / 32768.f);
+    block_Release(out);
+    duration = 0;
+    for (unsigned i = 0; i < RUNS; i++)
+        block_Release(Run(filter, s16, count * 2, FRAMES, &duration));
+    printf("convert s16l->f32l: %8.1f Msamples/s\n", Rate(count, duration));
+    test_audio_filter_Delete(filter);
+
+    /* FL32 -> S16 */
+    filter = test_audio_filter_New(obj,
+                                   VLC_CODEC_FL32, 48000, AOUT_CHANS_STEREO,
+                                   VLC_CODEC_S16N, 48000, AOUT_CHANS_STEREO);
+    test_audio_filter_Load(filter, "audio_format");
+    duration = 0;
+    out = Run(filter, fl, count * 4, FRAMES, &duration);
+    assert(out->i_buffer == count * 2);
+    for (size_t i = 0; i < count; i++)
+        assert(((int16_t *)out->p_buffer)[i] == RefFl32toS16(fl[i]));
+    block_Release(out);
+    duration = 0;
+    for (unsigned i = 0; i < RUNS; i++)
+        block_Release(Run(filter, fl, count * 4, FRAMES, &duration));
+    printf("convert f32l->s16l: %8.1f Msamples/s\n", Rate(count, duration));
+    test_audio_filter_Delete(filter);
+
+    /* S32 -> FL32 */
+    filter = test_audio_filter_New(obj,
+                                   VLC_CODEC_S32N, 48000, AOUT_CHANS_STEREO,
+                                   VLC_CODEC_FL32, 48000, AOUT_CHANS_STEREO);
+    test_audio_filter_Load(filter, "audio_format");
+    duration = 0;
+    out = Run(filter, s32, count * 4, FRAMES, &duration);
+    for (size_t i = 0; i < count; i++)
+        assert(((float *)out->p_buffer)[i] == s32[i] / 2147483648.f);
+    block_Release(out);
+    duration = 0;
+    for (unsigned i = 0; i < RUNS; i++)
+        block_Release(Run(filter, s32, count * 4, FRAMES, &duration));
+    printf("convert s32l->f32l: %8.1f Msamples/s\n", Rate(count, duration));
+    test_audio_filter_Delete(filter);
+
+    /* FL32 -> S32 */
+    filter = test_audio_filter_New(obj,
+                                   VLC_CODEC_FL32, 48000, AOUT_CHANS_STEREO,
+                                   VLC_CODEC_S32N, 48000, AOUT_CHANS_STEREO);
+    test_audio_filter_Load(filter, "audio_format");
+    duration = 0;
+    out = Run(filter, fl, count * 4, FRAMES, &duration);
+    for (size_t i = 0; i < count; i++)
+        assert(((int32_t *)out->p_buffer)[i] == RefFl32toS32(fl[i]));
+    block_Release(out);
+    duration = 0;
+    for (unsigned i = 0; i < RUNS; i++)
+        block_Release(Run(filter, fl, count * 4, FRAMES, &duration));
+    printf("convert f32l->s32l: %8.1f Msamples/s\n", Rate(count, duration));
+    test_audio_filter_Delete(filter);
+
+    free(s32);
+    free(s16);
+    free(fl);
+}
+
+/*** Downmixes ***/
+struct downmix
+{
+    const char *name;
+    uint32_t in, out;
+    void (*ref)(float *, const float *);
+};
+
+static void Ref_5_1_to_2_0(float *out, const float *in)
+{
+    out[0] = in[0] + 0.7071f * (in[4] + in[2]);
+    out[1] = in[1] + 0.7071f * (in[4] + in[3]);
+}
+
+static void Ref_7_1_to_2_0(float *out, const float *in)
+{
+    float ctr = in[6] * 0.7071f;
+    out[0] = ctr + in[0] + in[2] / 4 + in[4] / 4;
+    out[1] = ctr + in[1] + in[3] / 4 + in[5] / 4;
+}
+
+static void Ref_5_1_to_1_0(float *out, const float *in)
+{
+    out[0] = 0.7071f * (in[0] + in[1]) + in[4] + 0.5f * (in[2] + in[3]);
+}
+
+static void Ref_6_1_to_2_0(float *out, const float *in)
+{
+    float ctr = (in[2] + in[5]) * 0.7071f;
+    out[0] = in[0] + in[3] + ctr;
+    out[1] = in[1] + in[4] + ctr;
+}
+
+static const struct downmix downmixes[] = {
+    { "5.1->2.0", AOUT_CHANS_5_1, AOUT_CHANS_2_0, Ref_5_1_to_2_0 },
+    { "7.1->2.0", AOUT_CHANS_7_1, AOUT_CHANS_2_0, Ref_7_1_to_2_0 },
+    { "6.1->2.0", AOUT_CHANS_6_1_MIDDLE, AOUT_CHANS_2_0, Ref_6_1_to_2_0 },
+    { "5.1->1.0", AOUT_CHANS_5_1, AOUT_CHAN_CENTER, Ref_5_1_to_1_0 },
+};
+
+static void TestDownmix(vlc_object_t *obj, const struct downmix *dm)
+{
+    unsigned in_ch = popcount(dm->in), out_ch = popcount(dm->out);
+    size_t count = FRAMES * in_ch;
+    float *in = malloc(count * sizeof (*in));
+    assert(in != NULL);
+
+    for (size_t i = 0; i < count; i++)
+        in[i] = Random();
+
+    filter_t *filter = test_audio_filter_New(obj, VLC_CODEC_FL32, 48000, dm->in,
+                                             VLC_CODEC_FL32, 48000, dm->out);
+    test_audio_filter_Load(filter, "simple_channel_mixer");
+    mtime_t duration = 0;
+    block_t *out = Run(filter, in, count * 4, FRAMES, &duration);
+    assert(out->i_buffer == FRAMES * out_ch * 4);
+
+    for (unsigned i = 0; i < FRAMES; i++)
+    {
+        float ref[2];
+
+        dm->ref(ref, in + i * in_ch);
+        for (unsigned j = 0; j < out_ch; j++)
+            assert(fabsf(((float *)out->p_buffer)[i * out_ch + j] - ref[j])
+                   <= 1e-5f);
+    }
+    block_Release(out);
+
+    duration = 0;
+    for (unsigned i = 0; i < RUNS; i++)
+        block_Release(Run(filter, in, count * 4, FRAMES, &duration));
+    printf("downmix %s: %8.1f Mframes/s\n", dm->name,
+           Rate(FRAMES, duration));
+
+    test_audio_filter_Delete(filter);
+    free(in);
+}
+
+int main(void)
+{
+    test_init();
+
+    libvlc_instance_t *vlc = test_libvlc_new();
+    vlc_object_t *obj = VLC_OBJECT(vlc->p_libvlc_int);
+
+    static const unsigned channels[] = { 1, 2, 6, 8 };
+    for (size_t i = 0; i < ARRAY_SIZE(channels); i++)
+        TestVolume(obj, VLC_CODEC_FL32, channels[i]);
+    TestVolume(obj, VLC_CODEC_FL64, 2);
+
+    TestConversions(obj);
+
+    for (size_t i = 0; i < ARRAY_SIZE(downmixes); i++)
+        TestDownmix(obj, &downmixes[i]);
+
+    libvlc_release(vlc);
+    return 0;
+}
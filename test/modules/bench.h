@@ -0,0 +1,58 @@
+/*****************************************************************************
+ * bench.h: SIMD implementation test helpers
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#include <vlc_common.h>
+#include <vlc_cpu.h>
+
+/* Run time CPU checks, as functions for the tables of implementations */
+static inline bool test_CPU_Any(void)
+{
+    return true;
+}
+
+#if defined (__i386__) || defined (__x86_64__)
+static inline bool test_CPU_SSE2(void)
+{
+    return vlc_CPU_SSE2();
+}
+
+static inline bool test_CPU_AVX2(void)
+{
+    return vlc_CPU_AVX2();
+}
+#endif
+
+/* Calls a function repeatedly for at least the given duration. Returns the
+ * number of calls per second. */
+static inline double test_Throughput(void (*run)(void *), void *opaque,
+                                     mtime_t duration)
+{
+    mtime_t start = mdate(), elapsed;
+    unsigned long count = 0;
+
+    do
+    {
+        run(opaque);
+        count++;
+    }
+    while ((elapsed = mdate() - start) < duration);
+
+    return count * (double)CLOCK_FREQ / elapsed;
+}
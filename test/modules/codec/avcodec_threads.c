@@ -0,0 +1,85 @@
+/*****************************************************************************
+ * avcodec_threads.c: libavcodec decoder threading policy test
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#undef NDEBUG
+#include <assert.h>
+#include <stdio.h>
+
+#include <vlc_common.h>
+
+#include "../modules/codec/avcodec/threads.h"
+
+static const struct
+{
+    int requested;
+    unsigned cpus;
+    unsigned width, height;
+    bool hevc, low_delay, slices;
+    int expected;
+} tests[] = {
+    /* Explicit counts are only capped per codec */
+    {  3,  1,     0,    0, false, false, false,  3 },
+    {  3, 64,  1920, 1080, false,  true, false,  3 },
+    { 40,  4,     0,    0, false, false, false, 16 },
+    { 40,  4,     0,    0,  true, false, false, 32 },
+    /* Files: one more frame thread than CPUs, capped by picture size */
+    {  0,  1,   720,  576, false, false, false,  1 },
+    {  0,  2,   720,  576, false, false, false,  3 },
+    {  0, 16,   720,  576, false, false, false,  4 },
+    {  0, 16,  1024,  576, false, false, false,  4 },
+    {  0, 16,  1920, 1080, false, false, false,  8 },
+    {  0, 16,  2048, 1152, false, false, false,  8 },
+    {  0, 16,  3840, 2160, false, false, false, 16 },
+    {  0, 64,  7680, 4320,  true, false, false, 16 },
+    {  0,  4,  3840, 2160, false, false, false,  5 },
+    /* Unknown size: former caps */
+    {  0, 16,     0,    0, false, false, false,  6 },
+    {  0, 16,     0,    0,  true, false, false, 10 },
+    /* Low delay with slice threads: no extra thread */
+    {  0,  2,  1920, 1080, false,  true,  true,  2 },
+    {  0, 16,  1920, 1080, false,  true,  true,  8 },
+    /* Low delay with frame threads: at most 2 */
+    {  0, 16,  1920, 1080, false,  true, false,  2 },
+    {  0,  1,  1920, 1080, false,  true, false,  1 },
+    /* Hardware decoding asks for one thread */
+    {  1, 16,  3840, 2160,  true, false, false,  1 },
+};
+
+int main(void)
+{
+    for (size_t i = 0; i < ARRAY_SIZE(tests); i++)
+    {
+        int count = ffmpeg_GetThreadCount(tests[i].requested, tests[i].cpus,
+                                          tests[i].width, tests[i].height,
+                                          tests[i].hevc, tests[i].low_delay,
+                                          tests[i].slices);
+        if (count != tests[i].expected)
+        {
+            fprintf(stderr, "test %zu: %d thread(s), expected %d\n", i,
+                    count, tests[i].expected);
+            assert(0);
+        }
+    }
+    return 0;
+}
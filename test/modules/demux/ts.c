@@ -0,0 +1,211 @@
+/*****************************************************************************
+ * ts.c: MPEG-TS demuxer test and benchmark
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#include "../../libvlc/test.h"
+#include "../../src/input/demux-run.h"
+
+#include <vlc_common.h>
+
+#undef NDEBUG /* config.h was included again */
+#include <assert.h>
+
+/* A synthetic full transponder: many programs with many elementary streams
+ * each, and as many PIDs that are not referenced by any program. */
+#define PROGRAMS    16
+#define ES_PER_PMT  12
+#define ORPHANS     200
+#define PACKETS     50000
+#define PSI_PERIOD  1000 /* packets between PAT/PMT repetitions */
+#define PES_PACKETS 8    /* TS packets per PES */
+
+#define PMT_PID(p)   (0x100 + (p))
+#define ES_PID(p, e) (0x200 + (p) * ES_PER_PMT + (e))
+#define ORPHAN_PID(i) (0x1000 + (i))
+
+static uint8_t ts[PACKETS][188];
+static uint8_t cc[8192];
+static unsigned pes_left[8192];
+
+static uint32_t CRC32(const uint8_t *p, size_t len)
+{
+    uint32_t crc = 0xffffffff;
+
+    while (len-- > 0)
+    {
+        crc ^= (uint32_t)*(p++) << 24;
+        for (unsigned i = 0; i < 8; i++)
+            crc = (crc << 1) ^ ((crc & 0x80000000) ? 0x04c11db7 : 0);
+    }
+    return crc;
+}
+
+static uint8_t *Header(uint8_t *pkt, uint16_t pid, bool start)
+{
+    pkt[0] = 0x47;
+    pkt[1] = (start ? 0x40 : 0x00) | (pid >> 8);
+    pkt[2] = pid;
+    pkt[3] = 0x10 | (cc[pid]++ & 0x0f);
+    return pkt + 4;
+}
+
+/* Writes a PSI section, which must fit in a single packet */
+static void Section(uint8_t *pkt, uint16_t pid, uint8_t table_id,
+                    uint16_t ext, const uint8_t *data, size_t len)
+{
+    uint8_t *p = Header(pkt, pid, true);
+    uint8_t *section = p + 1;
+
+    assert(1 + 8 + len + 4 <= 184);
+    memset(p, 0xff, 184);
+    p[0] = 0; /* pointer field */
+    section[0] = table_id;
+    SetWBE(section + 1, 0xb000 | (5 + len + 4));
+    SetWBE(section + 3, ext);
+    section[5] = 0xc1; /* version 0, current */
+    section[6] = 0; /* section number */
+    section[7] = 0; /* last section number */
+    memcpy(section + 8, data, len);
+    SetDWBE(section + 8 + len, CRC32(section, 8 + len));
+}
+
+static void PAT(uint8_t *pkt)
+{
+    uint8_t data[4 * PROGRAMS];
+
+    for (unsigned p = 0; p < PROGRAMS; p++)
+    {
+        SetWBE(data + 4 * p, 1 + p);
+        SetWBE(data + 4 * p + 2, 0xe000 | PMT_PID(p));
+    }
+    Section(pkt, 0, 0x00, 1, data, sizeof (data));
+}
+
+static void PMT(uint8_t *pkt, unsigned p)
+{
+    uint8_t data[4 + 5 * ES_PER_PMT];
+
+    SetWBE(data, 0xe000 | ES_PID(p, 0)); /* PCR PID */
+    SetWBE(data + 2, 0xf000); /* no program descriptors */
+    for (unsigned e = 0; e < ES_PER_PMT; e++)
+    {
+        uint8_t *es = data + 4 + 5 * e;
+
+        es[0] = e ? 0x03 /* MPEG audio */ : 0x02 /* MPEG video */;
+        SetWBE(es + 1, 0xe000 | ES_PID(p, e));
+        SetWBE(es + 3, 0xf000);
+    }
+    Section(pkt, PMT_PID(p), 0x02, 1 + p, data, sizeof (data));
+}
+
+static void PES(uint8_t *pkt, uint16_t pid, unsigned n, bool video, bool pcr)
+{
+    bool start = pes_left[pid] == 0;
+    uint64_t pts = 90000 + (uint64_t)n * 90; /* 1 packet per ms */
+    uint8_t *p = Header(pkt, pid, start);
+    size_t len = 184;
+
+    if (start)
+        pes_left[pid] = PES_PACKETS;
+    pes_left[pid]--;
+
+    if (pcr)
+    {
+        pkt[3] |= 0x20;
+        p[0] = 7; /* adaptation field length */
+        p[1] = 0x10; /* PCR flag */
+        SetDWBE(p + 2, pts >> 1);
+        SetWBE(p + 6, ((pts & 1) << 15) | 0x7e00);
+        p += 8;
+        len -= 8;
+    }
+
+    for (size_t i = 0; i < len; i++)
+        p[i] = test_rand();
+
+    if (start)
+    {
+        p[0] = 0x00;
+        p[1] = 0x00;
+        p[2] = 0x01;
+        p[3] = video ? 0xe0 : 0xc0;
+        SetWBE(p + 4, 0); /* unbounded */
+        p[6] = 0x80;
+        p[7] = 0x80; /* PTS */
+        p[8] = 5;
+        p[9] = 0x21 | ((pts >> 29) & 0x0e);
+        SetWBE(p + 10, ((pts >> 14) & 0xfffe) | 1);
+        SetWBE(p + 12, ((pts << 1) & 0xfffe) | 1);
+    }
+}
+
+static void Generate(void)
+{
+    for (unsigned n = 0; n < PACKETS; n++)
+    {
+        uint8_t *pkt = ts[n];
+        unsigned k = n % PSI_PERIOD;
+
+        if (k == 0)
+            PAT(pkt);
+        else if (k <= PROGRAMS)
+            PMT(pkt, k - 1);
+        else if (test_rand() % 3 == 0)
+        {   /* PID with no program */
+            uint16_t pid = ORPHAN_PID(test_rand() % ORPHANS);
+            uint8_t *p = Header(pkt, pid, false);
+
+            memset(p, 0xff, 184);
+        }
+        else
+        {
+            unsigned p = test_rand() % PROGRAMS;
+            unsigned e = test_rand() % ES_PER_PMT;
+
+            /* the video PID carries the PCR */
+            PES(pkt, ES_PID(p, e), n, e == 0, e == 0);
+        }
+    }
+}
+
+int main(void)
+{
+    test_init();
+
+    struct vlc_run_args args;
+    vlc_run_args_init(&args);
+    args.name = "ts";
+
+    Generate();
+
+    /* Warm up, with the beginning of the stream */
+    int ret = vlc_demux_process_memory(&args, ts[0], 188 * PSI_PERIOD);
+    assert(ret == 0);
+
+    mtime_t start = mdate();
+    ret = vlc_demux_process_memory(&args, ts[0], sizeof (ts));
+    mtime_t d = mdate() - start;
+    assert(ret == 0);
+
+    printf("%d programs, %d PIDs: %.0f packets/s (%.0f Mbit/s)\n", PROGRAMS,
+           2 + PROGRAMS * (1 + ES_PER_PMT) + ORPHANS,
+           PACKETS * (double)CLOCK_FREQ / d,
+           PACKETS * 188 * 8. / d);
+    return 0;
+}
@@ -0,0 +1,118 @@
+/*****************************************************************************
+ * ts_pid.c: MPEG-TS demuxer PID list test and benchmark
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#include "../lib/libvlc_internal.h"
+
+#include <vlc_common.h>
+#include <vlc_demux.h>
+
+#include "../modules/demux/mpeg/ts_pid_list.c"
+
+#include "../../libvlc/test.h" /* last, as it enables assert() again */
+
+/* As many PIDs as a full transponder, see the demuxer test */
+#define PIDS    400
+#define LOOKUPS 10000000
+
+int main(void)
+{
+    test_init();
+
+    libvlc_instance_t *vlc = test_libvlc_new();
+    demux_t *demux = vlc_object_create(vlc->p_libvlc_int, sizeof (*demux));
+    assert(demux != NULL);
+
+    ts_pid_list_t *list = malloc(sizeof (*list));
+    assert(list != NULL);
+    ts_pid_list_Init(list);
+
+    /* Fixed PIDs exist from the start, and the PID is 13 bits */
+    assert(ts_pid_Get(list, 0) == &list->pat);
+    assert(ts_pid_Get(list, 0x1FFB) == &list->base_si);
+    assert(ts_pid_Get(list, 0x1FFF) == &list->dummy);
+    assert(ts_pid_Get(list, 0x2000) == &list->pat);
+    assert(list->i_all == 0);
+
+    /* Created once, in any order */
+    static uint16_t pids[PIDS];
+
+    for (unsigned i = 0; i < PIDS; i++)
+    {
+        uint16_t pid;
+        bool dup;
+
+        do
+        {
+            pid = 0x20 + test_rand() % (0x1FF0 - 0x20);
+            dup = false;
+            for (unsigned j = 0; j < i; j++)
+                dup |= pids[j] == pid;
+        }
+        while (dup);
+        pids[i] = pid;
+
+        ts_pid_t *p_pid = ts_pid_Get(list, pid);
+        assert(p_pid != NULL);
+        assert(p_pid->i_pid == pid);
+        assert(p_pid->i_cc == 0xff);
+        assert(p_pid->type == TYPE_FREE);
+        assert(ts_pid_Get(list, pid) == p_pid);
+        assert(ts_pid_Get(list, pid | 0xE000) == p_pid);
+    }
+    assert(list->i_all == PIDS);
+
+    /* Iterated by increasing PID */
+    ts_pid_next_context_t ctx = ts_pid_NextContextInitValue;
+    unsigned count = 0;
+    int prev = -1;
+
+    for (ts_pid_t *p_pid = ts_pid_Next(list, &ctx); p_pid != NULL;
+         p_pid = ts_pid_Next(list, &ctx))
+    {
+        assert(p_pid->i_pid > prev);
+        assert(ts_pid_Get(list, p_pid->i_pid) == p_pid);
+        prev = p_pid->i_pid;
+        count++;
+    }
+    assert(count == PIDS);
+
+    /* Interleaved lookups, as with a capture of a full transponder */
+    static uint16_t order[4096];
+    unsigned long sum = 0;
+
+    for (unsigned i = 0; i < ARRAY_SIZE(order); i++)
+        order[i] = pids[test_rand() % PIDS];
+
+    mtime_t start = mdate();
+    for (unsigned i = 0; i < LOOKUPS; i++)
+        sum += ts_pid_Get(list, order[i % ARRAY_SIZE(order)])->i_pid;
+    mtime_t d = mdate() - start;
+    assert(sum != 0);
+    assert(list->i_all == PIDS);
+
+    printf("%d PIDs: %.1f Mlookups/s\n", PIDS,
+           LOOKUPS * (double)CLOCK_FREQ / 1e6 / d);
+
+    ts_pid_list_Release(demux, list);
+    free(list);
+    vlc_object_release(demux);
+    libvlc_release(vlc);
+    return 0;
+}
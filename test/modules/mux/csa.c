@@ -0,0 +1,217 @@
+/*****************************************************************************
+ * csa.c: CSA scrambler/descrambler test and benchmark
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#include "../../libvlc/test.h"
+#include "../lib/libvlc_internal.h"
+
+#include <vlc_common.h>
+
+#include "../modules/mux/mpeg/csa.c"
+#include "../bench.h"
+
+#undef NDEBUG /* config.h was included again */
+#include <assert.h>
+
+const char vlc_module_name[] = "test_csa";
+
+#define PACKETS 1000
+
+static const struct
+{
+    const char *name;
+    void (*stream)( const csa_t *, const csa_lane_t *, unsigned );
+    unsigned lanes;
+    bool (*available)(void);
+} impls[] = {
+#define IMPL(name, lanes, cond) \
+    { #name, csa_BsStream_##name, lanes, cond }
+    IMPL(c, 64, NULL),
+#ifdef HAVE_CSA_BS_SSE2
+    IMPL(sse2, 128, test_CPU_SSE2),
+#endif
+#ifdef HAVE_CSA_BS_AVX2
+    IMPL(avx2, 256, test_CPU_AVX2),
+#endif
+#ifdef HAVE_CSA_BS_NEON
+    IMPL(neon, 128, NULL),
+#endif
+};
+
+/* Scrambled with the original byte-wise code, payload bytes 0, 1, 2... */
+static const uint8_t known_even[188] = {
+    0x47, 0x01, 0x00, 0x90, 0x12, 0x7d, 0xeb, 0x94, 0xac, 0x72, 0xa4, 0x53,
+    0x85, 0x44, 0x40, 0x3f, 0x37, 0x0a, 0x8c, 0x79, 0x54, 0x68, 0x5e, 0xf1,
+    0xc5, 0x2f, 0x5f, 0x70, 0x9c, 0xc5, 0xa8, 0xb9, 0x58, 0x1a, 0x4b, 0xec,
+    0x4b, 0xd0, 0x14, 0x8e, 0x65, 0x65, 0x04, 0xdd, 0xf8, 0x2b, 0x9b, 0xe1,
+    0x8e, 0xa8, 0xcd, 0x9d, 0x49, 0xce, 0xbf, 0xca, 0x0f, 0x32, 0xd5, 0x4b,
+    0x40, 0xb1, 0x6f, 0xfb, 0x50, 0x9c, 0x2f, 0x04, 0x48, 0x09, 0xb9, 0x77,
+    0x8d, 0x14, 0xf1, 0x0a, 0x2a, 0xfb, 0x33, 0x85, 0x92, 0x28, 0x0a, 0xfa,
+    0x1d, 0x08, 0x0e, 0x63, 0x49, 0x49, 0x16, 0xdc, 0x59, 0x61, 0x9c, 0xb4,
+    0x23, 0xbb, 0xfb, 0xcd, 0x3f, 0xb0, 0x56, 0xa9, 0x8f, 0x4e, 0x52, 0xd7,
+    0x6d, 0x7d, 0x45, 0xb5, 0x75, 0x3e, 0xa7, 0x1d, 0x80, 0x2a, 0x8c, 0xb3,
+    0x67, 0xb1, 0x03, 0x2f, 0x1b, 0x21, 0xd9, 0xbb, 0xb7, 0x58, 0x0c, 0x6d,
+    0x9d, 0xa7, 0x4f, 0xc0, 0x82, 0x0f, 0xfc, 0x9e, 0xed, 0x91, 0xf0, 0x7d,
+    0xea, 0x04, 0x06, 0x35, 0x7b, 0xc5, 0x2c, 0xc4, 0x7d, 0x62, 0x39, 0x36,
+    0x25, 0x0e, 0x69, 0x31, 0x17, 0xc6, 0x89, 0x16, 0xc6, 0x5b, 0xe8, 0x26,
+    0x1c, 0xb4, 0x8b, 0x54, 0x42, 0x36, 0x02, 0xeb, 0x1c, 0x52, 0x08, 0x83,
+    0x7e, 0x9b, 0x93, 0x0c, 0xdf, 0x61, 0x9f, 0x47
+};
+
+static uint8_t packets[PACKETS][188];
+static uint8_t ref[PACKETS][188];
+static uint8_t out[PACKETS][188];
+static uint8_t *pkts[PACKETS];
+
+static void Generate(void)
+{
+    for (unsigned i = 0; i < PACKETS; i++)
+    {
+        uint8_t *pkt = packets[i];
+
+        for (unsigned j = 0; j < 188; j++)
+            pkt[j] = test_rand();
+        pkt[0] = 0x47;
+        pkt[3] = 0x10 | (pkt[3] & 0x0f);
+
+        /* some packets have an adaptation field, of random length */
+        if (i % 3 == 0)
+        {
+            pkt[3] |= 0x20;
+            pkt[4] = test_rand() % 184;
+        }
+    }
+}
+
+static void Check(int size)
+{
+    for (unsigned i = 0; i < PACKETS; i++)
+        if (memcmp(ref[i], out[i], size))
+        {
+            fprintf(stderr, "packet %u (%d bytes) mismatch\n", i, size);
+            abort();
+        }
+}
+
+static void TestImpl(csa_t *c, int size)
+{
+    /* Scrambling, with the even then the odd key */
+    for (int odd = 0; odd < 2; odd++)
+    {
+        c->use_odd = odd;
+        memcpy(ref, packets, sizeof (ref));
+        memcpy(out, packets, sizeof (out));
+
+        for (unsigned i = 0; i < PACKETS; i++)
+            csa_Encrypt(c, ref[i], size);
+        csa_EncryptBatch(c, pkts, PACKETS, size);
+        Check(size);
+    }
+
+    /* Descrambling, with mixed keys */
+    for (unsigned i = 0; i < PACKETS; i++)
+    {
+        c->use_odd = test_rand() & 1;
+        memcpy(ref[i], packets[i], 188);
+        csa_Encrypt(c, ref[i], size);
+    }
+    memcpy(out, ref, sizeof (out));
+
+    for (unsigned i = 0; i < PACKETS; i++)
+        csa_Decrypt(c, ref[i], size);
+    csa_DecryptBatch(c, pkts, PACKETS, size);
+    Check(size);
+
+    /* Check the round trip (the scrambling control bits are cleared) */
+    for (unsigned i = 0; i < PACKETS; i++)
+    {
+        out[i][3] = packets[i][3];
+        assert(!memcmp(out[i], packets[i], 188));
+    }
+}
+
+static void EncryptEach(void *data)
+{
+    for (unsigned i = 0; i < PACKETS; i++)
+        csa_Encrypt(data, out[i], 188);
+}
+
+static void EncryptBatch(void *data)
+{
+    csa_EncryptBatch(data, pkts, PACKETS, 188);
+}
+
+static double Throughput(csa_t *c, bool batch)
+{
+    memcpy(out, packets, sizeof (out));
+
+    double rate = test_Throughput(batch ? EncryptBatch : EncryptEach, c,
+                                  CLOCK_FREQ / 4);
+    return rate * PACKETS * 188 * 8 / 1000000.; /* Mbit/s */
+}
+
+int main(void)
+{
+    test_init();
+
+    libvlc_instance_t *vlc = test_libvlc_new();
+    vlc_object_t *obj = VLC_OBJECT(vlc->p_libvlc_int);
+
+    csa_t *c = csa_New();
+    assert(c != NULL);
+    int ret = csa_SetCW(obj, c, (char *)"0x0123456789abcdef", false);
+    assert(ret == VLC_SUCCESS);
+    ret = csa_SetCW(obj, c, (char *)"fedcba9876543210", true);
+    assert(ret == VLC_SUCCESS);
+
+    for (unsigned i = 0; i < PACKETS; i++)
+        pkts[i] = out[i];
+
+    /* Known answer of the byte-wise code */
+    uint8_t pkt[188] = { 0x47, 0x01, 0x00, 0x10 };
+    for (unsigned i = 4; i < 188; i++)
+        pkt[i] = i - 4;
+    csa_Encrypt(c, pkt, 188);
+    assert(!memcmp(pkt, known_even, 188));
+
+    Generate();
+    double scalar = Throughput(c, false);
+    printf("byte-wise: %.0f Mbit/s\n", scalar);
+
+    for (size_t i = 0; i < ARRAY_SIZE(impls); i++)
+    {
+        if (impls[i].available != NULL && !impls[i].available())
+            continue;
+
+        c->bs_stream = impls[i].stream;
+        c->bs_lanes = impls[i].lanes;
+
+        TestImpl(c, 188);
+        TestImpl(c, 100);
+        TestImpl(c, 12);
+
+        double rate = Throughput(c, true);
+        printf("bit-sliced %s (%u packets): %.0f Mbit/s (x%.1f)\n",
+               impls[i].name, impls[i].lanes, rate, rate / scalar);
+    }
+
+    csa_Delete(c);
+    libvlc_release(vlc);
+    return 0;
+}
@@ -0,0 +1,216 @@
+/*****************************************************************************
+ * startcode.c: Annex B startcode scanning test and packetizer benchmark
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#include "../lib/libvlc_internal.h"
+
+#include <vlc_common.h>
+#include <vlc_block.h>
+#include <vlc_codec.h>
+#include <vlc_modules.h>
+
+#include "../modules/packetizer/startcode_helper.h"
+#include "../bench.h"
+
+#include "../../libvlc/test.h" /* last, as it enables assert() again */
+
+#define SIZE (1 << 20)
+
+static const struct impl
+{
+    const char *name;
+    const uint8_t *(*find)(const uint8_t *, const uint8_t *);
+    bool (*available)(void);
+} impls[] = {
+    { "c", startcode_FindAnnexB_C, test_CPU_Any },
+#if defined(CAN_COMPILE_SSE2) || defined(HAVE_SSE2_INTRINSICS)
+    { "sse2", startcode_FindAnnexB_SSE2, test_CPU_SSE2 },
+#endif
+#ifdef STARTCODE_HAVE_AVX2
+    { "avx2", startcode_FindAnnexB_AVX2, test_CPU_AVX2 },
+#endif
+#ifdef STARTCODE_HAVE_NEON
+    { "neon", startcode_FindAnnexB_NEON, test_CPU_Any },
+#endif
+};
+
+static uint8_t buf[SIZE + 64];
+
+static const uint8_t *Find(const uint8_t *p, const uint8_t *end)
+{
+    for (; end - p >= 3; p++)
+        if (p[0] == 0 && p[1] == 0 && p[2] == 1)
+            return p;
+    return NULL;
+}
+
+/* Many zeros, startcodes, and almost startcodes */
+static void GenerateWorstCase(void)
+{
+    for (size_t i = 0; i < sizeof (buf); i++)
+    {
+        uint32_t r = test_rand();
+        buf[i] = (r & 3) ? 0 : (r >> 8) & 3;
+    }
+}
+
+/* Annex B stream of NALs from 500 to 8000 bytes, with emulation prevention
+ * bytes like an actual stream */
+static void GenerateStream(void)
+{
+    size_t i = 0;
+
+    while (i < sizeof (buf))
+    {
+        size_t end = i + 500 + test_rand() % 7500;
+        if (end > sizeof (buf))
+            end = sizeof (buf);
+
+        static const uint8_t startcode[] = { 0, 0, 0, 1, 0x21 };
+        for (size_t j = 0; j < sizeof (startcode) && i < end; j++)
+            buf[i++] = startcode[j];
+
+        for (; i < end; i++)
+        {
+            buf[i] = test_rand() >> 8;
+            if (buf[i] <= 3 && buf[i - 1] == 0 && buf[i - 2] == 0)
+                buf[i] = 3;
+        }
+    }
+}
+
+static void Check(const uint8_t *(*find)(const uint8_t *, const uint8_t *),
+                  const uint8_t *p, const uint8_t *end)
+{
+    for (;;)
+    {
+        const uint8_t *ref = Find(p, end);
+        const uint8_t *val = find(p, end);
+
+        if (val != ref)
+        {
+            fprintf(stderr, "startcode at %td instead of %td (%td bytes)\n",
+                    val ? val - p : -1, ref ? ref - p : -1, end - p);
+            abort();
+        }
+        if (ref == NULL)
+            break;
+        p = ref + 1;
+    }
+}
+
+static void TestImpl(const uint8_t *(*find)(const uint8_t *, const uint8_t *))
+{
+    GenerateWorstCase();
+
+    /* All alignments and short lengths */
+    for (size_t offset = 0; offset < 64; offset++)
+        for (size_t len = 0; len < 200; len++)
+            Check(find, buf + offset, buf + offset + len);
+
+    Check(find, buf, buf + SIZE);
+    Check(find, buf + 1, buf + SIZE + 63);
+}
+
+static void FindAll(void *data)
+{
+    const struct impl *impl = data;
+    const uint8_t *p = buf, *end = buf + SIZE;
+
+    while ((p = impl->find(p, end)) != NULL)
+        p += 3;
+}
+
+static double Throughput(const struct impl *impl)
+{
+    double rate = test_Throughput(FindAll, (void *)impl, CLOCK_FREQ / 10);
+    return rate * SIZE / 1000000.; /* MB/s */
+}
+
+static void Packetize(vlc_object_t *obj, vlc_fourcc_t codec)
+{
+    decoder_t *dec = vlc_object_create(obj, sizeof (*dec));
+    assert(dec != NULL);
+
+    es_format_Init(&dec->fmt_in, VIDEO_ES, codec);
+    es_format_Init(&dec->fmt_out, VIDEO_ES, 0);
+    dec->p_module = module_need(dec, "packetizer", NULL, false);
+    if (dec->p_module == NULL)
+    {
+        fprintf(stderr, "no packetizer for %4.4s\n", (const char *)&codec);
+        vlc_object_release(dec);
+        return;
+    }
+
+    mtime_t start = mdate();
+    size_t bytes = 0;
+
+    do
+    {
+        for (size_t pos = 0; pos < SIZE; pos += 65536)
+        {
+            block_t *block = block_Alloc(65536);
+            assert(block != NULL);
+            memcpy(block->p_buffer, buf + pos, 65536);
+            block->i_dts = block->i_pts = VLC_TS_0 + pos;
+
+            block_t *out;
+            while ((out = dec->pf_packetize(dec, &block)) != NULL)
+                block_ChainRelease(out);
+        }
+        bytes += SIZE;
+    }
+    while (mdate() - start < CLOCK_FREQ / 10);
+
+    printf("%4.4s packetizer: %.0f MB/s\n", (const char *)&codec,
+           bytes / (double)(mdate() - start));
+
+    module_unneed(dec, dec->p_module);
+    es_format_Clean(&dec->fmt_in);
+    es_format_Clean(&dec->fmt_out);
+    vlc_object_release(dec);
+}
+
+int main(void)
+{
+    test_init();
+
+    for (size_t i = 0; i < ARRAY_SIZE(impls); i++)
+    {
+        if (!impls[i].available())
+            continue;
+
+        TestImpl(impls[i].find);
+        GenerateStream();
+        printf("%s: %.0f MB/s\n", impls[i].name,
+               Throughput(&impls[i]));
+    }
+
+    /* The packetizers use the best implementation */
+    libvlc_instance_t *vlc = test_libvlc_new();
+    vlc_object_t *obj = VLC_OBJECT(vlc->p_libvlc_int);
+
+    GenerateStream();
+    Packetize(obj, VLC_CODEC_H264);
+    Packetize(obj, VLC_CODEC_HEVC);
+    Packetize(obj, VLC_CODEC_MPGV);
+
+    libvlc_release(vlc);
+    return 0;
+}
@@ -0,0 +1,322 @@
+/*****************************************************************************
+ * duplicate.c: duplicate stream output test
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#include "../lib/libvlc_internal.h"
+
+#include <vlc_common.h>
+#include <vlc_block.h>
+#include <vlc_es.h>
+#include <vlc_sout.h>
+
+#include "sout.h"
+
+#include "../../libvlc/test.h" /* last, as it enables assert() again */
+
+#define BLOCKS     100
+#define KEY_PERIOD 10
+#define SIZE       1000
+#define KEY_SIZE   2000 /* tells key frames apart in the sink */
+#define PERIOD     (2 * CLOCK_FREQ / 1000)  /* between blocks */
+#define SLOW_DELAY (8 * CLOCK_FREQ / 1000)  /* per block in the slow sink */
+#define GATED      8
+#define SAMPLES    1024
+#define SAMPLE     0x1000
+
+/* smem output, with a configurable processing time */
+struct sink
+{
+    mtime_t delay;
+    vlc_sem_t *gate;    /* waited for each block, if set */
+    unsigned received;
+    unsigned keys;
+    mtime_t max_latency;
+    uint8_t buf[KEY_SIZE];
+};
+
+static void Prerender(void *data, uint8_t **pp, size_t size)
+{
+    struct sink *sink = data;
+
+    assert(size <= sizeof (sink->buf));
+    if (sink->delay)
+        msleep(sink->delay);
+    if (sink->gate != NULL)
+        vlc_sem_wait(sink->gate);
+    *pp = sink->buf;
+}
+
+static void Postrender(void *data, uint8_t *p, int width, int height,
+                       int bpp, size_t size, mtime_t pts)
+{
+    struct sink *sink = data;
+    mtime_t latency = mdate() - pts;
+
+    (void) p; (void) width; (void) height; (void) bpp;
+    sink->received++;
+    if (size == KEY_SIZE)
+        sink->keys++;
+    if (latency > sink->max_latency)
+        sink->max_latency = latency;
+}
+
+/* Sends paced blocks through a slow and a fast output */
+static void Run(vlc_object_t *obj, const char *opts,
+                struct sink *slow, struct sink *fast)
+{
+    memset(slow, 0, sizeof (*slow));
+    memset(fast, 0, sizeof (*fast));
+    slow->delay = SLOW_DELAY;
+
+    sout_instance_t *sout = test_sout_New(obj);
+    char *slow_chain = test_sout_Smem(Prerender, Postrender, slow);
+    char *fast_chain = test_sout_Smem(Prerender, Postrender, fast);
+    char *chain;
+    if (asprintf(&chain, "duplicate{%sdst=%s,dst=%s}", opts,
+                 slow_chain, fast_chain) < 0)
+        abort();
+    free(slow_chain);
+    free(fast_chain);
+
+    sout_stream_t *stream = sout_StreamChainNew(sout, chain, NULL, NULL);
+    assert(stream != NULL);
+    free(chain);
+
+    es_format_t fmt;
+    es_format_Init(&fmt, VIDEO_ES, VLC_CODEC_H264);
+    sout_stream_id_sys_t *id = sout_StreamIdAdd(stream, &fmt);
+    assert(id != NULL);
+
+    mtime_t deadline = mdate(), max_stall = 0;
+
+    for (unsigned i = 0; i < BLOCKS; i++)
+    {
+        bool key = (i % KEY_PERIOD) == 0;
+        block_t *block = block_Alloc(key ? KEY_SIZE : SIZE);
+        assert(block != NULL);
+
+        if (key)
+            block->i_flags |= BLOCK_FLAG_TYPE_I;
+        mtime_t now = mdate();
+        block->i_dts = block->i_pts = now;
+        sout_StreamIdSend(stream, id, block);
+
+        mtime_t stall = mdate() - now;
+        if (stall > max_stall)
+            max_stall = stall;
+
+        deadline += PERIOD;
+        mwait(deadline);
+    }
+
+    sout_StreamIdDel(stream, id);
+    sout_StreamChainDelete(stream, NULL);
+    es_format_Clean(&fmt);
+    test_sout_Delete(sout);
+
+    printf("duplicate{%s}: slow output %3u blocks, fast output %3u blocks, "
+           "%5.1f ms max latency, caller stalled up to %5.1f ms\n",
+           opts, slow->received, fast->received,
+           fast->max_latency / 1000., max_stall / 1000.);
+}
+
+/* Deleting an ES must not wait for a stuck output, and closing must not
+ * lose what is queued for it */
+static void RunGated(vlc_object_t *obj)
+{
+    struct sink gated = { .gate = NULL }, fast = { .gate = NULL };
+    vlc_sem_t gate;
+
+    vlc_sem_init(&gate, 0);
+    gated.gate = &gate;
+
+    sout_instance_t *sout = test_sout_New(obj);
+    char *gated_chain = test_sout_Smem(Prerender, Postrender, &gated);
+    char *fast_chain = test_sout_Smem(Prerender, Postrender, &fast);
+    char *chain;
+    if (asprintf(&chain, "duplicate{threads,queue=16,overflow=block,"
+                 "dst=%s,dst=%s}", gated_chain, fast_chain) < 0)
+        abort();
+    free(gated_chain);
+    free(fast_chain);
+
+    sout_stream_t *stream = sout_StreamChainNew(sout, chain, NULL, NULL);
+    assert(stream != NULL);
+    free(chain);
+
+    es_format_t fmt;
+    es_format_Init(&fmt, VIDEO_ES, VLC_CODEC_H264);
+    sout_stream_id_sys_t *id = sout_StreamIdAdd(stream, &fmt);
+    assert(id != NULL);
+
+    for (unsigned i = 0; i < GATED; i++)
+    {
+        block_t *block = block_Alloc(SIZE);
+        assert(block != NULL);
+
+        block->i_dts = block->i_pts = mdate();
+        sout_StreamIdSend(stream, id, block);
+    }
+
+    /* Returns with the gated output still stuck on the first block */
+    sout_StreamIdDel(stream, id);
+
+    for (unsigned i = 0; i < GATED; i++)
+        vlc_sem_post(&gate);
+    sout_StreamChainDelete(stream, NULL);
+    es_format_Clean(&fmt);
+    test_sout_Delete(sout);
+    vlc_sem_destroy(&gate);
+
+    printf("duplicate{threads,gated}: gated output %3u blocks, "
+           "fast output %3u blocks\n", gated.received, fast.received);
+    assert(fast.received == GATED);
+    assert(gated.received == GATED);
+}
+
+/* smem audio output, checking the samples */
+struct pcm_sink
+{
+    int16_t expected;
+    unsigned received;
+    bool intact;
+    int16_t buf[SAMPLES];
+};
+
+static void PrerenderAudio(void *data, uint8_t **pp, size_t size)
+{
+    struct pcm_sink *sink = data;
+
+    assert(size <= sizeof (sink->buf));
+    *pp = (uint8_t *)sink->buf;
+}
+
+static void PostrenderAudio(void *data, uint8_t *p, unsigned channels,
+                            unsigned rate, unsigned samples, unsigned bits,
+                            size_t size, mtime_t pts)
+{
+    struct pcm_sink *sink = data;
+    const int16_t *pcm = (const int16_t *)p;
+
+    (void) channels; (void) rate; (void) bits; (void) size; (void) pts;
+    sink->received++;
+    for (unsigned i = 0; i < samples; i++)
+        if (pcm[i] != sink->expected)
+            sink->intact = false;
+}
+
+/* A branch modifying the samples must not affect the other branches */
+static void RunWritable(vlc_object_t *obj)
+{
+    struct pcm_sink gained = { .expected = 2 * SAMPLE, .intact = true };
+    struct pcm_sink plain = { .expected = SAMPLE, .intact = true };
+
+    sout_instance_t *sout = test_sout_New(obj);
+    char *gained_chain = test_sout_SmemAudio(PrerenderAudio, PostrenderAudio,
+                                             &gained);
+    char *plain_chain = test_sout_SmemAudio(PrerenderAudio, PostrenderAudio,
+                                            &plain);
+    char *chain;
+    if (asprintf(&chain, "duplicate{dst=\"transcode{acodec=s16l,"
+                 "afilter=gain}:%s\",dst=%s}", gained_chain, plain_chain) < 0)
+        abort();
+    free(gained_chain);
+    free(plain_chain);
+
+    sout_stream_t *stream = sout_StreamChainNew(sout, chain, NULL, NULL);
+    assert(stream != NULL);
+    free(chain);
+
+    es_format_t fmt;
+    es_format_Init(&fmt, AUDIO_ES, VLC_CODEC_S16N);
+    fmt.audio.i_format = VLC_CODEC_S16N;
+    fmt.audio.i_rate = 48000;
+    fmt.audio.i_channels = 1;
+    fmt.audio.i_physical_channels = AOUT_CHAN_CENTER;
+    fmt.audio.i_bitspersample = 16;
+    sout_stream_id_sys_t *id = sout_StreamIdAdd(stream, &fmt);
+    assert(id != NULL);
+
+    for (unsigned i = 0; i < BLOCKS; i++)
+    {
+        block_t *block = block_Alloc(SAMPLES * sizeof (int16_t));
+        assert(block != NULL);
+
+        for (unsigned j = 0; j < SAMPLES; j++)
+            ((int16_t *)block->p_buffer)[j] = SAMPLE;
+        block->i_nb_samples = SAMPLES;
+        block->i_dts = block->i_pts = VLC_TS_0 + i * SAMPLES * CLOCK_FREQ
+                                                 / 48000;
+        block->i_length = SAMPLES * CLOCK_FREQ / 48000;
+        sout_StreamIdSend(stream, id, block);
+    }
+
+    sout_StreamIdDel(stream, id);
+    sout_StreamChainDelete(stream, NULL);
+    es_format_Clean(&fmt);
+    test_sout_Delete(sout);
+
+    printf("duplicate{transcode,std}: gained output %3u blocks, "
+           "plain output %3u blocks\n", gained.received, plain.received);
+    assert(gained.received > 0);
+    assert(gained.intact);
+    assert(plain.received == BLOCKS);
+    assert(plain.intact);
+}
+
+int main(void)
+{
+    test_init();
+
+    libvlc_instance_t *vlc = test_libvlc_new();
+    vlc_object_t *obj = VLC_OBJECT(vlc->p_libvlc_int);
+    struct sink slow, fast;
+
+    /* Synchronous: the slow output paces all outputs */
+    Run(obj, "", &slow, &fast);
+    assert(slow.received == BLOCKS);
+    assert(fast.received == BLOCKS);
+
+    /* The slow output loses frames, but not key frames */
+    Run(obj, "threads,queue=16,overflow=drop,", &slow, &fast);
+    assert(fast.received == BLOCKS);
+    assert(slow.received < BLOCKS);
+    assert(slow.keys == BLOCKS / KEY_PERIOD);
+
+    /* The slow output gets everything, eventually */
+    Run(obj, "threads,queue=16,overflow=block,", &slow, &fast);
+    assert(fast.received == BLOCKS);
+    assert(slow.received == BLOCKS);
+
+    /* The slow output is cut off */
+    Run(obj, "threads,queue=16,overflow=disconnect,", &slow, &fast);
+    assert(fast.received == BLOCKS);
+    assert(slow.received < BLOCKS);
+
+    /* ES deletion does not wait, closing flushes */
+    RunGated(obj);
+
+    /* Branches writing to the shared payload */
+    var_Create(obj, "gain-value", VLC_VAR_FLOAT);
+    var_SetFloat(obj, "gain-value", 2.f);
+    RunWritable(obj);
+
+    libvlc_release(vlc);
+    return 0;
+}
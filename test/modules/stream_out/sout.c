@@ -0,0 +1,79 @@
+/*****************************************************************************
+ * sout.c: stream output test helpers
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#undef NDEBUG
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "sout.h"
+
+sout_instance_t *test_sout_New(vlc_object_t *obj)
+{
+    sout_instance_t *sout = vlc_object_create(obj, sizeof (*sout));
+    assert(sout != NULL);
+    sout->psz_sout = NULL;
+    sout->i_out_pace_nocontrol = 0;
+    vlc_mutex_init(&sout->lock);
+    return sout;
+}
+
+void test_sout_Delete(sout_instance_t *sout)
+{
+    vlc_mutex_destroy(&sout->lock);
+    vlc_object_release(sout);
+}
+
+char *test_sout_Smem(void (*prerender)(void *, uint8_t **, size_t),
+                     void (*postrender)(void *, uint8_t *, int, int, int,
+                                        size_t, mtime_t),
+                     void *data)
+{
+    char *str;
+
+    if (asprintf(&str, "smem{video-prerender-callback=%"PRIdPTR","
+                 "video-postrender-callback=%"PRIdPTR","
+                 "video-data=%"PRIdPTR",time-sync=0}",
+                 (intptr_t)prerender, (intptr_t)postrender,
+                 (intptr_t)data) < 0)
+        abort();
+    return str;
+}
+
+char *test_sout_SmemAudio(void (*prerender)(void *, uint8_t **, size_t),
+                          void (*postrender)(void *, uint8_t *, unsigned,
+                                             unsigned, unsigned, unsigned,
+                                             size_t, mtime_t),
+                          void *data)
+{
+    char *str;
+
+    if (asprintf(&str, "smem{audio-prerender-callback=%"PRIdPTR","
+                 "audio-postrender-callback=%"PRIdPTR","
+                 "audio-data=%"PRIdPTR",time-sync=0}",
+                 (intptr_t)prerender, (intptr_t)postrender,
+                 (intptr_t)data) < 0)
+        abort();
+    return str;
+}
@@ -0,0 +1,39 @@
+/*****************************************************************************
+ * sout.h: stream output test helpers
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#include <vlc_common.h>
+#include <vlc_sout.h>
+
+/* Stream output instance to hang stream chains on, without a mux */
+sout_instance_t *test_sout_New(vlc_object_t *obj);
+void test_sout_Delete(sout_instance_t *sout);
+
+/* smem stream chain calling back into the test for each video block */
+char *test_sout_Smem(void (*prerender)(void *, uint8_t **, size_t),
+                     void (*postrender)(void *, uint8_t *, int, int, int,
+                                        size_t, mtime_t),
+                     void *data);
+
+/* smem stream chain calling back into the test for each audio block */
+char *test_sout_SmemAudio(void (*prerender)(void *, uint8_t **, size_t),
+                          void (*postrender)(void *, uint8_t *, unsigned,
+                                             unsigned, unsigned, unsigned,
+                                             size_t, mtime_t),
+                          void *data);
@@ -0,0 +1,143 @@
+/*****************************************************************************
+ * transcode.c: video transcoding pipeline test
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#include "../lib/libvlc_internal.h"
+
+#include <vlc_common.h>
+#include <vlc_block.h>
+#include <vlc_es.h>
+#include <vlc_sout.h>
+
+#include "sout.h"
+
+#include "../../libvlc/test.h" /* last, as it enables assert() again */
+
+#define FRAMES 50
+#define WIDTH  640
+#define HEIGHT 360
+#define PERIOD (CLOCK_FREQ / 25)
+
+/* smem output, checking the encoded pictures */
+struct sink
+{
+    unsigned received;
+    mtime_t last_pts;
+    bool ordered;
+    uint8_t buf[WIDTH * HEIGHT * 3 / 2];
+};
+
+static void Prerender(void *data, uint8_t **pp, size_t size)
+{
+    struct sink *sink = data;
+
+    assert(size <= sizeof (sink->buf));
+    *pp = sink->buf;
+}
+
+static void Postrender(void *data, uint8_t *p, int width, int height,
+                       int bpp, size_t size, mtime_t pts)
+{
+    struct sink *sink = data;
+
+    (void) p; (void) width; (void) height; (void) bpp;
+    assert(size > 0);
+    if (sink->received > 0 && pts <= sink->last_pts)
+        sink->ordered = false;
+    sink->last_pts = pts;
+    sink->received++;
+}
+
+static void Run(vlc_object_t *obj, vlc_fourcc_t chroma, const char *opts,
+                unsigned threads, unsigned filter_threads)
+{
+    struct sink *sink = calloc(1, sizeof (*sink));
+    assert(sink != NULL);
+    sink->ordered = true;
+
+    sout_instance_t *sout = test_sout_New(obj);
+    char *smem = test_sout_Smem(Prerender, Postrender, sink), *chain;
+    if (asprintf(&chain, "transcode{vcodec=jpeg,%s"
+                 "threads=%u,filter-threads=%u}:%s",
+                 opts, threads, filter_threads, smem) < 0)
+        abort();
+    free(smem);
+
+    sout_stream_t *stream = sout_StreamChainNew(sout, chain, NULL, NULL);
+    assert(stream != NULL);
+    free(chain);
+
+    es_format_t fmt;
+    es_format_Init(&fmt, VIDEO_ES, chroma);
+    fmt.video.i_chroma = chroma;
+    fmt.video.i_width = fmt.video.i_visible_width = WIDTH;
+    fmt.video.i_height = fmt.video.i_visible_height = HEIGHT;
+    fmt.video.i_sar_num = fmt.video.i_sar_den = 1;
+    fmt.video.i_frame_rate = 25;
+    fmt.video.i_frame_rate_base = 1;
+    sout_stream_id_sys_t *id = sout_StreamIdAdd(stream, &fmt);
+    assert(id != NULL);
+
+    size_t size = (chroma == VLC_CODEC_J422) ? WIDTH * HEIGHT * 2
+                                             : WIDTH * HEIGHT * 3 / 2;
+    mtime_t start = mdate();
+
+    for (unsigned i = 0; i < FRAMES; i++)
+    {
+        block_t *block = block_Alloc(size);
+        assert(block != NULL);
+
+        for (size_t j = 0; j < block->i_buffer; j++)
+            block->p_buffer[j] = (i + j) & 0xff;
+        block->i_dts = block->i_pts = VLC_TS_0 + i * PERIOD;
+        block->i_length = PERIOD;
+        sout_StreamIdSend(stream, id, block);
+    }
+
+    sout_StreamIdDel(stream, id);
+    sout_StreamChainDelete(stream, NULL);
+    es_format_Clean(&fmt);
+    test_sout_Delete(sout);
+
+    printf("%sthreads=%u,filter-threads=%u: %u pictures in %.1f ms\n",
+           opts, threads, filter_threads, sink->received,
+           (mdate() - start) / 1000.);
+    assert(sink->received == FRAMES);
+    assert(sink->ordered);
+    free(sink);
+}
+
+int main(void)
+{
+    test_init();
+
+    libvlc_instance_t *vlc = test_libvlc_new();
+    vlc_object_t *obj = VLC_OBJECT(vlc->p_libvlc_int);
+
+    Run(obj, VLC_CODEC_J420, "vfilter=gradient,", 0, 0); /* synchronous */
+    Run(obj, VLC_CODEC_J420, "vfilter=gradient,", 1, 0); /* encoder thread */
+    Run(obj, VLC_CODEC_J420, "vfilter=gradient,", 0, 1); /* filter thread */
+    /* user filters may keep state across pictures: forced to one thread */
+    Run(obj, VLC_CODEC_J420, "vfilter=gradient,", 1, 3);
+    /* chroma conversion only: filter threads */
+    Run(obj, VLC_CODEC_J422, "", 1, 3);
+
+    libvlc_release(vlc);
+    return 0;
+}
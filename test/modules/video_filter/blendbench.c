@@ -0,0 +1,112 @@
+/*****************************************************************************
+ * blendbench.c: optimized blending check and benchmark
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#include "../lib/libvlc_internal.h"
+
+#include <vlc_common.h>
+#include <vlc_modules.h>
+#include <vlc_filter.h>
+#include <vlc_picture.h>
+
+#include "../../libvlc/test.h" /* last, as it enables assert() again */
+
+static const vlc_fourcc_t sources[] = {
+    VLC_CODEC_YUVA, VLC_CODEC_RGBA,
+};
+
+static const vlc_fourcc_t destinations[] = {
+    VLC_CODEC_I420, VLC_CODEC_YV12, VLC_CODEC_NV12, VLC_CODEC_NV21,
+    VLC_CODEC_RGB32,
+    /* Not optimized */
+    VLC_CODEC_I422, VLC_CODEC_YUYV,
+};
+
+/* Runs the blendbench filter on one picture: it checks the optimized
+ * blending against the generic one, and drops the picture on mismatch */
+static void Run(vlc_object_t *obj, vlc_fourcc_t src, vlc_fourcc_t dst,
+                unsigned width, unsigned height, int alpha, int loops)
+{
+    filter_t *filter = vlc_object_create(obj, sizeof (*filter));
+    assert(filter != NULL);
+
+    char src_chroma[5], dst_chroma[5];
+    vlc_fourcc_to_char(src, src_chroma);
+    vlc_fourcc_to_char(dst, dst_chroma);
+    src_chroma[4] = dst_chroma[4] = '\0';
+
+    var_Create(filter, "blendbench-blend-chroma", VLC_VAR_STRING);
+    var_SetString(filter, "blendbench-blend-chroma", src_chroma);
+    var_Create(filter, "blendbench-base-chroma", VLC_VAR_STRING);
+    var_SetString(filter, "blendbench-base-chroma", dst_chroma);
+    var_Create(filter, "blendbench-width", VLC_VAR_INTEGER);
+    var_SetInteger(filter, "blendbench-width", width);
+    var_Create(filter, "blendbench-height", VLC_VAR_INTEGER);
+    var_SetInteger(filter, "blendbench-height", height);
+    var_Create(filter, "blendbench-alpha", VLC_VAR_INTEGER);
+    var_SetInteger(filter, "blendbench-alpha", alpha);
+    var_Create(filter, "blendbench-loops", VLC_VAR_INTEGER);
+    var_SetInteger(filter, "blendbench-loops", loops);
+
+    es_format_Init(&filter->fmt_in, VIDEO_ES, VLC_CODEC_I420);
+    video_format_Setup(&filter->fmt_in.video, VLC_CODEC_I420,
+                       16, 16, 16, 16, 1, 1);
+    es_format_Copy(&filter->fmt_out, &filter->fmt_in);
+
+    filter->p_module = module_need(filter, "video filter", "blendbench", true);
+    assert(filter->p_module != NULL);
+
+    picture_t *pic = picture_NewFromFormat(&filter->fmt_in.video);
+    assert(pic != NULL);
+    mtime_t start = mdate();
+    pic = filter->pf_video_filter(filter, pic);
+    mtime_t time = mdate() - start;
+    assert(pic != NULL);
+    picture_Release(pic);
+
+    if (loops > 1)
+        printf("%s -> %s %ux%u: %6.2f ms for %d generic and optimized "
+               "blendings\n", src_chroma, dst_chroma, width, height,
+               time / 1000., loops);
+
+    module_unneed(filter, filter->p_module);
+    es_format_Clean(&filter->fmt_in);
+    es_format_Clean(&filter->fmt_out);
+    vlc_object_release(filter);
+}
+
+int main(void)
+{
+    test_init();
+
+    libvlc_instance_t *vlc = test_libvlc_new();
+    vlc_object_t *obj = VLC_OBJECT(vlc->p_libvlc_int);
+
+    for (size_t i = 0; i < ARRAY_SIZE(sources); i++)
+        for (size_t j = 0; j < ARRAY_SIZE(destinations); j++)
+        {
+            /* Odd sizes and partial opacity, for the tails */
+            Run(obj, sources[i], destinations[j], 83, 29, 255, 1);
+            Run(obj, sources[i], destinations[j], 83, 29, 77, 1);
+            Run(obj, sources[i], destinations[j], 1920, 1080, 255, 4);
+        }
+
+    libvlc_release(vlc);
+    return 0;
+}
@@ -0,0 +1,116 @@
+/*****************************************************************************
+ * deinterlace.c: deinterlace SIMD routines test and benchmark
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#include "../lib/libvlc_internal.h"
+
+#include <vlc_common.h>
+#include <vlc_cpu.h>
+#include <vlc_modules.h>
+#include <vlc_filter.h>
+#include <vlc_picture.h>
+
+#include "filter.h"
+
+#include "../../libvlc/test.h" /* last, as it enables assert() again */
+
+#define FRAMES 4
+
+struct test
+{
+    const char *mode;
+    vlc_fourcc_t chroma;
+    bool merge; /* uses the merge routine rather than Yadif */
+};
+
+static const struct test tests[] = {
+    { "linear",  VLC_CODEC_I420,     true },
+    { "mean",    VLC_CODEC_I420,     true },
+    { "blend",   VLC_CODEC_I420,     true },
+    { "linear",  VLC_CODEC_I420_10L, true },
+    { "blend",   VLC_CODEC_I420_10L, true },
+    { "yadif",   VLC_CODEC_I420,     false },
+    { "yadif2x", VLC_CODEC_I420,     false },
+};
+
+/* Deinterlaces FRAMES pictures, returns the time spent in the filter */
+static mtime_t Run(vlc_object_t *obj, const struct test *test,
+                   unsigned width, unsigned height, bool simd,
+                   uint32_t sums[FRAMES])
+{
+    filter_t *filter = test_filter_New(obj, test->chroma, width, height);
+
+    var_Create(filter, "sout-deinterlace-mode", VLC_VAR_STRING);
+    var_SetString(filter, "sout-deinterlace-mode", test->mode);
+    var_Create(filter, "sout-deinterlace-simd", VLC_VAR_BOOL);
+    var_SetBool(filter, "sout-deinterlace-simd", simd);
+    filter->b_allow_fmt_out_change = true; /* mean halves the height */
+
+    filter->p_module = module_need(filter, "video filter", "deinterlace",
+                                   true);
+    assert(filter->p_module != NULL);
+
+    mtime_t total = test_filter_Run(filter, FRAMES, sums);
+
+    test_filter_Delete(filter);
+    return total;
+}
+
+static void Test(vlc_object_t *obj, const struct test *test,
+                 unsigned width, unsigned height)
+{
+    uint32_t ref[FRAMES], sums[FRAMES];
+    mtime_t c = Run(obj, test, width, height, false, ref);
+    mtime_t simd = Run(obj, test, width, height, true, sums);
+
+    /* The older x86 and Altivec merge routines round up, and are not
+     * expected to match the generic code. */
+    bool exact = !test->merge;
+#if defined(__i386__) || defined(__x86_64__)
+    exact = vlc_CPU_AVX2();
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    exact = true;
+#endif
+    if (exact)
+        for (unsigned i = 0; i < FRAMES; i++)
+            assert(sums[i] == ref[i]);
+
+    printf("%-7s %4.4s %ux%u: %6.2f ms/frame C, %6.2f ms/frame SIMD%s\n",
+           test->mode, (const char *)&test->chroma, width, height,
+           c / (1000. * FRAMES), simd / (1000. * FRAMES),
+           exact ? ", bit-exact" : "");
+}
+
+int main(void)
+{
+    test_init();
+
+    libvlc_instance_t *vlc = test_libvlc_new();
+    vlc_object_t *obj = VLC_OBJECT(vlc->p_libvlc_int);
+
+    for (size_t i = 0; i < ARRAY_SIZE(tests); i++)
+    {
+        /* Widths that are not multiples of the vector sizes */
+        Test(obj, &tests[i], 720, 576);
+        Test(obj, &tests[i], 1912, 1080);
+    }
+
+    libvlc_release(vlc);
+    return 0;
+}
@@ -0,0 +1,137 @@
+/*****************************************************************************
+ * filter.c: video filter test helpers
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#undef NDEBUG
+#include <assert.h>
+
+#include <vlc_common.h>
+#include <vlc_modules.h>
+
+#include "filter.h"
+
+static picture_t *BufferNew(filter_t *filter)
+{
+    return picture_NewFromFormat(&filter->fmt_out.video);
+}
+
+filter_t *test_filter_New(vlc_object_t *obj, vlc_fourcc_t chroma,
+                          unsigned width, unsigned height)
+{
+    filter_t *filter = vlc_object_create(obj, sizeof (*filter));
+    assert(filter != NULL);
+
+    es_format_Init(&filter->fmt_in, VIDEO_ES, chroma);
+    video_format_Setup(&filter->fmt_in.video, chroma,
+                       width, height, width, height, 1, 1);
+    filter->fmt_in.video.i_frame_rate = 25;
+    filter->fmt_in.video.i_frame_rate_base = 1;
+    es_format_Copy(&filter->fmt_out, &filter->fmt_in);
+    filter->owner.video.buffer_new = BufferNew;
+    return filter;
+}
+
+void test_filter_Delete(filter_t *filter)
+{
+    if (filter->p_module != NULL)
+        module_unneed(filter, filter->p_module);
+    es_format_Clean(&filter->fmt_in);
+    es_format_Clean(&filter->fmt_out);
+    vlc_object_release(filter);
+}
+
+mtime_t test_filter_Run(filter_t *filter, unsigned frames, uint32_t *sums)
+{
+    mtime_t total = 0;
+
+    for (unsigned i = 0; i < frames; i++)
+    {
+        picture_t *pic = picture_NewFromFormat(&filter->fmt_in.video);
+        assert(pic != NULL);
+        test_picture_Fill(pic, i);
+        pic->date = VLC_TS_0 + i * CLOCK_FREQ / 25;
+        pic->b_progressive = false;
+        pic->b_top_field_first = true;
+        pic->i_nb_fields = 2;
+
+        mtime_t start = mdate();
+        picture_t *out = filter->pf_video_filter(filter, pic);
+        total += mdate() - start;
+
+        sums[i] = 0;
+        while (out != NULL)
+        {
+            picture_t *next = out->p_next;
+
+            sums[i] = sums[i] * 31 + test_picture_Sum(out);
+            picture_Release(out);
+            out = next;
+        }
+    }
+    return total;
+}
+
+void test_picture_Fill(picture_t *pic, unsigned frame)
+{
+    const vlc_chroma_description_t *desc =
+        vlc_fourcc_GetChromaDescription(pic->format.i_chroma);
+    const unsigned pixel_size = desc != NULL ? desc->pixel_size : 1;
+    uint32_t seed = frame * 2654435761u;
+
+    for (int i = 0; i < pic->i_planes; i++)
+    {
+        plane_t *p = &pic->p[i];
+
+        for (int y = 0; y < p->i_lines; y++)
+        {
+            uint8_t *line = &p->p_pixels[y * p->i_pitch];
+
+            for (int x = 0; x < p->i_pitch / (int)pixel_size; x++)
+            {
+                seed = seed * 1103515245u + 12345u;
+                /* Gradients with noise, and fields that move apart */
+                unsigned v = (x + 2 * y + ((y & 1) ? 12 : 4) * frame) / 8
+                           + ((seed >> 16) & 15);
+                if (pixel_size == 2)
+                    ((uint16_t *)line)[x] = (v * 4 + (seed >> 24)) & 1023;
+                else
+                    line[x] = v;
+            }
+        }
+    }
+}
+
+uint32_t test_picture_Sum(const picture_t *pic)
+{
+    uint32_t sum = 2166136261u;
+
+    for (int i = 0; i < pic->i_planes; i++)
+    {
+        const plane_t *p = &pic->p[i];
+
+        for (int y = 0; y < p->i_visible_lines; y++)
+            for (int x = 0; x < p->i_visible_pitch; x++)
+                sum = (sum ^ p->p_pixels[y * p->i_pitch + x]) * 16777619u;
+    }
+    return sum;
+}
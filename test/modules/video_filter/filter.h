@@ -0,0 +1,41 @@
+/*****************************************************************************
+ * filter.h: video filter test helpers
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#include <vlc_common.h>
+#include <vlc_filter.h>
+#include <vlc_picture.h>
+
+/* Video filter object with the same input and output formats, at 25 fps.
+ * The caller adjusts the output format, creates the filter variables and
+ * loads the module. */
+filter_t *test_filter_New(vlc_object_t *obj, vlc_fourcc_t chroma,
+                          unsigned width, unsigned height);
+/* Unloads the module, if any, and releases the filter */
+void test_filter_Delete(filter_t *filter);
+
+/* Filters the given number of interlaced pictures, and stores a checksum of
+ * the output of each one. Returns the time spent in the filter. */
+mtime_t test_filter_Run(filter_t *filter, unsigned frames, uint32_t *sums);
+
+/* Fills a picture with noisy gradients, whose fields move apart from one
+ * frame to the next */
+void test_picture_Fill(picture_t *pic, unsigned frame);
+/* FNV-1a hash of the visible pixels of a picture */
+uint32_t test_picture_Sum(const picture_t *pic);
@@ -0,0 +1,114 @@
+/*****************************************************************************
+ * slices.c: video filter slice threads test and benchmark
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#include "../lib/libvlc_internal.h"
+
+#include <vlc_common.h>
+#include <vlc_modules.h>
+#include <vlc_filter.h>
+#include <vlc_picture.h>
+
+#include "filter.h"
+
+#include "../../libvlc/test.h" /* last, as it enables assert() again */
+
+/* Temporal filters need a few pictures before their output settles */
+#define FRAMES 3
+
+struct test
+{
+    const char *name;
+    const char *capability;
+    const char *module;
+    vlc_fourcc_t chroma_out;
+    const char *mode; /* deinterlace mode, if any */
+};
+
+static const struct test tests[] = {
+    { "adjust", "video filter", "adjust", VLC_CODEC_I420, NULL },
+    { "sharpen", "video filter", "sharpen", VLC_CODEC_I420, NULL },
+    { "gradfun", "video filter", "gradfun", VLC_CODEC_I420, NULL },
+    { "hqdn3d", "video filter", "hqdn3d", VLC_CODEC_I420, NULL },
+    { "yadif", "video filter", "deinterlace", VLC_CODEC_I420, "yadif" },
+    { "I420->YUY2", "video converter", "any", VLC_CODEC_YUYV, NULL },
+    { "I420->RV32", "video converter", "any", VLC_CODEC_RGB32, NULL },
+};
+
+/* Runs a filter on FRAMES pictures, returns the time spent in the filter */
+static mtime_t Run(vlc_object_t *obj, const struct test *test,
+                   unsigned width, unsigned height, unsigned threads,
+                   uint32_t sums[FRAMES])
+{
+    filter_t *filter = test_filter_New(obj, VLC_CODEC_I420, width, height);
+
+    var_Create(filter, "slice-threads", VLC_VAR_INTEGER);
+    var_SetInteger(filter, "slice-threads", threads);
+    if (test->mode != NULL)
+    {
+        var_Create(filter, "sout-deinterlace-mode", VLC_VAR_STRING);
+        var_SetString(filter, "sout-deinterlace-mode", test->mode);
+    }
+
+    filter->fmt_out.i_codec = test->chroma_out;
+    filter->fmt_out.video.i_chroma = test->chroma_out;
+    video_format_FixRgb(&filter->fmt_out.video);
+
+    filter->p_module = module_need(filter, test->capability, test->module,
+                                   true);
+    assert(filter->p_module != NULL);
+
+    mtime_t total = test_filter_Run(filter, FRAMES, sums);
+
+    test_filter_Delete(filter);
+    return total;
+}
+
+static void Test(vlc_object_t *obj, const struct test *test,
+                 unsigned width, unsigned height)
+{
+    uint32_t ref[FRAMES], sums[FRAMES];
+    mtime_t serial = Run(obj, test, width, height, 1, ref);
+    mtime_t sliced = Run(obj, test, width, height, 4, sums);
+
+    for (unsigned i = 0; i < FRAMES; i++)
+        assert(sums[i] == ref[i]);
+
+    printf("%-10s %ux%u: %6.2f ms/frame serial, %6.2f ms/frame "
+           "with 4 slice threads\n", test->name,
+           width, height, serial / (1000. * FRAMES),
+           sliced / (1000. * FRAMES));
+}
+
+int main(void)
+{
+    test_init();
+
+    libvlc_instance_t *vlc = test_libvlc_new();
+    vlc_object_t *obj = VLC_OBJECT(vlc->p_libvlc_int);
+
+    for (size_t i = 0; i < ARRAY_SIZE(tests); i++)
+    {
+        Test(obj, &tests[i], 1920, 1080);
+        Test(obj, &tests[i], 3840, 2160);
+    }
+
+    libvlc_release(vlc);
+    return 0;
+}
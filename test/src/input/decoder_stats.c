@@ -0,0 +1,117 @@
+/*****************************************************************************
+ * decoder_stats.c: video decoder statistics test
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#include "../lib/libvlc_internal.h"
+#include "../lib/media_internal.h"
+
+#include <string.h>
+
+#include <vlc_common.h>
+#include <vlc_input_item.h>
+
+#include "../../libvlc/test.h" /* last, as it enables assert() again */
+
+#define WIDTH  1280
+#define HEIGHT 720
+#define FRAMES 10
+
+/* Writes a short raw YUV4MPEG2 clip */
+static void WriteClip(int fd)
+{
+    static const char header[] =
+        "YUV4MPEG2 W1280 H720 F25:1 Ip A1:1 C420\n";
+    size_t size = WIDTH * HEIGHT * 3 / 2;
+    unsigned char *frame = malloc(size);
+    assert(frame != NULL);
+
+    assert(write(fd, header, strlen(header)) == (ssize_t)strlen(header));
+    for (unsigned i = 0; i < FRAMES; i++)
+    {
+        memset(frame, 16 + i * 16, size);
+        assert(write(fd, "FRAME\n", 6) == 6);
+        assert(write(fd, frame, size) == (ssize_t)size);
+    }
+    free(frame);
+}
+
+int main(void)
+{
+    test_init();
+
+    /* The clip is unlinked at once, so that it is removed even if the test
+     * fails, and played from its file descriptor. */
+    const char *tmpdir = getenv("TMPDIR");
+    char path[256];
+    snprintf(path, sizeof (path), "%s/vlc-decoder-stats-XXXXXX",
+             tmpdir != NULL ? tmpdir : "/tmp");
+    int fd = mkstemp(path);
+    assert(fd != -1);
+    unlink(path);
+    WriteClip(fd);
+    assert(lseek(fd, 0, SEEK_SET) == 0);
+
+    const char *argv[] = {
+        "-v", "--ignore-config", "-I", "dummy", "--no-media-library",
+        "--vout=vdummy", "--no-audio", "--demux=rawvid",
+        "--rawvid-fps=25", /* the demuxer ignores the Y4M frame rate */
+    };
+    libvlc_instance_t *vlc = libvlc_new(ARRAY_SIZE(argv), argv);
+    assert(vlc != NULL);
+
+    libvlc_media_t *md = libvlc_media_new_fd(vlc, fd);
+    assert(md != NULL);
+    libvlc_media_player_t *mp = libvlc_media_player_new_from_media(md);
+    assert(mp != NULL);
+
+    assert(libvlc_media_player_play(mp) == 0);
+    for (;;)
+    {
+        libvlc_state_t state = libvlc_media_get_state(md);
+
+        assert(state != libvlc_Error);
+        if (state == libvlc_Ended)
+            break;
+        usleep(10000);
+    }
+    /* Join the input thread, so that the statistics are final */
+    libvlc_media_player_stop(mp);
+
+    input_item_t *item = md->p_input_item;
+    vlc_mutex_lock(&item->lock);
+    assert(item->p_stats != NULL);
+    input_stats_t stats = *item->p_stats;
+    vlc_mutex_unlock(&item->lock);
+
+    printf("%"PRId64" pictures decoded, %"PRId64" us per picture, "
+           "%"PRId64" blocks queued\n", stats.i_decoded_video,
+           stats.i_decode_time, stats.i_decoder_queue);
+    /* Both the decoded blocks and the output pictures are counted */
+    assert(stats.i_decoded_video >= FRAMES);
+    assert(stats.i_decode_time > 0);
+    /* The last picture comes from the last block, dequeued from an empty
+     * fifo */
+    assert(stats.i_decoder_queue == 0);
+
+    libvlc_media_player_release(mp);
+    libvlc_media_release(md);
+    libvlc_release(vlc);
+    close(fd);
+    return 0;
+}
@@ -0,0 +1,195 @@
+/*****************************************************************************
+ * timeshift.c: timeshift data buffer test
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#include "../lib/libvlc_internal.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#ifdef HAVE_MMAP
+# include <sys/mman.h>
+#endif
+
+#include <vlc_common.h>
+#include <vlc_block.h>
+
+/* Failures are injected in the system calls of the buffer */
+static bool mmap_fails;
+static size_t fallocate_budget;
+
+#ifdef HAVE_MMAP
+static void *test_mmap(void *addr, size_t length, int prot, int flags, int fd,
+                       off_t offset)
+{
+    if (mmap_fails)
+    {
+        errno = ENOMEM;
+        return MAP_FAILED;
+    }
+    return mmap(addr, length, prot, flags, fd, offset);
+}
+# define mmap test_mmap
+#endif
+
+#ifdef HAVE_POSIX_FALLOCATE
+static int test_posix_fallocate(int fd, off_t offset, off_t length)
+{
+    if ((size_t)length > fallocate_budget)
+        return EIO; /* Not ENOSPC: any failure must stop the reservation */
+    fallocate_budget -= length;
+    return posix_fallocate(fd, offset, length);
+}
+# define posix_fallocate test_posix_fallocate
+#endif
+
+#include "../src/input/timeshift_buffer.c"
+
+#include "../../libvlc/test.h" /* last, as it enables assert() again */
+
+#define SIZE    (64 * 1024)
+#define STEP    (16 * 1024)
+#define RECORDS 20000
+
+static void Fill(uint8_t *p, size_t size, unsigned seq)
+{
+    for (size_t i = 0; i < size; i++)
+        p[i] = seq + i;
+}
+
+static struct
+{
+    int offset;
+    size_t size;
+} queue[SIZE / 16];
+static unsigned queue_r, queue_w;
+
+static void Pop(ts_buffer_t *buffer)
+{
+    assert(queue_r < queue_w);
+
+    const unsigned seq = queue_r++;
+    const size_t size = queue[seq % ARRAY_SIZE(queue)].size;
+    block_t *block = ts_buffer_Read(buffer, queue[seq % ARRAY_SIZE(queue)].offset,
+                                    size, false);
+    assert(block != NULL);
+    assert(block->i_buffer == size);
+    assert(block->i_pts == VLC_TS_0 + seq && block->i_dts == VLC_TS_INVALID);
+    assert(block->i_flags == (seq & BLOCK_FLAG_DISCONTINUITY));
+
+    uint8_t *ref = malloc(size + 1);
+    assert(ref != NULL);
+    Fill(ref, size, seq);
+    assert(!memcmp(block->p_buffer, ref, size));
+    free(ref);
+    block_Release(block);
+}
+
+/* Writes records of various sizes, reading the oldest ones back to make
+ * room, so that the buffer rotates many times. Returns the number of
+ * failed reservations. */
+static unsigned Rotate(ts_buffer_t *buffer)
+{
+    unsigned failures = 0;
+
+    queue_r = queue_w = 0;
+
+    for (unsigned seq = 0; seq < RECORDS; seq++)
+    {
+        const size_t size = (seq * 7919) % 3000;
+        block_t *block = block_Alloc(size);
+        assert(block != NULL);
+        Fill(block->p_buffer, size, seq);
+        block->i_pts = VLC_TS_0 + seq;
+        block->i_dts = VLC_TS_INVALID;
+        block->i_flags = seq & BLOCK_FLAG_DISCONTINUITY;
+
+        if (!ts_buffer_Reserve(buffer, size))
+            failures++;
+        while (!ts_buffer_HasRoom(buffer, size))
+            Pop(buffer);
+
+        const int offset = ts_buffer_Write(buffer, block);
+        block_Release(block);
+
+        assert(offset >= 0);
+        assert(offset + ts_buffer_RecordSize(size) <= buffer->i_data_size);
+        /* Mapped data is never written past the reserved disk space */
+        assert(buffer->p_data == NULL
+            || offset + ts_buffer_RecordSize(size) <= buffer->i_data_reserved);
+        assert(queue_w - queue_r < ARRAY_SIZE(queue));
+        queue[queue_w % ARRAY_SIZE(queue)].offset = offset;
+        queue[queue_w % ARRAY_SIZE(queue)].size = size;
+        queue_w++;
+        assert(buffer->i_data_w - buffer->i_data_r <= buffer->i_data_size);
+    }
+
+    assert(buffer->i_data_w > 4 * SIZE);
+    while (queue_r < queue_w)
+        Pop(buffer);
+    assert(buffer->i_data_r == buffer->i_data_w);
+    return failures;
+}
+
+int main(void)
+{
+    test_init();
+
+    const char *tmpdir = getenv("TMPDIR");
+    ts_buffer_t *buffer;
+
+    /* Mapped file, reserved step by step */
+    fallocate_budget = SIZE_MAX;
+    buffer = ts_buffer_New(tmpdir, SIZE, STEP);
+    assert(buffer != NULL);
+    assert(buffer->i_data_size == SIZE);
+    assert(Rotate(buffer) == 0);
+#ifdef TS_BUFFER_MMAP
+    assert(buffer->p_data != NULL);
+    assert(buffer->i_data_reserved == SIZE);
+#endif
+    ts_buffer_Delete(buffer);
+
+    /* Mapping failure: file I/O */
+    mmap_fails = true;
+    buffer = ts_buffer_New(tmpdir, SIZE, STEP);
+    assert(buffer != NULL);
+    assert(buffer->p_data == NULL);
+    assert(Rotate(buffer) == 0);
+    assert(buffer->i_data_size == SIZE);
+    ts_buffer_Delete(buffer);
+    mmap_fails = false;
+
+#ifdef TS_BUFFER_MMAP
+    /* Reservation failure: the buffer rotates within the reserved space */
+    fallocate_budget = 2 * STEP;
+    buffer = ts_buffer_New(tmpdir, SIZE, STEP);
+    assert(buffer != NULL);
+    assert(Rotate(buffer) == 1);
+    assert(buffer->i_data_size == 2 * STEP);
+    assert(buffer->i_data_reserved == 2 * STEP);
+    ts_buffer_Delete(buffer);
+
+    /* No space at all: no buffer */
+    fallocate_budget = 0;
+    assert(ts_buffer_New(tmpdir, SIZE, STEP) == NULL);
+#endif
+    return 0;
+}
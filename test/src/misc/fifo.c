@@ -0,0 +1,157 @@
+/*****************************************************************************
+ * fifo.c: test and benchmark for block FIFOs
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#include "../../libvlc/test.h"
+#include <vlc_common.h>
+#include <vlc_block.h>
+
+#define BLOCKS 500000
+
+static block_t blocks[BLOCKS];
+
+static void NoRelease(block_t *block)
+{
+    (void) block;
+}
+
+static void InitBlocks(void)
+{
+    for (size_t i = 0; i < BLOCKS; i++)
+    {
+        block_Init(&blocks[i], NULL, i % 1500);
+        blocks[i].pf_release = NoRelease;
+    }
+}
+
+static void test_spsc(void)
+{
+    block_spsc_t *fifo = block_SpscNew();
+    assert(fifo != NULL);
+
+    assert(block_SpscTryGet(fifo) == NULL);
+    assert(block_SpscCount(fifo) == 0);
+    assert(block_SpscSize(fifo) == 0);
+    block_SpscPut(fifo, NULL);
+    assert(block_SpscCount(fifo) == 0);
+
+    /* Span several segments, queue chains and single blocks */
+    size_t bytes = 0;
+    for (size_t i = 0; i < 2000; i += 4)
+    {
+        blocks[i].p_next = &blocks[i + 1];
+        assert(block_SpscPut(fifo, &blocks[i]) == VLC_SUCCESS);
+        block_SpscPut(fifo, &blocks[i + 2]);
+        block_SpscPut(fifo, &blocks[i + 3]);
+        for (size_t j = 0; j < 4; j++)
+            bytes += blocks[i + j].i_buffer;
+    }
+
+    assert(block_SpscCount(fifo) == 2000);
+    for (size_t i = 0; i < 2000; i++)
+    {
+        assert(block_SpscSize(fifo) == bytes);
+        block_t *block = block_SpscGet(fifo);
+        assert(block == &blocks[i]);
+        assert(block->p_next == NULL);
+        bytes -= block->i_buffer;
+    }
+    assert(block_SpscCount(fifo) == 0);
+    assert(block_SpscSize(fifo) == 0);
+    assert(block_SpscTryGet(fifo) == NULL);
+
+    /* Leftover blocks are released with the FIFO */
+    block_SpscPut(fifo, block_Alloc(42));
+    block_SpscRelease(fifo);
+}
+
+/* Benchmarks */
+static void *ConsumeFifo(void *data)
+{
+    block_fifo_t *fifo = data;
+
+    for (size_t i = 0; i < BLOCKS; i++)
+    {
+        block_t *block = block_FifoGet(fifo);
+        assert(block == &blocks[i]);
+    }
+    return NULL;
+}
+
+static void *ConsumeSpsc(void *data)
+{
+    block_spsc_t *fifo = data;
+
+    for (size_t i = 0; i < BLOCKS; i++)
+    {
+        block_t *block = block_SpscGet(fifo);
+        assert(block == &blocks[i]);
+    }
+    return NULL;
+}
+
+static void bench_fifo(void)
+{
+    block_fifo_t *fifo = block_FifoNew();
+    vlc_thread_t th;
+
+    assert(fifo != NULL);
+    mtime_t start = mdate();
+    if (vlc_clone(&th, ConsumeFifo, fifo, VLC_THREAD_PRIORITY_LOW))
+        abort();
+    for (size_t i = 0; i < BLOCKS; i++)
+        block_FifoPut(fifo, &blocks[i]);
+    vlc_join(th, NULL);
+
+    mtime_t d = mdate() - start;
+    printf("block_fifo_t: %6.1f ns/block, %.2f Mblocks/s\n",
+           d * 1000. / BLOCKS, BLOCKS / (double)d);
+    block_FifoRelease(fifo);
+}
+
+static void bench_spsc(void)
+{
+    block_spsc_t *fifo = block_SpscNew();
+    vlc_thread_t th;
+
+    assert(fifo != NULL);
+    mtime_t start = mdate();
+    if (vlc_clone(&th, ConsumeSpsc, fifo, VLC_THREAD_PRIORITY_LOW))
+        abort();
+    for (size_t i = 0; i < BLOCKS; i++)
+        block_SpscPut(fifo, &blocks[i]);
+    vlc_join(th, NULL);
+
+    mtime_t d = mdate() - start;
+    printf("block_spsc_t: %6.1f ns/block, %.2f Mblocks/s\n",
+           d * 1000. / BLOCKS, BLOCKS / (double)d);
+    block_SpscRelease(fifo);
+}
+
+int main(void)
+{
+    test_init();
+    InitBlocks();
+
+    test_spsc();
+    InitBlocks();
+    bench_fifo();
+    bench_spsc();
+    return 0;
+}
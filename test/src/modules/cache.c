@@ -0,0 +1,180 @@
+/*****************************************************************************
+ * cache.c: plugins cache test and startup benchmark
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#include "../../libvlc/test.h"
+
+#include <vlc_common.h>
+#include <vlc_modules.h>
+#include <vlc_plugin.h>
+
+static void DumpStrings(FILE *out, const char *const *list, unsigned n)
+{
+    for (unsigned i = 0; i < n; i++)
+        fprintf(out, " [%s]", list[i]);
+    fputc('\n', out);
+}
+
+static void DumpItem(FILE *out, const module_config_t *item)
+{
+    fprintf(out, "  %d %c %d%d%d%d %s %s\n", item->i_type,
+            item->i_short ? item->i_short : '-', item->b_advanced,
+            item->b_unsaveable, item->b_safe, item->b_removed,
+            item->psz_name ? item->psz_name : "(null)",
+            item->psz_type ? item->psz_type : "(null)");
+    fprintf(out, "   %s | %s\n", item->psz_text ? item->psz_text : "(null)",
+            item->psz_longtext ? item->psz_longtext : "(null)");
+
+    if (item->i_type & CONFIG_ITEM_STRING)
+    {
+        fprintf(out, "   \"%s\" \"%s\"",
+                item->orig.psz ? item->orig.psz : "(null)",
+                item->value.psz ? item->value.psz : "(null)");
+        if (item->list_count > 0)
+            DumpStrings(out, item->list.psz, item->list_count);
+        else
+            fputc('\n', out);
+    }
+    else if (item->i_type == CONFIG_ITEM_FLOAT)
+        fprintf(out, "   %f %f [%f, %f]\n", item->orig.f, item->value.f,
+                item->min.f, item->max.f);
+    else
+    {
+        fprintf(out, "   %"PRId64" %"PRId64" [%"PRId64", %"PRId64"]",
+                item->orig.i, item->value.i, item->min.i, item->max.i);
+        for (unsigned i = 0; i < item->list_count; i++)
+            fprintf(out, " %d", item->list.i[i]);
+        fputc('\n', out);
+    }
+
+    DumpStrings(out, item->list_text, item->list_count);
+    fprintf(out, "   %s\n",
+            item->list_cb_name ? item->list_cb_name : "(null)");
+}
+
+static int strcmpp(const void *a, const void *b)
+{
+    return strcmp(*(const char *const *)a, *(const char *const *)b);
+}
+
+/* Dumps all the modules and their configuration. The order of the modules
+ * within a plugin is irrelevant, so the module dumps are sorted. */
+static char *Dump(void)
+{
+    size_t count;
+    module_t **list = module_list_get(&count);
+    assert(count > 0);
+
+    char **dumps = malloc(count * sizeof (*dumps));
+    assert(dumps != NULL);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        module_t *module = list[i];
+        unsigned confsize;
+        size_t len;
+        FILE *out = open_memstream(&dumps[i], &len);
+        assert(out != NULL);
+
+        fprintf(out, "%s %s %d\n", module_get_object(module),
+                module_get_capability(module), module_get_score(module));
+
+        module_config_t *config = module_config_get(module, &confsize);
+        for (unsigned j = 0; j < confsize; j++)
+            DumpItem(out, config + j);
+        module_config_free(config);
+        fclose(out);
+    }
+    module_list_free(list);
+
+    qsort(dumps, count, sizeof (*dumps), strcmpp);
+
+    char *buf;
+    size_t len;
+    FILE *out = open_memstream(&buf, &len);
+    assert(out != NULL);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        fputs(dumps[i], out);
+        free(dumps[i]);
+    }
+    free(dumps);
+    fclose(out);
+    return buf;
+}
+
+static mtime_t Start(const char *const *opts, unsigned runs, char **dump)
+{
+    const char *argv[] = {
+        "-v", "--ignore-config", "-I", "dummy", "--no-media-library",
+        opts[0], opts[1],
+    };
+    mtime_t best = INT64_MAX;
+
+    for (unsigned i = 0; i < runs; i++)
+    {
+        mtime_t start = mdate();
+        libvlc_instance_t *vlc = libvlc_new(ARRAY_SIZE(argv), argv);
+        mtime_t d = mdate() - start;
+
+        assert(vlc != NULL);
+        if (d < best)
+            best = d;
+        if (i == 0)
+            *dump = Dump();
+        libvlc_release(vlc);
+    }
+    return best;
+}
+
+int main(void)
+{
+    test_init();
+
+    /* Scan all plugins, and (re)write the cache */
+    static const char *const reset[] = {
+        "--reset-plugins-cache", "--plugins-scan" };
+    /* Check the plugins against the cache */
+    static const char *const cache[] = {
+        "--plugins-cache", "--plugins-scan" };
+    /* Load everything from the cache: this depends on the cache format */
+    static const char *const only[] = {
+        "--plugins-cache", "--no-plugins-scan" };
+    char *scanned, *cached, *loaded;
+
+    mtime_t scan_time = Start(reset, 1, &scanned);
+    mtime_t cache_time = Start(cache, 20, &cached);
+    mtime_t only_time = Start(only, 20, &loaded);
+
+    printf("libvlc_new(): %.2f ms without cache, %.2f ms with cache, "
+           "%.2f ms from the cache only\n", scan_time / 1000.,
+           cache_time / 1000., only_time / 1000.);
+
+    /* The cache must describe the plugins exactly */
+    if (strcmp(scanned, cached) || strcmp(scanned, loaded))
+    {
+        fprintf(stderr, "plugins cache mismatch\n");
+        abort();
+    }
+    free(scanned);
+    free(cached);
+    free(loaded);
+    return 0;
+}
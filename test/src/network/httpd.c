@@ -0,0 +1,238 @@
+/*****************************************************************************
+ * httpd.c: HTTP stream server test and load generator
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#include "../../libvlc/test.h"
+#include "../lib/libvlc_internal.h"
+
+#include <vlc_common.h>
+#include <vlc_block.h>
+#include <vlc_httpd.h>
+#include <vlc_network.h>
+
+#include <errno.h>
+#include <poll.h>
+#include <time.h>
+
+#define CLIENTS     256
+#define BLOCK_SIZE  (7 * 188 * 8)
+#define STREAM_SIZE (BLOCK_SIZE * 200)  /* about 2 MB */
+
+struct client
+{
+    int fd;
+    bool body;      /* answer headers received */
+    char header[512];
+    size_t header_len;
+    size_t received;
+};
+
+static struct client clients[CLIENTS];
+static size_t sent; /* bytes fed to the stream so far */
+
+static int Connect(unsigned port)
+{
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_port = htons(port),
+        .sin_addr.s_addr = htonl(INADDR_LOOPBACK),
+    };
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    assert(fd != -1);
+
+    if (connect(fd, (struct sockaddr *)&addr, sizeof (addr)))
+    {
+        perror("connect");
+        abort();
+    }
+
+    static const char req[] = "GET /stream HTTP/1.0\r\n\r\n";
+    if (send(fd, req, sizeof (req) - 1, 0) != sizeof (req) - 1)
+        abort();
+    return fd;
+}
+
+/* Checks the received bytes: stream byte N has the value N modulo 256. */
+static void Check(struct client *cl, const uint8_t *buf, size_t len)
+{
+    for (size_t i = 0; i < len; i++)
+        assert(buf[i] == (uint8_t)(cl->received + i));
+    cl->received += len;
+}
+
+static void Receive(struct client *cl)
+{
+    uint8_t buf[65536];
+    ssize_t len = recv(cl->fd, buf, sizeof (buf), MSG_DONTWAIT);
+
+    if (len <= 0)
+    {
+        assert(len == 0 || errno == EAGAIN);
+        return;
+    }
+
+    size_t offset = 0;
+    if (!cl->body)
+    {   /* Look for the end of the answer headers */
+        while (offset < (size_t)len && !cl->body)
+        {
+            assert(cl->header_len < sizeof (cl->header));
+            cl->header[cl->header_len++] = buf[offset++];
+            cl->body = cl->header_len >= 4
+                    && !memcmp(cl->header + cl->header_len - 4, "\r\n\r\n", 4);
+        }
+        if (cl->body)
+            assert(!strncmp(cl->header, "HTTP/1.0 200 ", 13));
+    }
+    Check(cl, buf + offset, len - offset);
+}
+
+/* Receives until all clients satisfy the condition. There is no deadline:
+ * the test alarm is the only guard against a server that stops sending. */
+static void ReceiveAll(bool (*done)(const struct client *))
+{
+    struct pollfd ufd[CLIENTS];
+
+    for (;;)
+    {
+        unsigned n = 0;
+
+        for (unsigned i = 0; i < CLIENTS; i++)
+            if (!done(&clients[i]))
+            {
+                ufd[n].fd = clients[i].fd;
+                ufd[n].events = POLLIN;
+                n++;
+            }
+        if (n == 0)
+            return;
+
+        int val = poll(ufd, n, -1);
+        assert(val >= 0);
+
+        for (unsigned i = 0, j = 0; i < CLIENTS && j < n; i++)
+            if (clients[i].fd == ufd[j].fd)
+            {
+                if (ufd[j].revents)
+                    Receive(&clients[i]);
+                j++;
+            }
+    }
+}
+
+static bool HasHeaders(const struct client *cl)
+{
+    return cl->body;
+}
+
+static bool HasSent(const struct client *cl)
+{
+    return cl->received >= sent;
+}
+
+static void test_httpd(unsigned workers, size_t size, unsigned port)
+{
+    char port_opt[20], workers_opt[20];
+    const char *argv[] = {
+        "-v", "--ignore-config", "-I", "dummy", "--no-media-library",
+        "--http-host=127.0.0.1", port_opt, workers_opt,
+    };
+
+    sprintf(port_opt, "--http-port=%u", port);
+    sprintf(workers_opt, "--http-workers=%u", workers);
+
+    libvlc_instance_t *vlc = libvlc_new(ARRAY_SIZE(argv), argv);
+    assert(vlc != NULL);
+
+    httpd_host_t *host = vlc_http_HostNew(VLC_OBJECT(vlc->p_libvlc_int));
+    assert(host != NULL);
+    httpd_stream_t *stream = httpd_StreamNew(host, "/stream",
+                                             "video/MP2T", NULL, NULL);
+    assert(stream != NULL);
+
+    memset(clients, 0, sizeof (clients));
+    sent = 0;
+    for (unsigned i = 0; i < CLIENTS; i++)
+        clients[i].fd = Connect(port);
+    ReceiveAll(HasHeaders);
+
+    /* Feed the stream block by block, each one received by every client
+     * before the next one, so that no client can fall behind the stream
+     * buffer whatever the machine load. */
+    mtime_t start = mdate();
+    mtime_t cpu_start = test_cputime(CLOCK_PROCESS_CPUTIME_ID);
+
+    for (size_t pos = 0; pos < size; pos += BLOCK_SIZE)
+    {
+        block_t *block = block_Alloc(BLOCK_SIZE);
+        assert(block != NULL);
+
+        for (size_t i = 0; i < BLOCK_SIZE; i++)
+            block->p_buffer[i] = pos + i;
+        httpd_StreamSend(stream, block);
+        block_Release(block);
+
+        sent = pos + BLOCK_SIZE;
+        ReceiveAll(HasSent);
+    }
+
+    mtime_t end = mdate();
+    mtime_t cpu_end = test_cputime(CLOCK_PROCESS_CPUTIME_ID);
+    size_t bytes = 0;
+
+    for (unsigned i = 0; i < CLIENTS; i++)
+    {
+        assert(clients[i].received == size);
+        bytes += clients[i].received;
+    }
+
+    double secs = (end - start) / (double)CLOCK_FREQ;
+    printf("%u worker(s): %d clients, %.1f MB in %.2f s, %.0f Mbit/s out, "
+           "%.2f ms CPU/MB (server and clients)\n",
+           workers, CLIENTS, bytes / 1e6, secs, bytes * 8 / secs / 1e6,
+           (cpu_end - cpu_start) / 1000. / (bytes / 1e6));
+
+    /* Deleting the stream disconnects the clients */
+    httpd_StreamDelete(stream);
+    for (unsigned i = 0; i < CLIENTS; i++)
+    {
+        uint8_t c;
+        ssize_t val;
+
+        while ((val = recv(clients[i].fd, &c, 1, 0)) < 0 && errno == EINTR);
+        assert(val == 0);
+        net_Close(clients[i].fd);
+    }
+
+    httpd_HostDelete(host);
+    libvlc_release(vlc);
+}
+
+int main(void)
+{
+    test_init();
+
+    unsigned port = 20000 + (getpid() % 20000);
+
+    /* The server thread alone is much slower: send less */
+    test_httpd(0, STREAM_SIZE / 10, port);
+    test_httpd(1, STREAM_SIZE, port + 1);
+    test_httpd(4, STREAM_SIZE, port + 2);
+    return 0;
+}
@@ -0,0 +1,223 @@
+/*****************************************************************************
+ * spu_cache.c: scaled subpicture region cache test and benchmark
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#include "../lib/libvlc_internal.h"
+
+#include <vlc_common.h>
+#include <vlc_modules.h>
+#include <vlc_filter.h>
+#include <vlc_spu.h>
+#include <vlc_subpicture.h>
+#include <vlc_text_style.h>
+
+#include "../../libvlc/test.h" /* last, as it enables assert() again */
+
+#define PAGES 8
+
+static const vlc_fourcc_t chroma_list[] = { VLC_CODEC_RGBA, 0 };
+
+/* A DVB like bitmap page, refreshed with the same content */
+static subpicture_t *NewBitmap(unsigned seed)
+{
+    video_format_t fmt;
+    video_palette_t palette = { .i_entries = 4 };
+
+    for (int i = 0; i < 4; i++)
+    {
+        palette.palette[i][0] = 16 + 60 * i;
+        palette.palette[i][1] = 128;
+        palette.palette[i][2] = 128;
+        palette.palette[i][3] = i ? 0xff : 0;
+    }
+    video_format_Init(&fmt, VLC_CODEC_YUVP);
+    fmt.i_width = fmt.i_visible_width = 640;
+    fmt.i_height = fmt.i_visible_height = 96;
+    fmt.i_sar_num = fmt.i_sar_den = 1;
+    fmt.p_palette = &palette;
+
+    subpicture_t *subpic = subpicture_New(NULL);
+    assert(subpic != NULL);
+    subpic->i_original_picture_width = 720;
+    subpic->i_original_picture_height = 576;
+
+    subpicture_region_t *r = subpic->p_region = subpicture_region_New(&fmt);
+    assert(r != NULL);
+    r->i_x = 40;
+    r->i_y = 460;
+
+    const plane_t *p = &r->p_picture->p[0];
+    for (int y = 0; y < p->i_lines; y++)
+        for (int x = 0; x < p->i_pitch; x++)
+            p->p_pixels[y * p->i_pitch + x] = ((x / 8) ^ (y / 8) ^ seed) & 3;
+    return subpic;
+}
+
+/* A styled text line, as decoded from SSA */
+static subpicture_t *NewText(const char *text)
+{
+    video_format_t fmt;
+
+    video_format_Init(&fmt, VLC_CODEC_TEXT);
+
+    subpicture_t *subpic = subpicture_New(NULL);
+    assert(subpic != NULL);
+    subpic->i_original_picture_width = 1920;
+    subpic->i_original_picture_height = 1080;
+
+    subpicture_region_t *r = subpic->p_region = subpicture_region_New(&fmt);
+    assert(r != NULL);
+    r->i_align = SUBPICTURE_ALIGN_BOTTOM;
+
+    text_segment_t *seg = r->p_text = text_segment_New(text);
+    assert(seg != NULL);
+    seg->style = text_style_Create(STYLE_NO_DEFAULTS);
+    assert(seg->style != NULL);
+    seg->style->i_style_flags = STYLE_BOLD | STYLE_OUTLINE;
+    seg->style->i_features |= STYLE_HAS_FLAGS;
+    seg->style->i_font_color = 0xffff00;
+    seg->style->i_features |= STYLE_HAS_FONT_COLOR;
+    return subpic;
+}
+
+/* Shows each page for one second, and returns the rendered pictures */
+static void Run(spu_t *spu, subpicture_t *(*pages[PAGES])(unsigned),
+                picture_t *out[PAGES], mtime_t times[PAGES])
+{
+    video_format_t fmt;
+
+    video_format_Init(&fmt, VLC_CODEC_RGBA);
+    video_format_Setup(&fmt, VLC_CODEC_RGBA, 3840, 2160, 3840, 2160, 1, 1);
+
+    for (unsigned i = 0; i < PAGES; i++)
+    {
+        const mtime_t start = VLC_TS_0 + i * CLOCK_FREQ;
+        subpicture_t *subpic = pages[i](i);
+
+        subpic->i_start = start;
+        subpic->i_stop = start + CLOCK_FREQ;
+        subpic->b_subtitle = true;
+        spu_PutSubpicture(spu, subpic);
+
+        mtime_t date = mdate();
+        subpicture_t *render = spu_Render(spu, chroma_list, &fmt, &fmt,
+                                          start + CLOCK_FREQ / 2,
+                                          start + CLOCK_FREQ / 2, false);
+        times[i] = mdate() - date;
+
+        out[i] = NULL;
+        if (render != NULL)
+        {
+            if (render->p_region != NULL)
+                out[i] = picture_Hold(render->p_region->p_picture);
+            subpicture_Delete(render);
+        }
+    }
+}
+
+static subpicture_t *Page0(unsigned i) { (void) i; return NewBitmap(0); }
+static subpicture_t *Page1(unsigned i) { (void) i; return NewBitmap(1); }
+static subpicture_t *Line0(unsigned i)
+{
+    (void) i;
+    return NewText("A styled subtitle");
+}
+static subpicture_t *Line1(unsigned i) { (void) i; return NewText("Another line"); }
+
+/* Regions are scaled only if a converter like the one of the SPU loads */
+static bool HasScaler(vlc_object_t *obj)
+{
+    filter_t *scale = vlc_object_create(obj, sizeof (*scale));
+    assert(scale != NULL);
+
+    es_format_Init(&scale->fmt_in, VIDEO_ES, VLC_CODEC_YUVA);
+    video_format_Setup(&scale->fmt_in.video, VLC_CODEC_YUVA,
+                       32, 32, 32, 32, 1, 1);
+    es_format_Init(&scale->fmt_out, VIDEO_ES, VLC_CODEC_RGBA);
+    video_format_Setup(&scale->fmt_out.video, VLC_CODEC_RGBA,
+                       16, 16, 16, 16, 1, 1);
+
+    scale->p_module = module_need(scale, "video converter", NULL, false);
+    bool ok = scale->p_module != NULL;
+    if (ok)
+        module_unneed(scale, scale->p_module);
+    es_format_Clean(&scale->fmt_in);
+    es_format_Clean(&scale->fmt_out);
+    vlc_object_release(scale);
+    return ok;
+}
+
+static void Test(vlc_object_t *obj, const char *name,
+                 subpicture_t *(*a)(unsigned), subpicture_t *(*b)(unsigned))
+{
+    /* The same page shown repeatedly, then another one, then the first
+     * one again */
+    subpicture_t *(*pages[PAGES])(unsigned) = { a, a, a, a, b, b, a, a };
+    picture_t *out[PAGES];
+    mtime_t times[PAGES];
+
+    spu_t *spu = spu_Create(obj, NULL);
+    assert(spu != NULL);
+    Run(spu, pages, out, times);
+    spu_Destroy(spu);
+
+    if (out[0] == NULL)
+    {
+        printf("%-6s: not rendered, skipped\n", name);
+        for (unsigned i = 0; i < PAGES; i++)
+            assert(out[i] == NULL);
+        return;
+    }
+
+    /* Identical regions share the scaled picture, other ones do not */
+    for (unsigned i = 1; i < PAGES; i++)
+    {
+        assert(out[i] != NULL);
+        assert((out[i] == out[0]) == (pages[i] == a));
+    }
+    assert(out[5] == out[4]);
+
+    mtime_t hit = 0;
+    for (unsigned i = 1; i < 4; i++)
+        hit += times[i];
+    printf("%-6s: %6.2f ms on the first page, %6.2f ms on refreshes\n",
+           name, times[0] / 1000., hit / (1000. * 3));
+
+    for (unsigned i = 0; i < PAGES; i++)
+        picture_Release(out[i]);
+}
+
+int main(void)
+{
+    test_init();
+
+    libvlc_instance_t *vlc = test_libvlc_new();
+    vlc_object_t *obj = VLC_OBJECT(vlc->p_libvlc_int);
+
+    if (HasScaler(obj))
+    {
+        Test(obj, "bitmap", Page0, Page1);
+        Test(obj, "text", Line0, Line1);
+    }
+    else
+        printf("no YUVA to RGBA scaler, skipped\n");
+
+    libvlc_release(vlc);
+    return 0;
+}